@@ -0,0 +1,197 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measures the cost of application-not-responding detection as the number of
+ * connected sessions grows: the number of detector wakeups, the CPU time they
+ * take in total, and the longest single wakeup (which stalls the main loop).
+ *
+ * Sessions connect at even intervals across the first ping period and answer
+ * every ping straight away. Time is simulated, so only the detector's own
+ * work is measured.
+ *
+ * Usage: benchmark_anr_detector [periods]
+ */
+
+#include "src/server/scene/timeout_application_not_responding_detector.h"
+#include "mir/time/alarm_factory.h"
+#include "mir/time/clock.h"
+#include "mir/lockable_callback.h"
+#include "mir/test/doubles/stub_session.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace mf = mir::frontend;
+namespace ms = mir::scene;
+namespace mt = mir::time;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+using namespace std::literals::chrono_literals;
+
+auto const period = 1000ms;
+
+class ManualClock : public mt::Clock
+{
+public:
+    mt::Timestamp now() const override { return current; }
+    mt::Duration min_wait_until(mt::Timestamp t) const override { return std::max(t - current, mt::Duration{0}); }
+
+    mt::Timestamp current{};
+};
+
+class ManualAlarm : public mt::Alarm
+{
+public:
+    ManualAlarm(ManualClock const& clock, std::function<void()> const& callback) :
+        clock{clock}, callback{callback}
+    {
+    }
+
+    bool cancel() override
+    {
+        if (current_state == pending)
+            current_state = cancelled;
+        return current_state == cancelled;
+    }
+
+    State state() const override { return current_state; }
+
+    bool reschedule_in(std::chrono::milliseconds delay) override
+    {
+        return reschedule_for(clock.now() + delay);
+    }
+
+    bool reschedule_for(mt::Timestamp timeout) override
+    {
+        auto const was_pending = current_state == pending;
+        current_state = pending;
+        due = timeout;
+        return was_pending;
+    }
+
+    void fire()
+    {
+        current_state = triggered;
+        callback();
+    }
+
+    mt::Timestamp due{};
+
+private:
+    ManualClock const& clock;
+    std::function<void()> const callback;
+    State current_state{triggered};
+};
+
+class ManualAlarmFactory : public mt::AlarmFactory
+{
+public:
+    explicit ManualAlarmFactory(ManualClock const& clock) : clock{clock} {}
+
+    std::unique_ptr<mt::Alarm> create_alarm(std::function<void()> const& callback) override
+    {
+        auto const alarm = new ManualAlarm{clock, callback};
+        alarms.push_back(alarm);
+        return std::unique_ptr<mt::Alarm>{alarm};
+    }
+
+    std::unique_ptr<mt::Alarm> create_alarm(std::unique_ptr<mir::LockableCallback> callback) override
+    {
+        std::shared_ptr<mir::LockableCallback> const shared{std::move(callback)};
+        return create_alarm([shared] { (*shared)(); });
+    }
+
+    ManualAlarm* next_pending() const
+    {
+        ManualAlarm* next{nullptr};
+        for (auto const alarm : alarms)
+        {
+            if (alarm->state() == mt::Alarm::pending && (!next || alarm->due < next->due))
+                next = alarm;
+        }
+        return next;
+    }
+
+private:
+    ManualClock const& clock;
+    std::vector<ManualAlarm*> alarms;
+};
+
+void run(int session_count, int periods)
+{
+    auto const clock = std::make_shared<ManualClock>();
+    ManualAlarmFactory alarms{*clock};
+    ms::TimeoutApplicationNotRespondingDetector detector{alarms, clock, period};
+
+    std::vector<mir::test::doubles::StubSession> sessions(session_count);
+    std::vector<mf::Session const*> pinged;
+    pinged.reserve(session_count);
+
+    auto const key = [&](int i) -> mf::Session const* { return &sessions[i]; };
+
+    auto const connect_interval = std::chrono::duration_cast<mt::Duration>(period) / session_count;
+    for (auto i = 0; i != session_count; ++i)
+    {
+        clock->current = mt::Timestamp{} + i * connect_interval;
+        detector.register_session(key(i), [&pinged, &key, i] { pinged.push_back(key(i)); });
+    }
+
+    auto const end = clock->current + periods * period;
+    int wakeups{0};
+    Clock::duration total{0};
+    Clock::duration worst{0};
+
+    while (auto const alarm = alarms.next_pending())
+    {
+        if (alarm->due > end)
+            break;
+
+        clock->current = alarm->due;
+
+        auto const start = Clock::now();
+        alarm->fire();
+        auto const elapsed = Clock::now() - start;
+
+        ++wakeups;
+        total += elapsed;
+        worst = std::max(worst, elapsed);
+
+        for (auto const session : pinged)
+            detector.pong_received(session);
+        pinged.clear();
+    }
+
+    printf("%6d sessions  %5.1f wakeups/period  %8.1fus CPU/period  %7.1fus worst wakeup\n",
+           session_count,
+           static_cast<double>(wakeups) / periods,
+           std::chrono::duration<double, std::micro>(total).count() / periods,
+           std::chrono::duration<double, std::micro>(worst).count());
+}
+}
+
+int main(int argc, char* argv[])
+{
+    auto const periods = argc > 1 ? atoi(argv[1]) : 100;
+
+    for (auto const session_count : {10, 100, 1000, 10000})
+        run(session_count, periods);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Connects N mirclient clients to $MIR_SOCKET and has each of them make
+ * request after request to the server. Most clients allocate small buffers;
+ * a few allocate very large ones, which is slow on the server side. Reports
+ * the round-trip latency percentiles of the small requests, to show how much
+ * the expensive requests hold everyone else up.
+ *
+ * Compare runs against a server started with different --ipc-thread-pool
+ * values.
+ *
+ * Usage: benchmark_ipc_latency [clients] [expensive-clients] [seconds]
+ */
+
+#include "mir_toolkit/mir_client_library.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+std::chrono::microseconds percentile(std::vector<std::chrono::microseconds> const& sorted, double p)
+{
+    if (sorted.empty())
+        return {};
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+}
+
+bool run_client(bool expensive, Clock::time_point end, std::vector<std::chrono::microseconds>& latencies)
+{
+    auto const connection = mir_connect_sync(nullptr, "benchmark_ipc_latency");
+    if (!mir_connection_is_valid(connection))
+    {
+        fprintf(stderr, "Failed to connect: %s\n", mir_connection_get_error_message(connection));
+        mir_connection_release(connection);
+        return false;
+    }
+
+    int const size = expensive ? 4096 : 64;
+
+    while (Clock::now() < end)
+    {
+        auto const start = Clock::now();
+        auto const buffer = mir_connection_allocate_buffer_sync(connection, size, size, mir_pixel_format_abgr_8888);
+        auto const latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+        if (!mir_buffer_is_valid(buffer))
+        {
+            fprintf(stderr, "Failed to allocate buffer: %s\n", mir_buffer_get_error_message(buffer));
+            mir_buffer_release(buffer);
+            mir_connection_release(connection);
+            return false;
+        }
+        mir_buffer_release(buffer);
+
+        if (!expensive)
+            latencies.push_back(latency);
+    }
+
+    mir_connection_release(connection);
+    return true;
+}
+}
+
+int main(int argc, char const* argv[])
+{
+    int const client_count = argc > 1 ? atoi(argv[1]) : 100;
+    int const expensive_count = argc > 2 ? atoi(argv[2]) : 4;
+    int const seconds = argc > 3 ? atoi(argv[3]) : 10;
+
+    std::mutex results_mutex;
+    std::vector<std::chrono::microseconds> latencies;
+    std::atomic<int> failures{0};
+
+    auto const end = Clock::now() + std::chrono::seconds{seconds};
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i != client_count; ++i)
+    {
+        bool const expensive = i < expensive_count;
+
+        threads.emplace_back(
+            [&, expensive]()
+            {
+                std::vector<std::chrono::microseconds> client_latencies;
+                if (!run_client(expensive, end, client_latencies))
+                {
+                    ++failures;
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock{results_mutex};
+                latencies.insert(latencies.end(), client_latencies.begin(), client_latencies.end());
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    if (failures)
+        return EXIT_FAILURE;
+
+    std::sort(latencies.begin(), latencies.end());
+
+    printf("%d clients (%d allocating 4096x4096 buffers) for %ds\n", client_count, expensive_count, seconds);
+    if (!latencies.empty())
+    {
+        printf("64x64 allocations: %zu requests, round trip (µs) p50=%lld p90=%lld p99=%lld max=%lld\n",
+               latencies.size(),
+               static_cast<long long>(percentile(latencies, 0.5).count()),
+               static_cast<long long>(percentile(latencies, 0.9).count()),
+               static_cast<long long>(percentile(latencies, 0.99).count()),
+               static_cast<long long>(latencies.back().count()));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measures how long the focused client's submit_buffer requests wait to be
+ * dispatched while many background clients flood the server with requests,
+ * with requests dispatched in the order they are read (as without a
+ * RequestScheduler) and with the RequestScheduler.
+ *
+ * Each background client always has its next request ready, as a client
+ * spamming modify_surface would. Requests take a fixed time to dispatch.
+ * Like a SocketConnection, a client's next request is only read (on an IPC
+ * thread) once the previous one has been dispatched.
+ *
+ * Usage: benchmark_request_scheduler [background clients] [IPC threads]
+ */
+
+#include "src/server/frontend/request_scheduler.h"
+#include "mir/frontend/message_processor_report.h"
+#include "mir/scene/session_event_handler_register.h"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mf = mir::frontend;
+namespace mfd = mir::frontend::detail;
+namespace ms = mir::scene;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+using namespace std::literals::chrono_literals;
+
+auto const request_time = 50us;
+auto const frame_interval = 16ms;
+int const frames{60};
+pid_t const focused_pid{1};
+
+struct NullSessionEventHandlerRegister : ms::SessionEventHandlerRegister
+{
+    void add(ms::SessionEventSink*) override {}
+    void remove(ms::SessionEventSink*) override {}
+};
+
+struct NullMessageProcessorReport : mf::MessageProcessorReport
+{
+    void received_invocation(void const*, int, std::string const&) override {}
+    void completed_invocation(void const*, int, bool) override {}
+    void unknown_method(void const*, int, std::string const&) override {}
+    void exception_handled(void const*, int, std::exception const&) override {}
+    void exception_handled(void const*, std::exception const&) override {}
+    void request_rate(int, double, std::chrono::microseconds) override {}
+};
+
+void do_request()
+{
+    auto const end = Clock::now() + request_time;
+    while (Clock::now() < end)
+        ;
+}
+
+/// Either dispatches requests as they are read, or hands them to a scheduler
+class Server
+{
+public:
+    Server(int threads, bool scheduled) :
+        work{io},
+        scheduler{scheduled ?
+            std::make_shared<mfd::RequestScheduler>(
+                threads,
+                std::make_shared<NullSessionEventHandlerRegister>(),
+                std::make_shared<NullMessageProcessorReport>()) :
+            nullptr}
+    {
+        if (scheduler)
+            scheduler->set_focused_client(focused_pid);
+
+        for (auto i = 0; i != threads; ++i)
+            ipc_threads.emplace_back([this] { io.run(); });
+    }
+
+    ~Server()
+    {
+        io.stop();
+        for (auto& thread : ipc_threads)
+            thread.join();
+    }
+
+    auto add_client(pid_t pid) -> std::unique_ptr<mfd::RequestScheduler::Client>
+    {
+        if (!scheduler)
+            return nullptr;
+
+        return scheduler->add_client(pid, [this](std::function<void()>&& work) { io.post(std::move(work)); });
+    }
+
+    /// Reads a request on an IPC thread, then dispatches or queues it
+    void receive(
+        mfd::RequestScheduler::Client* client,
+        mfd::RequestScheduler::Priority priority,
+        std::function<void()> const& request)
+    {
+        io.post([client, priority, request]
+            {
+                if (client)
+                    client->enqueue(priority, std::function<void()>{request});
+                else
+                    request();
+            });
+    }
+
+private:
+    boost::asio::io_service io;
+    boost::asio::io_service::work work;
+    std::shared_ptr<mfd::RequestScheduler> const scheduler;
+    std::vector<std::thread> ipc_threads;
+};
+
+void run(char const* name, int background_clients, int threads, bool scheduled)
+{
+    std::atomic<bool> stopping{false};
+    std::vector<std::chrono::microseconds> waits;
+    std::atomic<long> background_requests{0};
+    std::mutex mutex;
+    std::vector<std::unique_ptr<mfd::RequestScheduler::Client>> clients;
+    std::vector<std::function<void()>> next_request(background_clients);
+
+    {
+        Server server{threads, scheduled};
+
+        for (auto i = 0; i != background_clients; ++i)
+        {
+            clients.push_back(server.add_client(focused_pid + 1 + i));
+            auto const client = clients.back().get();
+
+            next_request[i] = [&, client, i]
+                {
+                    do_request();
+                    ++background_requests;
+                    if (!stopping)
+                        server.receive(client, mfd::RequestScheduler::Priority::normal, next_request[i]);
+                };
+            server.receive(client, mfd::RequestScheduler::Priority::normal, next_request[i]);
+        }
+
+        clients.push_back(server.add_client(focused_pid));
+        auto const focused = clients.back().get();
+
+        for (auto frame = 0; frame != frames; ++frame)
+        {
+            std::this_thread::sleep_for(frame_interval);
+
+            auto const sent = Clock::now();
+            server.receive(focused, mfd::RequestScheduler::Priority::latency_critical,
+                [&, sent]
+                {
+                    auto const wait = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - sent);
+                    do_request();
+                    std::lock_guard<std::mutex> lock{mutex};
+                    waits.push_back(wait);
+                });
+        }
+
+        std::this_thread::sleep_for(frame_interval);
+        stopping = true;
+        std::this_thread::sleep_for(frame_interval);
+    }
+
+    std::sort(begin(waits), end(waits));
+    auto const percentile = [&](double p) { return waits.empty() ? 0L : long(waits[(waits.size() - 1) * p].count()); };
+
+    printf("%-10s %4d background clients  %2d threads  submit_buffer waited: median %7ldus  p90 %7ldus  max %7ldus"
+           "  (%zu/%d dispatched, %ld background requests)\n",
+           name, background_clients, threads,
+           percentile(0.5), percentile(0.9), percentile(1.0),
+           waits.size(), frames, background_requests.load());
+}
+}
+
+int main(int argc, char* argv[])
+{
+    auto const background_clients = argc > 1 ? atoi(argv[1]) : 100;
+    auto const threads = argc > 2 ? atoi(argv[2]) : 1;
+
+    run("fifo", background_clients, threads, false);
+    run("scheduled", background_clients, threads, true);
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Runs an in-process server and connects N mirclient clients to it, each
+ * drawing software buffers as fast as the server lets it. Reports how long
+ * each output takes to composite a frame and how many frames the clients
+ * managed to submit.
+ *
+ * Server options are passed through, so compare e.g.
+ *
+ *   benchmark_software_renderer --offscreen --renderer=gl
+ *   benchmark_software_renderer --offscreen --renderer=software
+ *
+ * Usage: benchmark_software_renderer [server options] [--benchmark-clients N] [--benchmark-seconds S]
+ */
+
+#include "mir/server.h"
+#include "mir/fd.h"
+#include "mir/options/option.h"
+#include "mir/compositor/display_buffer_compositor.h"
+#include "mir/compositor/display_buffer_compositor_factory.h"
+
+#include "mir_toolkit/mir_client_library.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+char const* const clients_opt = "benchmark-clients";
+char const* const seconds_opt = "benchmark-seconds";
+
+struct Results
+{
+    std::mutex mutex;
+    std::vector<std::chrono::microseconds> composite_times;
+    unsigned long frames_submitted{0};
+};
+
+class TimingCompositor : public mc::DisplayBufferCompositor
+{
+public:
+    TimingCompositor(std::unique_ptr<mc::DisplayBufferCompositor> wrapped, Results& results)
+        : wrapped{std::move(wrapped)},
+          results(results)
+    {
+    }
+
+    void composite(mc::SceneElementSequence&& scene_sequence) override
+    {
+        auto const start = Clock::now();
+        wrapped->composite(std::move(scene_sequence));
+        auto const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+        std::lock_guard<std::mutex> lock{results.mutex};
+        results.composite_times.push_back(elapsed);
+    }
+
+private:
+    std::unique_ptr<mc::DisplayBufferCompositor> const wrapped;
+    Results& results;
+};
+
+class TimingCompositorFactory : public mc::DisplayBufferCompositorFactory
+{
+public:
+    TimingCompositorFactory(std::shared_ptr<mc::DisplayBufferCompositorFactory> const& wrapped, Results& results)
+        : wrapped{wrapped},
+          results(results)
+    {
+    }
+
+    std::unique_ptr<mc::DisplayBufferCompositor> create_compositor_for(mg::DisplayBuffer& display_buffer) override
+    {
+        return std::make_unique<TimingCompositor>(wrapped->create_compositor_for(display_buffer), results);
+    }
+
+private:
+    std::shared_ptr<mc::DisplayBufferCompositorFactory> const wrapped;
+    Results& results;
+};
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+bool run_client(mir::Server& server, int index, Clock::time_point end, Results& results)
+{
+    char connect_string[64] = {0};
+    sprintf(connect_string, "fd://%d", dup(server.open_client_socket()));
+
+    auto const connection = mir_connect_sync(connect_string, "benchmark_software_renderer");
+    if (!mir_connection_is_valid(connection))
+    {
+        fprintf(stderr, "Failed to connect: %s\n", mir_connection_get_error_message(connection));
+        mir_connection_release(connection);
+        return false;
+    }
+
+    auto const spec = mir_create_normal_window_spec(connection, 400, 300);
+    mir_window_spec_set_pixel_format(spec, mir_pixel_format_argb_8888);
+    mir_window_spec_set_buffer_usage(spec, mir_buffer_usage_software);
+    mir_window_spec_set_name(spec, "benchmark_software_renderer");
+    auto const window = mir_create_window_sync(spec);
+    mir_window_spec_release(spec);
+
+    if (!mir_window_is_valid(window))
+    {
+        fprintf(stderr, "Failed to create window: %s\n", mir_window_get_error_message(window));
+        mir_window_release_sync(window);
+        mir_connection_release(connection);
+        return false;
+    }
+
+    auto const stream = mir_window_get_buffer_stream(window);
+    unsigned long frames{0};
+    unsigned char shade = index * 16;
+
+    while (Clock::now() < end)
+    {
+        MirGraphicsRegion region;
+        mir_buffer_stream_get_graphics_region(stream, &region);
+        for (auto row = 0; row != region.height; ++row)
+            memset(region.vaddr + row * region.stride, shade, region.width * 4);
+        ++shade;
+
+        mir_buffer_stream_swap_buffers_sync(stream);
+        ++frames;
+    }
+
+    mir_window_release_sync(window);
+    mir_connection_release(connection);
+
+    std::lock_guard<std::mutex> lock{results.mutex};
+    results.frames_submitted += frames;
+    return true;
+}
+#pragma GCC diagnostic pop
+
+std::chrono::microseconds percentile(std::vector<std::chrono::microseconds> const& sorted, double p)
+{
+    if (sorted.empty())
+        return {};
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+}
+}
+
+int main(int argc, char const* argv[])
+{
+    mir::Server server;
+    Results results;
+    std::atomic<int> failures{0};
+    std::thread driver;
+
+    server.set_command_line(argc, argv);
+    server.add_configuration_option(clients_opt, "Number of clients drawing", 8);
+    server.add_configuration_option(seconds_opt, "Seconds to run for", 10);
+
+    server.wrap_display_buffer_compositor_factory(
+        [&results](std::shared_ptr<mc::DisplayBufferCompositorFactory> const& wrapped)
+        {
+            return std::make_shared<TimingCompositorFactory>(wrapped, results);
+        });
+
+    server.add_init_callback(
+        [&]
+        {
+            auto const options = server.get_options();
+            auto const client_count = options->get<int>(clients_opt);
+            auto const end = Clock::now() + std::chrono::seconds{options->get<int>(seconds_opt)};
+
+            driver = std::thread{
+                [&server, &results, &failures, client_count, end]
+                {
+                    std::vector<std::thread> clients;
+                    for (auto i = 0; i != client_count; ++i)
+                    {
+                        clients.emplace_back(
+                            [&server, &results, &failures, i, end]
+                            {
+                                if (!run_client(server, i, end, results))
+                                    ++failures;
+                            });
+                    }
+
+                    for (auto& client : clients)
+                        client.join();
+
+                    server.stop();
+                }};
+        });
+
+    server.run();
+
+    if (driver.joinable())
+        driver.join();
+
+    if (!server.exited_normally() || failures)
+        return EXIT_FAILURE;
+
+    auto& times = results.composite_times;
+    std::sort(times.begin(), times.end());
+
+    auto const options = server.get_options();
+    printf("%d clients for %ds\n", options->get<int>(clients_opt), options->get<int>(seconds_opt));
+    printf("Frames submitted by clients: %lu\n", results.frames_submitted);
+    if (!times.empty())
+    {
+        printf("%zu frames composited, composite time (µs) p50=%lld p90=%lld p99=%lld max=%lld\n",
+               times.size(),
+               static_cast<long long>(percentile(times, 0.5).count()),
+               static_cast<long long>(percentile(times, 0.9).count()),
+               static_cast<long long>(percentile(times, 0.99).count()),
+               static_cast<long long>(times.back().count()));
+    }
+
+    return EXIT_SUCCESS;
+}
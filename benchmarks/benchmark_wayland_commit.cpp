@@ -0,0 +1,301 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Connects N Wayland clients to $WAYLAND_DISPLAY, each committing a fresh SHM
+ * buffer at 60Hz, and reports the latency from wl_surface.commit to the
+ * frame callback. Optionally one of the clients commits a much larger buffer,
+ * to show how much a single heavy client delays everyone else.
+ *
+ * Usage: benchmark_wayland_commit [clients] [seconds] [large-client-width large-client-height]
+ */
+
+#include <wayland-client.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+auto const frame_interval = std::chrono::microseconds{1000000 / 60};
+
+struct Globals
+{
+    wl_compositor* compositor = nullptr;
+    wl_shm* shm = nullptr;
+    wl_shell* shell = nullptr;
+};
+
+void new_global(void* data, wl_registry* registry, uint32_t id, char const* interface, uint32_t)
+{
+    auto const globals = static_cast<Globals*>(data);
+
+    if (strcmp(interface, "wl_compositor") == 0)
+        globals->compositor = static_cast<wl_compositor*>(wl_registry_bind(registry, id, &wl_compositor_interface, 3));
+    else if (strcmp(interface, "wl_shm") == 0)
+        globals->shm = static_cast<wl_shm*>(wl_registry_bind(registry, id, &wl_shm_interface, 1));
+    else if (strcmp(interface, "wl_shell") == 0)
+        globals->shell = static_cast<wl_shell*>(wl_registry_bind(registry, id, &wl_shell_interface, 1));
+}
+
+void global_remove(void*, wl_registry*, uint32_t)
+{
+}
+
+wl_registry_listener const registry_listener{&new_global, &global_remove};
+
+class Client
+{
+public:
+    Client(int width, int height)
+        : width{width},
+          height{height},
+          display{wl_display_connect(nullptr)}
+    {
+        if (!display)
+            throw std::runtime_error{"Failed to connect to Wayland server"};
+
+        auto const registry = wl_display_get_registry(display);
+        wl_registry_add_listener(registry, &registry_listener, &globals);
+        wl_display_roundtrip(display);
+
+        if (!globals.compositor || !globals.shm || !globals.shell)
+            throw std::runtime_error{"Wayland server lacks wl_compositor, wl_shm or wl_shell"};
+
+        auto const stride = width * 4;
+        buffer_bytes = static_cast<size_t>(stride) * height;
+        auto const pool_bytes = buffer_bytes * buffer_count;
+
+        int const fd = open("/dev/shm", O_TMPFILE | O_RDWR | O_EXCL, S_IRWXU);
+        if (fd < 0 || posix_fallocate(fd, 0, pool_bytes) != 0)
+            throw std::system_error{errno, std::system_category(), "Failed to create SHM pool"};
+
+        pixels = static_cast<unsigned char*>(mmap(nullptr, pool_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+        if (pixels == MAP_FAILED)
+            throw std::system_error{errno, std::system_category(), "Failed to map SHM pool"};
+
+        auto const pool = wl_shm_create_pool(globals.shm, fd, pool_bytes);
+        close(fd);
+
+        for (auto i = 0; i != buffer_count; ++i)
+        {
+            buffers[i].buffer = wl_shm_pool_create_buffer(
+                pool, i * buffer_bytes, width, height, stride, WL_SHM_FORMAT_ARGB8888);
+            wl_buffer_add_listener(buffers[i].buffer, &buffer_listener, &buffers[i]);
+        }
+        wl_shm_pool_destroy(pool);
+
+        surface = wl_compositor_create_surface(globals.compositor);
+        auto const shell_surface = wl_shell_get_shell_surface(globals.shell, surface);
+        wl_shell_surface_set_toplevel(shell_surface);
+        wl_display_roundtrip(display);
+    }
+
+    ~Client()
+    {
+        wl_display_disconnect(display);
+    }
+
+    void run(Clock::time_point end)
+    {
+        auto next_frame = Clock::now();
+
+        while (Clock::now() < end)
+        {
+            if (Clock::now() >= next_frame)
+            {
+                commit_frame();
+                next_frame += frame_interval;
+            }
+
+            wl_display_flush(display);
+
+            auto const timeout = std::chrono::duration_cast<std::chrono::milliseconds>(next_frame - Clock::now());
+            pollfd pfd{wl_display_get_fd(display), POLLIN, 0};
+            if (poll(&pfd, 1, std::max(0, static_cast<int>(timeout.count()))) > 0)
+            {
+                wl_display_dispatch(display);
+            }
+            else
+            {
+                wl_display_dispatch_pending(display);
+            }
+        }
+    }
+
+    std::vector<std::chrono::microseconds> latencies;
+    unsigned int dropped_frames{0};
+
+private:
+    static int const buffer_count{3};
+
+    struct Buffer
+    {
+        wl_buffer* buffer;
+        bool busy;
+    };
+
+    struct PendingFrame
+    {
+        Client* client;
+        Clock::time_point committed;
+    };
+
+    void commit_frame()
+    {
+        auto const free_buffer = std::find_if(
+            std::begin(buffers), std::end(buffers), [](Buffer const& b) { return !b.busy; });
+
+        if (free_buffer == std::end(buffers))
+        {
+            ++dropped_frames;
+            return;
+        }
+
+        memset(pixels + (free_buffer - std::begin(buffers)) * buffer_bytes, ++shade, buffer_bytes);
+        free_buffer->busy = true;
+
+        auto const callback = wl_surface_frame(surface);
+        wl_callback_add_listener(callback, &frame_listener, new PendingFrame{this, Clock::now()});
+        wl_surface_attach(surface, free_buffer->buffer, 0, 0);
+        wl_surface_damage(surface, 0, 0, width, height);
+        wl_surface_commit(surface);
+    }
+
+    static void frame_done(void* data, wl_callback* callback, uint32_t)
+    {
+        auto const frame = static_cast<PendingFrame*>(data);
+        frame->client->latencies.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - frame->committed));
+        delete frame;
+        wl_callback_destroy(callback);
+    }
+
+    static void buffer_release(void* data, wl_buffer*)
+    {
+        static_cast<Buffer*>(data)->busy = false;
+    }
+
+    static wl_callback_listener const frame_listener;
+    static wl_buffer_listener const buffer_listener;
+
+    int const width;
+    int const height;
+    wl_display* const display;
+    Globals globals;
+    size_t buffer_bytes;
+    unsigned char* pixels;
+    Buffer buffers[buffer_count]{};
+    wl_surface* surface;
+    unsigned char shade{0};
+};
+
+wl_callback_listener const Client::frame_listener{&Client::frame_done};
+wl_buffer_listener const Client::buffer_listener{&Client::buffer_release};
+
+std::chrono::microseconds percentile(std::vector<std::chrono::microseconds> const& sorted, double p)
+{
+    if (sorted.empty())
+        return {};
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+}
+}
+
+int main(int argc, char const* argv[])
+{
+    int const client_count = argc > 1 ? atoi(argv[1]) : 40;
+    int const seconds = argc > 2 ? atoi(argv[2]) : 10;
+    int const large_width = argc > 4 ? atoi(argv[3]) : 0;
+    int const large_height = argc > 4 ? atoi(argv[4]) : 0;
+
+    std::mutex results_mutex;
+    std::vector<std::chrono::microseconds> small_latencies;
+    std::vector<std::chrono::microseconds> large_latencies;
+    unsigned int dropped_frames{0};
+    std::atomic<int> failures{0};
+
+    auto const end = Clock::now() + std::chrono::seconds{seconds};
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i != client_count; ++i)
+    {
+        bool const large = (i == 0) && large_width > 0 && large_height > 0;
+
+        threads.emplace_back(
+            [&, large]()
+            {
+                try
+                {
+                    Client client{large ? large_width : 256, large ? large_height : 256};
+                    client.run(end);
+
+                    std::lock_guard<std::mutex> lock{results_mutex};
+                    auto& results = large ? large_latencies : small_latencies;
+                    results.insert(results.end(), client.latencies.begin(), client.latencies.end());
+                    dropped_frames += client.dropped_frames;
+                }
+                catch (std::exception const& error)
+                {
+                    fprintf(stderr, "Client failed: %s\n", error.what());
+                    ++failures;
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    if (failures)
+        return EXIT_FAILURE;
+
+    auto const report = [](char const* name, std::vector<std::chrono::microseconds>& latencies)
+        {
+            if (latencies.empty())
+                return;
+
+            std::sort(latencies.begin(), latencies.end());
+            printf("%s: %zu frames, commit to frame callback (µs) p50=%lld p90=%lld p99=%lld max=%lld\n",
+                   name,
+                   latencies.size(),
+                   static_cast<long long>(percentile(latencies, 0.5).count()),
+                   static_cast<long long>(percentile(latencies, 0.9).count()),
+                   static_cast<long long>(percentile(latencies, 0.99).count()),
+                   static_cast<long long>(latencies.back().count()));
+        };
+
+    printf("%d clients committing at 60Hz for %ds\n", client_count, seconds);
+    report("256x256 clients", small_latencies);
+    report("large client", large_latencies);
+    printf("Frames skipped waiting for a buffer release: %u\n", dropped_frames);
+
+    return EXIT_SUCCESS;
+}
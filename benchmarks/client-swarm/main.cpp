@@ -0,0 +1,316 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir_client.h"
+#include "server_process.h"
+#include "wayland_client.h"
+#include "workload.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+#include <unistd.h>
+
+namespace cs = client_swarm;
+
+namespace
+{
+struct Options
+{
+    int mir_clients{10};
+    int wayland_clients{0};
+    cs::Workload workload{cs::Workload::animation};
+    int seconds{10};
+    std::string input_recording;
+    pid_t server_pid{0};
+    std::string output;
+    std::vector<std::string> server_command;
+};
+
+void usage(char const* program)
+{
+    fprintf(stderr,
+        "Usage: %s [options] [-- server command...]\n"
+        "Runs a swarm of clients against a Mir server and reports, as JSON, the server's\n"
+        "CPU and memory use and the clients' frame times and request and input latencies.\n"
+        "\n"
+        "With a server command, runs that server (e.g. \"mir_demo_server --offscreen\")\n"
+        "on private sockets; otherwise uses $MIR_SOCKET and $WAYLAND_DISPLAY.\n"
+        "\n"
+        "  --mir-clients N          mirclient clients (default 10)\n"
+        "  --wayland-clients N      Wayland clients (default 0)\n"
+        "  --workload NAME          idle, animation, resize, input or screencast (default animation)\n"
+        "  --seconds N              Length of the run, after the clients have set up (default 10)\n"
+        "  --input-recording FILE   Recording the server replays for the input workload\n"
+        "                           (see generate_input_recording.py)\n"
+        "  --server-pid PID         Server to measure, when not running one\n"
+        "  --output FILE            Write the report to FILE rather than stdout\n",
+        program);
+}
+
+bool parse_options(int argc, char* argv[], Options& options)
+{
+    enum { mir_clients, wayland_clients, workload, seconds, input_recording, server_pid, output };
+
+    option const long_options[] = {
+        {"mir-clients", required_argument, nullptr, mir_clients},
+        {"wayland-clients", required_argument, nullptr, wayland_clients},
+        {"workload", required_argument, nullptr, workload},
+        {"seconds", required_argument, nullptr, seconds},
+        {"input-recording", required_argument, nullptr, input_recording},
+        {"server-pid", required_argument, nullptr, server_pid},
+        {"output", required_argument, nullptr, output},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "", long_options, nullptr)) != -1)
+    {
+        switch (option)
+        {
+        case mir_clients: options.mir_clients = atoi(optarg); break;
+        case wayland_clients: options.wayland_clients = atoi(optarg); break;
+        case seconds: options.seconds = atoi(optarg); break;
+        case input_recording: options.input_recording = optarg; break;
+        case server_pid: options.server_pid = atoi(optarg); break;
+        case output: options.output = optarg; break;
+
+        case workload:
+            if (!cs::parse_workload(optarg, options.workload))
+            {
+                fprintf(stderr, "Unknown workload: %s\n", optarg);
+                return false;
+            }
+            break;
+
+        default:
+            return false;
+        }
+    }
+
+    options.server_command.assign(argv + optind, argv + argc);
+
+    if (options.workload == cs::Workload::input &&
+        !options.server_command.empty() &&
+        options.input_recording.empty())
+    {
+        fprintf(stderr, "The input workload needs an --input-recording for the server to replay\n");
+        return false;
+    }
+
+    return options.mir_clients >= 0 && options.wayland_clients >= 0 && options.seconds > 0;
+}
+
+void write_report(
+    std::ostream& out,
+    Options const& options,
+    int failed_clients,
+    bool have_server,
+    cs::ServerUsage const& before,
+    cs::ServerUsage const& after,
+    long peak_rss_kib,
+    cs::ClientResults const& results)
+{
+    out << "{\n"
+        << "  \"workload\": \"" << cs::name_of(options.workload) << "\",\n"
+        << "  \"mir_clients\": " << options.mir_clients << ",\n"
+        << "  \"wayland_clients\": " << options.wayland_clients << ",\n"
+        << "  \"seconds\": " << options.seconds << ",\n"
+        << "  \"failed_clients\": " << failed_clients << ",\n";
+
+    if (have_server)
+    {
+        auto const cpu_seconds = (after.cpu_time - before.cpu_time).count();
+        out << "  \"server\": {\"cpu_seconds\": " << cpu_seconds
+            << ", \"cpu_percent\": " << 100 * cpu_seconds / options.seconds
+            << ", \"rss_start_kib\": " << before.rss_kib
+            << ", \"rss_peak_kib\": " << peak_rss_kib
+            << ", \"rss_end_kib\": " << after.rss_kib << "},\n";
+    }
+
+    out << "  \"frame_time_us\": ";
+    results.frame_times.write_json(out);
+    out << ",\n  \"request_latency_us\": ";
+    results.request_latencies.write_json(out);
+    out << ",\n  \"input_latency_us\": ";
+    results.input_latencies.write_json(out);
+    out << "\n}\n";
+}
+}
+
+int main(int argc, char* argv[])
+try
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::string mir_socket;
+    std::string wayland_display;
+    std::string socket_directory;
+    std::unique_ptr<cs::ServerProcess> server;
+    auto server_pid = options.server_pid;
+
+    if (!options.server_command.empty())
+    {
+        char directory[] = "/tmp/mir-client-swarm-XXXXXX";
+        if (!mkdtemp(directory))
+            throw std::system_error{errno, std::system_category(), "Failed to create socket directory"};
+        socket_directory = directory;
+
+        mir_socket = socket_directory + "/mir_socket";
+        wayland_display = "mir-client-swarm-" + std::to_string(getpid());
+
+        cs::ServerProcess::Environment environment{
+            {"MIR_SERVER_FILE", mir_socket},
+            {"MIR_SERVER_WAYLAND_SOCKET_NAME", wayland_display}};
+        std::vector<std::string> sockets{mir_socket};
+
+        if (options.workload == cs::Workload::input)
+            environment.emplace_back("MIR_SERVER_INPUT_REPLAY", options.input_recording);
+
+        if (options.wayland_clients > 0)
+        {
+            auto const runtime_dir = getenv("XDG_RUNTIME_DIR");
+            if (!runtime_dir)
+                throw std::runtime_error{"Wayland clients need XDG_RUNTIME_DIR"};
+            sockets.push_back(std::string{runtime_dir} + "/" + wayland_display);
+        }
+
+        server = std::make_unique<cs::ServerProcess>(
+            options.server_command, environment, sockets, std::chrono::seconds{30});
+        server_pid = server->pid();
+    }
+
+    cs::StartLine start_line{options.mir_clients + options.wayland_clients};
+    std::mutex results_mutex;
+    cs::ClientResults results;
+    std::atomic<int> failures{0};
+
+    auto const run_client = [&](auto create_client)
+        {
+            bool arrived{false};
+            try
+            {
+                auto client = create_client();
+                auto const end = start_line.arrive();
+                arrived = true;
+
+                cs::ClientResults client_results;
+                client->run(end, client_results);
+
+                std::lock_guard<std::mutex> lock{results_mutex};
+                results.frame_times.add(client_results.frame_times);
+                results.request_latencies.add(client_results.request_latencies);
+                results.input_latencies.add(client_results.input_latencies);
+            }
+            catch (std::exception const& error)
+            {
+                if (!arrived)
+                    start_line.leave();
+
+                fprintf(stderr, "Client failed: %s\n", error.what());
+                ++failures;
+            }
+        };
+
+    auto const mir_socket_name = mir_socket.empty() ? nullptr : mir_socket.c_str();
+    auto const wayland_display_name = wayland_display.empty() ? nullptr : wayland_display.c_str();
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i != options.mir_clients; ++i)
+    {
+        threads.emplace_back(run_client, [&]
+            { return std::make_unique<cs::MirClient>(mir_socket_name, options.workload); });
+    }
+    for (auto i = 0; i != options.wayland_clients; ++i)
+    {
+        threads.emplace_back(run_client, [&]
+            { return std::make_unique<cs::WaylandClient>(wayland_display_name, options.workload); });
+    }
+
+    start_line.wait_for_clients();
+
+    cs::ServerUsage before{};
+    long peak_rss_kib{0};
+    if (server_pid)
+    {
+        before = cs::usage_of(server_pid);
+        peak_rss_kib = before.rss_kib;
+    }
+
+    auto const end = cs::Clock::now() + std::chrono::seconds{options.seconds};
+    start_line.start(end);
+
+    while (cs::Clock::now() < end)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        try
+        {
+            if (server_pid)
+                peak_rss_kib = std::max(peak_rss_kib, cs::usage_of(server_pid).rss_kib);
+        }
+        catch (std::exception const&)
+        {
+            // The server has gone: the clients will fail, and reading its usage after the run will report it
+        }
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    cs::ServerUsage after{};
+    if (server_pid)
+        after = cs::usage_of(server_pid);
+
+    server.reset();
+    if (!socket_directory.empty())
+    {
+        unlink(mir_socket.c_str());
+        rmdir(socket_directory.c_str());
+    }
+
+    if (options.output.empty())
+    {
+        write_report(std::cout, options, failures, server_pid != 0, before, after, peak_rss_kib, results);
+    }
+    else
+    {
+        std::ofstream out{options.output};
+        write_report(out, options, failures, server_pid != 0, before, after, peak_rss_kib, results);
+    }
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+catch (std::exception const& error)
+{
+    fprintf(stderr, "%s\n", error.what());
+    return EXIT_FAILURE;
+}
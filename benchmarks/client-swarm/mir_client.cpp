@@ -0,0 +1,239 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir_client.h"
+
+#include "mir_toolkit/mir_screencast.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace cs = client_swarm;
+
+namespace
+{
+int const width{400};
+int const height{300};
+auto const frame_interval = std::chrono::microseconds{1000000 / 60};
+
+MirPixelFormat find_8888_format(MirConnection* connection)
+{
+    MirPixelFormat formats[mir_pixel_formats];
+    unsigned int valid_formats{0};
+    mir_connection_get_available_surface_formats(connection, formats, mir_pixel_formats, &valid_formats);
+
+    for (auto i = 0u; i != valid_formats; ++i)
+    {
+        switch (formats[i])
+        {
+        case mir_pixel_format_abgr_8888:
+        case mir_pixel_format_xbgr_8888:
+        case mir_pixel_format_argb_8888:
+        case mir_pixel_format_xrgb_8888:
+            return formats[i];
+
+        default:
+            break;
+        }
+    }
+
+    throw std::runtime_error{"Server offers no 8888 pixel format"};
+}
+
+std::chrono::microseconds since(cs::Clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(cs::Clock::now() - start);
+}
+}
+
+cs::MirClient::MirClient(char const* socket, Workload workload) :
+    workload{workload},
+    connection{mir_connect_sync(socket, "mir_client_swarm")}
+{
+    try
+    {
+        if (!mir_connection_is_valid(connection))
+            throw std::runtime_error{std::string{"Failed to connect: "} + mir_connection_get_error_message(connection)};
+
+        pixel_format = find_8888_format(connection);
+
+        surface = mir_connection_create_render_surface_sync(connection, width, height);
+
+        auto const spec = mir_create_normal_window_spec(connection, width, height);
+        mir_window_spec_set_name(spec, "mir_client_swarm");
+        mir_window_spec_add_render_surface(spec, surface, width, height, 0, 0);
+        mir_window_spec_set_event_handler(spec, &handle_event, this);
+        window = mir_create_window_sync(spec);
+        mir_window_spec_release(spec);
+
+        if (!mir_window_is_valid(window))
+            throw std::runtime_error{std::string{"Failed to create window: "} + mir_window_get_error_message(window)};
+
+        stream = mir_render_surface_get_buffer_stream(surface, width, height, pixel_format);
+        draw();
+
+        if (workload == Workload::screencast)
+        {
+            MirRectangle const region{0, 0, width, height};
+            auto const screencast_spec = mir_create_screencast_spec(connection);
+            mir_screencast_spec_set_capture_region(screencast_spec, &region);
+            mir_screencast_spec_set_width(screencast_spec, width);
+            mir_screencast_spec_set_height(screencast_spec, height);
+            mir_screencast_spec_set_pixel_format(screencast_spec, pixel_format);
+            mir_screencast_spec_set_number_of_buffers(screencast_spec, 0);
+            screencast = mir_screencast_create_sync(screencast_spec);
+            mir_screencast_spec_release(screencast_spec);
+
+            if (!mir_screencast_is_valid(screencast))
+                throw std::runtime_error{
+                    std::string{"Failed to create screencast: "} + mir_screencast_get_error_message(screencast)};
+
+            capture_buffer = mir_connection_allocate_buffer_sync(connection, width, height, pixel_format);
+            if (!mir_buffer_is_valid(capture_buffer))
+                throw std::runtime_error{
+                    std::string{"Failed to allocate buffer: "} + mir_buffer_get_error_message(capture_buffer)};
+        }
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+}
+
+cs::MirClient::~MirClient()
+{
+    release();
+}
+
+void cs::MirClient::run(Clock::time_point end, ClientResults& results)
+{
+    auto next_probe = Clock::now();
+    auto last_frame = Clock::now();
+    int frame{0};
+
+    while (Clock::now() < end)
+    {
+        if (Clock::now() >= next_probe)
+        {
+            probe(results);
+            next_probe += probe_interval;
+        }
+
+        switch (workload)
+        {
+        case Workload::idle:
+        case Workload::input:
+            std::this_thread::sleep_until(std::min(next_probe, end));
+            continue;
+
+        case Workload::animation:
+            draw();
+            break;
+
+        case Workload::resize:
+            ++frame;
+            resize(width + (frame % 8) * 20, height + (frame % 8) * 15);
+            draw();
+            break;
+
+        case Workload::screencast:
+            std::this_thread::sleep_until(last_frame + frame_interval);
+            capture();
+            break;
+        }
+
+        auto const now = Clock::now();
+        results.frame_times.add(std::chrono::duration_cast<std::chrono::microseconds>(now - last_frame));
+        last_frame = now;
+    }
+
+    std::lock_guard<std::mutex> lock{input_mutex};
+    results.input_latencies.add(input_latencies);
+}
+
+void cs::MirClient::handle_event(MirWindow*, MirEvent const* event, void* context)
+{
+    if (mir_event_get_type(event) != mir_event_type_input)
+        return;
+
+    // Input event times are CLOCK_MONOTONIC, as is steady_clock
+    auto const event_time = std::chrono::nanoseconds{mir_input_event_get_event_time(mir_event_get_input_event(event))};
+    auto const latency = Clock::now().time_since_epoch() - event_time;
+
+    auto const self = static_cast<MirClient*>(context);
+    std::lock_guard<std::mutex> lock{self->input_mutex};
+    self->input_latencies.add(std::chrono::duration_cast<std::chrono::microseconds>(latency));
+}
+
+void cs::MirClient::draw()
+{
+    MirGraphicsRegion region;
+    if (!mir_buffer_stream_get_graphics_region(stream, &region))
+        throw std::runtime_error{"Failed to map buffer"};
+
+    ++shade;
+    for (auto row = 0; row != region.height; ++row)
+        memset(region.vaddr + row * region.stride, shade, region.width * 4);
+
+    mir_buffer_stream_swap_buffers_sync(stream);
+}
+
+void cs::MirClient::resize(int width, int height)
+{
+    mir_render_surface_set_size(surface, width, height);
+    mir_buffer_stream_set_size(stream, width, height);
+
+    auto const spec = mir_create_window_spec(connection);
+    mir_window_spec_set_width(spec, width);
+    mir_window_spec_set_height(spec, height);
+    mir_window_spec_add_render_surface(spec, surface, width, height, 0, 0);
+    mir_window_apply_spec(window, spec);
+    mir_window_spec_release(spec);
+}
+
+void cs::MirClient::capture()
+{
+    if (mir_screencast_capture_to_buffer_sync(screencast, capture_buffer) != mir_screencast_success)
+        throw std::runtime_error{std::string{"Screencast failed: "} + mir_screencast_get_error_message(screencast)};
+}
+
+void cs::MirClient::probe(ClientResults& results)
+{
+    auto const start = Clock::now();
+    auto const buffer = mir_connection_allocate_buffer_sync(connection, 1, 1, pixel_format);
+    results.request_latencies.add(since(start));
+
+    auto const valid = mir_buffer_is_valid(buffer);
+    mir_buffer_release(buffer);
+
+    if (!valid)
+        throw std::runtime_error{"Failed to allocate probe buffer"};
+}
+
+void cs::MirClient::release()
+{
+    if (capture_buffer)
+        mir_buffer_release(capture_buffer);
+    if (screencast)
+        mir_screencast_release_sync(screencast);
+    if (window)
+        mir_window_release_sync(window);
+    if (surface)
+        mir_render_surface_release(surface);
+    mir_connection_release(connection);
+}
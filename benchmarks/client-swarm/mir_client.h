@@ -0,0 +1,65 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLIENT_SWARM_MIR_CLIENT_H_
+#define CLIENT_SWARM_MIR_CLIENT_H_
+
+#include "workload.h"
+
+#include "mir_toolkit/mir_client_library.h"
+
+#include <mutex>
+
+namespace client_swarm
+{
+/// A mirclient client with a software rendered window, running a workload
+class MirClient
+{
+public:
+    /// \throws std::runtime_error if the client fails to connect or set up its window
+    MirClient(char const* socket, Workload workload);
+    ~MirClient();
+
+    void run(Clock::time_point end, ClientResults& results);
+
+private:
+    MirClient(MirClient const&) = delete;
+    MirClient& operator=(MirClient const&) = delete;
+
+    static void handle_event(MirWindow* window, MirEvent const* event, void* context);
+
+    void draw();
+    void resize(int width, int height);
+    void capture();
+    void probe(ClientResults& results);
+    void release();
+
+    Workload const workload;
+    MirConnection* const connection;
+    MirPixelFormat pixel_format{mir_pixel_format_invalid};
+    MirRenderSurface* surface{nullptr};
+    MirWindow* window{nullptr};
+    MirBufferStream* stream{nullptr};
+    MirScreencast* screencast{nullptr};
+    MirBuffer* capture_buffer{nullptr};
+    unsigned char shade{0};
+
+    std::mutex input_mutex;
+    Samples input_latencies;
+};
+}
+
+#endif // CLIENT_SWARM_MIR_CLIENT_H_
@@ -0,0 +1,56 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "samples.h"
+
+#include <algorithm>
+#include <numeric>
+#include <ostream>
+
+namespace cs = client_swarm;
+
+void cs::Samples::add(std::chrono::microseconds sample)
+{
+    samples.push_back(sample);
+}
+
+void cs::Samples::add(Samples const& other)
+{
+    samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+}
+
+void cs::Samples::write_json(std::ostream& out) const
+{
+    auto sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto const percentile = [&sorted](double p) -> long long
+        {
+            if (sorted.empty())
+                return 0;
+            return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))].count();
+        };
+
+    auto const total = std::accumulate(sorted.begin(), sorted.end(), std::chrono::microseconds{0});
+
+    out << "{\"count\": " << sorted.size()
+        << ", \"mean\": " << (sorted.empty() ? 0 : total.count() / static_cast<long long>(sorted.size()))
+        << ", \"p50\": " << percentile(0.5)
+        << ", \"p90\": " << percentile(0.9)
+        << ", \"p99\": " << percentile(0.99)
+        << ", \"max\": " << (sorted.empty() ? 0 : sorted.back().count())
+        << "}";
+}
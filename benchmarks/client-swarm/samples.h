@@ -0,0 +1,41 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLIENT_SWARM_SAMPLES_H_
+#define CLIENT_SWARM_SAMPLES_H_
+
+#include <chrono>
+#include <iosfwd>
+#include <vector>
+
+namespace client_swarm
+{
+/// A set of durations, reported as percentiles
+class Samples
+{
+public:
+    void add(std::chrono::microseconds sample);
+    void add(Samples const& other);
+
+    /// Writes {"count": ..., "mean": ..., "p50": ..., "p90": ..., "p99": ..., "max": ...} in µs
+    void write_json(std::ostream& out) const;
+
+private:
+    std::vector<std::chrono::microseconds> samples;
+};
+}
+
+#endif // CLIENT_SWARM_SAMPLES_H_
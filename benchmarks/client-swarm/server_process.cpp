@@ -0,0 +1,125 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server_process.h"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace cs = client_swarm;
+
+namespace
+{
+bool exists(std::string const& path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0;
+}
+}
+
+cs::ServerUsage cs::usage_of(pid_t pid)
+{
+    auto const proc = "/proc/" + std::to_string(pid);
+
+    std::ifstream stat_file{proc + "/stat"};
+    std::string stat;
+    if (!std::getline(stat_file, stat))
+        throw std::system_error{ESRCH, std::system_category(), "Failed to read " + proc + "/stat"};
+
+    // The command name (field 2) may contain spaces, so count fields after it.
+    // utime and stime are fields 14 and 15.
+    std::istringstream fields{stat.substr(stat.rfind(')') + 2)};
+    std::vector<std::string> const values{
+        std::istream_iterator<std::string>{fields}, std::istream_iterator<std::string>{}};
+    if (values.size() < 13)
+        throw std::runtime_error{"Unexpected format of " + proc + "/stat"};
+
+    auto const ticks = std::stoull(values[11]) + std::stoull(values[12]);
+
+    ServerUsage usage{std::chrono::duration<double>{static_cast<double>(ticks) / sysconf(_SC_CLK_TCK)}, 0};
+
+    std::ifstream status{proc + "/status"};
+    for (std::string line; std::getline(status, line);)
+    {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+            usage.rss_kib = std::stol(line.substr(6));
+    }
+
+    return usage;
+}
+
+cs::ServerProcess::ServerProcess(
+    std::vector<std::string> const& command,
+    Environment const& environment,
+    std::vector<std::string> const& sockets,
+    std::chrono::seconds timeout) :
+    server_pid{fork()}
+{
+    if (server_pid < 0)
+        throw std::system_error{errno, std::system_category(), "Failed to fork server"};
+
+    if (server_pid == 0)
+    {
+        for (auto const& variable : environment)
+            setenv(variable.first.c_str(), variable.second.c_str(), 1);
+
+        std::vector<char*> argv;
+        for (auto const& arg : command)
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        argv.push_back(nullptr);
+
+        execvp(argv[0], argv.data());
+        perror("Failed to run server");
+        _exit(EXIT_FAILURE);
+    }
+
+    auto const give_up = std::chrono::steady_clock::now() + timeout;
+
+    for (auto const& socket : sockets)
+    {
+        while (!exists(socket))
+        {
+            int status;
+            if (waitpid(server_pid, &status, WNOHANG) == server_pid)
+                throw std::runtime_error{"Server exited during startup"};
+
+            if (std::chrono::steady_clock::now() > give_up)
+            {
+                kill(server_pid, SIGKILL);
+                waitpid(server_pid, nullptr, 0);
+                throw std::runtime_error{"Server did not create " + socket};
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+    }
+}
+
+cs::ServerProcess::~ServerProcess()
+{
+    kill(server_pid, SIGTERM);
+    waitpid(server_pid, nullptr, 0);
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLIENT_SWARM_SERVER_PROCESS_H_
+#define CLIENT_SWARM_SERVER_PROCESS_H_
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace client_swarm
+{
+struct ServerUsage
+{
+    /// User and system CPU time used so far
+    std::chrono::duration<double> cpu_time;
+    /// Current resident set size
+    long rss_kib;
+};
+
+/// \throws std::system_error if the process has gone
+ServerUsage usage_of(pid_t pid);
+
+/// A server run for the benchmark, which is stopped when this is destroyed
+class ServerProcess
+{
+public:
+    using Environment = std::vector<std::pair<std::string, std::string>>;
+
+    /**
+     * Runs \a command with \a environment added, and waits for it to create
+     * \a sockets.
+     * \throws std::runtime_error if the server exits or doesn't create them within \a timeout
+     */
+    ServerProcess(
+        std::vector<std::string> const& command,
+        Environment const& environment,
+        std::vector<std::string> const& sockets,
+        std::chrono::seconds timeout);
+    ~ServerProcess();
+
+    pid_t pid() const { return server_pid; }
+
+private:
+    ServerProcess(ServerProcess const&) = delete;
+    ServerProcess& operator=(ServerProcess const&) = delete;
+
+    pid_t server_pid;
+};
+}
+
+#endif // CLIENT_SWARM_SERVER_PROCESS_H_
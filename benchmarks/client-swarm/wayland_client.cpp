@@ -0,0 +1,247 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wayland_client.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cs = client_swarm;
+
+namespace
+{
+int const width{400};
+int const height{300};
+
+// Room for the largest size of the resize workload
+int const max_width{width + 7 * 20};
+int const max_height{height + 7 * 15};
+}
+
+wl_registry_listener const cs::WaylandClient::registry_listener{&new_global, &global_remove};
+wl_callback_listener const cs::WaylandClient::frame_listener{&frame_done};
+wl_buffer_listener const cs::WaylandClient::buffer_listener{&buffer_release};
+
+cs::WaylandClient::WaylandClient(char const* display_name, Workload workload) :
+    workload{workload},
+    display{wl_display_connect(display_name)}
+{
+    if (!display)
+        throw std::runtime_error{"Failed to connect to Wayland server"};
+
+    try
+    {
+        auto const registry = wl_display_get_registry(display);
+        wl_registry_add_listener(registry, &registry_listener, &globals);
+        wl_display_roundtrip(display);
+
+        if (!globals.compositor || !globals.shm || !globals.shell)
+            throw std::runtime_error{"Wayland server lacks wl_compositor, wl_shm or wl_shell"};
+
+        buffer_bytes = static_cast<size_t>(max_width) * max_height * 4;
+        auto const pool_bytes = buffer_bytes * buffer_count;
+
+        int const fd = open("/dev/shm", O_TMPFILE | O_RDWR | O_EXCL, S_IRWXU);
+        if (fd < 0 || posix_fallocate(fd, 0, pool_bytes) != 0)
+            throw std::system_error{errno, std::system_category(), "Failed to create SHM pool"};
+
+        auto const mapped = mmap(nullptr, pool_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED)
+        {
+            close(fd);
+            throw std::system_error{errno, std::system_category(), "Failed to map SHM pool"};
+        }
+        pixels = static_cast<unsigned char*>(mapped);
+
+        pool = wl_shm_create_pool(globals.shm, fd, pool_bytes);
+        close(fd);
+
+        surface = wl_compositor_create_surface(globals.compositor);
+        auto const shell_surface = wl_shell_get_shell_surface(globals.shell, surface);
+        wl_shell_surface_set_toplevel(shell_surface);
+
+        commit_frame();
+        wl_display_roundtrip(display);
+    }
+    catch (...)
+    {
+        wl_display_disconnect(display);
+        if (pixels)
+            munmap(pixels, buffer_bytes * buffer_count);
+        throw;
+    }
+}
+
+cs::WaylandClient::~WaylandClient()
+{
+    wl_display_disconnect(display);
+    munmap(pixels, buffer_bytes * buffer_count);
+}
+
+void cs::WaylandClient::run(Clock::time_point end, ClientResults& results)
+{
+    this->results = &results;
+    last_frame = Clock::now();
+
+    bool const animating = workload == Workload::animation || workload == Workload::resize;
+    if (animating && !frame_pending)
+        commit_frame();
+
+    auto next_probe = Clock::now();
+
+    while (Clock::now() < end)
+    {
+        if (Clock::now() >= next_probe)
+        {
+            probe(results);
+            next_probe += probe_interval;
+        }
+
+        if (wl_display_flush(display) < 0 && errno != EAGAIN)
+            throw std::system_error{errno, std::system_category(), "Lost connection to Wayland server"};
+
+        auto const timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::min(next_probe, end) - Clock::now());
+
+        pollfd pfd{wl_display_get_fd(display), POLLIN, 0};
+        if (poll(&pfd, 1, std::max(0, static_cast<int>(timeout.count()))) > 0)
+        {
+            if (wl_display_dispatch(display) < 0)
+                throw std::system_error{errno, std::system_category(), "Lost connection to Wayland server"};
+        }
+        else
+        {
+            wl_display_dispatch_pending(display);
+        }
+    }
+
+    this->results = nullptr;
+}
+
+bool cs::WaylandClient::commit_frame()
+{
+    auto const free_buffer = std::find_if(
+        std::begin(buffers), std::end(buffers), [](Buffer const& b) { return !b.busy; });
+
+    if (free_buffer == std::end(buffers))
+    {
+        waiting_for_buffer = true;
+        return false;
+    }
+
+    auto frame_width = width;
+    auto frame_height = height;
+    if (workload == Workload::resize)
+    {
+        ++frame;
+        frame_width += (frame % 8) * 20;
+        frame_height += (frame % 8) * 15;
+    }
+
+    auto const index = free_buffer - std::begin(buffers);
+    if (!free_buffer->buffer || free_buffer->width != frame_width || free_buffer->height != frame_height)
+    {
+        if (free_buffer->buffer)
+            wl_buffer_destroy(free_buffer->buffer);
+
+        free_buffer->buffer = wl_shm_pool_create_buffer(
+            pool, index * buffer_bytes, frame_width, frame_height, frame_width * 4, WL_SHM_FORMAT_ARGB8888);
+        free_buffer->width = frame_width;
+        free_buffer->height = frame_height;
+        wl_buffer_add_listener(free_buffer->buffer, &buffer_listener, this);
+    }
+
+    memset(pixels + index * buffer_bytes, ++shade, static_cast<size_t>(frame_width) * frame_height * 4);
+    free_buffer->busy = true;
+
+    auto const callback = wl_surface_frame(surface);
+    wl_callback_add_listener(callback, &frame_listener, this);
+    wl_surface_attach(surface, free_buffer->buffer, 0, 0);
+    wl_surface_damage(surface, 0, 0, frame_width, frame_height);
+    wl_surface_commit(surface);
+
+    frame_pending = true;
+    waiting_for_buffer = false;
+    return true;
+}
+
+void cs::WaylandClient::probe(ClientResults& results)
+{
+    auto const start = Clock::now();
+    if (wl_display_roundtrip(display) < 0)
+        throw std::system_error{errno, std::system_category(), "Lost connection to Wayland server"};
+
+    results.request_latencies.add(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start));
+}
+
+void cs::WaylandClient::new_global(
+    void* data, wl_registry* registry, uint32_t id, char const* interface, uint32_t)
+{
+    auto const globals = static_cast<Globals*>(data);
+
+    if (strcmp(interface, "wl_compositor") == 0)
+        globals->compositor = static_cast<wl_compositor*>(wl_registry_bind(registry, id, &wl_compositor_interface, 3));
+    else if (strcmp(interface, "wl_shm") == 0)
+        globals->shm = static_cast<wl_shm*>(wl_registry_bind(registry, id, &wl_shm_interface, 1));
+    else if (strcmp(interface, "wl_shell") == 0)
+        globals->shell = static_cast<wl_shell*>(wl_registry_bind(registry, id, &wl_shell_interface, 1));
+}
+
+void cs::WaylandClient::global_remove(void*, wl_registry*, uint32_t)
+{
+}
+
+void cs::WaylandClient::frame_done(void* data, wl_callback* callback, uint32_t)
+{
+    wl_callback_destroy(callback);
+
+    auto const self = static_cast<WaylandClient*>(data);
+    self->frame_pending = false;
+
+    // Only frames shown during the run count
+    if (!self->results)
+        return;
+
+    auto const now = Clock::now();
+    self->results->frame_times.add(std::chrono::duration_cast<std::chrono::microseconds>(now - self->last_frame));
+    self->last_frame = now;
+
+    if (self->workload == Workload::animation || self->workload == Workload::resize)
+        self->commit_frame();
+}
+
+void cs::WaylandClient::buffer_release(void* data, wl_buffer* buffer)
+{
+    auto const self = static_cast<WaylandClient*>(data);
+
+    for (auto& b : self->buffers)
+    {
+        if (b.buffer == buffer)
+            b.busy = false;
+    }
+
+    if (self->waiting_for_buffer)
+        self->commit_frame();
+}
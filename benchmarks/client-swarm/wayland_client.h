@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLIENT_SWARM_WAYLAND_CLIENT_H_
+#define CLIENT_SWARM_WAYLAND_CLIENT_H_
+
+#include "workload.h"
+
+#include <wayland-client.h>
+
+namespace client_swarm
+{
+/**
+ * A Wayland client with a wl_shm window, running a workload.
+ *
+ * The input and screencast workloads have no Wayland equivalent here, so
+ * they show a single frame, as idle.
+ */
+class WaylandClient
+{
+public:
+    /// \throws std::runtime_error if the client fails to connect or set up its window
+    WaylandClient(char const* display_name, Workload workload);
+    ~WaylandClient();
+
+    void run(Clock::time_point end, ClientResults& results);
+
+private:
+    WaylandClient(WaylandClient const&) = delete;
+    WaylandClient& operator=(WaylandClient const&) = delete;
+
+    static int const buffer_count{3};
+
+    struct Buffer
+    {
+        wl_buffer* buffer;
+        int width;
+        int height;
+        bool busy;
+    };
+
+    struct Globals
+    {
+        wl_compositor* compositor{nullptr};
+        wl_shm* shm{nullptr};
+        wl_shell* shell{nullptr};
+    };
+
+    bool commit_frame();
+    void probe(ClientResults& results);
+
+    static void new_global(void* data, wl_registry* registry, uint32_t id, char const* interface, uint32_t version);
+    static void global_remove(void* data, wl_registry* registry, uint32_t id);
+    static void frame_done(void* data, wl_callback* callback, uint32_t time);
+    static void buffer_release(void* data, wl_buffer* buffer);
+
+    static wl_registry_listener const registry_listener;
+    static wl_callback_listener const frame_listener;
+    static wl_buffer_listener const buffer_listener;
+
+    Workload const workload;
+    wl_display* const display;
+    Globals globals;
+    wl_shm_pool* pool{nullptr};
+    unsigned char* pixels{nullptr};
+    size_t buffer_bytes{0};
+    Buffer buffers[buffer_count]{};
+    wl_surface* surface{nullptr};
+    unsigned char shade{0};
+    int frame{0};
+
+    ClientResults* results{nullptr};
+    Clock::time_point last_frame;
+    bool frame_pending{false};
+    bool waiting_for_buffer{false};
+};
+}
+
+#endif // CLIENT_SWARM_WAYLAND_CLIENT_H_
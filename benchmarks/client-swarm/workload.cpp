@@ -0,0 +1,57 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "workload.h"
+
+namespace cs = client_swarm;
+
+namespace
+{
+cs::Workload const workloads[] = {
+    cs::Workload::idle,
+    cs::Workload::animation,
+    cs::Workload::resize,
+    cs::Workload::input,
+    cs::Workload::screencast
+};
+}
+
+bool cs::parse_workload(std::string const& name, Workload& workload)
+{
+    for (auto const candidate : workloads)
+    {
+        if (name == name_of(candidate))
+        {
+            workload = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+char const* cs::name_of(Workload workload)
+{
+    switch (workload)
+    {
+    case Workload::idle: return "idle";
+    case Workload::animation: return "animation";
+    case Workload::resize: return "resize";
+    case Workload::input: return "input";
+    case Workload::screencast: return "screencast";
+    }
+
+    return "";
+}
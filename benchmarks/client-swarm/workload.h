@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLIENT_SWARM_WORKLOAD_H_
+#define CLIENT_SWARM_WORKLOAD_H_
+
+#include "samples.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+namespace client_swarm
+{
+using Clock = std::chrono::steady_clock;
+
+enum class Workload
+{
+    idle,       // A window showing a single frame
+    animation,  // A window redrawing a software buffer every frame
+    resize,     // As animation, but with a different window size every frame
+    input,      // A window waiting for input (from a server replaying an input recording)
+    screencast  // A window showing a single frame and a screencast capturing at 60Hz
+};
+
+bool parse_workload(std::string const& name, Workload& workload);
+char const* name_of(Workload workload);
+
+/// Each client makes a trivial request this often, to measure how responsive the server is
+auto const probe_interval = std::chrono::milliseconds{100};
+
+/// What a client measured while running its workload
+struct ClientResults
+{
+    /// Intervals between the frames a client showed (or screencast captures)
+    Samples frame_times;
+    /// Round trips of the probe requests
+    Samples request_latencies;
+    /// From input events' timestamps to the client receiving them
+    Samples input_latencies;
+};
+
+/// Holds the clients back until all have set up, so that the run doesn't measure setup
+class StartLine
+{
+public:
+    explicit StartLine(int clients) : waiting_for{clients} {}
+
+    /// Called by a client once set up. Returns the end of the run once it has started
+    Clock::time_point arrive()
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        --waiting_for;
+        changed.notify_all();
+        changed.wait(lock, [this] { return started; });
+        return end;
+    }
+
+    /// Called instead of arrive() by a client that failed to set up
+    void leave()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        --waiting_for;
+        changed.notify_all();
+    }
+
+    void wait_for_clients()
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        changed.wait(lock, [this] { return waiting_for == 0; });
+    }
+
+    void start(Clock::time_point end)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        this->end = end;
+        started = true;
+        changed.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    int waiting_for;
+    bool started{false};
+    Clock::time_point end;
+};
+}
+
+#endif // CLIENT_SWARM_WORKLOAD_H_
@@ -25,7 +25,7 @@ FrameUniformityTest::FrameUniformityTest(FrameUniformityTestParameters const& pa
           parameters.touch_end,
           parameters.touch_duration,
           client_ready_fence),
-      client(client_ready_fence, parameters.touch_duration)
+      client(client_ready_fence, parameters.touch_duration, parameters.resample_input)
 {
 }
 
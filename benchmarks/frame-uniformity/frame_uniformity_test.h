@@ -39,6 +39,8 @@ struct FrameUniformityTestParameters
     mir::geometry::Point touch_end;
 
     std::chrono::milliseconds touch_duration;
+
+    bool resample_input;
 };
 
 class FrameUniformityTest : public mir_test_framework::ServerRunner
@@ -105,11 +105,7 @@ Results compute_frame_uniformity(std::vector<TouchSamples::Sample> const& result
     return {average_pixel_offset, uniformity};
 }
 
-}
-
-// Main is inside a test to work around mir_test_framework 'issues' (e.g. mir_test_framework contains
-// a main function).
-TEST(FrameUniformity, average_frame_offset)
+Results run_frame_uniformity_test(bool resample_input)
 {
     geom::Size const screen_size{1024, 1024};
     geom::Point const touch_start_point{0, 0};
@@ -126,7 +122,7 @@ TEST(FrameUniformity, average_frame_offset)
     
     for (int i = 0; i < run_count; i++)
     {
-        FrameUniformityTest t({screen_size, touch_start_point, touch_end_point, touch_duration});
+        FrameUniformityTest t({screen_size, touch_start_point, touch_end_point, touch_duration, resample_input});
 
         t.run_test();
   
@@ -145,7 +141,27 @@ TEST(FrameUniformity, average_frame_offset)
     average_lag /= run_count;
     average_uniformity /= run_count;
     
+    std::cout << (resample_input ? "With input resampled to frame time:" : "With raw input:") << std::endl;
     std::cout << "Average pixel lag: " << average_lag << "px" << std::endl;
     std::cout << "Frame Uniformity (smaller scores are more uniform): " << average_uniformity << "px per sample\n"
         << std::endl;
+
+    return {average_lag, average_uniformity};
+}
+
+}
+
+// Main is inside a test to work around mir_test_framework 'issues' (e.g. mir_test_framework contains
+// a main function).
+TEST(FrameUniformity, average_frame_offset)
+{
+    run_frame_uniformity_test(false);
+}
+
+TEST(FrameUniformity, average_frame_offset_with_resampled_input)
+{
+    auto const raw = run_frame_uniformity_test(false);
+    auto const resampled = run_frame_uniformity_test(true);
+
+    EXPECT_LT(resampled.frame_uniformity, raw.frame_uniformity);
 }
@@ -31,7 +31,7 @@ namespace
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-MirWindow *create_window(MirConnection *connection)
+MirWindow *create_window(MirConnection *connection, bool resample_input)
 {
     MirPixelFormat pixel_format;
     unsigned int valid_formats;
@@ -41,6 +41,7 @@ MirWindow *create_window(MirConnection *connection)
     mir_window_spec_set_pixel_format(spec, pixel_format);
     mir_window_spec_set_name(spec, "frame-uniformity-test");
     mir_window_spec_set_buffer_usage(spec, mir_buffer_usage_hardware);
+    mir_window_spec_set_input_resampling(spec, resample_input);
 
     auto window = mir_create_window_sync(spec);
     mir_window_spec_release(spec);
@@ -80,9 +81,11 @@ void collect_input_and_frame_timing(MirWindow *surface, mt::Barrier& client_read
 }
 
 TouchMeasuringClient::TouchMeasuringClient(mt::Barrier& client_ready,
-    std::chrono::high_resolution_clock::duration const& touch_duration)
+    std::chrono::high_resolution_clock::duration const& touch_duration,
+    bool resample_input)
     : client_ready(client_ready),
       touch_duration(touch_duration),
+      resample_input(resample_input),
       results_(std::make_shared<TouchSamples>())
 {
 }
@@ -109,7 +112,7 @@ void TouchMeasuringClient::run(std::string const& connect_string)
      */
     mir_connection_set_lifecycle_event_callback(connection, null_lifecycle_callback, nullptr);
     
-    auto window = create_window(connection);
+    auto window = create_window(connection, resample_input);
 
     collect_input_and_frame_timing(window, client_ready, touch_duration, results_);
     
@@ -30,7 +30,8 @@ class TouchMeasuringClient
 {
 public:
     TouchMeasuringClient(mir::test::Barrier& client_ready,
-        std::chrono::high_resolution_clock::duration const& touch_duration);
+        std::chrono::high_resolution_clock::duration const& touch_duration,
+        bool resample_input);
     
     void run(std::string const& connect_string);
     
@@ -40,6 +41,7 @@ private:
     mir::test::Barrier& client_ready;
     
     std::chrono::high_resolution_clock::duration const touch_duration;
+    bool const resample_input;
     
     std::shared_ptr<TouchSamples> results_;
 };
@@ -0,0 +1,60 @@
+#!/usr/bin/python3
+
+# Writes a synthetic input recording for the input-replay platform, e.g.
+#   generate_input_recording.py --pointers 4 --touchscreens 4 --rate 1000 > load.recording
+#   mir_demo_server --input-replay load.recording
+# See src/include/platform/mir/input/input_recording.h for the format.
+
+import argparse
+import math
+import sys
+
+POINTER = 1 << 1
+TOUCHSCREEN = (1 << 4) | (1 << 8)
+
+MOTION = 4
+TOUCH_DOWN = 1
+TOUCH_CHANGE = 2
+TOUCH_UP = 0
+FINGER = 1
+
+def write_recording(out, pointers, touchscreens, rate, seconds):
+    out.write("mir-input-recording 1\n")
+
+    devices = [(POINTER, "pointer")] * pointers + [(TOUCHSCREEN, "touchscreen")] * touchscreens
+    for number, (capabilities, kind) in enumerate(devices):
+        out.write('0 add {0} {1} "replay-{0}" "Replayed {2} {0}"\n'.format(number, capabilities, kind))
+
+    period = 10**9 // rate
+    samples = rate * seconds
+
+    for sample in range(samples):
+        time = (sample + 1) * period
+        angle = 2 * math.pi * sample / rate
+        for number, (capabilities, kind) in enumerate(devices):
+            if capabilities == POINTER:
+                out.write("{} pointer {} {} 0 0 0 {:.3f} {:.3f}\n".format(
+                    time, number, MOTION, 2 * math.cos(angle), 2 * math.sin(angle)))
+            else:
+                if sample == 0:
+                    action = TOUCH_DOWN
+                elif sample == samples - 1:
+                    action = TOUCH_UP
+                else:
+                    action = TOUCH_CHANGE
+                out.write("{} touch {} 1 0 {} {} {:.3f} {:.3f} 1 8 8 0\n".format(
+                    time, number, action, FINGER,
+                    400 + 200 * math.cos(angle), 300 + 200 * math.sin(angle)))
+
+    for number in range(len(devices)):
+        out.write("{} remove {}\n".format((samples + 1) * period, number))
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Generate an input recording for benchmarking input load")
+    parser.add_argument("--pointers", type=int, default=4)
+    parser.add_argument("--touchscreens", type=int, default=4)
+    parser.add_argument("--rate", type=int, default=1000, help="events per second per device")
+    parser.add_argument("--seconds", type=int, default=10)
+    args = parser.parse_args()
+
+    write_recording(sys.stdout, args.pointers, args.touchscreens, args.rate, args.seconds)
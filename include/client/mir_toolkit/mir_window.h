@@ -481,6 +481,25 @@ void mir_window_spec_set_event_handler(MirWindowSpec* spec,
                                        MirWindowEventCallback callback,
                                        void* context);
 
+/**
+ * Ask for pointer and touch motion to be delivered in step with the frames
+ * of the window's output, rather than as each event arrives.
+ *
+ * The motion of each device is collected and delivered once per frame, at
+ * the frame deadline, as a single event resampled to where the pointer or
+ * touches are estimated to be when the frame is shown. Other events are
+ * delivered as they arrive, after any motion that came before them.
+ *
+ * The raw events a resampled event replaces can be got with
+ * mir_window_get_raw_motion_event() while handling it.
+ *
+ * Only takes effect when creating a window.
+ *
+ * \param [in] spec      The spec to accumulate the request in.
+ * \param [in] resample  Whether to resample motion (the default is not to)
+ */
+void mir_window_spec_set_input_resampling(MirWindowSpec* spec, bool resample);
+
 /**
  * Ask the shell to customize "chrome" for this window.
  * For example, on the phone hide indicators when this window is active.
@@ -681,6 +700,28 @@ void mir_window_set_event_handler(MirWindow* window,
                                   MirWindowEventCallback callback,
                                   void* context);
 
+/**
+ * The number of raw events the resampled motion event being handled
+ * replaces (see mir_window_spec_set_input_resampling()).
+ *   \warning Only valid from within the window's event handler, while it
+ *            handles the resampled event. Returns 0 for other events.
+ *   \param [in] window   The window
+ *   \return              The number of raw motion events
+ */
+size_t mir_window_get_raw_motion_count(MirWindow const* window);
+
+/**
+ * Get one of the raw events the resampled motion event being handled
+ * replaces, oldest first.
+ *   \warning Only valid from within the window's event handler, and the
+ *            event returned only until the handler returns.
+ *   \param [in] window   The window
+ *   \param [in] index    The index of the event, less than
+ *                        mir_window_get_raw_motion_count()
+ *   \return              The raw motion event
+ */
+MirEvent const* mir_window_get_raw_motion_event(MirWindow const* window, size_t index);
+
 /**
  * Retrieve the primary MirBufferStream associated with a window (to advance buffers,
  * obtain EGLNativeWindow, etc...)
@@ -26,6 +26,9 @@ namespace mir
 namespace events
 {
 
+/// The number of touch contacts the server tracks per device; further contacts are dropped
+unsigned int const max_contacts{16};
+
 struct ContactState
 {
     MirTouchId touch_id;
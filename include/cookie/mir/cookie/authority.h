@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "mir/cookie/cookie.h"
+#include "mir/cookie/format.h"
 
 namespace mir
 {
@@ -69,6 +70,17 @@ public:
     */
     static std::unique_ptr<Authority> create_from(Secret const& secret);
 
+    /**
+    *   As create_from(secret), but making cookies of the given format.
+    *
+    *   An Authority only accepts cookies of the format it makes.
+    *
+    *   \param [in] secret  A secret used to set the key for the hash function
+    *   \param [in] format  The MAC to sign new cookies with
+    *   \return             An Authority
+    */
+    static std::unique_ptr<Authority> create_from(Secret const& secret, Format format);
+
     /**
     *   Construction function used to create an Authority as well as a secret.
     *
@@ -84,6 +96,14 @@ public:
     */
     static std::unique_ptr<Authority> create();
 
+    /**
+    *   As create(), but making cookies of the given format.
+    *
+    *   \param [in] format  The MAC to sign new cookies with
+    *   \return             An Authority
+    */
+    static std::unique_ptr<Authority> create(Format format);
+
     Authority(Authority const& authority) = delete;
     Authority& operator=(Authority const& authority) = delete;
     virtual ~Authority() noexcept = default;
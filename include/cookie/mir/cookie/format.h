@@ -25,9 +25,13 @@ namespace mir
 {
 namespace cookie
 {
+/**
+ * The MAC used to sign cookies; serialized as the first byte of a cookie.
+ */
 enum class Format : uint8_t
 {
-    hmac_sha_256,
+    hmac_sha_256,   ///< HMAC-SHA256: 41 byte cookies
+    siphash_2_4,    ///< SipHash-2-4: 17 byte cookies, much cheaper to make per input event
 };
 }
 }
@@ -23,6 +23,9 @@
 #include "mir/geometry/size.h"
 #include "mir/geometry/displacement.h"
 
+#include <chrono>
+#include <cstddef>
+
 namespace mir
 {
 namespace graphics
@@ -46,6 +49,18 @@ protected:
     CursorImage(CursorImage const&) = delete;
     CursorImage& operator=(CursorImage const&) = delete;
 };
+
+// A cursor image that cycles through a sequence of frames. As a CursorImage it
+// is the first frame.
+class AnimatedCursorImage : public CursorImage
+{
+public:
+    virtual size_t frames() const = 0;
+    virtual CursorImage const& frame(size_t index) const = 0;
+
+    // How long frame \a index is shown before moving on to the next
+    virtual std::chrono::milliseconds frame_delay(size_t index) const = 0;
+};
 }
 }
 
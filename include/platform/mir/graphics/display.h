@@ -23,6 +23,7 @@
 #include <memory>
 #include <functional>
 #include <chrono>
+#include <vector>
 
 namespace mir
 {
@@ -132,6 +133,34 @@ public:
      */
     virtual void configure(DisplayConfiguration const& conf) = 0;
 
+    /**
+     * Sets a new output configuration, keeping the DisplaySyncGroups whose
+     * outputs it leaves unchanged.
+     *
+     * \p retiring is called with each DisplaySyncGroup that is to be removed
+     * or replaced, before anything is done to it. References to the other
+     * DisplaySyncGroups and their DisplayBuffers remain valid, and they may
+     * carry on being rendered and posted while the configuration is applied.
+     *
+     * The default implementation retires every DisplaySyncGroup and calls
+     * configure().
+     *
+     * \param conf     [in] Configuration to apply.
+     * \param retiring [in] Called for each DisplaySyncGroup before it is invalidated.
+     */
+    virtual void configure_keeping_unchanged_groups(
+        DisplayConfiguration const& conf,
+        std::function<void(DisplaySyncGroup&)> const& retiring)
+    {
+        std::vector<DisplaySyncGroup*> groups;
+        for_each_display_sync_group([&groups](DisplaySyncGroup& group) { groups.push_back(&group); });
+
+        for (auto const group : groups)
+            retiring(*group);
+
+        configure(conf);
+    }
+
     /**
      * Registers a handler for display configuration changes.
      *
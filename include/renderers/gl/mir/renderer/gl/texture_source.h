@@ -49,6 +49,24 @@ protected:
     TextureSource& operator=(TextureSource const&) = delete;
 };
 
+//Implemented by buffers whose pixels are uploaded from CPU memory. A texture cache
+//that knows the bound texture already holds storage for this buffer's size and
+//format can then update it in place instead of reallocating it every frame.
+class TextureUpdateSource
+{
+public:
+    virtual ~TextureUpdateSource() = default;
+
+    //Uploads into the existing storage of the bound texture, which must have
+    //been filled by bind() from a buffer of the same size and pixel format.
+    virtual void update_bound_texture() = 0;
+
+protected:
+    TextureUpdateSource() = default;
+    TextureUpdateSource(TextureUpdateSource const&) = delete;
+    TextureUpdateSource& operator=(TextureUpdateSource const&) = delete;
+};
+
 }
 }
 }
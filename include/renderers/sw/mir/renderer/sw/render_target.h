@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_SW_RENDER_TARGET_H_
+#define MIR_RENDERER_SW_RENDER_TARGET_H_
+
+#include "mir/geometry/size.h"
+#include "mir/geometry/dimensions.h"
+#include "mir_toolkit/common.h"
+
+namespace mir
+{
+namespace renderer
+{
+namespace software
+{
+
+/**
+ * A display buffer the CPU can draw into directly.
+ *
+ * This is the software counterpart of renderer::gl::RenderTarget; display
+ * buffers that implement it can be used with the software renderer.
+ */
+class RenderTarget
+{
+public:
+    struct Mapping
+    {
+        unsigned char* pixels;
+        geometry::Stride stride;
+        /**
+         * How many frames ago the mapped buffer was last drawn into, with the
+         * same meaning as EGL_EXT_buffer_age: 1 means it holds the previous
+         * frame, 0 that its contents are undefined.
+         */
+        unsigned int age;
+    };
+
+    virtual ~RenderTarget() = default;
+
+    /** The size of the buffer in pixels, before any output transformation. */
+    virtual geometry::Size size() const = 0;
+    /** The pixel format of the buffer. Only 32-bit RGB formats are supported. */
+    virtual MirPixelFormat pixel_format() const = 0;
+
+    /** Maps the buffer to draw the next frame into. */
+    virtual Mapping map_back_buffer() = 0;
+    /**
+     * Finishes drawing into the mapped buffer.
+     * The mapping returned by map_back_buffer() is invalid after this returns.
+     */
+    virtual void swap_buffers() = 0;
+
+protected:
+    RenderTarget() = default;
+    RenderTarget(RenderTarget const&) = delete;
+    RenderTarget& operator=(RenderTarget const&) = delete;
+};
+
+}
+}
+}
+
+#endif /* MIR_RENDERER_SW_RENDER_TARGET_H_ */
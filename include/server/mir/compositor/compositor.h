@@ -19,8 +19,12 @@
 #ifndef MIR_COMPOSITOR_COMPOSITOR_H_
 #define MIR_COMPOSITOR_COMPOSITOR_H_
 
+#include <functional>
+
 namespace mir
 {
+namespace graphics { class DisplaySyncGroup; }
+
 namespace compositor
 {
 
@@ -32,6 +36,37 @@ public:
     virtual void start() = 0;
     virtual void stop() = 0;
 
+    /**
+     * Makes a change to the display that may remove or replace some of its
+     * DisplaySyncGroups.
+     *
+     * \p change is passed a function that it must call with each
+     * DisplaySyncGroup before invalidating it (as
+     * graphics::Display::configure_keeping_unchanged_groups() does); only
+     * compositing to those groups is stopped. Compositing to any groups the
+     * display has gained starts when \p change returns.
+     *
+     * The default implementation stops all compositing for the duration of
+     * \p change.
+     */
+    virtual void reconfigure(
+        std::function<void(std::function<void(graphics::DisplaySyncGroup&)> const& retiring)> const& change)
+    {
+        stop();
+
+        try
+        {
+            change([](graphics::DisplaySyncGroup&) {});
+        }
+        catch (...)
+        {
+            start();
+            throw;
+        }
+
+        start();
+    }
+
 protected:
     Compositor() = default;
     Compositor(Compositor const&) = delete;
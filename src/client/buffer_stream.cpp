@@ -149,8 +149,10 @@ struct BufferDepository
         std::shared_ptr<mcl::ServerBufferRequests> const& requests,
         std::weak_ptr<mcl::SurfaceMap> const& surface_map,
         geom::Size size, MirPixelFormat format, int usage,
-        unsigned int initial_nbuffers) :
-        vault(factory, mirbuffer_factory, requests, surface_map, size, format, usage, initial_nbuffers),
+        unsigned int initial_nbuffers,
+        unsigned int preallocated_nbuffers) :
+        vault(factory, mirbuffer_factory, requests, surface_map, size, format, usage,
+              initial_nbuffers, preallocated_nbuffers),
         current(nullptr),
         size_(size)
     {
@@ -237,6 +239,11 @@ struct BufferDepository
         vault.set_interval(interval);
     }
 
+    void set_adaptive(bool adaptive)
+    {
+        vault.set_adaptive(adaptive);
+    }
+
     // Future must be before vault, to ensure vault's destruction marks future
     // as ready.
     mir::client::NoTLSFuture<std::shared_ptr<mcl::MirBuffer>> future;
@@ -315,7 +322,7 @@ mcl::BufferStream::BufferStream(
             std::make_shared<Requests>(server, protobuf_bs->id().value(), client_platform),
             map,
             ideal_buffer_size, static_cast<MirPixelFormat>(protobuf_bs->pixel_format()), 
-            protobuf_bs->buffer_usage(), nbuffers);
+            protobuf_bs->buffer_usage(), nbuffers, protobuf_bs->preallocated_buffers());
 
         egl_native_window_ = client_platform->create_egl_native_window(this);
 
@@ -385,7 +392,11 @@ MirWaitHandle* mcl::BufferStream::swap_buffers(std::function<void()> const& done
 
     if (!using_client_side_vsync &&
         current_swap_interval != interval_config.swap_interval())
+    {
+        // Server-side throttling needs the queue, not a spare buffer
+        buffer_depository->set_adaptive(false);
         set_server_swap_interval(current_swap_interval);
+    }
 
     secured_region.reset();
 
@@ -516,9 +527,17 @@ void mcl::BufferStream::swap_buffers_sync()
      * proven this is a real problem so we must be sure to put the server in
      * interval 0 when using client-side vsync. This guarantees that random
      * scheduling imperfections won't create queuing lag.
+     *
+     * Only the server is switched to interval 0 here. The buffers keep
+     * following the client's own interval: zero gets mailbox behaviour with
+     * a spare buffer, while non-zero intervals stay double buffered unless
+     * we are seen to block waiting for the server to return one.
      */
     if (interval_config.swap_interval() != 0)
-        set_server_swap_interval(0);
+    {
+        buffer_depository->set_adaptive(true);
+        interval_config.set_swap_interval(0);
+    }
 
     swap_buffers([](){})->wait_for_all();
 
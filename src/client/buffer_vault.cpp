@@ -53,6 +53,9 @@ void incoming_buffer(MirBuffer* buffer, void* context)
     auto vault = static_cast<mcl::BufferVault*>(context);
     vault->wire_transfer_inbound(reinterpret_cast<mcl::Buffer*>(buffer)->rpc_id());
 }
+
+// About two seconds at 60Hz of never needing the extra buffer
+unsigned int const adaptive_shrink_threshold{120};
 }
 
 mcl::BufferVault::BufferVault(
@@ -60,7 +63,8 @@ mcl::BufferVault::BufferVault(
     std::shared_ptr<AsyncBufferFactory> const& buffer_factory,
     std::shared_ptr<ServerBufferRequests> const& server_requests,
     std::weak_ptr<SurfaceMap> const& surface_map,
-    geom::Size size, MirPixelFormat format, int usage, unsigned int initial_nbuffers) :
+    geom::Size size, MirPixelFormat format, int usage, unsigned int initial_nbuffers,
+    unsigned int preallocated_nbuffers) :
     platform_factory(platform_factory),
     buffer_factory(buffer_factory),
     server_requests(server_requests),
@@ -73,8 +77,14 @@ mcl::BufferVault::BufferVault(
     needed_buffer_count(initial_nbuffers),
     initial_buffer_count(initial_nbuffers)
 {
+    // The server may already be sending buffers allocated along with the stream
     for (auto i = 0u; i < initial_buffer_count; i++)
-        alloc_buffer(size, format, usage);
+    {
+        if (i < preallocated_nbuffers)
+            expect_buffer(size, format, usage);
+        else
+            alloc_buffer(size, format, usage);
+    }
 }
 
 mcl::BufferVault::~BufferVault()
@@ -140,13 +150,18 @@ mcl::BufferVault::~BufferVault()
     }
 }
 
-void mcl::BufferVault::alloc_buffer(geom::Size size, MirPixelFormat format, int usage)
+void mcl::BufferVault::expect_buffer(geom::Size size, MirPixelFormat format, int usage)
 {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
     buffer_factory->expect_buffer(platform_factory, nullptr, size, format, static_cast<MirBufferUsage>(usage),
         incoming_buffer, this);
 #pragma GCC diagnostic pop
+}
+
+void mcl::BufferVault::alloc_buffer(geom::Size size, MirPixelFormat format, int usage)
+{
+    expect_buffer(size, format, usage);
     server_requests->allocate_buffer(size, format, usage);
 }
 
@@ -222,12 +237,23 @@ mcl::NoTLSFuture<std::shared_ptr<mcl::MirBuffer>> mcl::BufferVault::withdraw()
     {
         it->second = Owner::ContentProducer;
         promise.set_value(checked_buffer_from_map(it->first));
+        if (adaptive)
+            note_unblocked_withdraw(free_ids);
         lk.unlock();
     }
     else
     {
         promises.emplace_back(std::move(promise));
 
+        // Only count it as blocking on the server if no allocations are in flight
+        if (adaptive && interval != 0 &&
+            needed_buffer_count == initial_buffer_count &&
+            buffers.size() >= current_buffer_count)
+        {
+            needed_buffer_count++;
+        }
+        withdrawals_with_spare_buffer = 0;
+
         auto s = size;
         bool allocate_buffer = (current_buffer_count <  needed_buffer_count);
         if (allocate_buffer)
@@ -385,6 +411,9 @@ void mcl::BufferVault::set_interval(int i)
 
     if (i == 0)
     {
+        // An adaptive vault may already have grown the extra buffer
+        if (needed_buffer_count > initial_buffer_count)
+            return;
         current_buffer_count++;
         needed_buffer_count++;
         lk.unlock();
@@ -392,19 +421,63 @@ void mcl::BufferVault::set_interval(int i)
     }
     else
     {
-        needed_buffer_count = initial_buffer_count;
-        while (current_buffer_count > needed_buffer_count)
-        {
-            auto it = std::find_if(buffers.begin(), buffers.end(),
-                [](auto const& entry) { return entry.second == Owner::Self; });
-            if (it == buffers.end())
-                break;
-            current_buffer_count--;
-            int id = it->first;
-            buffers.erase(it);
-            lk.unlock();
-            free_buffer(id);
-            lk.lock();
-        }
+        shrink_to_initial_count(lk);
+    }
+}
+
+void mcl::BufferVault::set_adaptive(bool a)
+{
+    std::unique_lock<std::mutex> lk(mutex);
+
+    if (a == adaptive)
+        return;
+    adaptive = a;
+    withdrawals_with_spare_buffer = 0;
+
+    if (!adaptive && interval != 0)
+        shrink_to_initial_count(lk);
+}
+
+void mcl::BufferVault::shrink_to_initial_count(std::unique_lock<std::mutex>& lk)
+{
+    needed_buffer_count = initial_buffer_count;
+    while (current_buffer_count > needed_buffer_count)
+    {
+        auto it = std::find_if(buffers.begin(), buffers.end(),
+            [](auto const& entry) { return entry.second == Owner::Self; });
+        if (it == buffers.end())
+            break;
+        current_buffer_count--;
+        int id = it->first;
+        buffers.erase(it);
+        lk.unlock();
+        free_buffer(id);
+        lk.lock();
+    }
+}
+
+void mcl::BufferVault::note_unblocked_withdraw(std::vector<int>& free_ids)
+{
+    if (interval == 0 || needed_buffer_count == initial_buffer_count)
+        return;
+
+    auto spare = available_buffer();
+    if (spare == buffers.end())
+    {
+        withdrawals_with_spare_buffer = 0;
+        return;
+    }
+
+    if (++withdrawals_with_spare_buffer < adaptive_shrink_threshold)
+        return;
+
+    // Any buffer still with the server is released when it is returned
+    withdrawals_with_spare_buffer = 0;
+    needed_buffer_count = initial_buffer_count;
+    if (current_buffer_count > needed_buffer_count)
+    {
+        current_buffer_count--;
+        free_ids.push_back(spare->first);
+        buffers.erase(spare);
     }
 }
@@ -27,6 +27,7 @@
 #include "no_tls_future-inl.h"
 #include <deque>
 #include <map>
+#include <vector>
 
 namespace mir
 {
@@ -62,7 +63,8 @@ public:
         std::shared_ptr<ServerBufferRequests> const&,
         std::weak_ptr<SurfaceMap> const&,
         geometry::Size size, MirPixelFormat format, int usage,
-        unsigned int initial_nbuffers);
+        unsigned int initial_nbuffers,
+        unsigned int preallocated_nbuffers = 0);
     ~BufferVault();
 
     NoTLSFuture<std::shared_ptr<MirBuffer>> withdraw();
@@ -75,17 +77,28 @@ public:
     void set_scale(float scale);
     void set_interval(int);
 
+    /*
+     * In adaptive mode a non-zero interval starts with the initial buffer
+     * count, grows by one buffer when withdraw() is observed to block on the
+     * server, and shrinks back once the extra buffer has been spare for a
+     * while. An interval of zero ("mailbox") always keeps the extra buffer.
+     */
+    void set_adaptive(bool);
+
 private:
     enum class Owner;
     typedef std::map<int, Owner> BufferMap;
     BufferMap::iterator available_buffer();
     void trigger_callback(std::unique_lock<std::mutex> lk);
 
+    void expect_buffer(geometry::Size size, MirPixelFormat format, int usage);
     void alloc_buffer(geometry::Size size, MirPixelFormat format, int usage);
     void free_buffer(int free_id);
     void realloc_buffer(int free_id, geometry::Size size, MirPixelFormat format, int usage);
     std::shared_ptr<MirBuffer> checked_buffer_from_map(int id);
     void set_size(std::unique_lock<std::mutex> const& lk, geometry::Size new_size);
+    void shrink_to_initial_count(std::unique_lock<std::mutex>& lk);
+    void note_unblocked_withdraw(std::vector<int>& free_ids);
 
 
     std::shared_ptr<ClientBufferFactory> const platform_factory;
@@ -106,6 +119,8 @@ private:
     size_t const initial_buffer_count;
     int last_received_id = 0;
     int interval = 1;
+    bool adaptive = false;
+    unsigned int withdrawals_with_spare_buffer = 0;
     MirWaitHandle swap_buffers_wait_handle;
     std::function<void()> deferred_cb;
 };
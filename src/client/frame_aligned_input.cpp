@@ -0,0 +1,135 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_aligned_input.h"
+#include "frame_clock.h"
+
+namespace mcl = mir::client;
+
+namespace
+{
+// Deliver motion this long before the frame deadline, so that a client
+// woken for the same frame (e.g. by swap buffers) sees it first
+std::chrono::nanoseconds const delivery_lead = std::chrono::milliseconds{1};
+}
+
+mcl::FrameAlignedInput::State::State(std::shared_ptr<FrameClock> const& frame_clock, Deliver const& deliver) :
+    frame_clock{frame_clock},
+    deliver{deliver}
+{
+}
+
+bool mcl::FrameAlignedInput::State::stopped()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return stopping;
+}
+
+mcl::FrameAlignedInput::FrameAlignedInput(std::shared_ptr<FrameClock> const& frame_clock, Deliver const& deliver) :
+    state{std::make_shared<State>(frame_clock, deliver)},
+    thread{[state = state] { deliver_motion(state); }}
+{
+}
+
+mcl::FrameAlignedInput::~FrameAlignedInput()
+{
+    {
+        std::lock_guard<std::mutex> lock{state->mutex};
+        state->stopping = true;
+    }
+    state->motion_pending.notify_all();
+
+    if (thread.get_id() == std::this_thread::get_id())
+        thread.detach();
+    else
+        thread.join();
+}
+
+void mcl::FrameAlignedInput::handle(MirEvent const& event)
+{
+    // Delivering may destroy us
+    auto const state = this->state;
+
+    std::lock_guard<std::mutex> delivering{state->delivery_mutex};
+    std::unique_lock<std::mutex> lock{state->mutex};
+
+    if (state->resampler.add(event))
+    {
+        lock.unlock();
+        state->motion_pending.notify_all();
+        return;
+    }
+
+    auto const motion = state->resampler.flush();
+    lock.unlock();
+
+    for (auto const& m : motion)
+    {
+        state->deliver(m.event, m.raw);
+        if (state->stopped())
+            return;
+    }
+
+    state->deliver(event, {});
+}
+
+void mcl::FrameAlignedInput::deliver_motion(std::shared_ptr<State> const& state)
+{
+    std::unique_lock<std::mutex> lock{state->mutex};
+    time::PosixTimestamp last_deadline;
+
+    while (!state->stopping)
+    {
+        state->motion_pending.wait(lock, [&] { return state->stopping || !state->resampler.empty(); });
+
+        // Unthrottled windows (with no refresh rate) get their motion right away
+        auto const now = time::PosixTimestamp::now(CLOCK_MONOTONIC);
+        auto deadline = state->frame_clock->next_frame_after(now);
+        auto const throttled = deadline > now;
+
+        if (throttled && deadline <= last_deadline)
+            deadline = state->frame_clock->next_frame_after(last_deadline);
+
+        auto const wait = throttled ? deadline - now - delivery_lead : std::chrono::nanoseconds{0};
+        if (state->motion_pending.wait_for(lock, wait, [&] { return state->stopping; }))
+            break;
+
+        last_deadline = deadline;
+
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> delivering{state->delivery_mutex};
+
+            std::vector<MotionResampler::Motion> motion;
+            {
+                std::lock_guard<std::mutex> collecting{state->mutex};
+                if (state->stopping)
+                    break;
+
+                motion = throttled ? state->resampler.resample(deadline.nanoseconds) : state->resampler.flush();
+            }
+
+            for (auto const& m : motion)
+            {
+                if (state->stopped())
+                    break;
+
+                state->deliver(m.event, m.raw);
+            }
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_CLIENT_FRAME_ALIGNED_INPUT_H_
+#define MIR_CLIENT_FRAME_ALIGNED_INPUT_H_
+
+#include "motion_resampler.h"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mir
+{
+namespace client
+{
+class FrameClock;
+
+/**
+ * Delivers a window's motion events once per frame, resampled to the
+ * frame's deadline, from a thread of its own. Other events are delivered
+ * straight away, after any motion that came before them.
+ *
+ * It may be destroyed from the Deliver callback; nothing more is delivered
+ * once it has been.
+ */
+class FrameAlignedInput
+{
+public:
+    /// raw is empty unless event is resampled motion
+    using Deliver = std::function<void(MirEvent const& event, std::vector<MirEvent> const& raw)>;
+
+    FrameAlignedInput(std::shared_ptr<FrameClock> const& frame_clock, Deliver const& deliver);
+    ~FrameAlignedInput();
+
+    void handle(MirEvent const& event);
+
+private:
+    // Shared with the delivery thread, which outlives us if we are destroyed from it
+    struct State
+    {
+        State(std::shared_ptr<FrameClock> const& frame_clock, Deliver const& deliver);
+
+        std::shared_ptr<FrameClock> const frame_clock;
+        Deliver const deliver;
+
+        std::mutex delivery_mutex;  // Held while delivering, to keep events in order
+        std::mutex mutex;
+        std::condition_variable motion_pending;
+        MotionResampler resampler;
+        bool stopping{false};
+
+        bool stopped();
+    };
+
+    static void deliver_motion(std::shared_ptr<State> const& state);
+
+    std::shared_ptr<State> const state;
+    std::thread thread;
+};
+}
+}
+
+#endif /* MIR_CLIENT_FRAME_ALIGNED_INPUT_H_ */
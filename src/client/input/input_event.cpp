@@ -352,7 +352,8 @@ void mir_cookie_to_buffer(MirCookie const* cookie, void* buffer, size_t size) MI
 
 MirCookie const* mir_cookie_from_buffer(void const* buffer, size_t size) MIR_HANDLE_EVENT_EXCEPTION(
 {
-    if (size != mir::cookie::default_blob_size)
+    if (size != mir::cookie::default_blob_size &&
+        size != mir::cookie::siphash_2_4_blob_size)
         return NULL;
 
     return new MirCookie(buffer, size);
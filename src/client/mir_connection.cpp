@@ -108,6 +108,38 @@ size_t get_nbuffers_from_env()
     return 3u;
 }
 
+/*
+ * Asks the server to allocate the default stream's buffers along with the
+ * surface, rather than mcl::BufferStream asking for them once it exists
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+void request_initial_buffers(mp::SurfaceParameters& message, mcl::ClientPlatform& platform, size_t nbuffers)
+{
+    auto const format = static_cast<MirPixelFormat>(message.pixel_format());
+    auto const usage = static_cast<MirBufferUsage>(message.buffer_usage());
+    geom::Size const size{message.width(), message.height()};
+
+    for (auto i = 0u; i != nbuffers; ++i)
+    {
+        auto const buf_params = message.add_initial_buffer();
+        buf_params->set_width(size.width.as_int());
+        buf_params->set_height(size.height.as_int());
+
+        if (usage == mir_buffer_usage_hardware)
+        {
+            buf_params->set_native_format(platform.native_format_for(format));
+            buf_params->set_flags(platform.native_flags_for(usage, size));
+        }
+        else
+        {
+            buf_params->set_pixel_format(format);
+            buf_params->set_buffer_usage(usage);
+        }
+    }
+}
+#pragma GCC diagnostic pop
+
 struct OnScopeExit
 {
     ~OnScopeExit() { f(); }
@@ -372,7 +404,9 @@ MirWaitHandle* MirConnection::create_surface(
     auto response = std::make_shared<mp::Surface>();
     auto c = std::make_shared<MirConnection::SurfaceCreationRequest>(callback, context, spec);
     c->wh->expect_result();
-    auto const message = serialize_spec(spec);
+    auto message = serialize_spec(spec);
+    if (!spec.streams.is_set())
+        request_initial_buffers(message, *platform, nbuffers);
     {
         std::lock_guard<decltype(mutex)> lock(mutex);
         surface_requests.emplace_back(c);
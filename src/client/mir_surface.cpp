@@ -22,6 +22,7 @@
 #include "make_protobuf_object.h"
 #include "mir_protobuf.pb.h"
 #include "connection_surface_map.h"
+#include "frame_aligned_input.h"
 
 #include "mir_toolkit/mir_client_library.h"
 #include "mir_toolkit/mir_blob.h"
@@ -39,6 +40,8 @@
 #include <unistd.h>
 
 #include <boost/exception/diagnostic_information.hpp>
+#include <boost/throw_exception.hpp>
+#include <stdexcept>
 
 namespace geom = mir::geometry;
 namespace mcl = mir::client;
@@ -56,6 +59,25 @@ namespace
 std::mutex handle_mutex;
 std::unordered_set<MirWindow*> valid_surfaces;
 
+// The raw events behind the resampled motion event being handled on this thread
+thread_local MirSurface const* raw_motion_window{nullptr};
+thread_local std::vector<MirEvent> const* raw_motion{nullptr};
+
+struct RawMotionBeingHandled
+{
+    RawMotionBeingHandled(MirSurface const* window, std::vector<MirEvent> const& raw)
+    {
+        raw_motion_window = window;
+        raw_motion = &raw;
+    }
+
+    ~RawMotionBeingHandled()
+    {
+        raw_motion_window = nullptr;
+        raw_motion = nullptr;
+    }
+};
+
 void apply_device_state(MirEvent const& event, mi::KeyMapper& keymapper)
 {
     auto device_state = mir_event_get_input_device_state_event(&event);
@@ -194,6 +216,16 @@ MirSurface::MirSurface(
             spec.event_handler.value().context);
     }
 
+    if (spec.input_resampling.is_set() && spec.input_resampling.value())
+    {
+        frame_aligned_input = std::make_unique<mcl::FrameAlignedInput>(
+            frame_clock,
+            [this](MirEvent const& event, std::vector<MirEvent> const& raw_motion)
+            {
+                deliver_aligned(event, raw_motion);
+            });
+    }
+
     std::lock_guard<decltype(handle_mutex)> lock(handle_mutex);
     valid_surfaces.insert(this);
 
@@ -202,6 +234,9 @@ MirSurface::MirSurface(
 
 MirSurface::~MirSurface()
 {
+    // Stop delivering resampled motion before anything it uses goes away
+    frame_aligned_input.reset();
+
     StreamSet old_streams;
 
     {
@@ -558,7 +593,12 @@ void MirSurface::handle_event(MirEvent& e)
         break;
     };
 
-    if (handle_event_callback)
+    if (frame_aligned_input)
+    {
+        lock.unlock();
+        frame_aligned_input->handle(e);
+    }
+    else if (handle_event_callback)
     {
         auto callback = handle_event_callback;
         lock.unlock();
@@ -566,6 +606,33 @@ void MirSurface::handle_event(MirEvent& e)
     }
 }
 
+void MirSurface::deliver_aligned(MirEvent const& event, std::vector<MirEvent> const& raw)
+{
+    std::unique_lock<decltype(mutex)> lock(mutex);
+
+    if (handle_event_callback)
+    {
+        auto callback = handle_event_callback;
+        lock.unlock();
+
+        RawMotionBeingHandled const handling{this, raw};
+        callback(&event);
+    }
+}
+
+size_t MirSurface::raw_motion_count() const
+{
+    return raw_motion_window == this ? raw_motion->size() : 0;
+}
+
+MirEvent const* MirSurface::raw_motion_event(size_t index) const
+{
+    if (index >= raw_motion_count())
+        BOOST_THROW_EXCEPTION(std::out_of_range("Raw motion event index out of range"));
+
+    return &(*raw_motion)[index];
+}
+
 void MirSurface::request_and_wait_for_configure(MirWindowAttrib a, int value)
 {
     configure(a, value)->wait_for_all();
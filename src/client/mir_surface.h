@@ -39,9 +39,14 @@
 #include <functional>
 #include <mutex>
 #include <unordered_set>
+#include <vector>
 
 namespace mir
 {
+namespace client
+{
+class FrameAlignedInput;
+}
 namespace dispatch
 {
 class ThreadedDispatcher;
@@ -149,6 +154,7 @@ struct MirSurfaceSpec
         void* context;
     };
     mir::optional_value<EventHandler> event_handler;
+    mir::optional_value<bool> input_resampling;
     mir::optional_value<MirShellChrome> shell_chrome;
     
     mir::optional_value<std::string> cursor_name;
@@ -211,6 +217,10 @@ public:
                            void* context);
     void handle_event(MirEvent& e);
 
+    /// The raw events behind the resampled motion event being handled on this thread
+    size_t raw_motion_count() const;
+    MirEvent const* raw_motion_event(size_t index) const;
+
     void request_and_wait_for_configure(MirWindowAttrib a, int value);
 
     MirBufferStream* get_buffer_stream();
@@ -272,6 +282,10 @@ private:
 
     std::shared_ptr<mir::dispatch::ThreadedDispatcher> input_thread;
 
+    // Only set on creation, so may be used without holding the mutex
+    std::unique_ptr<mir::client::FrameAlignedInput> frame_aligned_input;
+    void deliver_aligned(MirEvent const& event, std::vector<MirEvent> const& raw_motion);
+
     //a bit batty, but the creation handle has to exist for as long as the MirSurface does,
     //as we don't really manage the lifetime of MirWaitHandle sensibly.
     std::shared_ptr<MirWaitHandle> const creation_handle;
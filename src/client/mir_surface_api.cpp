@@ -426,6 +426,17 @@ catch (std::exception const& ex)
     MIR_LOG_UNCAUGHT_EXCEPTION(ex);
 }
 
+void mir_window_spec_set_input_resampling(MirWindowSpec* spec, bool resample)
+try
+{
+    mir::require(spec);
+    spec->input_resampling = resample;
+}
+catch (std::exception const& ex)
+{
+    MIR_LOG_UNCAUGHT_EXCEPTION(ex);
+}
+
 void mir_window_spec_set_shell_chrome(MirWindowSpec* spec, MirShellChrome style)
 try
 {
@@ -674,6 +685,30 @@ void mir_window_set_event_handler(MirWindow* window,
     window->set_event_handler(callback, context);
 }
 
+size_t mir_window_get_raw_motion_count(MirWindow const* window)
+try
+{
+    mir::require(window);
+    return window->raw_motion_count();
+}
+catch (std::exception const& ex)
+{
+    MIR_LOG_UNCAUGHT_EXCEPTION(ex);
+    return 0;
+}
+
+MirEvent const* mir_window_get_raw_motion_event(MirWindow const* window, size_t index)
+try
+{
+    mir::require(window);
+    return window->raw_motion_event(index);
+}
+catch (std::exception const& ex)
+{
+    MIR_LOG_UNCAUGHT_EXCEPTION(ex);
+    return nullptr;
+}
+
 MirBufferStream *mir_window_get_buffer_stream(MirWindow* window)
 try
 {
@@ -0,0 +1,269 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "motion_resampler.h"
+
+#include <algorithm>
+
+namespace mcl = mir::client;
+
+using namespace std::chrono;
+
+namespace
+{
+// Resample to this long before the frame, to usually have a later sample
+nanoseconds const resample_latency = milliseconds{5};
+
+// Samples closer together than this are too noisy to extrapolate from
+nanoseconds const min_sample_delta = milliseconds{2};
+
+// Samples further apart than this no longer describe the same motion
+nanoseconds const max_sample_delta = milliseconds{20};
+
+nanoseconds const max_prediction = milliseconds{8};
+
+bool is_motion(MirInputEvent const& event)
+{
+    switch (event.input_type())
+    {
+    case mir_input_event_type_pointer:
+        return event.to_pointer()->action() == mir_pointer_action_motion;
+
+    case mir_input_event_type_touch:
+    {
+        auto const touch = event.to_touch();
+        for (size_t i = 0; i != touch->pointer_count(); ++i)
+        {
+            if (touch->action(i) != mir_touch_action_change)
+                return false;
+        }
+        return touch->pointer_count() > 0;
+    }
+
+    default:
+        return false;
+    }
+}
+}
+
+bool mcl::MotionResampler::add(MirEvent const& event)
+{
+    if (event.type() != mir_event_type_input)
+        return false;
+
+    auto const input = event.to_input();
+    auto& device = device_for(*input);
+
+    if (!is_motion(*input))
+    {
+        // Whatever follows (a button press, a touch going up) is a new gesture
+        device.history.clear();
+        return false;
+    }
+
+    Sample sample{input->event_time(), {}};
+    if (input->input_type() == mir_input_event_type_pointer)
+    {
+        auto const pointer = input->to_pointer();
+        sample.positions.push_back({-1, pointer->x(), pointer->y()});
+    }
+    else
+    {
+        auto const touch = input->to_touch();
+        for (size_t i = 0; i != touch->pointer_count(); ++i)
+            sample.positions.push_back({touch->id(i), touch->x(i), touch->y(i)});
+    }
+
+    auto const same_contacts = [&](Sample const& other)
+        {
+            return std::equal(
+                begin(sample.positions), end(sample.positions),
+                begin(other.positions), end(other.positions),
+                [](Position const& lhs, Position const& rhs) { return lhs.id == rhs.id; });
+        };
+
+    if (!device.history.empty() &&
+        (!same_contacts(device.history.back()) || device.history.back().time > sample.time))
+    {
+        device.history.clear();
+    }
+
+    device.history.push_back(sample);
+    device.batch.push_back(event);
+    device.latest_arrival = arrivals++;
+
+    return true;
+}
+
+bool mcl::MotionResampler::empty() const
+{
+    return std::all_of(begin(devices), end(devices), [](Device const& device) { return device.batch.empty(); });
+}
+
+auto mcl::MotionResampler::resample(nanoseconds frame_time) -> std::vector<Motion>
+{
+    return take(&frame_time);
+}
+
+auto mcl::MotionResampler::flush() -> std::vector<Motion>
+{
+    return take(nullptr);
+}
+
+size_t mcl::MotionResampler::samples_kept() const
+{
+    size_t samples{0};
+    for (auto const& device : devices)
+        samples += device.history.size();
+    return samples;
+}
+
+auto mcl::MotionResampler::device_for(MirInputEvent const& event) -> Device&
+{
+    auto const id = event.device_id();
+    auto const type = event.input_type();
+
+    auto const existing = std::find_if(begin(devices), end(devices),
+        [&](Device const& device) { return device.id == id && device.type == type; });
+
+    if (existing != end(devices))
+        return *existing;
+
+    devices.push_back(Device{id, type, {}, {}, 0});
+    return devices.back();
+}
+
+auto mcl::MotionResampler::take(nanoseconds const* frame_time) -> std::vector<Motion>
+{
+    std::vector<Device*> pending;
+    for (auto& device : devices)
+    {
+        if (!device.batch.empty())
+            pending.push_back(&device);
+    }
+
+    std::sort(begin(pending), end(pending),
+        [](Device const* lhs, Device const* rhs) { return lhs->latest_arrival < rhs->latest_arrival; });
+
+    std::vector<Motion> result;
+    for (auto const device : pending)
+    {
+        Motion motion{device->batch.back(), std::move(device->batch)};
+        device->batch.clear();
+
+        auto const input = motion.event.to_input();
+
+        // Relative motion and scrolling are summed rather than resampled, so none is lost
+        if (device->type == mir_input_event_type_pointer && motion.raw.size() > 1)
+        {
+            float dx{0}, dy{0}, hscroll{0}, vscroll{0};
+            for (auto const& raw : motion.raw)
+            {
+                auto const pointer = raw.to_input()->to_pointer();
+                dx += pointer->dx();
+                dy += pointer->dy();
+                hscroll += pointer->hscroll();
+                vscroll += pointer->vscroll();
+            }
+
+            auto const pointer = input->to_pointer();
+            pointer->set_dx(dx);
+            pointer->set_dy(dy);
+            pointer->set_hscroll(hscroll);
+            pointer->set_vscroll(vscroll);
+        }
+
+        auto& history = device->history;
+        if (!frame_time || history.size() < 2)
+        {
+            // Only the latest two samples matter to the next frame
+            if (history.size() > 2)
+                history.erase(begin(history), end(history) - 2);
+
+            result.push_back(std::move(motion));
+            continue;
+        }
+
+        auto const target = *frame_time - resample_latency;
+        auto const after = std::find_if(begin(history), end(history),
+            [&](Sample const& sample) { return sample.time > target; });
+
+        Sample const* a{nullptr};
+        Sample const* b{nullptr};
+        auto sample_time = target;
+
+        if (after == end(history))
+        {
+            // Extrapolate from the latest two samples, a short way only
+            a = &history[history.size() - 2];
+            b = &history.back();
+            auto const delta = b->time - a->time;
+
+            if (delta < min_sample_delta || delta > max_sample_delta)
+                a = b = nullptr;
+            else
+                sample_time = std::min(target, b->time + std::min(delta / 2, max_prediction));
+        }
+        else if (after != begin(history))
+        {
+            // Interpolate between the samples either side of the target
+            a = &*(after - 1);
+            b = &*after;
+
+            if (b->time - a->time > max_sample_delta)
+                a = b = nullptr;
+        }
+
+        if (a && b && b->time > a->time)
+        {
+            auto const alpha = float(duration<double>(sample_time - a->time).count() /
+                                     duration<double>(b->time - a->time).count());
+
+            auto const resampled = [&](size_t i, float Position::* axis)
+                {
+                    return a->positions[i].*axis + alpha * (b->positions[i].*axis - a->positions[i].*axis);
+                };
+
+            if (device->type == mir_input_event_type_pointer)
+            {
+                auto const pointer = input->to_pointer();
+                pointer->set_x(resampled(0, &Position::x));
+                pointer->set_y(resampled(0, &Position::y));
+            }
+            else
+            {
+                auto const touch = input->to_touch();
+                for (size_t i = 0; i != touch->pointer_count() && i != a->positions.size(); ++i)
+                {
+                    touch->set_x(i, resampled(i, &Position::x));
+                    touch->set_y(i, resampled(i, &Position::y));
+                }
+            }
+
+            input->set_event_time(sample_time);
+
+            // Keep what the next frame may interpolate from
+            history.erase(begin(history), begin(history) + (a - &history[0]));
+        }
+
+        if (history.size() > 2 && history[history.size() - 2].time <= target)
+            history.erase(begin(history), end(history) - 2);
+
+        result.push_back(std::move(motion));
+    }
+
+    return result;
+}
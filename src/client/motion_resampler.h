@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_CLIENT_MOTION_RESAMPLER_H_
+#define MIR_CLIENT_MOTION_RESAMPLER_H_
+
+#include "mir/events/event_private.h"
+
+#include <chrono>
+#include <vector>
+
+namespace mir
+{
+namespace client
+{
+/**
+ * Collects pointer and touch motion so that all the motion of a frame can
+ * be delivered as one event per device, resampled to where the pointer or
+ * touches are estimated to be when the frame is shown.
+ *
+ * As in Android's InputConsumer, motion is resampled to a little before the
+ * frame time, so that there are usually samples either side to interpolate
+ * between, and is only extrapolated a short way past the last sample.
+ */
+class MotionResampler
+{
+public:
+    struct Motion
+    {
+        MirEvent event;
+        std::vector<MirEvent> raw;  ///< The events it replaces, oldest first
+    };
+
+    /// Keeps the event if it is motion, otherwise returns false
+    bool add(MirEvent const& event);
+
+    bool empty() const;
+
+    /// The motion collected, resampled for a frame shown at frame_time
+    std::vector<Motion> resample(std::chrono::nanoseconds frame_time);
+
+    /// The motion collected, without resampling it
+    std::vector<Motion> flush();
+
+    /// The samples kept to resample later frames from, over all devices
+    size_t samples_kept() const;
+
+private:
+    struct Position
+    {
+        int id;
+        float x, y;
+    };
+
+    struct Sample
+    {
+        std::chrono::nanoseconds time;
+        std::vector<Position> positions;
+    };
+
+    struct Device
+    {
+        MirInputDeviceId id;
+        MirInputEventType type;
+        std::vector<MirEvent> batch;
+        std::vector<Sample> history;    ///< Includes samples of earlier frames
+        unsigned long latest_arrival;
+    };
+
+    std::vector<Motion> take(std::chrono::nanoseconds const* frame_time);
+    Device& device_for(MirInputEvent const& event);
+
+    std::vector<Device> devices;
+    unsigned long arrivals{0};
+};
+}
+}
+
+#endif /* MIR_CLIENT_MOTION_RESAMPLER_H_ */
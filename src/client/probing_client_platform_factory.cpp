@@ -1,14 +1,58 @@
 #include "probing_client_platform_factory.h"
 #include "mir/client/client_platform.h"
+#include "mir/client/client_context.h"
 #include "mir/shared_library.h"
 #include "mir/shared_library_prober.h"
 #include "mir/shared_library_prober_report.h"
 
 #include <boost/exception/all.hpp>
+#include <boost/filesystem.hpp>
+#include <mutex>
 #include <stdexcept>
+#include <unordered_map>
+
+#include <dlfcn.h>
 
 namespace mcl = mir::client;
 
+namespace
+{
+// The client module chosen for each server graphics module. This is shared by
+// every connection the process makes, so only the first needs to probe.
+std::mutex selected_modules_mutex;
+std::unordered_map<std::string, std::string> selected_modules;
+
+std::string server_module_key(mcl::ClientContext* context)
+{
+    MirModuleProperties server_module;
+    context->populate_graphics_module(server_module);
+
+    return std::string{server_module.name ? server_module.name : ""} +
+        "/" + std::to_string(server_module.major_version);
+}
+
+std::string selected_module_for(std::string const& server_module)
+{
+    std::lock_guard<std::mutex> lock{selected_modules_mutex};
+    auto const i = selected_modules.find(server_module);
+    return i != selected_modules.end() ? i->second : std::string{};
+}
+
+void select_module_for(std::string const& server_module, std::string const& filename)
+{
+    std::lock_guard<std::mutex> lock{selected_modules_mutex};
+    selected_modules[server_module] = filename;
+}
+
+std::string filename_of(void* symbol)
+{
+    Dl_info info;
+    if (dladdr(symbol, &info) && info.dli_fname)
+        return info.dli_fname;
+    return {};
+}
+}
+
 mcl::ProbingClientPlatformFactory::ProbingClientPlatformFactory(
     std::shared_ptr<mir::SharedLibraryProberReport> const& rep,
     StringList const& force_libs,
@@ -32,8 +76,10 @@ mcl::ProbingClientPlatformFactory::create_client_platform(mcl::ClientContext* co
     // Note we don't want to keep unused platform modules loaded any longer
     // than it takes to choose the right one. So this list is local:
     std::vector<std::shared_ptr<mir::SharedLibrary>> platform_modules;
+    std::string selected_file;
 
-    auto const module_selector = [context, &platform_modules](std::shared_ptr<mir::SharedLibrary> const& module)
+    auto const module_selector =
+        [context, &platform_modules, &selected_file](std::shared_ptr<mir::SharedLibrary> const& module)
     {
         try
         {
@@ -41,6 +87,7 @@ mcl::ProbingClientPlatformFactory::create_client_platform(mcl::ClientContext* co
             if (probe(context))
             {
                 platform_modules.push_back(module);
+                selected_file = filename_of(reinterpret_cast<void*>(probe));
                 return Selection::quit;
             }
         }
@@ -52,20 +99,44 @@ mcl::ProbingClientPlatformFactory::create_client_platform(mcl::ClientContext* co
         return Selection::persist;
     };
 
-    if (!platform_overrides.empty())
+    // Try the module that suited this server's platform before. It still gets
+    // probed, but nothing else needs to be opened.
+    auto const server_module = server_module_key(context);
+    auto const previous_selection = selected_module_for(server_module);
+    if (!previous_selection.empty() && is_candidate(previous_selection))
     {
-        // Even forcing a choice, platform is only loaded on demand. It's good
-        // to not need to hold the module open when there are no connections.
-        // Also, this allows you to swap driver binaries on disk at run-time,
-        // if you really wanted to.
-
-        for (auto const& platform : platform_overrides)
-            module_selector(std::make_shared<mir::SharedLibrary>(platform));
+        try
+        {
+            shared_library_prober_report->loading_library(previous_selection);
+            module_selector(std::make_shared<mir::SharedLibrary>(previous_selection));
+        }
+        catch (std::runtime_error const& error)
+        {
+            shared_library_prober_report->loading_failed(previous_selection, error);
+        }
     }
-    else
+
+    if (platform_modules.empty())
     {
-        for (auto const& path : platform_paths)
-            select_libraries_for_path(path, module_selector, *shared_library_prober_report);
+        if (!platform_overrides.empty())
+        {
+            // Even forcing a choice, platform is only loaded on demand. It's good
+            // to not need to hold the module open when there are no connections.
+            // Also, this allows you to swap driver binaries on disk at run-time,
+            // if you really wanted to.
+
+            for (auto const& platform : platform_overrides)
+                if (module_selector(std::make_shared<mir::SharedLibrary>(platform)) == Selection::quit)
+                    break;
+        }
+        else
+        {
+            for (auto const& path : platform_paths)
+                select_libraries_for_path(path, module_selector, *shared_library_prober_report);
+        }
+
+        if (!selected_file.empty())
+            select_module_for(server_module, selected_file);
     }
 
     for (auto& module : platform_modules)
@@ -76,3 +147,27 @@ mcl::ProbingClientPlatformFactory::create_client_platform(mcl::ClientContext* co
 
     BOOST_THROW_EXCEPTION(std::runtime_error{"No appropriate client platform module found"});
 }
+
+bool mcl::ProbingClientPlatformFactory::is_candidate(std::string const& filename) const
+{
+    boost::filesystem::path const file{filename};
+    auto const directory = file.parent_path();
+
+    for (auto const& platform : platform_overrides)
+    {
+        if (platform == filename || platform == file.filename().string())
+            return true;
+    }
+
+    if (platform_overrides.empty())
+    {
+        for (auto const& path : platform_paths)
+        {
+            auto const trimmed = path.substr(0, path.find_last_not_of('/') + 1);
+            if (boost::filesystem::path{trimmed} == directory)
+                return true;
+        }
+    }
+
+    return false;
+}
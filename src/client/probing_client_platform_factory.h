@@ -25,6 +25,9 @@ public:
     std::shared_ptr<ClientPlatform> create_client_platform(ClientContext *context) override;
 
 private:
+    /// Whether filename is one of the modules this factory would consider
+    bool is_candidate(std::string const& filename) const;
+
     std::shared_ptr<mir::SharedLibraryProberReport> const shared_library_prober_report;
     StringList const platform_overrides;
     StringList const platform_paths;
@@ -0,0 +1,396 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_logger.h"
+#include "mir/thread_name.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <tuple>
+
+namespace ml = mir::logging;
+
+namespace
+{
+// Long enough for anything mir::log() formats
+size_t const max_message_length{4096};
+size_t const max_component_length{64};
+auto const flush_interval = std::chrono::milliseconds{10};
+time_t const repeat_interval{1};
+
+std::atomic<unsigned long> next_id{1};
+
+struct RecordHeader
+{
+    uint32_t size;              // Of the whole record, including padding
+    uint32_t component_length;
+    uint32_t message_length;
+    ml::Severity severity;
+    timespec when;
+};
+
+// A record of this component length just marks the rest of the ring as unused
+uint32_t const padding{~0u};
+
+size_t aligned(size_t size)
+{
+    auto const alignment = alignof(RecordHeader);
+    return (size + alignment - 1) / alignment * alignment;
+}
+}
+
+/*
+ * A single producer, single consumer ring of variable length records. The
+ * producer is the thread the ring belongs to; consumers (the writer thread,
+ * or a thread logging a critical message) hold the logger's mutex.
+ */
+class ml::AsyncLogger::Ring
+{
+public:
+    explicit Ring(size_t size) :
+        buffer(aligned(std::max(size, 4*sizeof(RecordHeader))))
+    {
+    }
+
+    /// Returns false, without blocking, if there is not enough room
+    bool push(RecordHeader header, char const* component, char const* message)
+    {
+        auto const capacity = buffer.size();
+        auto const total = aligned(sizeof header + header.component_length + header.message_length);
+
+        if (total > capacity / 2)
+            return false;
+
+        auto const head = write_pos.load(std::memory_order_relaxed);
+        auto const tail = read_pos.load(std::memory_order_acquire);
+
+        auto const to_end = capacity - head % capacity;
+        auto const skip = to_end < total ? to_end : 0;
+
+        if (head + skip + total - tail > capacity)
+            return false;
+
+        if (skip >= sizeof(RecordHeader))
+        {
+            RecordHeader const marker{static_cast<uint32_t>(skip), padding, 0, header.severity, header.when};
+            memcpy(&buffer[head % capacity], &marker, sizeof marker);
+        }
+
+        auto const record = &buffer[(head + skip) % capacity];
+        header.size = total;
+        memcpy(record, &header, sizeof header);
+        memcpy(record + sizeof header, component, header.component_length);
+        memcpy(record + sizeof header + header.component_length, message, header.message_length);
+
+        write_pos.store(head + skip + total, std::memory_order_release);
+        return true;
+    }
+
+    bool more_than_half_full() const
+    {
+        return write_pos.load(std::memory_order_relaxed) - read_pos.load(std::memory_order_relaxed) >
+            buffer.size() / 2;
+    }
+
+    template<typename Consumer>
+    void drain(Consumer const& consume)
+    {
+        auto const capacity = buffer.size();
+        auto tail = read_pos.load(std::memory_order_relaxed);
+        auto const head = write_pos.load(std::memory_order_acquire);
+
+        while (tail != head)
+        {
+            auto const to_end = capacity - tail % capacity;
+            if (to_end < sizeof(RecordHeader))
+            {
+                tail += to_end;
+                continue;
+            }
+
+            auto const record = &buffer[tail % capacity];
+            RecordHeader header;
+            memcpy(&header, record, sizeof header);
+
+            if (header.component_length != padding)
+            {
+                consume(
+                    header,
+                    record + sizeof header,
+                    record + sizeof header + header.component_length);
+            }
+
+            tail += header.size;
+        }
+
+        read_pos.store(tail, std::memory_order_release);
+    }
+
+    std::atomic<unsigned int> dropped{0};
+
+private:
+    std::vector<char> buffer;
+    std::atomic<size_t> write_pos{0};
+    std::atomic<size_t> read_pos{0};
+};
+
+struct ml::AsyncLogger::Entry
+{
+    timespec when;
+    Severity severity;
+    std::string component;
+    std::string message;
+};
+
+namespace
+{
+void format(std::string& out, timespec const& when, ml::Severity severity, std::string const& component, std::string const& message)
+{
+    static const char* lut[5] =
+    {
+        "<CRITICAL> ",
+        "<ERROR> ",
+        "<WARNING> ",
+        "",
+        "<DEBUG> "
+    };
+
+    tm local;
+    char now[32];
+    auto offset = strftime(now, sizeof(now), "%F %T", localtime_r(&when.tv_sec, &local));
+    snprintf(now+offset, sizeof(now)-offset, ".%06ld", when.tv_nsec / 1000);
+
+    out += "[";
+    out += now;
+    out += "] ";
+    out += lut[static_cast<int>(severity)];
+    out += component;
+    out += ": ";
+    out += message;
+    out += "\n";
+}
+
+auto stream_for(ml::Severity severity) -> std::ostream&
+{
+    return severity < ml::Severity::informational ? std::cerr : std::cout;
+}
+
+timespec realtime_now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts;
+}
+}
+
+ml::AsyncLogger::AsyncLogger(size_t ring_size) :
+    ring_size{ring_size},
+    id{next_id++}
+{
+    writer = std::thread{[this]
+        {
+            mir::set_thread_name("Mir/Logger");
+
+            std::unique_lock<std::mutex> lock{mutex};
+            while (!stopping)
+            {
+                wake.wait_for(lock, flush_interval);
+                write_pending(lock);
+            }
+        }};
+}
+
+ml::AsyncLogger::~AsyncLogger()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+
+    std::unique_lock<std::mutex> lock{mutex};
+    write_pending(lock);
+}
+
+void ml::AsyncLogger::log(Severity severity, const std::string& message, const std::string& component)
+{
+    if (severity == Severity::critical)
+        write_now(severity, message, component);
+    else
+        enqueue(severity, component.data(), component.size(), message.data(), message.size());
+}
+
+void ml::AsyncLogger::log(char const* component, Severity severity, char const* format, ...)
+{
+    char message[max_message_length];
+    va_list va;
+    va_start(va, format);
+    auto const length = vsnprintf(message, sizeof message, format, va);
+    va_end(va);
+
+    if (length < 0)
+        return;
+
+    if (severity == Severity::critical)
+        write_now(severity, message, component);
+    else
+        enqueue(severity, component, strlen(component), message, std::min<size_t>(length, sizeof message - 1));
+}
+
+void ml::AsyncLogger::enqueue(
+    Severity severity,
+    char const* component, size_t component_length,
+    char const* message, size_t message_length)
+{
+    RecordHeader const header{
+        0,
+        static_cast<uint32_t>(std::min(component_length, max_component_length)),
+        static_cast<uint32_t>(std::min(message_length, max_message_length)),
+        severity,
+        realtime_now()};
+
+    auto& ring = this_thread_ring();
+
+    if (!ring.push(header, component, message))
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+
+    if (ring.more_than_half_full())
+        wake.notify_one();
+}
+
+auto ml::AsyncLogger::this_thread_ring() -> Ring&
+{
+    struct ThreadRing
+    {
+        unsigned long owner;
+        std::shared_ptr<Ring> ring;
+    };
+    thread_local ThreadRing current{0, nullptr};
+
+    if (current.owner != id)
+    {
+        auto const ring = std::make_shared<Ring>(ring_size);
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            rings.push_back(ring);
+        }
+        current = ThreadRing{id, ring};
+    }
+
+    return *current.ring;
+}
+
+void ml::AsyncLogger::write_pending(std::unique_lock<std::mutex> const& /*lock*/)
+{
+    std::vector<Entry> entries;
+    unsigned int dropped{0};
+
+    for (auto const& ring : rings)
+    {
+        ring->drain(
+            [&entries](RecordHeader const& header, char const* component, char const* message)
+            {
+                entries.push_back(Entry{
+                    header.when,
+                    header.severity,
+                    std::string(component, header.component_length),
+                    std::string(message, header.message_length)});
+            });
+
+        dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    // A ring only we hold belongs to a thread that has exited, and we've drained it
+    rings.erase(
+        std::remove_if(rings.begin(), rings.end(), [](auto const& ring) { return ring.use_count() == 1; }),
+        rings.end());
+
+    // Rings are each in order, so a stable sort keeps a thread's messages in sequence
+    std::stable_sort(entries.begin(), entries.end(),
+        [](Entry const& lhs, Entry const& rhs)
+        {
+            return std::tie(lhs.when.tv_sec, lhs.when.tv_nsec) < std::tie(rhs.when.tv_sec, rhs.when.tv_nsec);
+        });
+
+    std::string out;
+    std::string err;
+
+    auto const write_repeats = [&]
+        {
+            if (repeats)
+            {
+                auto& stream = last->severity < Severity::informational ? err : out;
+                format(stream, realtime_now(), last->severity, last->component,
+                       "last message repeated " + std::to_string(repeats) + " times");
+                repeats = 0;
+            }
+        };
+
+    for (auto& entry : entries)
+    {
+        if (last &&
+            entry.severity == last->severity &&
+            entry.component == last->component &&
+            entry.message == last->message &&
+            entry.when.tv_sec - last->when.tv_sec < repeat_interval)
+        {
+            ++repeats;
+            continue;
+        }
+
+        write_repeats();
+        format(entry.severity < Severity::informational ? err : out,
+               entry.when, entry.severity, entry.component, entry.message);
+        last = std::make_unique<Entry>(std::move(entry));
+    }
+
+    if (last && (stopping || realtime_now().tv_sec - last->when.tv_sec >= repeat_interval))
+    {
+        write_repeats();
+        last.reset();
+    }
+
+    if (dropped)
+    {
+        format(err, realtime_now(), Severity::warning, "logging",
+               std::to_string(dropped) + " messages dropped: logging faster than they can be written");
+    }
+
+    if (!err.empty())
+        std::cerr << err << std::flush;
+
+    if (!out.empty())
+        std::cout << out << std::flush;
+}
+
+void ml::AsyncLogger::write_now(Severity severity, std::string const& message, std::string const& component)
+{
+    std::unique_lock<std::mutex> lock{mutex};
+
+    // Write what is already queued first, so the output stays in order
+    write_pending(lock);
+
+    std::string line;
+    format(line, realtime_now(), severity, component, message);
+    stream_for(severity) << line << std::flush;
+}
@@ -22,14 +22,25 @@
 #include <mutex>
 #include <cstdarg>
 #include <cstdio>
+#include <cstring>
 
 namespace ml = mir::logging;
 
 void ml::Logger::log(char const* component, Severity severity, char const* format, ...)
 {
-    auto const bufsize = 4096;
     va_list va;
     va_start(va, format);
+
+    // A message ml::log() passes on has already been formatted
+    if (std::strcmp(format, "%s") == 0)
+    {
+        char const* const message = va_arg(va, char const*);
+        va_end(va);
+        log(severity, std::string{message ? message : "(null)"}, std::string{component});
+        return;
+    }
+
+    auto const bufsize = 4096;
     char message[bufsize];
     vsnprintf(message, bufsize, format, va);
     va_end(va);
@@ -61,6 +72,14 @@ void ml::log(ml::Severity severity, const std::string& message, const std::strin
     logger->log(severity, message, component);
 }
 
+void ml::log(ml::Severity severity, char const* message, char const* component)
+{
+    auto const logger = get_logger();
+
+    // Lets loggers that override the printf style log() avoid making std::strings
+    logger->log(component, severity, "%s", message);
+}
+
 void ml::set_logger(std::shared_ptr<Logger> const& new_logger)
 {
     if (new_logger)
@@ -18,6 +18,7 @@
 
 #include "mir/shared_library_prober.h"
 #include "mir/shared_library.h"
+#include "mir/startup_trace.h"
 
 #include <boost/filesystem.hpp>
 
@@ -93,6 +94,7 @@ void mir::select_libraries_for_path(
     {
         try
         {
+            StartupTraceSpan const span{"probe " + lib.filename().string()};
             report.loading_library(lib);
             auto const shared_lib = std::make_shared<mir::SharedLibrary>(lib.string());
 
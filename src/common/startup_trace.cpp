@@ -0,0 +1,146 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/startup_trace.h"
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace
+{
+struct Event
+{
+    std::string name;
+    long thread;
+    std::chrono::microseconds start;
+    std::chrono::microseconds duration;
+    std::chrono::microseconds cpu;
+};
+
+std::atomic<bool> running{false};
+std::mutex mutex;
+std::chrono::steady_clock::time_point epoch;
+std::vector<Event> events;
+
+std::chrono::nanoseconds thread_cpu_time()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec};
+}
+
+void write_json_string(std::ostream& out, std::string const& text)
+{
+    out << '"';
+    for (auto const c : text)
+    {
+        switch (c)
+        {
+        case '"':  out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                snprintf(escaped, sizeof escaped, "\\u%04x", c);
+                out << escaped;
+            }
+            else
+            {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+}
+}
+
+void mir::start_startup_trace()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    events.clear();
+    epoch = std::chrono::steady_clock::now();
+    running = true;
+}
+
+std::string mir::stop_startup_trace()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    running = false;
+
+    auto const pid = getpid();
+    std::ostringstream out;
+    out << "{\"traceEvents\":[";
+    for (auto i = events.begin(); i != events.end(); ++i)
+    {
+        if (i != events.begin())
+            out << ",";
+
+        out << "\n{\"name\":";
+        write_json_string(out, i->name);
+        out << ",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << i->thread
+            << ",\"ts\":" << i->start.count() << ",\"dur\":" << i->duration.count()
+            << ",\"args\":{\"cpu_us\":" << i->cpu.count() << "}}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    events.clear();
+    return out.str();
+}
+
+bool mir::startup_trace_running()
+{
+    return running;
+}
+
+mir::StartupTraceSpan::StartupTraceSpan(std::string const& name)
+    : recording{running},
+      name{recording ? name : std::string{}},
+      start{recording ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}},
+      cpu_start{recording ? thread_cpu_time() : std::chrono::nanoseconds{}}
+{
+}
+
+mir::StartupTraceSpan::~StartupTraceSpan()
+{
+    if (!recording)
+        return;
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    auto const cpu = duration_cast<microseconds>(thread_cpu_time() - cpu_start);
+    auto const end = std::chrono::steady_clock::now();
+    auto const thread = static_cast<long>(syscall(SYS_gettid));
+
+    std::lock_guard<std::mutex> lock{mutex};
+    if (!running || start < epoch)
+        return;
+
+    events.push_back(Event{
+        name,
+        thread,
+        duration_cast<microseconds>(start - epoch),
+        duration_cast<microseconds>(end - start),
+        cpu});
+}
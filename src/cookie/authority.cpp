@@ -20,8 +20,8 @@
 #include "mir/cookie/authority.h"
 #include "mir/cookie/blob.h"
 #include "hmac_cookie.h"
+#include "siphash.h"
 #include "const_memcmp.h"
-#include "format.h"
 
 #include <algorithm>
 #include <random>
@@ -29,6 +29,7 @@
 #include <system_error>
 
 #include <nettle/hmac.h>
+#include <nettle/sha2.h>
 
 #include <linux/random.h>
 #include <sys/types.h>
@@ -41,14 +42,14 @@
 
 namespace
 {
-uint32_t const mac_byte_size{32};
-
 size_t cookie_size_from_format(mir::cookie::Format const& format)
 {
     switch (format)
     {
         case mir::cookie::Format::hmac_sha_256:
             return mir::cookie::default_blob_size;
+        case mir::cookie::Format::siphash_2_4:
+            return mir::cookie::siphash_2_4_blob_size;
         default:
             break;
     }
@@ -84,13 +85,25 @@ mir::cookie::SecurityCheckError::SecurityCheckError() :
 class AuthorityNettle : public mir::cookie::Authority
 {
 public:
-    AuthorityNettle(mir::cookie::Secret const& secret)
+    AuthorityNettle(mir::cookie::Secret const& secret, mir::cookie::Format format)
+        : format{format}
     {
         if (secret.size() < minimum_secret_size)
             BOOST_THROW_EXCEPTION(std::logic_error("Secret size " + std::to_string(secret.size()) + " is to small, require " +
                                                    std::to_string(minimum_secret_size) + " or greater."));
 
+        if (cookie_size_from_format(format) == 0)
+            BOOST_THROW_EXCEPTION(std::logic_error("Unsupported cookie format"));
+
         hmac_sha256_set_key(&ctx, secret.size(), secret.data());
+
+        // Derive the SipHash key rather than use the secret directly, so the two MACs share no key material
+        uint8_t const domain[] = "mir-cookie-siphash-2-4";
+        struct sha256_ctx sha;
+        sha256_init(&sha);
+        sha256_update(&sha, sizeof(domain), domain);
+        sha256_update(&sha, secret.size(), secret.data());
+        sha256_digest(&sha, siphash_key.size(), siphash_key.data());
     }
 
     virtual ~AuthorityNettle() noexcept = default;
@@ -98,29 +111,28 @@ public:
 
     std::unique_ptr<mir::cookie::Cookie> make_cookie(uint64_t const& timestamp) override
     {
-        return std::make_unique<mir::cookie::HMACCookie>(timestamp, calculate_cookie(timestamp), mir::cookie::Format::hmac_sha_256);
+        return std::make_unique<mir::cookie::HMACCookie>(timestamp, calculate_mac(format, timestamp), format);
     }
 
     std::unique_ptr<mir::cookie::Cookie> make_cookie(std::vector<uint8_t> const& raw_cookie) override
     {
         /*
-        SHA_256 Format:
+        Format:
         1  byte  = FORMAT
         8  bytes = TIMESTAMP
-        32 bytes = MAC
+        32 bytes = MAC (hmac_sha_256) or 8 bytes = MAC (siphash_2_4)
+
+        Only cookies of the format this Authority makes are accepted, so a
+        client cannot choose a weaker MAC than the one configured.
         */
 
-        if (raw_cookie.size() != cookie_size_from_format(mir::cookie::Format::hmac_sha_256))
+        if (raw_cookie.empty() ||
+            static_cast<mir::cookie::Format>(raw_cookie[0]) != format ||
+            raw_cookie.size() != cookie_size_from_format(format))
         {
            BOOST_THROW_EXCEPTION(mir::cookie::SecurityCheckError());
         }
 
-        mir::cookie::Format format = static_cast<mir::cookie::Format>(raw_cookie[0]);
-        if (format != mir::cookie::Format::hmac_sha_256)
-        {
-            BOOST_THROW_EXCEPTION(mir::cookie::SecurityCheckError());
-        }
-
         uint64_t timestamp = 0;
 
         auto ptr = raw_cookie.data();
@@ -129,42 +141,38 @@ public:
         memcpy(&timestamp, ptr, sizeof(uint64_t));
         ptr += sizeof(timestamp);
 
-        std::vector<uint8_t> mac(mac_byte_size);
-        memcpy(mac.data(), ptr, mac.size());
-
-        std::unique_ptr<mir::cookie::Cookie> cookie =
-            std::make_unique<mir::cookie::HMACCookie>(timestamp, mac, mir::cookie::Format::hmac_sha_256);
+        std::vector<uint8_t> mac(ptr, raw_cookie.data() + raw_cookie.size());
+        auto const expected_mac = calculate_mac(format, timestamp);
 
-        if (!verify_cookie(timestamp, cookie))
+        if (expected_mac.size() != mac.size() ||
+            mir::cookie::const_memcmp(expected_mac.data(), mac.data(), mac.size()) != 0)
         {
             BOOST_THROW_EXCEPTION(mir::cookie::SecurityCheckError());
         }
 
-        return cookie;
+        return std::make_unique<mir::cookie::HMACCookie>(timestamp, mac, format);
     }
 
 private:
-    std::vector<uint8_t> calculate_cookie(uint64_t const& timestamp)
+    std::vector<uint8_t> calculate_mac(mir::cookie::Format cookie_format, uint64_t const& timestamp)
     {
-        std::vector<uint8_t> mac(mac_byte_size);
+        if (cookie_format == mir::cookie::Format::siphash_2_4)
+        {
+            auto const hash = mir::cookie::siphash_2_4(siphash_key, &timestamp, sizeof(timestamp));
+            auto const hash_bytes = reinterpret_cast<uint8_t const*>(&hash);
+            return {hash_bytes, hash_bytes + sizeof(hash)};
+        }
+
+        std::vector<uint8_t> mac(SHA256_DIGEST_SIZE);
         hmac_sha256_update(&ctx, sizeof(timestamp), reinterpret_cast<uint8_t const*>(&timestamp));
         hmac_sha256_digest(&ctx, mac.size(), mac.data());
 
         return mac;
     }
 
-    bool verify_cookie(uint64_t const& timestamp, std::unique_ptr<mir::cookie::Cookie> const& cookie)
-    {
-        auto const calculated_cookie = make_cookie(timestamp);
-
-        auto const this_stream  = cookie->serialize();
-        auto const other_stream = calculated_cookie->serialize();
-
-        return this_stream.size() == other_stream.size() &&
-               mir::cookie::const_memcmp(this_stream.data(), other_stream.data(), this_stream.size()) == 0;
-    }
-
+    mir::cookie::Format const format;
     struct hmac_sha256_ctx ctx;
+    mir::cookie::SipHashKey siphash_key;
 };
 
 size_t mir::cookie::Authority::optimal_secret_size()
@@ -177,17 +185,29 @@ size_t mir::cookie::Authority::optimal_secret_size()
 
 std::unique_ptr<mir::cookie::Authority> mir::cookie::Authority::create_from(mir::cookie::Secret const& secret)
 {
-  return std::make_unique<AuthorityNettle>(secret);
+  return create_from(secret, Format::hmac_sha_256);
+}
+
+std::unique_ptr<mir::cookie::Authority> mir::cookie::Authority::create_from(
+    mir::cookie::Secret const& secret,
+    mir::cookie::Format format)
+{
+  return std::make_unique<AuthorityNettle>(secret, format);
 }
 
 std::unique_ptr<mir::cookie::Authority> mir::cookie::Authority::create_saving(mir::cookie::Secret& save_secret)
 {
   save_secret = get_random_data(optimal_secret_size());
-  return std::make_unique<AuthorityNettle>(save_secret);
+  return std::make_unique<AuthorityNettle>(save_secret, Format::hmac_sha_256);
 }
 
 std::unique_ptr<mir::cookie::Authority> mir::cookie::Authority::create()
+{
+  return create(Format::hmac_sha_256);
+}
+
+std::unique_ptr<mir::cookie::Authority> mir::cookie::Authority::create(mir::cookie::Format format)
 {
   auto secret = get_random_data(optimal_secret_size());
-  return std::make_unique<AuthorityNettle>(secret);
+  return std::make_unique<AuthorityNettle>(secret, format);
 }
@@ -20,7 +20,7 @@
 #define MIR_COOKIE_HMAC_COOKIE_H_
 
 #include "mir/cookie/cookie.h"
-#include "format.h"
+#include "mir/cookie/format.h"
 
 namespace mir
 {
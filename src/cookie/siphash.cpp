@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "siphash.h"
+
+namespace
+{
+uint64_t rotl(uint64_t x, int b)
+{
+    return (x << b) | (x >> (64 - b));
+}
+
+uint64_t load_le64(uint8_t const* p)
+{
+    uint64_t v{0};
+    for (int i = 7; i >= 0; --i)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+struct State
+{
+    uint64_t v0, v1, v2, v3;
+
+    void round()
+    {
+        v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+        v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+    }
+
+    void compress(uint64_t m)
+    {
+        v3 ^= m;
+        round();
+        round();
+        v0 ^= m;
+    }
+};
+}
+
+uint64_t mir::cookie::siphash_2_4(SipHashKey const& key, void const* data, size_t size)
+{
+    auto const k0 = load_le64(key.data());
+    auto const k1 = load_le64(key.data() + 8);
+
+    State s{
+        k0 ^ 0x736f6d6570736575ull,
+        k1 ^ 0x646f72616e646f6dull,
+        k0 ^ 0x6c7967656e657261ull,
+        k1 ^ 0x7465646279746573ull};
+
+    auto in = static_cast<uint8_t const*>(data);
+    auto const end = in + (size - size % 8);
+
+    for (; in != end; in += 8)
+        s.compress(load_le64(in));
+
+    uint64_t last = static_cast<uint64_t>(size) << 56;
+    for (auto i = size % 8; i != 0; --i)
+        last |= static_cast<uint64_t>(in[i - 1]) << (8 * (i - 1));
+    s.compress(last);
+
+    s.v2 ^= 0xff;
+    s.round();
+    s.round();
+    s.round();
+    s.round();
+
+    return s.v0 ^ s.v1 ^ s.v2 ^ s.v3;
+}
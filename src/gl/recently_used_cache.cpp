@@ -42,7 +42,19 @@ std::shared_ptr<mgl::Texture> mgl::RecentlyUsedCache::load(mg::Renderable const&
 
     if ((texture.last_bound_buffer != buffer_id) || (!texture.valid_binding))
     {
-        texture_source->bind();
+        auto const update_source = dynamic_cast<mrgl::TextureUpdateSource*>(buffer->native_buffer_base());
+        if (update_source && texture.valid_binding &&
+            texture.storage_size == buffer->size() && texture.storage_format == buffer->pixel_format())
+        {
+            update_source->update_bound_texture();
+        }
+        else
+        {
+            texture_source->bind();
+        }
+
+        texture.storage_size = buffer->size();
+        texture.storage_format = update_source ? buffer->pixel_format() : mir_pixel_format_invalid;
         texture.resource = buffer;
         texture.last_bound_buffer = buffer_id;
     }
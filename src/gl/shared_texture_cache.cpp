@@ -0,0 +1,257 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/gl/shared_texture_cache.h"
+#include "mir/graphics/buffer.h"
+#include "mir/renderer/gl/texture_source.h"
+
+#include <stdexcept>
+#include <boost/throw_exception.hpp>
+
+namespace mg = mir::graphics;
+namespace mgl = mir::gl;
+namespace mrgl = mir::renderer::gl;
+
+size_t const mgl::SharedTextureCache::default_byte_budget;
+unsigned int const mgl::SharedTextureCache::default_idle_limit;
+
+mgl::SharedTextureCache::SharedTextureCache(size_t byte_budget, unsigned int idle_limit)
+    : byte_budget{byte_budget},
+      idle_limit{idle_limit}
+{
+}
+
+mgl::SharedTextureCache::SharedTextureCache()
+    : SharedTextureCache{default_byte_budget, default_idle_limit}
+{
+}
+
+class mgl::SharedTextureCache::RendererCache : public TextureCache
+{
+public:
+    RendererCache(std::shared_ptr<SharedTextureCache> const& shared, RendererID id)
+        : shared{shared},
+          id{id}
+    {
+    }
+
+    ~RendererCache()
+    {
+        shared->remove(id);
+    }
+
+    std::shared_ptr<Texture> load(mg::Renderable const& renderable) override
+    {
+        return shared->load(id, renderable);
+    }
+
+    void invalidate() override
+    {
+        shared->invalidate(id);
+    }
+
+    void drop_unused() override
+    {
+        shared->drop_unused(id);
+    }
+
+private:
+    std::shared_ptr<SharedTextureCache> const shared;
+    RendererID const id;
+};
+
+std::unique_ptr<mgl::TextureCache> mgl::SharedTextureCache::create_texture_cache()
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto const id = next_renderer++;
+    renderers[id];
+
+    return std::make_unique<RendererCache>(shared_from_this(), id);
+}
+
+std::shared_ptr<mgl::Texture> mgl::SharedTextureCache::load(RendererID renderer, mg::Renderable const& renderable)
+{
+    auto const& buffer = renderable.buffer();
+    auto const buffer_id = buffer->id();
+
+    auto const texture_source = dynamic_cast<mrgl::TextureSource*>(buffer->native_buffer_base());
+    if (!texture_source)
+        BOOST_THROW_EXCEPTION(std::logic_error("Buffer does not support GL rendering"));
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto const& state = renderers[renderer];
+
+    bool const is_new = textures.find(buffer_id) == textures.end();
+    auto& entry = textures[buffer_id];
+    if (is_new)
+    {
+        auto const size = buffer->size();
+        entry.bytes = static_cast<size_t>(size.width.as_int()) * size.height.as_int() *
+                      MIR_BYTES_PER_PIXEL(buffer->pixel_format());
+        lru.push_front(buffer_id);
+        entry.lru_position = lru.begin();
+        stats.bytes += entry.bytes;
+        ++stats.textures;
+    }
+    else
+    {
+        lru.splice(lru.begin(), lru, entry.lru_position);
+    }
+
+    // A renderable moving on to a buffer means the client has refilled it
+    auto& last_shown = shown[renderable.id()];
+    if (last_shown.buffer != buffer_id)
+    {
+        last_shown.buffer = buffer_id;
+        ++entry.generation;
+    }
+    last_shown.seen[renderer] = state.frame;
+
+    // A new user has nothing to invalidate
+    auto& use = entry.users.emplace(renderer, Use{state.frame, state.invalidations, nullptr}).first->second;
+
+    entry.texture->bind();
+
+    // Only the renderer that invalidated its textures needs them reloaded
+    bool const stale = !entry.valid_binding || use.invalidations != state.invalidations;
+    if (stale || entry.uploaded_generation != entry.generation)
+    {
+        auto const update_source = dynamic_cast<mrgl::TextureUpdateSource*>(buffer->native_buffer_base());
+        if (update_source && !stale && entry.reusable_storage)
+            update_source->update_bound_texture();
+        else
+            texture_source->bind();
+
+        entry.reusable_storage = update_source != nullptr;
+        entry.uploaded_generation = entry.generation;
+        entry.valid_binding = true;
+        ++stats.uploads;
+
+        // Other contexts in the share group only see the upload once flushed
+        glFlush();
+    }
+    else
+    {
+        ++stats.hits;
+    }
+    texture_source->secure_for_render();
+
+    use.frame = state.frame;
+    use.invalidations = state.invalidations;
+    use.resource = buffer;
+
+    return entry.texture;
+}
+
+void mgl::SharedTextureCache::invalidate(RendererID renderer)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    ++renderers[renderer].invalidations;
+}
+
+void mgl::SharedTextureCache::drop_unused(RendererID renderer)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto const frame = ++renderers[renderer].frame;
+
+    for (auto t = textures.begin(); t != textures.end();)
+    {
+        auto& users = t->second.users;
+        auto const use = users.find(renderer);
+        if (use != users.end())
+        {
+            use->second.resource.reset();
+            if (use->second.frame + idle_limit < frame)
+                users.erase(use);
+        }
+
+        auto const id = t->first;
+        ++t;
+        if (users.empty())
+            evict(id);
+    }
+
+    while (stats.bytes > byte_budget && !lru.empty())
+    {
+        auto const id = lru.back();
+        if (in_latest_frame(textures[id]))
+            break;
+        evict(id);
+    }
+
+    for (auto s = shown.begin(); s != shown.end();)
+    {
+        auto& seen = s->second.seen;
+        auto const last = seen.find(renderer);
+        if (last != seen.end() && last->second + idle_limit < frame)
+            seen.erase(last);
+
+        if (seen.empty())
+            s = shown.erase(s);
+        else
+            ++s;
+    }
+}
+
+void mgl::SharedTextureCache::remove(RendererID renderer)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    renderers.erase(renderer);
+
+    // Textures left without users are freed by the next drop_unused(), when
+    // some renderer has a current context
+    for (auto& t : textures)
+        t.second.users.erase(renderer);
+
+    for (auto& s : shown)
+        s.second.seen.erase(renderer);
+}
+
+bool mgl::SharedTextureCache::in_latest_frame(Entry const& entry) const
+{
+    // Anything a renderer loaded since its previous drop may still be drawn
+    for (auto const& use : entry.users)
+    {
+        auto const state = renderers.find(use.first);
+        if (state != renderers.end() && use.second.frame + 1 >= state->second.frame)
+            return true;
+    }
+    return false;
+}
+
+void mgl::SharedTextureCache::evict(mg::BufferID id)
+{
+    auto const t = textures.find(id);
+    if (t == textures.end())
+        return;
+
+    stats.bytes -= t->second.bytes;
+    --stats.textures;
+    ++stats.evictions;
+    lru.erase(t->second.lru_position);
+    textures.erase(t);
+}
+
+mgl::SharedTextureCache::Statistics mgl::SharedTextureCache::statistics() const
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    return stats;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_LOGGING_ASYNC_LOGGER_H_
+#define MIR_LOGGING_ASYNC_LOGGER_H_
+
+#include "mir/logging/logger.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mir
+{
+namespace logging
+{
+/**
+ * Writes to the console in the same format as DumbConsoleLogger, but from a
+ * background thread so that logging never blocks the logging thread.
+ *
+ * Each logging thread copies its messages into a ring of its own; the writer
+ * thread merges the rings, collapses runs of repeated messages and writes
+ * them in batches. When a thread's ring is full its messages are dropped
+ * (and the number dropped reported). Critical messages are written before
+ * log() returns, as the process may not survive long enough otherwise.
+ */
+class AsyncLogger : public Logger
+{
+public:
+    explicit AsyncLogger(size_t ring_size = 64*1024);
+    ~AsyncLogger();
+
+protected:
+    void log(Severity severity, const std::string& message, const std::string& component) override;
+    void log(char const* component, Severity severity, char const* format, ...) override
+        __attribute__ ((format (printf, 4, 5)));
+
+private:
+    class Ring;
+    struct Entry;
+
+    void enqueue(Severity severity, char const* component, size_t component_length,
+                 char const* message, size_t message_length);
+    auto this_thread_ring() -> Ring&;
+    void write_pending(std::unique_lock<std::mutex> const& lock);
+    void write_now(Severity severity, std::string const& message, std::string const& component);
+
+    size_t const ring_size;
+    unsigned long const id;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping{false};
+    std::vector<std::shared_ptr<Ring>> rings;
+    std::unique_ptr<Entry> last;
+    unsigned int repeats{0};
+
+    std::thread writer;
+};
+}
+}
+
+#endif // MIR_LOGGING_ASYNC_LOGGER_H_
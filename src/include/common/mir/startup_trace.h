@@ -0,0 +1,55 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_STARTUP_TRACE_H_
+#define MIR_STARTUP_TRACE_H_
+
+#include <chrono>
+#include <string>
+
+namespace mir
+{
+/// Starts recording StartupTraceSpans, discarding any recorded before
+void start_startup_trace();
+
+/// Stops recording and returns the spans recorded as Chrome trace event JSON
+std::string stop_startup_trace();
+
+bool startup_trace_running();
+
+/**
+ * Records the wall clock and thread CPU time between construction and
+ * destruction, while a startup trace is running. Spans on the same thread
+ * nest, so a trace shows what each step of startup spent its time on.
+ */
+class StartupTraceSpan
+{
+public:
+    explicit StartupTraceSpan(std::string const& name);
+    ~StartupTraceSpan();
+
+    StartupTraceSpan(StartupTraceSpan const&) = delete;
+    StartupTraceSpan& operator=(StartupTraceSpan const&) = delete;
+
+private:
+    bool const recording;
+    std::string const name;
+    std::chrono::steady_clock::time_point const start;
+    std::chrono::nanoseconds const cpu_start;
+};
+}
+
+#endif /* MIR_STARTUP_TRACE_H_ */
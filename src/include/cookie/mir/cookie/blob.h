@@ -25,7 +25,8 @@ namespace mir
 {
 namespace cookie
 {
-size_t const default_blob_size = 41;
+size_t const default_blob_size = 41;       // Format::hmac_sha_256, the largest
+size_t const siphash_2_4_blob_size = 17;    // Format::siphash_2_4
 using Blob = std::array<uint8_t, default_blob_size>;
 }
 }
@@ -0,0 +1,145 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GL_SHARED_TEXTURE_CACHE_H_
+#define MIR_GL_SHARED_TEXTURE_CACHE_H_
+
+#include "mir/gl/texture_cache.h"
+#include "mir/gl/texture.h"
+#include "mir/graphics/buffer_id.h"
+#include "mir/graphics/renderable.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mir
+{
+namespace graphics { class Buffer; }
+namespace gl
+{
+/**
+ * The textures shared by all the renderers whose GL contexts are in one share
+ * group. Each renderer uses them through its own TextureCache from
+ * create_texture_cache().
+ *
+ * Textures are keyed by buffer rather than by renderable, so a buffer shown
+ * on several outputs is uploaded once. A buffer's content is considered new
+ * whenever a renderable switches to it; until then any renderer reuses the
+ * existing upload. Use is counted in each renderer's own frames: a texture is
+ * freed once no renderer has loaded it for a while, or when the textures
+ * exceed their byte budget and no renderer loaded it in its latest frame.
+ *
+ * Buffers uploaded from CPU memory (TextureUpdateSource) have their texture
+ * storage updated in place on later uploads rather than reallocated.
+ */
+class SharedTextureCache : public std::enable_shared_from_this<SharedTextureCache>
+{
+public:
+    struct Statistics
+    {
+        unsigned long long hits;
+        unsigned long long uploads;
+        unsigned long long evictions;
+        size_t textures;
+        size_t bytes;
+    };
+
+    static size_t const default_byte_budget{128 * 1024 * 1024};
+    static unsigned int const default_idle_limit{60};
+
+    /**
+     *   \param [in] byte_budget  Size above which unused textures are freed
+     *   \param [in] idle_limit   Number of a renderer's drop_unused() calls
+     *                            after which a texture it did not load is no
+     *                            longer in use by that renderer
+     */
+    SharedTextureCache(size_t byte_budget, unsigned int idle_limit);
+    SharedTextureCache();
+
+    SharedTextureCache(SharedTextureCache const&) = delete;
+    SharedTextureCache& operator=(SharedTextureCache const&) = delete;
+
+    /**
+     * The TextureCache for one renderer. Its invalidate() and drop_unused()
+     * only concern the textures as that renderer uses them.
+     */
+    std::unique_ptr<TextureCache> create_texture_cache();
+
+    Statistics statistics() const;
+
+private:
+    class RendererCache;
+    typedef unsigned int RendererID;
+
+    struct RendererState
+    {
+        unsigned long long frame{1};
+        unsigned long long invalidations{0};
+    };
+
+    struct Use
+    {
+        unsigned long long frame;
+        unsigned long long invalidations;
+        std::shared_ptr<graphics::Buffer> resource;
+    };
+
+    struct Entry
+    {
+        Entry()
+         : texture(std::make_shared<Texture>())
+        {}
+        std::shared_ptr<Texture> texture;
+        unsigned long long generation{1};
+        unsigned long long uploaded_generation{0};
+        size_t bytes{0};
+        bool valid_binding{false};
+        bool reusable_storage{false};   // The last upload came from a TextureUpdateSource
+        std::unordered_map<RendererID, Use> users;
+        std::list<graphics::BufferID>::iterator lru_position;
+    };
+
+    struct Shown
+    {
+        graphics::BufferID buffer;
+        std::unordered_map<RendererID, unsigned long long> seen;   // Frame of each renderer
+    };
+
+    std::shared_ptr<Texture> load(RendererID renderer, graphics::Renderable const& renderable);
+    void invalidate(RendererID renderer);
+    void drop_unused(RendererID renderer);
+    void remove(RendererID renderer);
+
+    bool in_latest_frame(Entry const& entry) const;
+    void evict(graphics::BufferID id);
+
+    size_t const byte_budget;
+    unsigned int const idle_limit;
+
+    std::mutex mutable mutex;
+    std::unordered_map<graphics::BufferID, Entry> textures;
+    std::unordered_map<graphics::Renderable::ID, Shown> shown;
+    std::list<graphics::BufferID> lru; // Most recently used at the front
+    std::unordered_map<RendererID, RendererState> renderers;
+    RendererID next_renderer{0};
+    Statistics stats{0, 0, 0, 0, 0};
+};
+}
+}
+
+#endif /* MIR_GL_SHARED_TEXTURE_CACHE_H_ */
@@ -0,0 +1,119 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_INPUT_RECORDING_H_
+#define MIR_INPUT_INPUT_RECORDING_H_
+
+#include "mir/input/input_device_info.h"
+#include "mir/events/contact_state.h"
+
+#include <chrono>
+#include <iosfwd>
+#include <vector>
+
+namespace mir
+{
+namespace input
+{
+/**
+ * Input recordings hold the devices added to and removed from the server and
+ * the events they sent, as passed to the input device hub. The input-record
+ * option writes them and the input-replay platform plays them back.
+ *
+ * They are text, one record per line:
+ * \code
+ *   mir-input-recording 1
+ *   <time> add <device> <capabilities> "<unique id>" "<name>"
+ *   <time> remove <device>
+ *   <time> key <device> <action> <keysym> <scan code>
+ *   <time> pointer <device> <action> <buttons> <hscroll> <vscroll> <dx> <dy>
+ *   <time> touch <device> <count> [<id> <action> <tooltype> <x> <y> <pressure> <major> <minor> <orientation>]...
+ * \endcode
+ * where times are in nanoseconds since the start of the recording, devices
+ * are numbered by the recording and enumerations are written as numbers.
+ * Empty lines and lines starting with '#' are ignored.
+ */
+namespace recording
+{
+enum class RecordType
+{
+    device_added,
+    device_removed,
+    key,
+    pointer,
+    touch
+};
+
+struct Record
+{
+    std::chrono::nanoseconds time{0};
+    RecordType type{RecordType::key};
+    int device{0};
+
+    // device_added
+    InputDeviceInfo info;
+
+    // key
+    MirKeyboardAction key_action{mir_keyboard_action_down};
+    xkb_keysym_t keysym{0};
+    int scan_code{0};
+
+    // pointer
+    MirPointerAction pointer_action{mir_pointer_action_motion};
+    MirPointerButtons buttons{0};
+    float hscroll{0};
+    float vscroll{0};
+    float dx{0};
+    float dy{0};
+
+    // touch
+    std::vector<events::ContactState> contacts;
+};
+
+class Writer
+{
+public:
+    /// Writes the recording header
+    explicit Writer(std::ostream& out);
+
+    void write(Record const& record);
+
+private:
+    std::ostream& out;
+};
+
+class Reader
+{
+public:
+    /// \throws std::runtime_error if \a in does not start with a recording header
+    explicit Reader(std::istream& in);
+
+    /**
+     * Reads the next record
+     * \returns false at the end of the recording
+     * \throws std::runtime_error for a malformed record
+     */
+    bool read(Record& record);
+
+private:
+    std::istream& in;
+    int line{1};
+};
+}
+}
+}
+
+#endif /* MIR_INPUT_INPUT_RECORDING_H_ */
@@ -53,9 +53,22 @@ extern char const* const fatal_except_opt;
 extern char const* const debug_opt;
 extern char const* const composite_delay_opt;
 extern char const* const enable_key_repeat_opt;
+extern char const* const cookie_format_opt;
+extern char const* const renderer_opt;
+extern char const* const gl_program_cache_opt;
+extern char const* const gl_flatten_layers_opt;
+extern char const* const startup_trace_opt;
+extern char const* const parallel_startup_opt;
+extern char const* const async_logging_opt;
+extern char const* const input_record_opt;
+extern char const* const input_replay_opt;
+extern char const* const input_replay_speed_opt;
 
 extern char const* const name_opt;
 extern char const* const offscreen_opt;
+extern char const* const offscreen_render_targets_opt;
+extern char const* const offscreen_refresh_rate_opt;
+extern char const* const offscreen_frame_sink_opt;
 
 extern char const* const enable_key_repeat_opt;
 
@@ -19,12 +19,15 @@
 #define MIR_DEFAULT_SERVER_CONFIGURATION_H_
 
 #include "mir/cached_ptr.h"
+#include "mir/startup_cached_ptr.h"
 #include "mir/extension_description.h"
 #include "mir/server_configuration.h"
 #include "mir/shell/window_manager_builder.h"
 
+#include <future>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace mir
 {
@@ -71,6 +74,7 @@ class EventSink;
 class DisplayChanger;
 class Screencast;
 class InputConfigurationChanger;
+namespace detail { class RequestScheduler; }
 }
 
 namespace shell
@@ -172,6 +176,14 @@ public:
     DefaultServerConfiguration(int argc, char const* argv[]);
     explicit DefaultServerConfiguration(std::shared_ptr<options::Configuration> const& configuration_options);
 
+    /**
+     * Starts constructing, on worker threads, the components that are slow to
+     * create but do not need the display. The futures hold the components: keep
+     * them until the server is running. If a worker fails the component is made
+     * again (and the failure reported) when the server needs it.
+     */
+    auto start_parallel_initialization() -> std::vector<std::future<std::shared_ptr<void>>>;
+
     /** @name DisplayServer dependencies
      * dependencies of DisplayServer on the rest of the Mir
      *  @{ */
@@ -379,99 +391,105 @@ protected:
         std::shared_ptr<input::CursorListener> const& wrapped);
 /** @} */
 
-    CachedPtr<frontend::Connector>   connector;
-    CachedPtr<frontend::Connector>   wayland_connector;
-    CachedPtr<frontend::Connector>   prompt_connector;
-
-    CachedPtr<input::InputReport> input_report;
-    CachedPtr<input::EventFilterChainDispatcher> event_filter_chain_dispatcher;
-    CachedPtr<input::CompositeEventFilter> composite_event_filter;
-    CachedPtr<input::InputManager>    input_manager;
-    CachedPtr<input::SurfaceInputDispatcher>    surface_input_dispatcher;
-    CachedPtr<input::DefaultInputDeviceHub>    default_input_device_hub;
-    CachedPtr<input::InputDeviceHub>    input_device_hub;
-    CachedPtr<dispatch::MultiplexingDispatchable> input_reading_multiplexer;
-    CachedPtr<input::InputDispatcher> input_dispatcher;
-    CachedPtr<shell::InputTargeter> input_targeter;
-    CachedPtr<input::CursorListener> cursor_listener;
-    CachedPtr<input::TouchVisualizer> touch_visualizer;
-    CachedPtr<input::Seat> seat;
-    CachedPtr<graphics::Platform>     graphics_platform;
-    CachedPtr<graphics::GraphicBufferAllocator> buffer_allocator;
-    CachedPtr<graphics::Display>      display;
-    CachedPtr<graphics::Cursor>       cursor;
-    CachedPtr<graphics::CursorImage>  default_cursor_image;
-    CachedPtr<input::CursorImages> cursor_images;
-
-    CachedPtr<frontend::ConnectorReport>   connector_report;
-    CachedPtr<frontend::MessageProcessorReport> message_processor_report;
-    CachedPtr<frontend::SessionAuthorizer> session_authorizer;
-    CachedPtr<frontend::EventSink> global_event_sink;
-    CachedPtr<frontend::ConnectionCreator> connection_creator;
-    CachedPtr<frontend::ConnectionCreator> prompt_connection_creator;
-    CachedPtr<frontend::Screencast> screencast;
-    CachedPtr<frontend::InputConfigurationChanger> input_configuration_changer;
-    CachedPtr<renderer::RendererFactory> renderer_factory;
-    CachedPtr<compositor::BufferStreamFactory> buffer_stream_factory;
-    CachedPtr<scene::SurfaceStack> scene_surface_stack;
-    CachedPtr<shell::SurfaceStack> surface_stack;
-    CachedPtr<scene::SceneReport> scene_report;
-
-    CachedPtr<scene::SurfaceFactory> surface_factory;
-    CachedPtr<scene::SessionContainer>  session_container;
-    CachedPtr<scene::SessionListener> session_listener;
-    CachedPtr<scene::PixelBuffer>       pixel_buffer;
-    CachedPtr<scene::SnapshotStrategy>  snapshot_strategy;
-    CachedPtr<shell::DisplayLayout>     shell_display_layout;
-    CachedPtr<compositor::DisplayBufferCompositorFactory> display_buffer_compositor_factory;
-    CachedPtr<compositor::Compositor> compositor;
-    CachedPtr<compositor::CompositorReport> compositor_report;
-    CachedPtr<logging::Logger> logger;
-    CachedPtr<graphics::DisplayReport> display_report;
-    CachedPtr<time::Clock> clock;
-    CachedPtr<MainLoop> main_loop;
-    CachedPtr<ServerStatusListener> server_status_listener;
-    CachedPtr<graphics::DisplayConfigurationPolicy> display_configuration_policy;
-    CachedPtr<graphics::nested::MirClientHostConnection> host_connection;
-    CachedPtr<scene::MediatingDisplayChanger> mediating_display_changer;
-    CachedPtr<graphics::GLConfig> gl_config;
-    CachedPtr<scene::PromptSessionListener> prompt_session_listener;
-    CachedPtr<scene::PromptSessionManager> prompt_session_manager;
-    CachedPtr<scene::SessionCoordinator> session_coordinator;
-    CachedPtr<scene::CoordinateTranslator> coordinate_translator;
-    CachedPtr<EmergencyCleanup> emergency_cleanup;
-    CachedPtr<shell::HostLifecycleEventListener> host_lifecycle_event_listener;
-    CachedPtr<shell::PersistentSurfaceStore> persistent_surface_store;
-    CachedPtr<SharedLibraryProberReport> shared_library_prober_report;
-    CachedPtr<shell::Shell> shell;
-    CachedPtr<shell::ShellReport> shell_report;
-    CachedPtr<scene::ApplicationNotRespondingDetector> application_not_responding_detector;
-    CachedPtr<cookie::Authority> cookie_authority;
-    CachedPtr<input::KeyMapper> key_mapper;
+    StartupCachedPtr<frontend::Connector>   connector;
+    StartupCachedPtr<frontend::Connector>   wayland_connector;
+    StartupCachedPtr<frontend::Connector>   prompt_connector;
+
+    StartupCachedPtr<input::InputReport> input_report;
+    StartupCachedPtr<input::EventFilterChainDispatcher> event_filter_chain_dispatcher;
+    StartupCachedPtr<input::CompositeEventFilter> composite_event_filter;
+    StartupCachedPtr<input::InputManager>    input_manager;
+    StartupCachedPtr<input::SurfaceInputDispatcher>    surface_input_dispatcher;
+    StartupCachedPtr<input::DefaultInputDeviceHub>    default_input_device_hub;
+    StartupCachedPtr<input::InputDeviceHub>    input_device_hub;
+    StartupCachedPtr<dispatch::MultiplexingDispatchable> input_reading_multiplexer;
+    StartupCachedPtr<input::InputDispatcher> input_dispatcher;
+    StartupCachedPtr<shell::InputTargeter> input_targeter;
+    StartupCachedPtr<input::CursorListener> cursor_listener;
+    StartupCachedPtr<input::TouchVisualizer> touch_visualizer;
+    StartupCachedPtr<input::Seat> seat;
+    StartupCachedPtr<graphics::Platform>     graphics_platform;
+    StartupCachedPtr<graphics::GraphicBufferAllocator> buffer_allocator;
+    StartupCachedPtr<graphics::Display>      display;
+    StartupCachedPtr<graphics::Cursor>       cursor;
+    StartupCachedPtr<graphics::CursorImage>  default_cursor_image;
+    StartupCachedPtr<input::CursorImages> cursor_images;
+
+    StartupCachedPtr<frontend::ConnectorReport>   connector_report;
+    StartupCachedPtr<frontend::MessageProcessorReport> message_processor_report;
+    StartupCachedPtr<frontend::SessionAuthorizer> session_authorizer;
+    StartupCachedPtr<frontend::EventSink> global_event_sink;
+    StartupCachedPtr<frontend::ConnectionCreator> connection_creator;
+    StartupCachedPtr<frontend::ConnectionCreator> prompt_connection_creator;
+    StartupCachedPtr<frontend::Screencast> screencast;
+    StartupCachedPtr<frontend::InputConfigurationChanger> input_configuration_changer;
+    StartupCachedPtr<renderer::RendererFactory> renderer_factory;
+    StartupCachedPtr<compositor::BufferStreamFactory> buffer_stream_factory;
+    StartupCachedPtr<scene::SurfaceStack> scene_surface_stack;
+    StartupCachedPtr<shell::SurfaceStack> surface_stack;
+    StartupCachedPtr<scene::SceneReport> scene_report;
+
+    StartupCachedPtr<scene::SurfaceFactory> surface_factory;
+    StartupCachedPtr<scene::SessionContainer>  session_container;
+    StartupCachedPtr<scene::SessionListener> session_listener;
+    StartupCachedPtr<scene::PixelBuffer>       pixel_buffer;
+    StartupCachedPtr<scene::SnapshotStrategy>  snapshot_strategy;
+    StartupCachedPtr<shell::DisplayLayout>     shell_display_layout;
+    StartupCachedPtr<compositor::DisplayBufferCompositorFactory> display_buffer_compositor_factory;
+    StartupCachedPtr<compositor::Compositor> compositor;
+    StartupCachedPtr<compositor::CompositorReport> compositor_report;
+    StartupCachedPtr<logging::Logger> logger;
+    StartupCachedPtr<graphics::DisplayReport> display_report;
+    StartupCachedPtr<time::Clock> clock;
+    StartupCachedPtr<MainLoop> main_loop;
+    StartupCachedPtr<ServerStatusListener> server_status_listener;
+    StartupCachedPtr<graphics::DisplayConfigurationPolicy> display_configuration_policy;
+    StartupCachedPtr<graphics::nested::MirClientHostConnection> host_connection;
+    StartupCachedPtr<scene::MediatingDisplayChanger> mediating_display_changer;
+    StartupCachedPtr<graphics::GLConfig> gl_config;
+    StartupCachedPtr<scene::PromptSessionListener> prompt_session_listener;
+    StartupCachedPtr<scene::PromptSessionManager> prompt_session_manager;
+    StartupCachedPtr<scene::SessionCoordinator> session_coordinator;
+    StartupCachedPtr<scene::CoordinateTranslator> coordinate_translator;
+    StartupCachedPtr<EmergencyCleanup> emergency_cleanup;
+    StartupCachedPtr<shell::HostLifecycleEventListener> host_lifecycle_event_listener;
+    StartupCachedPtr<shell::PersistentSurfaceStore> persistent_surface_store;
+    StartupCachedPtr<SharedLibraryProberReport> shared_library_prober_report;
+    StartupCachedPtr<shell::Shell> shell;
+    StartupCachedPtr<shell::ShellReport> shell_report;
+    StartupCachedPtr<scene::ApplicationNotRespondingDetector> application_not_responding_detector;
+    StartupCachedPtr<cookie::Authority> cookie_authority;
+    StartupCachedPtr<input::KeyMapper> key_mapper;
     std::shared_ptr<ConsoleServices> console_services{nullptr};
 
 private:
     std::shared_ptr<options::Configuration> const configuration_options;
     std::shared_ptr<input::EventFilter> const default_filter;
-    CachedPtr<ObserverMultiplexer<graphics::DisplayConfigurationObserver>>
+    StartupCachedPtr<ObserverMultiplexer<graphics::DisplayConfigurationObserver>>
         display_configuration_observer_multiplexer;
-    CachedPtr<ObserverMultiplexer<input::SeatObserver>>
+    StartupCachedPtr<ObserverMultiplexer<input::SeatObserver>>
         seat_observer_multiplexer;
-    CachedPtr<ObserverMultiplexer<frontend::SessionMediatorObserver>>
+    StartupCachedPtr<ObserverMultiplexer<frontend::SessionMediatorObserver>>
         session_mediator_observer_multiplexer;
 
     virtual std::string the_socket_file() const;
 
     // The following caches and factory functions are internal to the
     // default implementations of corresponding the Mir components
-    CachedPtr<scene::BroadcastingSessionEventSink> broadcasting_session_event_sink;
+    StartupCachedPtr<scene::BroadcastingSessionEventSink> broadcasting_session_event_sink;
 
     std::shared_ptr<scene::BroadcastingSessionEventSink> the_broadcasting_session_event_sink();
 
+    // One per connection creator, as requests run on the threads of its connector
+    std::shared_ptr<frontend::detail::RequestScheduler> new_request_scheduler();
+
     auto report_factory(char const* report_opt) -> std::unique_ptr<report::ReportFactory>;
 
-    CachedPtr<shell::detail::FrontendShell> frontend_shell;
+    StartupCachedPtr<shell::detail::FrontendShell> frontend_shell;
     std::vector<mir::ExtensionDescription> the_extensions();
+
+    StartupCachedPtr<SharedLibrary> input_platform_module;
+    std::shared_ptr<SharedLibrary> the_input_platform_module();
 };
 }
 
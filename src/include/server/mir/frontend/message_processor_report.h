@@ -22,6 +22,7 @@
 
 #include "mir_toolkit/event.h"
 
+#include <chrono>
 #include <string>
 
 namespace mir
@@ -45,6 +46,9 @@ public:
 
     virtual void exception_handled(void const* mediator, std::exception const& error) = 0;
 
+    /// Summarises a client's requests since the last summary
+    virtual void request_rate(int client_pid, double requests_per_second, std::chrono::microseconds longest_wait) = 0;
+
 private:
     MessageProcessorReport(MessageProcessorReport const&) = delete;
     MessageProcessorReport& operator=(MessageProcessorReport const&) = delete;
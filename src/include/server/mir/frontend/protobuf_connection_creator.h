@@ -36,6 +36,7 @@ class SessionAuthorizer;
 namespace detail
 {
 class DisplayServer;
+class RequestScheduler;
 class SocketConnection;
 class MessageProcessor;
 class ProtobufMessageSender;
@@ -48,7 +49,8 @@ public:
         std::shared_ptr<ProtobufIpcFactory> const& ipc_factory,
         std::shared_ptr<SessionAuthorizer> const& session_authorizer,
         std::shared_ptr<graphics::PlatformIpcOperations> const& operations,
-        std::shared_ptr<MessageProcessorReport> const& report);
+        std::shared_ptr<MessageProcessorReport> const& report,
+        std::shared_ptr<detail::RequestScheduler> const& scheduler);
     ~ProtobufConnectionCreator() noexcept;
 
     void create_connection_for(
@@ -67,6 +69,7 @@ private:
     std::shared_ptr<SessionAuthorizer> const session_authorizer;
     std::shared_ptr<graphics::PlatformIpcOperations> const operations;
     std::shared_ptr<MessageProcessorReport> const report;
+    std::shared_ptr<detail::RequestScheduler> const scheduler;
     std::atomic<int> next_session_id;
     std::shared_ptr<detail::Connections<detail::SocketConnection>> const connections;
 };
@@ -0,0 +1,47 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_SURFACE_LAYER_H_
+#define MIR_GRAPHICS_SURFACE_LAYER_H_
+
+#include "mir/graphics/renderable.h"
+
+namespace mir
+{
+namespace graphics
+{
+/**
+ * Implemented by renderables that are one of the layers (buffer streams or
+ * Wayland subsurfaces) making up a surface, so renderers can tell which
+ * renderables belong together.
+ */
+class SurfaceLayer
+{
+public:
+    virtual ~SurfaceLayer() = default;
+
+    /// Shared by all the layers of a surface
+    virtual Renderable::ID surface_id() const = 0;
+
+protected:
+    SurfaceLayer() = default;
+    SurfaceLayer(SurfaceLayer const&) = delete;
+    SurfaceLayer& operator=(SurfaceLayer const&) = delete;
+};
+}
+}
+
+#endif /* MIR_GRAPHICS_SURFACE_LAYER_H_ */
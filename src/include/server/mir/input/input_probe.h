@@ -29,6 +29,7 @@ namespace options
 class Option;
 }
 class EmergencyCleanupRegistry;
+class SharedLibrary;
 class SharedLibraryProberReport;
 class ConsoleServices;
 
@@ -38,6 +39,23 @@ class InputReport;
 class Platform;
 class InputDeviceRegistry;
 
+/// Probes for the input module best suited to the system, throwing if there is none
+auto select_input_platform_module(
+    options::Option const& options,
+    std::shared_ptr<ConsoleServices> const& console,
+    SharedLibraryProberReport& prober_report)
+-> std::shared_ptr<SharedLibrary>;
+
+/// Creates the input platform provided by module
+auto input_platform_from_module(
+    SharedLibrary const& module,
+    options::Option const& options,
+    std::shared_ptr<EmergencyCleanupRegistry> const& emergency_cleanup,
+    std::shared_ptr<InputDeviceRegistry> const& device_registry,
+    std::shared_ptr<ConsoleServices> const& console,
+    std::shared_ptr<InputReport> const& input_report)
+-> mir::UniqueModulePtr<Platform>;
+
 mir::UniqueModulePtr<Platform> probe_input_platforms(
     options::Option const& options,
     std::shared_ptr<EmergencyCleanupRegistry> const& emergency_cleanup,
@@ -21,6 +21,8 @@
 
 #include "mir/events/contact_state.h"
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -39,15 +41,30 @@ public:
     void validate_and_dispatch(MirEvent const& event);
 
 private:
+    /// The contacts of a touch event, up to events::max_contacts of them
+    struct TouchState
+    {
+        std::array<events::ContactState, events::max_contacts> contacts;
+        unsigned int count{0};
+    };
+
     std::mutex state_guard;
     std::function<void(MirEvent const&)> const dispatch_valid_event;
-    std::unordered_map<MirInputDeviceId, std::vector<events::ContactState>> last_event_by_device;
+    std::unordered_map<MirInputDeviceId, TouchState> last_event_by_device;
+    TouchState next_state;
+    std::vector<events::ContactState> synthesized_contacts;
 
     void handle_touch_event(MirEvent const& event);
     void ensure_stream_validity_locked(std::lock_guard<std::mutex> const& lg,
-                                       std::vector<events::ContactState> const& new_state,
-                                       std::vector<events::ContactState> & last_state,
-                                       std::function<void(std::vector<events::ContactState> const&)> const&);
+                                       MirInputDeviceId id,
+                                       MirTouchEvent const* touch_event,
+                                       TouchState const& new_state,
+                                       TouchState& last_state);
+    void dispatch_synthesized_locked(std::lock_guard<std::mutex> const& lg,
+                                     MirInputDeviceId id,
+                                     MirTouchEvent const* touch_event,
+                                     TouchState const& state,
+                                     uint32_t excluded);
 };
 }
 }
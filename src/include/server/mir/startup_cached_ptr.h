@@ -0,0 +1,82 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_STARTUP_CACHED_PTR_H_
+#define MIR_STARTUP_CACHED_PTR_H_
+
+#include "mir/startup_trace.h"
+
+#include <boost/core/demangle.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+
+namespace mir
+{
+/**
+ * A CachedPtr for the server configuration that may be resolved from several
+ * threads during startup, and that records the time taken to construct each
+ * object in the startup trace.
+ *
+ * Each cache has its own lock, held while the object is made. As the
+ * configuration's objects form a dependency graph without cycles two threads
+ * can never wait on each other's locks. The lock is recursive because the
+ * the_*() wrappers of mir::Server re-enter the cache they are resolving.
+ */
+template<typename Type>
+class StartupCachedPtr
+{
+    std::recursive_mutex mutex;
+    std::weak_ptr<Type> cache;
+    StartupCachedPtr(StartupCachedPtr const&) = delete;
+    StartupCachedPtr& operator=(StartupCachedPtr const&) = delete;
+
+    static std::string type_name()
+    {
+        // Type may be incomplete here, so name a pointer to it and drop the '*'
+        auto name = boost::core::demangle(typeid(Type*).name());
+        name.pop_back();
+        return name;
+    }
+public:
+    StartupCachedPtr() = default;
+
+    std::shared_ptr<Type> operator()(std::function<std::shared_ptr<Type>()> make)
+    {
+        std::lock_guard<std::recursive_mutex> lock{mutex};
+
+        auto result = cache.lock();
+        if (!result)
+        {
+            if (startup_trace_running())
+            {
+                StartupTraceSpan const span{type_name()};
+                cache = result = make();
+            }
+            else
+            {
+                cache = result = make();
+            }
+        }
+        return result;
+    }
+};
+} // namespace mir
+
+#endif // MIR_STARTUP_CACHED_PTR_H_
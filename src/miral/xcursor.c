@@ -248,25 +248,6 @@ XcursorImagesDestroy (XcursorImages *images)
     free (images);
 }
 
-static void
-XcursorImagesSetName (XcursorImages *images, const char *name)
-{
-    char    *new;
-
-    if (!images || !name)
-        return;
-
-    new = malloc (strlen (name) + 1);
-
-    if (!new)
-	return;
-
-    strcpy (new, name);
-    if (images->name)
-	free (images->name);
-    images->name = new;
-}
-
 static XcursorBool
 _XcursorReadUInt (XcursorFile *file, XcursorUInt *u)
 {
@@ -614,14 +595,11 @@ XcursorFileLoadImages (FILE *file, int size)
 static const char *
 XcursorLibraryPath (void)
 {
-    static const char	*path;
+    const char	*path;
 
+    path = getenv ("XCURSOR_PATH");
     if (!path)
-    {
-	path = getenv ("XCURSOR_PATH");
-	if (!path)
-	    path = XCURSORPATH;
-    }
+	path = XCURSORPATH;
     return path;
 }
 
@@ -790,15 +768,13 @@ _XcursorThemeInherits (const char *full)
 }
 
 static void
-load_all_cursors_from_dir(const char *path, int size,
-			  void (*load_callback)(XcursorImages *, void *),
-			  void *user_data)
+scan_cursors_dir(const char *path,
+		 void (*scan_callback)(const char *, const char *, void *),
+		 void *user_data)
 {
-	FILE *f;
 	DIR *dir = opendir(path);
 	struct dirent *ent;
 	char *full;
-	XcursorImages *images;
 
 	if (!dir)
 		return;
@@ -814,49 +790,31 @@ load_all_cursors_from_dir(const char *path, int size,
 		if (!full)
 			continue;
 
-		f = fopen(full, "r");
-		if (!f) {
-			free(full);
-			continue;
-		}
-
-		images = XcursorFileLoadImages(f, size);
-
-		if (images) {
-			XcursorImagesSetName(images, ent->d_name);
-			load_callback(images, user_data);
-		}
-
-		fclose (f);
+		scan_callback(ent->d_name, full, user_data);
 		free(full);
 	}
 
 	closedir(dir);
 }
 
-/** Load all the cursor of a theme
+/** Find the cursor files of a theme
  *
- * This function loads all the cursor images of a given theme and its
- * inherited themes. Each cursor is loaded into an XcursorImages object
- * which is passed to the caller's load callback. If a cursor appears
- * more than once across all the inherited themes, the load callback
- * will be called multiple times, with possibly different XcursorImages
- * object which have the same name. The user is expected to destroy the
- * XcursorImages objects passed to the callback with
- * XcursorImagesDestroy().
+ * This function lists the cursor files of a given theme and its
+ * inherited themes without reading them. Files from the theme itself
+ * are reported before those of the themes it inherits from, so if a
+ * cursor appears more than once the first report is the one that
+ * should be used.
  *
- * \param theme The name of theme that should be loaded
- * \param size The desired size of the cursor images
- * \param load_callback A callback function that will be called
- * for each cursor loaded. The first parameter is the XcursorImages
- * object representing the loaded cursor and the second is a pointer
- * to data provided by the user.
- * \param user_data The data that should be passed to the load callback
+ * \param theme The name of theme that should be scanned
+ * \param scan_callback A callback function that will be called for
+ * each cursor file found, with the cursor name, the path of the file
+ * and the data provided by the user.
+ * \param user_data The data that should be passed to the scan callback
  */
 void
-xcursor_load_theme(const char *theme, int size,
-		    void (*load_callback)(XcursorImages *, void *),
-		    void *user_data)
+xcursor_scan_theme(const char *theme,
+		   void (*scan_callback)(const char *, const char *, void *),
+		   void *user_data)
 {
 	char *full, *dir;
 	char *inherits = NULL;
@@ -875,8 +833,7 @@ xcursor_load_theme(const char *theme, int size,
 		full = _XcursorBuildFullname(dir, "cursors", "");
 
 		if (full) {
-			load_all_cursors_from_dir(full, size, load_callback,
-						  user_data);
+			scan_cursors_dir(full, scan_callback, user_data);
 			free(full);
 		}
 
@@ -892,8 +849,37 @@ xcursor_load_theme(const char *theme, int size,
 	}
 
 	for (i = inherits; i; i = _XcursorNextPath(i))
-		xcursor_load_theme(i, size, load_callback, user_data);
+		xcursor_scan_theme(i, scan_callback, user_data);
 
 	if (inherits)
 		free(inherits);
 }
+
+/** Load a cursor file at one size
+ *
+ * Only the images of the available size nearest to the requested one
+ * (there may be several for an animated cursor) are decoded. The caller
+ * should destroy the result with XcursorImagesDestroy().
+ *
+ * \param path The path of the cursor file
+ * \param size The desired size of the cursor images
+ * \return The images, or NULL if the file could not be read
+ */
+XcursorImages *
+xcursor_load_file(const char *path, int size)
+{
+	FILE *f;
+	XcursorImages *images;
+
+	if (!path)
+		return NULL;
+
+	f = fopen(path, "r");
+	if (!f)
+		return NULL;
+
+	images = XcursorFileLoadImages(f, size);
+	fclose(f);
+
+	return images;
+}
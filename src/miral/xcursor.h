@@ -56,7 +56,10 @@ void
 XcursorImagesDestroy (XcursorImages *images);
 
 void
-xcursor_load_theme(const char *theme, int size,
-		    void (*load_callback)(XcursorImages *, void *),
-		    void *user_data);
+xcursor_scan_theme(const char *theme,
+		   void (*scan_callback)(const char *, const char *, void *),
+		   void *user_data);
+
+XcursorImages *
+xcursor_load_file(const char *path, int size);
 #endif
@@ -21,7 +21,9 @@
 #include <mir/graphics/cursor_image.h>
 
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 #include <stdexcept>
+#include <vector>
 
 #include <string.h>
 
@@ -44,32 +46,73 @@ namespace
 class XCursorImage : public mg::CursorImage
 {
 public:
-    XCursorImage(_XcursorImage *image, std::shared_ptr<_XcursorImages> const& save_resource)
-        : image(image),
-          save_resource(save_resource)
+    // Copies the image out so that the rest of the XCursor file can be freed
+    explicit XCursorImage(_XcursorImage const* image)
+        : delay{image->delay},
+          pixels(image->pixels, image->pixels + image->width * image->height),
+          size_{image->width, image->height},
+          hotspot_{image->xhot, image->yhot}
     {
     }
 
-    ~XCursorImage()
+    void const* as_argb_8888() const override
+    {
+        return pixels.data();
+    }
+    geom::Size size() const override
+    {
+        return size_;
+    }
+    geom::Displacement hotspot() const override
+    {
+        return hotspot_;
+    }
+
+    std::chrono::milliseconds const delay;
+
+private:
+    std::vector<XcursorPixel> const pixels;
+    geom::Size const size_;
+    geom::Displacement const hotspot_;
+};
+
+class XCursorAnimation : public mg::AnimatedCursorImage
+{
+public:
+    explicit XCursorAnimation(std::vector<std::unique_ptr<XCursorImage>> frames)
+        : frames_(std::move(frames))
     {
     }
 
     void const* as_argb_8888() const override
     {
-        return image->pixels;
+        return frames_.front()->as_argb_8888();
     }
     geom::Size size() const override
     {
-        return {image->width, image->height};
+        return frames_.front()->size();
     }
     geom::Displacement hotspot() const override
     {
-        return {image->xhot, image->yhot};
+        return frames_.front()->hotspot();
+    }
+
+    size_t frames() const override
+    {
+        return frames_.size();
+    }
+    mg::CursorImage const& frame(size_t index) const override
+    {
+        return *frames_.at(index);
+    }
+    std::chrono::milliseconds frame_delay(size_t index) const override
+    {
+        // Themes occasionally leave the delay unset
+        return std::max(frames_.at(index)->delay, std::chrono::milliseconds{1});
     }
 
 private:
-    _XcursorImage *image;
-    std::shared_ptr<_XcursorImages> const save_resource;
+    std::vector<std::unique_ptr<XCursorImage>> const frames_;
 };
 
 std::string const
@@ -144,72 +187,92 @@ xcursor_name_for_mir_cursor(std::string const& mir_cursor_name)
 
 miral::XCursorLoader::XCursorLoader()
 {
-    load_cursor_theme("default");
+    index_cursor_theme("default");
 }
 
 miral::XCursorLoader::XCursorLoader(std::string const& theme)
 {
-    load_cursor_theme(theme);
+    index_cursor_theme(theme);
 }
 
-// Each XcursorImages represents images for the different sizes of a given symbolic cursor.
-void miral::XCursorLoader::load_appropriately_sized_image(_XcursorImages *images)
+void miral::XCursorLoader::index_cursor_theme(std::string const& theme_name)
 {
-    // We would rather take this lock in load_cursor_theme but the Xcursor lib style
-    // makes it difficult to use our standard 'pass the lg around to _locked members' pattern
-    std::lock_guard<std::mutex> lg(guard);
-
-    // We have to save all the images as XCursor expects us to free them.
-    // This contains the actual image data though, so we need to ensure they stay alive
-    // with the lifetime of the mg::CursorImage instance which refers to them.
-    auto saved_xcursor_library_resource = std::shared_ptr<_XcursorImages>(images, [](_XcursorImages *images)
+    xcursor_scan_theme(theme_name.c_str(),
+        [](char const* name, char const* path, void *this_ptr)  -> void
         {
-            XcursorImagesDestroy(images);
-        });
+            // Can't use lambda capture as this lambda is thunked to a C function ptr
+            auto p = static_cast<miral::XCursorLoader*>(this_ptr);
+
+            // The theme's own cursors are found before inherited ones, and take precedence
+            p->theme_files.emplace(name, path);
+        }, this);
+}
 
+std::shared_ptr<mg::CursorImage> miral::XCursorLoader::load_image(std::string const& xcursor_name, int nominal_size)
+{
+    auto const file = theme_files.find(xcursor_name);
+    if (file == theme_files.end())
+        return nullptr;
+
+    // Only the frames of the nearest available size are decoded
+    std::unique_ptr<_XcursorImages, void(*)(_XcursorImages*)> const images{
+        xcursor_load_file(file->second.c_str(), nominal_size),
+        &XcursorImagesDestroy};
+
+    if (!images || images->nimage == 0)
+        return nullptr;
+
+    // Cursors are named by their square dimension...called the nominal size in XCursor terminology,
+    // so we only checked the width. Now prefer frames of exactly the size asked for.
+    auto width = images->images[0]->width;
+    auto height = images->images[0]->height;
     for (int i = 0; i < images->nimage; i++)
     {
         _XcursorImage *candidate = images->images[i];
-        if (candidate->width == mi::default_cursor_size.width.as_uint32_t() &&
-            candidate->height == mi::default_cursor_size.height.as_uint32_t())
+        if (candidate->width == static_cast<XcursorDim>(nominal_size) &&
+            candidate->height == static_cast<XcursorDim>(nominal_size))
         {
-            loaded_images[std::string(images->name)] = std::make_shared<XCursorImage>(candidate, saved_xcursor_library_resource);
-            return;
+            width = height = nominal_size;
+            break;
         }
     }
 
-    loaded_images[std::string(images->name)] = std::make_shared<XCursorImage>(images->images[0], saved_xcursor_library_resource);
-}
+    // Animated cursors have several frames of each size
+    std::vector<std::unique_ptr<XCursorImage>> frames;
+    for (int i = 0; i < images->nimage; i++)
+    {
+        _XcursorImage *candidate = images->images[i];
+        if (candidate->width == width && candidate->height == height)
+            frames.push_back(std::make_unique<XCursorImage>(candidate));
+    }
 
-void miral::XCursorLoader::load_cursor_theme(std::string const& theme_name)
-{
-    // Cursors are named by their square dimension...called the nominal size in XCursor terminology, so we just look up by width.
-    // Later we verify the actual size.
-    xcursor_load_theme(theme_name.c_str(), mi::default_cursor_size.width.as_uint32_t(),
-        [](XcursorImages* images, void *this_ptr)  -> void
-        {
-            // Can't use lambda capture as this lambda is thunked to a C function ptr
-            auto p = static_cast<miral::XCursorLoader*>(this_ptr);
-            p->load_appropriately_sized_image(images);
-        }, this);
+    if (frames.size() == 1)
+        return std::move(frames.front());
+
+    return std::make_shared<XCursorAnimation>(std::move(frames));
 }
 
 std::shared_ptr<mg::CursorImage> miral::XCursorLoader::image(
     std::string const& cursor_name,
-    geom::Size const& /*size*/)
+    geom::Size const& size)
 {
     auto xcursor_name = xcursor_name_for_mir_cursor(cursor_name);
+    auto const nominal_size = size.width.as_int() > 0 ? size.width.as_int() : mi::default_cursor_size.width.as_int();
 
     std::lock_guard<std::mutex> lg(guard);
 
-    auto it = loaded_images.find(xcursor_name);
-    if (it != loaded_images.end())
-        return it->second;
+    // Fall back (without caching under the unknown name, as clients choose the names)
+    if (theme_files.find(xcursor_name) == theme_files.end())
+        xcursor_name = "arrow";
 
-    // Fall back
-    it = loaded_images.find("arrow");
+    auto const key = std::make_pair(xcursor_name, nominal_size);
+    auto it = loaded_images.find(key);
     if (it != loaded_images.end())
         return it->second;
 
-    return nullptr;
+    auto const image = load_image(xcursor_name, nominal_size);
+    if (image)
+        loaded_images[key] = image;
+
+    return image;
 }
@@ -26,17 +26,18 @@
 #include <string>
 #include <map>
 #include <mutex>
-
-// Unfortunately this library does not compile as C++ so we can not namespace it.
-extern "C"
-{
-struct _XcursorImages;
-}
+#include <utility>
 
 namespace mir { namespace graphics { class CursorImage; } }
 
 namespace miral
 {
+/**
+ * Cursor images from an XCursor theme
+ *
+ * Construction only indexes the theme's files; a cursor is decoded the first
+ * time it is asked for, at the requested size, and only that size is kept.
+ */
 class XCursorLoader : public mir::input::CursorImages
 {
 public:
@@ -55,10 +56,14 @@ protected:
 private:
     std::mutex guard;
 
-    std::map<std::string, std::shared_ptr<mir::graphics::CursorImage>> loaded_images;
+    // Cursor name to the file providing it
+    std::map<std::string, std::string> theme_files;
+
+    // Keyed by cursor name and nominal size
+    std::map<std::pair<std::string, int>, std::shared_ptr<mir::graphics::CursorImage>> loaded_images;
 
-    void load_cursor_theme(std::string const& theme_name);
-    void load_appropriately_sized_image(_XcursorImages *images);
+    void index_cursor_theme(std::string const& theme_name);
+    std::shared_ptr<mir::graphics::CursorImage> load_image(std::string const& xcursor_name, int nominal_size);
 };
 }
 
@@ -19,6 +19,7 @@
 #include "mir/log.h"
 #include "mir/graphics/platform.h"
 #include "mir/graphics/platform_probe.h"
+#include "mir/startup_trace.h"
 
 #include <boost/throw_exception.hpp>
 
@@ -34,6 +35,26 @@ mir::graphics::module_for_device(
     {
         try
         {
+            auto describe =
+                [module]()
+                {
+                    try
+                    {
+                        return module->load_function<DescribeModule>(
+                            "describe_graphics_module",
+                            MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
+
+                    }
+                    catch (std::runtime_error const&)
+                    {
+                        return module->load_function<DescribeModule>(
+                            "describe_graphics_module",
+                            obsolete_0_27::symbol_version);
+
+                    }
+                }() ;
+            auto desc = describe();
+
             auto probe =
                 [module]() -> std::function<std::remove_pointer<PlatformProbe>::type>
                 {
@@ -65,32 +86,17 @@ mir::graphics::module_for_device(
                     }
                 }();
 
-            auto module_priority = probe(console, options);
+            auto const module_priority = [&]
+                {
+                    StartupTraceSpan const span{std::string{"probe_graphics_platform "} + desc->name};
+                    return probe(console, options);
+                }();
             if (module_priority > best_priority_so_far)
             {
                 best_priority_so_far = module_priority;
                 best_module_so_far = module;
             }
 
-            auto describe =
-                [module]()
-                {
-                    try
-                    {
-                        return module->load_function<DescribeModule>(
-                            "describe_graphics_module",
-                            MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
-
-                    }
-                    catch (std::runtime_error const&)
-                    {
-                        return module->load_function<DescribeModule>(
-                            "describe_graphics_module",
-                            obsolete_0_27::symbol_version);
-
-                    }
-                }() ;
-            auto desc = describe();
             mir::log_info("Found graphics driver: %s (version %d.%d.%d)",
                           desc->name,
                           desc->major_version,
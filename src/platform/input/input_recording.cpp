@@ -0,0 +1,203 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/input_recording.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace mi = mir::input;
+namespace mir_rec = mir::input::recording;
+
+namespace
+{
+char const* const header = "mir-input-recording 1";
+
+char const* name_of(mir_rec::RecordType type)
+{
+    switch (type)
+    {
+    case mir_rec::RecordType::device_added: return "add";
+    case mir_rec::RecordType::device_removed: return "remove";
+    case mir_rec::RecordType::key: return "key";
+    case mir_rec::RecordType::pointer: return "pointer";
+    case mir_rec::RecordType::touch: return "touch";
+    }
+
+    return "";
+}
+
+bool type_named(std::string const& name, mir_rec::RecordType& type)
+{
+    for (auto const candidate : {mir_rec::RecordType::device_added, mir_rec::RecordType::device_removed,
+                                 mir_rec::RecordType::key, mir_rec::RecordType::pointer, mir_rec::RecordType::touch})
+    {
+        if (name == name_of(candidate))
+        {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename Enum>
+bool read_enum(std::istream& in, Enum& value)
+{
+    int number;
+    if (!(in >> number))
+        return false;
+
+    value = static_cast<Enum>(number);
+    return true;
+}
+
+bool read_fields(std::istream& in, mir_rec::Record& record)
+{
+    switch (record.type)
+    {
+    case mir_rec::RecordType::device_added:
+    {
+        mi::DeviceCapabilities::value_type capabilities;
+        if (!(in >> capabilities >> std::quoted(record.info.unique_id) >> std::quoted(record.info.name)))
+            return false;
+        record.info.capabilities = mi::DeviceCapabilities{capabilities};
+        return true;
+    }
+
+    case mir_rec::RecordType::device_removed:
+        return true;
+
+    case mir_rec::RecordType::key:
+        return read_enum(in, record.key_action) && (in >> record.keysym >> record.scan_code);
+
+    case mir_rec::RecordType::pointer:
+        return read_enum(in, record.pointer_action) &&
+            (in >> record.buttons >> record.hscroll >> record.vscroll >> record.dx >> record.dy);
+
+    case mir_rec::RecordType::touch:
+    {
+        unsigned int count;
+        if (!(in >> count))
+            return false;
+
+        record.contacts.resize(count);
+        for (auto& contact : record.contacts)
+        {
+            if (!(in >> contact.touch_id) ||
+                !read_enum(in, contact.action) ||
+                !read_enum(in, contact.tooltype) ||
+                !(in >> contact.x >> contact.y >> contact.pressure >>
+                  contact.touch_major >> contact.touch_minor >> contact.orientation))
+                return false;
+        }
+        return true;
+    }
+    }
+
+    return false;
+}
+}
+
+mir_rec::Writer::Writer(std::ostream& out) :
+    out{out}
+{
+    out.precision(std::numeric_limits<float>::max_digits10);
+    out << header << '\n';
+}
+
+void mir_rec::Writer::write(Record const& record)
+{
+    out << record.time.count() << ' ' << name_of(record.type) << ' ' << record.device;
+
+    switch (record.type)
+    {
+    case RecordType::device_added:
+        out << ' ' << record.info.capabilities.value()
+            << ' ' << std::quoted(record.info.unique_id)
+            << ' ' << std::quoted(record.info.name);
+        break;
+
+    case RecordType::device_removed:
+        break;
+
+    case RecordType::key:
+        out << ' ' << record.key_action << ' ' << record.keysym << ' ' << record.scan_code;
+        break;
+
+    case RecordType::pointer:
+        out << ' ' << record.pointer_action << ' ' << record.buttons
+            << ' ' << record.hscroll << ' ' << record.vscroll
+            << ' ' << record.dx << ' ' << record.dy;
+        break;
+
+    case RecordType::touch:
+        out << ' ' << record.contacts.size();
+        for (auto const& contact : record.contacts)
+        {
+            out << ' ' << contact.touch_id << ' ' << contact.action << ' ' << contact.tooltype
+                << ' ' << contact.x << ' ' << contact.y << ' ' << contact.pressure
+                << ' ' << contact.touch_major << ' ' << contact.touch_minor << ' ' << contact.orientation;
+        }
+        break;
+    }
+
+    out << '\n';
+}
+
+mir_rec::Reader::Reader(std::istream& in) :
+    in{in}
+{
+    std::string first_line;
+    if (!std::getline(in, first_line) || first_line != header)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Not an input recording"));
+}
+
+bool mir_rec::Reader::read(Record& record)
+{
+    std::string text;
+    while (std::getline(in, text))
+    {
+        ++line;
+
+        if (text.empty() || text[0] == '#')
+            continue;
+
+        std::istringstream fields{text};
+        int64_t time;
+        std::string type;
+
+        if (!(fields >> time >> type >> record.device) ||
+            !type_named(type, record.type) ||
+            !read_fields(fields, record))
+        {
+            BOOST_THROW_EXCEPTION(std::runtime_error(
+                "Malformed input recording at line " + std::to_string(line) + ": " + text));
+        }
+
+        record.time = std::chrono::nanoseconds{time};
+        return true;
+    }
+
+    return false;
+}
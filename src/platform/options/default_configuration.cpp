@@ -49,12 +49,25 @@ char const* const mo::nested_passthrough_opt      = "nested-passthrough";
 char const* const mo::frontend_threads_opt        = "ipc-thread-pool";
 char const* const mo::name_opt                    = "name";
 char const* const mo::offscreen_opt               = "offscreen";
+char const* const mo::offscreen_render_targets_opt = "offscreen-render-targets";
+char const* const mo::offscreen_refresh_rate_opt  = "offscreen-refresh-rate";
+char const* const mo::offscreen_frame_sink_opt    = "offscreen-frame-sink";
 char const* const mo::touchspots_opt              = "enable-touchspots";
 char const* const mo::cursor_opt                  = "cursor";
 char const* const mo::fatal_except_opt            = "on-fatal-error-except";
 char const* const mo::debug_opt                   = "debug";
 char const* const mo::composite_delay_opt         = "composite-delay";
 char const* const mo::enable_key_repeat_opt       = "enable-key-repeat";
+char const* const mo::cookie_format_opt           = "cookie-format";
+char const* const mo::renderer_opt                = "renderer";
+char const* const mo::gl_program_cache_opt        = "gl-program-cache";
+char const* const mo::gl_flatten_layers_opt       = "gl-flatten-layers";
+char const* const mo::startup_trace_opt           = "startup-trace";
+char const* const mo::parallel_startup_opt        = "parallel-startup";
+char const* const mo::async_logging_opt           = "async-logging";
+char const* const mo::input_record_opt            = "input-record";
+char const* const mo::input_replay_opt            = "input-replay";
+char const* const mo::input_replay_speed_opt      = "input-replay-speed";
 
 char const* const mo::off_opt_value = "off";
 char const* const mo::log_opt_value = "log";
@@ -188,18 +201,63 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "Default: A negative value means decide automatically.")
         (name_opt, po::value<std::string>(),
             "When nested, the name Mir uses when registering with the host.")
+        (frontend_threads_opt, po::value<int>()->default_value(1),
+            "Number of threads processing mirclient requests. Requests from any one "
+            "client are still handled in order, but a slow request (e.g. allocating "
+            "a large buffer) only holds up other clients when every thread is busy.")
         (nested_passthrough_opt, po::value<bool>()->default_value(true),
             "When nested, attempt to pass a client's graphics content directly to the host"
             " to avoid a composition pass")
         (offscreen_opt,
             "Render to offscreen buffers instead of the real outputs.")
+        (offscreen_render_targets_opt, po::value<int>()->default_value(2),
+            "Number of framebuffers each offscreen output cycles through, letting "
+            "the compositor run ahead of the GPU.")
+        (offscreen_refresh_rate_opt, po::value<int>()->default_value(0),
+            "Simulated refresh rate (Hz) of offscreen outputs. 0 composites as "
+            "fast as possible.")
+        (offscreen_frame_sink_opt, po::value<int>()->default_value(0),
+            "Number of completed frames each offscreen output keeps in a shared "
+            "memory ring for recorders and test harnesses. 0 disables.")
         (touchspots_opt,
             "Display visualization of touchspots (e.g. for screencasting).")
         (cursor_opt,
             po::value<std::string>()->default_value("auto"),
             "Cursor (mouse pointer) to use [{auto,null,software}]")
+        (renderer_opt, po::value<std::string>()->default_value("gl"),
+            "Renderer used for compositing [{gl,software}]. The software renderer "
+            "needs no GPU, but only draws CPU-accessible (e.g. SHM) client buffers.")
+        (gl_program_cache_opt, po::value<std::string>(),
+            "Directory the GL renderer keeps compiled shader programs in, where the "
+            "driver supports it [default: $XDG_CACHE_HOME/mir/gl-programs; \"off\" disables].")
+        (gl_flatten_layers_opt, po::value<bool>()->default_value(false),
+            "Have the GL renderer draw the layers (e.g. subsurfaces) of a surface that "
+            "have stopped changing from one cached texture, saving draws per frame "
+            "at the cost of texture memory.")
         (enable_key_repeat_opt, po::value<bool>()->default_value(true),
              "Enable server generated key repeat")
+        (input_record_opt, po::value<std::string>(),
+            "File to record input device changes and events to, for replaying "
+            "with --input-replay.")
+        (input_replay_opt, po::value<std::string>(),
+            "Recording to replay instead of reading input devices (needs the "
+            "input-replay platform module).")
+        (input_replay_speed_opt, po::value<double>()->default_value(1.0),
+            "How much faster than recorded to replay input (e.g. 2 halves the "
+            "time between events).")
+        (cookie_format_opt, po::value<std::string>()->default_value("hmac-sha256"),
+            "MAC used to sign input event cookies. SipHash is much cheaper "
+            "to compute but produces a shorter cookie. [{hmac-sha256,siphash}]")
+        (startup_trace_opt, po::value<std::string>(),
+            "File to write a timeline of server startup to, in Chrome trace "
+            "event format (view with chrome://tracing).")
+        (parallel_startup_opt, po::value<bool>()->default_value(false),
+            "Construct components that do not need the display (e.g. probing "
+            "for the input platform) on worker threads during startup.")
+        (async_logging_opt, po::value<bool>()->default_value(false),
+            "Write log messages from a background thread, so logging never blocks "
+            "the compositor, input or IPC threads. Repeated messages are collapsed, "
+            "and messages are dropped if they are logged faster than they can be written.")
         (fatal_except_opt, "On \"fatal error\" conditions [e.g. drivers behaving "
             "in unexpected ways] throw an exception (instead of a core dump)")
         (debug_opt, "Enable extra development debugging. "
@@ -184,6 +184,20 @@ void mgc::ShmBuffer::secure_for_render()
 {
 }
 
+void mgc::ShmBuffer::update_bound_texture()
+{
+    GLenum format, type;
+
+    if (mg::get_gl_pixel_format(pixel_format_, format, type))
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                        size_.width.as_int(), size_.height.as_int(),
+                        format, type, pixels);
+    }
+}
+
 void mir::graphics::common::ShmBuffer::bind_for_write()
 {
     gl_bind_to_texture();
@@ -41,6 +41,7 @@ namespace common
 
 class ShmBuffer : public BufferBasic, public NativeBufferBase,
                   public renderer::gl::TextureSource,
+                  public renderer::gl::TextureUpdateSource,
                   public renderer::gl::TextureTarget,
                   public renderer::software::PixelSource
 {
@@ -55,6 +56,7 @@ public:
     void gl_bind_to_texture() override;
     void bind() override;
     void secure_for_render() override;
+    void update_bound_texture() override;
     void write(unsigned char const* data, size_t size) override;
     void read(std::function<void(unsigned char const*)> const& do_with_pixels) override;
     NativeBufferBase* native_buffer_base() override;
@@ -114,6 +114,7 @@ struct mie::LibInputDevice::ContactExtension
 mie::LibInputDevice::LibInputDevice(std::shared_ptr<mi::InputReport> const& report, LibInputDevicePtr dev)
     : contact_extension{std::make_unique<ContactExtension>()}, report{report}, pointer_pos{0, 0}, button_state{0}
 {
+    frame_contacts.reserve(last_seen_properties.size());
     add_device_of_group(std::move(dev));
 }
 
@@ -312,14 +313,17 @@ mir::EventUPtr mie::LibInputDevice::convert_touch_frame(libinput_event_touch* to
     // TODO make libinput indicate tool type
     auto const tool = mir_touch_tooltype_finger;
 
-    std::vector<events::ContactState> contacts;
-    for(auto it = begin(last_seen_properties); it != end(last_seen_properties);)
+    frame_contacts.clear();
+    for (unsigned int slot = 0; slot != last_seen_properties.size(); ++slot)
     {
-        auto & id = it->first;
-        auto & data = it->second;
+        uint32_t const bit = 1u << slot;
+        if (!(active_contacts & bit))
+            continue;
 
-        contacts.push_back(events::ContactState{
-                           id,
+        auto& data = last_seen_properties[slot];
+
+        frame_contacts.push_back(events::ContactState{
+                           data.id,
                            data.action,
                            tool,
                            data.x,
@@ -333,24 +337,43 @@ mir::EventUPtr mie::LibInputDevice::convert_touch_frame(libinput_event_touch* to
             data.action = mir_touch_action_change;
 
         if (data.action == mir_touch_action_up)
-            it = last_seen_properties.erase(it);
-        else
-            ++it;
+            active_contacts &= ~bit;
     }
 
-    return builder->touch_event(time, contacts);
+    return builder->touch_event(time, frame_contacts);
 }
 
-void mie::LibInputDevice::handle_touch_down(libinput_event_touch* touch)
+auto mie::LibInputDevice::contact_data(libinput_event_touch* touch) -> ContactData*
 {
     MirTouchId const id = libinput_event_touch_get_slot(touch);
-    update_contact_data(last_seen_properties[id], mir_touch_action_down, touch);
+
+    // Single touch devices have no slots (and report -1) so their one contact takes the first
+    unsigned int const slot = id < 0 ? 0 : id;
+    if (slot >= last_seen_properties.size())
+        return nullptr;
+
+    auto& data = last_seen_properties[slot];
+    uint32_t const bit = 1u << slot;
+    if (!(active_contacts & bit))
+    {
+        data = ContactData{};
+        data.id = id;
+        active_contacts |= bit;
+    }
+
+    return &data;
+}
+
+void mie::LibInputDevice::handle_touch_down(libinput_event_touch* touch)
+{
+    if (auto const data = contact_data(touch))
+        update_contact_data(*data, mir_touch_action_down, touch);
 }
 
 void mie::LibInputDevice::handle_touch_up(libinput_event_touch* touch)
 {
-    MirTouchId const id = libinput_event_touch_get_slot(touch);
-    last_seen_properties[id].action = mir_touch_action_up;
+    if (auto const data = contact_data(touch))
+        data->action = mir_touch_action_up;
 }
 
 void mie::LibInputDevice::update_contact_data(ContactData & data, MirTouchAction action, libinput_event_touch* touch)
@@ -372,8 +395,8 @@ void mie::LibInputDevice::update_contact_data(ContactData & data, MirTouchAction
 
 void mie::LibInputDevice::handle_touch_motion(libinput_event_touch* touch)
 {
-    MirTouchId const id = libinput_event_touch_get_slot(touch);
-    update_contact_data(last_seen_properties[id], mir_touch_action_change, touch);
+    if (auto const data = contact_data(touch))
+        update_contact_data(*data, mir_touch_action_change, touch);
 }
 
 mi::InputDeviceInfo mie::LibInputDevice::get_device_info()
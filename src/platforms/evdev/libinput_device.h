@@ -28,8 +28,9 @@
 #include "mir/input/touchscreen_settings.h"
 #include "mir/geometry/point.h"
 
+#include <array>
+#include <cstdint>
 #include <vector>
-#include <map>
 
 struct libinput_event;
 struct libinput_event_keyboard;
@@ -100,11 +101,17 @@ private:
     struct ContactData
     {
         ContactData() {}
+        MirTouchId id{0};
         MirTouchAction action{mir_touch_action_change};
         float x{0}, y{0}, major{0}, minor{0}, pressure{0}, orientation{0};
     };
-    std::map<MirTouchId,ContactData> last_seen_properties;
+    // Indexed by slot, with a bit set in active_contacts for each slot in use
+    std::array<ContactData, events::max_contacts> last_seen_properties;
+    uint32_t active_contacts{0};
+    // Reused for every touch frame so that converting one does not allocate
+    std::vector<events::ContactState> frame_contacts;
 
+    ContactData* contact_data(libinput_event_touch* touch);
     void update_contact_data(ContactData &data, MirTouchAction action, libinput_event_touch* touch);
 };
 }
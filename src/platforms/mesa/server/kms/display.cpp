@@ -263,6 +263,57 @@ void mgm::Display::configure(mg::DisplayConfiguration const& conf)
     if (auto c = cursor.lock()) c->resume();
 }
 
+void mgm::Display::configure_keeping_unchanged_groups(
+    mg::DisplayConfiguration const& conf,
+    std::function<void(mg::DisplaySyncGroup&)> const& retiring)
+{
+    if (!conf.valid())
+    {
+        BOOST_THROW_EXCEPTION(
+            std::logic_error("Invalid or inconsistent display configuration"));
+    }
+
+    auto const& kms_conf = dynamic_cast<RealKMSDisplayConfiguration const&>(conf);
+    std::vector<DisplayBuffer*> unchanged;
+    std::vector<DisplayBuffer*> retired;
+
+    {
+        std::lock_guard<decltype(configuration_mutex)> lock{configuration_mutex};
+
+        // A compatible configuration is applied to the existing display buffers
+        if (compatible(kms_conf, current_display_configuration))
+        {
+            for (auto const& db : display_buffers)
+                unchanged.push_back(db.get());
+        }
+        else
+        {
+            unchanged = unchanged_display_buffers(kms_conf, lock);
+        }
+
+        for (auto const& db : display_buffers)
+        {
+            if (std::find(unchanged.begin(), unchanged.end(), db.get()) == unchanged.end())
+                retired.push_back(db.get());
+        }
+    }
+
+    /*
+     * Only the main loop reconfigures the display, so the display buffers
+     * can't change while we're not holding the lock; and whoever is using the
+     * retired ones may need it to stop.
+     */
+    for (auto const db : retired)
+        retiring(*db);
+
+    {
+        std::lock_guard<decltype(configuration_mutex)> lock{configuration_mutex};
+        configure_locked(kms_conf, lock, unchanged);
+    }
+
+    if (auto c = cursor.lock()) c->resume();
+}
+
 void mgm::Display::register_configuration_change_handler(
     EventHandlerRegister& handlers,
     DisplayConfigurationChangeHandler const& conf_change_handler)
@@ -470,9 +521,62 @@ void add_to_drm_device_group(
 }
 }
 
+auto mgm::Display::unchanged_display_buffers(
+    RealKMSDisplayConfiguration const& kms_conf,
+    std::lock_guard<std::mutex> const&) const -> std::vector<DisplayBuffer*>
+{
+    std::vector<DisplayConfigurationOutput> current_outputs;
+    current_display_configuration.for_each_output(
+        [&current_outputs](DisplayConfigurationOutput const& conf_output)
+        {
+            current_outputs.push_back(conf_output);
+        });
+
+    auto const unchanged_output = [&current_outputs](DisplayConfigurationOutput const& conf_output)
+        {
+            return std::find(current_outputs.begin(), current_outputs.end(), conf_output) != current_outputs.end();
+        };
+
+    std::vector<DisplayBuffer*> unchanged;
+    OverlappingOutputGrouping grouping{kms_conf};
+
+    grouping.for_each_group(
+        [&](OverlappingOutputGroup const& group)
+        {
+            auto const bounding_rect = group.bounding_rectangle();
+            std::vector<std::vector<std::shared_ptr<KMSOutput>>> kms_output_groups;
+            bool group_unchanged{true};
+
+            group.for_each_output(
+                [&](DisplayConfigurationOutput const& conf_output)
+                {
+                    group_unchanged &= unchanged_output(conf_output);
+                    add_to_drm_device_group(
+                        kms_output_groups,
+                        current_display_configuration.get_output_for(conf_output.id));
+                });
+
+            if (!group_unchanged)
+                return;
+
+            // Outputs may have left the group, or the group been split differently
+            for (auto const& kms_outputs : kms_output_groups)
+            {
+                for (auto const& db : display_buffers)
+                {
+                    if (db->view_area() == bounding_rect && db->scans_out_to(kms_outputs))
+                        unchanged.push_back(db.get());
+                }
+            }
+        });
+
+    return unchanged;
+}
+
 void mgm::Display::configure_locked(
     mgm::RealKMSDisplayConfiguration const& kms_conf,
-    std::lock_guard<std::mutex> const&)
+    std::lock_guard<std::mutex> const&,
+    std::vector<DisplayBuffer*> const& keep)
 {
     // Treat the current_display_configuration as incompatible with itself,
     // before it's fully constructed, to force proper initialization.
@@ -481,6 +585,21 @@ void mgm::Display::configure_locked(
         compatible(kms_conf, current_display_configuration)};
     std::vector<std::unique_ptr<DisplayBuffer>> display_buffers_new;
 
+    /*
+     * Display buffers in keep are left scanning out (and possibly being
+     * composited) undisturbed, as are their outputs.
+     */
+    auto const kept = [&keep](DisplayBuffer const& db)
+        {
+            return std::find(keep.begin(), keep.end(), &db) != keep.end();
+        };
+
+    auto const kept_output = [&keep](KMSOutput const& kms_output)
+        {
+            return std::any_of(keep.begin(), keep.end(),
+                [&kms_output](DisplayBuffer const* db) { return db->scans_out_to(kms_output); });
+        };
+
     if (!comp)
     {
         /*
@@ -492,15 +611,21 @@ void mgm::Display::configure_locked(
          * display_buffers_new are created and take control of the outputs.
          */
         for (auto& db : display_buffers)
-            db->wait_for_page_flip();
+        {
+            if (!kept(*db))
+                db->wait_for_page_flip();
+        }
 
-        /* Reset the state of all outputs */
+        /* Reset the state of all outputs we're not keeping */
         kms_conf.for_each_output(
             [&](DisplayConfigurationOutput const& conf_output)
             {
                 auto kms_output = current_display_configuration.get_output_for(conf_output.id);
-                kms_output->clear_cursor();
-                kms_output->reset();
+                if (!kept_output(*kms_output))
+                {
+                    kms_output->clear_cursor();
+                    kms_output->reset();
+                }
             });
     }
 
@@ -521,16 +646,21 @@ void mgm::Display::configure_locked(
                 {
                     auto kms_output = current_display_configuration.get_output_for(conf_output.id);
 
-                    auto const mode_index = kms_conf.get_kms_mode_index(conf_output.id,
-                                                                  conf_output.current_mode_index);
-                    kms_output->configure(conf_output.top_left - bounding_rect.top_left, mode_index);
-                    if (!comp)
+                    if (comp || !kept_output(*kms_output))
                     {
-                        kms_output->set_power_mode(conf_output.power_mode);
-                        kms_output->set_gamma(conf_output.gamma);
-                        add_to_drm_device_group(kms_output_groups, std::move(kms_output));
+                        auto const mode_index = kms_conf.get_kms_mode_index(conf_output.id,
+                                                                      conf_output.current_mode_index);
+                        kms_output->configure(conf_output.top_left - bounding_rect.top_left, mode_index);
+                        if (!comp)
+                        {
+                            kms_output->set_power_mode(conf_output.power_mode);
+                            kms_output->set_gamma(conf_output.gamma);
+                        }
                     }
 
+                    if (!comp)
+                        add_to_drm_device_group(kms_output_groups, std::move(kms_output));
+
                     /*
                      * Presently OverlappingOutputGroup guarantees all grouped
                      * outputs have the same transformation.
@@ -555,6 +685,18 @@ void mgm::Display::configure_locked(
 
                 for (auto const& group : kms_output_groups)
                 {
+                    auto const keeper = std::find_if(display_buffers.begin(), display_buffers.end(),
+                        [&](std::unique_ptr<DisplayBuffer> const& db)
+                        {
+                            return db && kept(*db) && db->scans_out_to(group);
+                        });
+
+                    if (keeper != display_buffers.end())
+                    {
+                        display_buffers_new.push_back(std::move(*keeper));
+                        continue;
+                    }
+
                     /*
                      * In a hybrid setup a scanout surface needs to be allocated differently if it
                      * needs to be able to be shared across GPUs. This likely reduces performance.
@@ -81,6 +81,9 @@ public:
     std::unique_ptr<DisplayConfiguration> configuration() const override;
     bool apply_if_configuration_preserves_display_buffers(DisplayConfiguration const& conf) override;
     void configure(DisplayConfiguration const& conf) override;
+    void configure_keeping_unchanged_groups(
+        DisplayConfiguration const& conf,
+        std::function<void(graphics::DisplaySyncGroup&)> const& retiring) override;
 
     void register_configuration_change_handler(
         EventHandlerRegister& handlers,
@@ -119,7 +122,12 @@ private:
 
     void configure_locked(
         RealKMSDisplayConfiguration const& conf,
-        std::lock_guard<decltype(configuration_mutex)> const&);
+        std::lock_guard<decltype(configuration_mutex)> const&,
+        std::vector<DisplayBuffer*> const& keep = {});
+
+    auto unchanged_display_buffers(
+        RealKMSDisplayConfiguration const& conf,
+        std::lock_guard<decltype(configuration_mutex)> const&) const -> std::vector<DisplayBuffer*>;
 
     BypassOption bypass_option;
     std::weak_ptr<Cursor> cursor;
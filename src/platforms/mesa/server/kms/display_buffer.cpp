@@ -780,6 +780,18 @@ void mgm::DisplayBuffer::wait_for_page_flip()
     }
 }
 
+bool mgm::DisplayBuffer::scans_out_to(KMSOutput const& kms_output) const
+{
+    return std::any_of(outputs.begin(), outputs.end(),
+        [&kms_output](std::shared_ptr<KMSOutput> const& output) { return output.get() == &kms_output; });
+}
+
+bool mgm::DisplayBuffer::scans_out_to(std::vector<std::shared_ptr<KMSOutput>> const& kms_outputs) const
+{
+    return kms_outputs.size() == outputs.size() &&
+        std::is_permutation(outputs.begin(), outputs.end(), kms_outputs.begin());
+}
+
 void mgm::DisplayBuffer::make_current()
 {
     surface.make_current();
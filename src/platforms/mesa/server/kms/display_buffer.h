@@ -126,6 +126,9 @@ public:
     void schedule_set_crtc();
     void wait_for_page_flip();
 
+    bool scans_out_to(KMSOutput const& kms_output) const;
+    bool scans_out_to(std::vector<std::shared_ptr<KMSOutput>> const& kms_outputs) const;
+
 private:
     bool schedule_page_flip(FBHandle const& bufobj);
     void set_crtc(FBHandle const&);
@@ -0,0 +1,136 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cursor.h"
+#include "mir/graphics/cursor_image.h"
+
+#include <X11/extensions/Xrender.h>
+
+namespace mg = mir::graphics;
+namespace mgx = mg::X;
+namespace geom = mir::geometry;
+
+namespace
+{
+::Cursor create_blank_cursor(::Display* x_dpy, Window win)
+{
+    char const data{0};
+    XColor black{};
+    auto const bitmap = XCreateBitmapFromData(x_dpy, win, &data, 1, 1);
+    auto const cursor = XCreatePixmapCursor(x_dpy, bitmap, bitmap, &black, &black, 0, 0);
+    XFreePixmap(x_dpy, bitmap);
+    return cursor;
+}
+
+::Cursor create_argb_cursor(::Display* x_dpy, Window win, mg::CursorImage const& cursor_image)
+{
+    auto const width = cursor_image.size().width.as_uint32_t();
+    auto const height = cursor_image.size().height.as_uint32_t();
+
+    // The pixels are 32 bit values in our byte order, not (necessarily) the server's
+    uint32_t const one{1};
+    auto const byte_order = *reinterpret_cast<unsigned char const*>(&one) ? LSBFirst : MSBFirst;
+
+    XImage ximage{};
+    ximage.width = width;
+    ximage.height = height;
+    ximage.format = ZPixmap;
+    ximage.data = const_cast<char*>(static_cast<char const*>(cursor_image.as_argb_8888()));
+    ximage.byte_order = byte_order;
+    ximage.bitmap_unit = 32;
+    ximage.bitmap_bit_order = byte_order;
+    ximage.bitmap_pad = 32;
+    ximage.depth = 32;
+    ximage.bits_per_pixel = 32;
+    ximage.bytes_per_line = width * 4;
+    XInitImage(&ximage);
+
+    auto const pixmap = XCreatePixmap(x_dpy, win, width, height, 32);
+    auto const gc = XCreateGC(x_dpy, pixmap, 0, nullptr);
+    XPutImage(x_dpy, pixmap, gc, &ximage, 0, 0, 0, 0, width, height);
+    XFreeGC(x_dpy, gc);
+
+    auto const picture = XRenderCreatePicture(
+        x_dpy, pixmap, XRenderFindStandardFormat(x_dpy, PictStandardARGB32), 0, nullptr);
+    auto const cursor = XRenderCreateCursor(
+        x_dpy, picture, cursor_image.hotspot().dx.as_int(), cursor_image.hotspot().dy.as_int());
+
+    XRenderFreePicture(x_dpy, picture);
+    XFreePixmap(x_dpy, pixmap);
+
+    return cursor;
+}
+}
+
+mgx::Cursor::Cursor(::Display* x_dpy, Window win) :
+    x_dpy{x_dpy},
+    win{win},
+    blank{create_blank_cursor(x_dpy, win)}
+{
+    XDefineCursor(x_dpy, win, blank);
+    XFlush(x_dpy);
+}
+
+mgx::Cursor::~Cursor()
+{
+    XUndefineCursor(x_dpy, win);
+    if (image != None)
+        XFreeCursor(x_dpy, image);
+    XFreeCursor(x_dpy, blank);
+    XFlush(x_dpy);
+}
+
+void mgx::Cursor::show()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    visible = true;
+    XDefineCursor(x_dpy, win, image != None ? image : blank);
+    XFlush(x_dpy);
+}
+
+void mgx::Cursor::show(CursorImage const& cursor_image)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const old_image = image;
+    auto const size = cursor_image.size();
+    image = size.width.as_int() > 0 && size.height.as_int() > 0 ?
+        create_argb_cursor(x_dpy, win, cursor_image) : None;
+
+    visible = true;
+    XDefineCursor(x_dpy, win, image != None ? image : blank);
+    if (old_image != None)
+        XFreeCursor(x_dpy, old_image);
+    XFlush(x_dpy);
+}
+
+void mgx::Cursor::hide()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (!visible)
+        return;
+
+    visible = false;
+    XDefineCursor(x_dpy, win, blank);
+    XFlush(x_dpy);
+}
+
+void mgx::Cursor::move_to(geom::Point)
+{
+    // The X server moves it with the host pointer
+}
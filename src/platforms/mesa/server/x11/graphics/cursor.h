@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_X_CURSOR_H_
+#define MIR_GRAPHICS_X_CURSOR_H_
+
+#include "mir/graphics/cursor.h"
+
+#include <X11/Xlib.h>
+
+#include <mutex>
+
+namespace mir
+{
+namespace graphics
+{
+namespace X
+{
+/**
+ * The cursor, as the X cursor of the Mir window
+ *
+ * The X server draws it at the host pointer, which is where the input
+ * platform puts our pointer, so moving it involves no compositing at all.
+ */
+class Cursor : public graphics::Cursor
+{
+public:
+    Cursor(::Display* x_dpy, Window win);
+    ~Cursor();
+
+    void show() override;
+    void show(CursorImage const& cursor_image) override;
+    void hide() override;
+
+    void move_to(geometry::Point position) override;
+
+private:
+    ::Display* const x_dpy;
+    Window const win;
+    ::Cursor const blank;
+
+    std::mutex mutex;
+    ::Cursor image{None};
+    bool visible{false};
+};
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_X_CURSOR_H_ */
@@ -27,10 +27,12 @@
 #include "display_configuration.h"
 #include "display.h"
 #include "display_buffer.h"
+#include "cursor.h"
 
 #include <boost/throw_exception.hpp>
 
 #include <X11/Xatom.h>
+#include <X11/extensions/Xrender.h>
 #include <algorithm>
 
 #define MIR_LOG_COMPONENT "x11-display"
@@ -335,9 +337,14 @@ void mgx::Display::resume()
     BOOST_THROW_EXCEPTION(std::runtime_error("'Display::resume()' not yet supported on x11 platform"));
 }
 
-auto mgx::Display::create_hardware_cursor() -> std::shared_ptr<Cursor>
+auto mgx::Display::create_hardware_cursor() -> std::shared_ptr<graphics::Cursor>
 {
-    return nullptr;
+    // ARGB cursors need XRender
+    int event_base, error_base;
+    if (!XRenderQueryExtension(x_dpy, &event_base, &error_base))
+        return nullptr;
+
+    return std::make_shared<mgx::Cursor>(x_dpy, *win);
 }
 
 std::unique_ptr<mg::VirtualOutput> mgx::Display::create_virtual_output(int /*width*/, int /*height*/)
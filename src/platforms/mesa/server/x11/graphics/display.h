@@ -94,7 +94,7 @@ public:
     void pause() override;
     void resume() override;
 
-    std::shared_ptr<Cursor> create_hardware_cursor() override;
+    std::shared_ptr<graphics::Cursor> create_hardware_cursor() override;
     std::unique_ptr<VirtualOutput> create_virtual_output(int width, int height) override;
 
     NativeDisplay* native_display() override;
@@ -0,0 +1,206 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "platform.h"
+#include "replay_device.h"
+
+#include "mir/dispatch/multiplexing_dispatchable.h"
+#include "mir/dispatch/readable_fd.h"
+#include "mir/input/input_device_registry.h"
+
+#define MIR_LOG_COMPONENT "replay-input"
+#include "mir/log.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <stdexcept>
+#include <system_error>
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace md = mir::dispatch;
+namespace mir_rec = mir::input::recording;
+namespace mir_replay = mir::input::replay;
+
+namespace
+{
+std::chrono::nanoseconds now()
+{
+    // The same clock (CLOCK_MONOTONIC) as the timer and input event timestamps
+    return std::chrono::steady_clock::now().time_since_epoch();
+}
+
+mir::Fd create_timer()
+{
+    mir::Fd timer{timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)};
+    if (timer < 0)
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to create input replay timer"}));
+
+    return timer;
+}
+}
+
+mir_replay::Platform::Platform(
+    std::shared_ptr<InputDeviceRegistry> const& registry,
+    std::string const& recording_path,
+    double speed) :
+    registry{registry},
+    recording_path{recording_path},
+    speed{speed},
+    platform_dispatchable{std::make_shared<md::MultiplexingDispatchable>()},
+    timer{create_timer()},
+    timer_dispatchable{std::make_shared<md::ReadableFd>(timer, [this] { replay_due_records(); })},
+    recording{recording_path}
+{
+    if (speed <= 0)
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Input replay speed must be positive"));
+
+    if (!recording)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to open input recording: " + recording_path));
+
+    // Fail now, rather than on start(), if it is not a recording
+    recording::Reader{recording};
+}
+
+mir_replay::Platform::~Platform() = default;
+
+std::shared_ptr<mir::dispatch::Dispatchable> mir_replay::Platform::dispatchable()
+{
+    return platform_dispatchable;
+}
+
+void mir_replay::Platform::start()
+{
+    recording.clear();
+    recording.seekg(0);
+    reader = std::make_unique<recording::Reader>(recording);
+
+    started = now();
+    read_next();
+
+    platform_dispatchable->add_watch(timer_dispatchable);
+}
+
+void mir_replay::Platform::stop()
+{
+    platform_dispatchable->remove_watch(timer_dispatchable);
+    set_timer(std::chrono::nanoseconds::zero());
+
+    replaying = false;
+    reader.reset();
+    remove_devices();
+}
+
+void mir_replay::Platform::pause_for_config()
+{
+}
+
+void mir_replay::Platform::continue_after_config()
+{
+}
+
+void mir_replay::Platform::replay_due_records()
+{
+    uint64_t expirations;
+    if (read(timer, &expirations, sizeof expirations) != sizeof expirations)
+        return;
+
+    auto const time = now();
+
+    try
+    {
+        // Records due at the same time (or that we've fallen behind on) are sent together
+        while (replaying && due(next) <= time)
+        {
+            replay(next, due(next));
+            read_next();
+        }
+    }
+    catch (std::exception const& error)
+    {
+        log_error("Input replay stopped: %s", error.what());
+        replaying = false;
+    }
+}
+
+void mir_replay::Platform::replay(recording::Record const& record, std::chrono::nanoseconds timestamp)
+{
+    auto const existing = devices.find(record.device);
+
+    switch (record.type)
+    {
+    case mir_rec::RecordType::device_added:
+    {
+        if (existing != end(devices))
+        {
+            registry->remove_device(existing->second);
+            devices.erase(existing);
+        }
+
+        auto const device = std::make_shared<ReplayDevice>(record.info);
+        devices[record.device] = device;
+        registry->add_device(device);
+        break;
+    }
+
+    case mir_rec::RecordType::device_removed:
+        if (existing != end(devices))
+        {
+            registry->remove_device(existing->second);
+            devices.erase(existing);
+        }
+        break;
+
+    default:
+        if (existing != end(devices))
+            existing->second->replay(record, timestamp);
+        break;
+    }
+}
+
+void mir_replay::Platform::read_next()
+{
+    replaying = reader->read(next);
+
+    if (replaying)
+        set_timer(due(next));
+    else
+        log_info("Finished replaying %s", recording_path.c_str());
+}
+
+auto mir_replay::Platform::due(recording::Record const& record) const -> std::chrono::nanoseconds
+{
+    return started + std::chrono::duration_cast<std::chrono::nanoseconds>(record.time / speed);
+}
+
+void mir_replay::Platform::set_timer(std::chrono::nanoseconds time)
+{
+    // The timer is absolute, and a time of zero disarms it
+    itimerspec const spec{
+        {0, 0},
+        {static_cast<time_t>(time.count() / 1000000000), static_cast<long>(time.count() % 1000000000)}};
+
+    timerfd_settime(timer, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+void mir_replay::Platform::remove_devices()
+{
+    for (auto const& device : devices)
+        registry->remove_device(device.second);
+
+    devices.clear();
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_REPLAY_PLATFORM_H_
+#define MIR_INPUT_REPLAY_PLATFORM_H_
+
+#include "mir/input/platform.h"
+#include "mir/input/input_recording.h"
+#include "mir/fd.h"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace mir
+{
+namespace dispatch
+{
+class MultiplexingDispatchable;
+class ReadableFd;
+}
+namespace input
+{
+class InputDeviceRegistry;
+namespace replay
+{
+class ReplayDevice;
+
+/**
+ * Replays an input recording (see mir/input/input_recording.h): adds and
+ * removes its devices and sends their events with the recorded timing,
+ * optionally sped up.
+ *
+ * The recording is read as it is replayed. Each time start() is called the
+ * replay begins again from the start of the recording.
+ */
+class Platform : public input::Platform
+{
+public:
+    Platform(
+        std::shared_ptr<InputDeviceRegistry> const& registry,
+        std::string const& recording_path,
+        double speed);
+    ~Platform();
+
+    std::shared_ptr<mir::dispatch::Dispatchable> dispatchable() override;
+    void start() override;
+    void stop() override;
+    void pause_for_config() override;
+    void continue_after_config() override;
+
+private:
+    void replay_due_records();
+    void replay(recording::Record const& record, std::chrono::nanoseconds timestamp);
+    void read_next();
+    auto due(recording::Record const& record) const -> std::chrono::nanoseconds;
+    void set_timer(std::chrono::nanoseconds time);
+    void remove_devices();
+
+    std::shared_ptr<InputDeviceRegistry> const registry;
+    std::string const recording_path;
+    double const speed;
+    std::shared_ptr<dispatch::MultiplexingDispatchable> const platform_dispatchable;
+    Fd const timer;
+    std::shared_ptr<dispatch::ReadableFd> const timer_dispatchable;
+
+    std::ifstream recording;
+    std::unique_ptr<recording::Reader> reader;
+    recording::Record next;
+    bool replaying{false};
+    std::chrono::nanoseconds started;
+
+    std::unordered_map<int, std::shared_ptr<ReplayDevice>> devices;
+};
+}
+}
+}
+
+#endif
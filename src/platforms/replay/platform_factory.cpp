@@ -0,0 +1,75 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "platform.h"
+#include "mir/options/configuration.h"
+#include "mir/options/option.h"
+#include "mir/assert_module_entry_point.h"
+#include "mir/libname.h"
+
+namespace mo = mir::options;
+namespace mi = mir::input;
+
+namespace
+{
+mir::ModuleProperties const description = {
+    "mir:input-replay",
+    MIR_VERSION_MAJOR,
+    MIR_VERSION_MINOR,
+    MIR_VERSION_MICRO,
+    mir::libname()
+};
+}
+
+mir::UniqueModulePtr<mi::Platform> create_input_platform(
+    mo::Option const& options,
+    std::shared_ptr<mir::EmergencyCleanupRegistry> const& /*emergency_cleanup_registry*/,
+    std::shared_ptr<mi::InputDeviceRegistry> const& input_device_registry,
+    std::shared_ptr<mir::ConsoleServices> const& /*console*/,
+    std::shared_ptr<mi::InputReport> const& /*report*/)
+{
+    mir::assert_entry_point_signature<mi::CreatePlatform>(&create_input_platform);
+    return mir::make_module_ptr<mi::replay::Platform>(
+        input_device_registry,
+        options.get<std::string>(mo::input_replay_opt),
+        options.get<double>(mo::input_replay_speed_opt));
+}
+
+void add_input_platform_options(
+    boost::program_options::options_description& /*config*/)
+{
+    mir::assert_entry_point_signature<mi::AddPlatformOptions>(&add_input_platform_options);
+    // input-replay and input-replay-speed are server options
+}
+
+mi::PlatformPriority probe_input_platform(
+    mo::Option const& options,
+    mir::ConsoleServices& /*console*/)
+{
+    mir::assert_entry_point_signature<mi::ProbePlatform>(&probe_input_platform);
+
+    // Replaces the real devices only when asked to
+    if (options.is_set(mo::input_replay_opt))
+        return mi::PlatformPriority::best;
+
+    return mi::PlatformPriority::unsupported;
+}
+
+mir::ModuleProperties const* describe_input_module()
+{
+    mir::assert_entry_point_signature<mi::DescribeModule>(&describe_input_module);
+    return &description;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "replay_device.h"
+
+#include "mir/input/input_recording.h"
+#include "mir/input/input_sink.h"
+#include "mir/input/event_builder.h"
+#include "mir/input/touchpad_settings.h"
+
+namespace mi = mir::input;
+namespace mir_rec = mir::input::recording;
+namespace mir_replay = mir::input::replay;
+
+mir_replay::ReplayDevice::ReplayDevice(InputDeviceInfo const& info) :
+    info(info)
+{
+}
+
+void mir_replay::ReplayDevice::replay(recording::Record const& record, std::chrono::nanoseconds timestamp)
+{
+    if (!sink)
+        return;
+
+    switch (record.type)
+    {
+    case mir_rec::RecordType::key:
+        sink->handle_input(builder->key_event(timestamp, record.key_action, record.keysym, record.scan_code));
+        break;
+
+    case mir_rec::RecordType::pointer:
+        sink->handle_input(builder->pointer_event(
+            timestamp, record.pointer_action, record.buttons,
+            record.hscroll, record.vscroll, record.dx, record.dy));
+        break;
+
+    case mir_rec::RecordType::touch:
+        sink->handle_input(builder->touch_event(timestamp, record.contacts));
+        break;
+
+    default:
+        break;
+    }
+}
+
+void mir_replay::ReplayDevice::start(InputSink* destination, EventBuilder* builder)
+{
+    sink = destination;
+    this->builder = builder;
+}
+
+void mir_replay::ReplayDevice::stop()
+{
+    sink = nullptr;
+    builder = nullptr;
+}
+
+mi::InputDeviceInfo mir_replay::ReplayDevice::get_device_info()
+{
+    return info;
+}
+
+mir::optional_value<mi::PointerSettings> mir_replay::ReplayDevice::get_pointer_settings() const
+{
+    if (!contains(info.capabilities, DeviceCapability::pointer))
+        return {};
+
+    return pointer_settings;
+}
+
+void mir_replay::ReplayDevice::apply_settings(PointerSettings const& settings)
+{
+    pointer_settings = settings;
+}
+
+mir::optional_value<mi::TouchpadSettings> mir_replay::ReplayDevice::get_touchpad_settings() const
+{
+    if (!contains(info.capabilities, DeviceCapability::touchpad))
+        return {};
+
+    return TouchpadSettings{};
+}
+
+void mir_replay::ReplayDevice::apply_settings(TouchpadSettings const&)
+{
+}
+
+mir::optional_value<mi::TouchscreenSettings> mir_replay::ReplayDevice::get_touchscreen_settings() const
+{
+    if (!contains(info.capabilities, DeviceCapability::touchscreen))
+        return {};
+
+    return touchscreen_settings;
+}
+
+void mir_replay::ReplayDevice::apply_settings(TouchscreenSettings const& settings)
+{
+    touchscreen_settings = settings;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_REPLAY_REPLAY_DEVICE_H_
+#define MIR_INPUT_REPLAY_REPLAY_DEVICE_H_
+
+#include "mir/input/input_device.h"
+#include "mir/input/input_device_info.h"
+#include "mir/input/pointer_settings.h"
+#include "mir/input/touchscreen_settings.h"
+
+#include <chrono>
+
+namespace mir
+{
+namespace input
+{
+namespace recording
+{
+struct Record;
+}
+namespace replay
+{
+/// A device of an input recording, which sends the recorded events as they are replayed
+class ReplayDevice : public InputDevice
+{
+public:
+    explicit ReplayDevice(InputDeviceInfo const& info);
+
+    /// Sends the event of a key, pointer or touch record, if the device has been started
+    void replay(recording::Record const& record, std::chrono::nanoseconds timestamp);
+
+    void start(InputSink* destination, EventBuilder* builder) override;
+    void stop() override;
+
+    InputDeviceInfo get_device_info() override;
+
+    optional_value<PointerSettings> get_pointer_settings() const override;
+    void apply_settings(PointerSettings const&) override;
+
+    optional_value<TouchpadSettings> get_touchpad_settings() const override;
+    void apply_settings(TouchpadSettings const&) override;
+
+    optional_value<TouchscreenSettings> get_touchscreen_settings() const override;
+    void apply_settings(TouchscreenSettings const&) override;
+
+private:
+    InputDeviceInfo const info;
+    InputSink* sink{nullptr};
+    EventBuilder* builder{nullptr};
+
+    // The recorded events were already shaped by the settings, so these are only kept
+    PointerSettings pointer_settings;
+    TouchscreenSettings touchscreen_settings;
+};
+}
+}
+}
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "program_binary_cache.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+
+#include <unistd.h>
+
+namespace mrg = mir::renderer::gl;
+namespace bfs = boost::filesystem;
+
+namespace
+{
+// Bump if the file layout changes
+char const file_magic[] = "MIRGLPB1";
+
+// The full key is kept in the file, so a hash collision is only a miss
+struct Header
+{
+    char magic[sizeof file_magic];
+    uint32_t key_size;
+    uint32_t format;
+};
+}
+
+mrg::ProgramBinaryCache::ProgramBinaryCache(std::string const& directory) :
+    directory{directory}
+{
+}
+
+std::string mrg::ProgramBinaryCache::default_directory()
+{
+    if (auto const cache_home = getenv("XDG_CACHE_HOME"))
+    {
+        if (*cache_home)
+            return std::string{cache_home} + "/mir/gl-programs";
+    }
+
+    if (auto const home = getenv("HOME"))
+    {
+        if (*home)
+            return std::string{home} + "/.cache/mir/gl-programs";
+    }
+
+    return {};
+}
+
+std::string mrg::ProgramBinaryCache::path_for(std::string const& key) const
+{
+    char name[32];
+    snprintf(name, sizeof name, "%016zx", std::hash<std::string>{}(key));
+    return directory + "/" + name;
+}
+
+bool mrg::ProgramBinaryCache::load(std::string const& key, GLenum& format, std::vector<char>& binary) const
+{
+    std::ifstream file{path_for(key), std::ios::binary};
+
+    Header header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof header) ||
+        memcmp(header.magic, file_magic, sizeof file_magic) != 0 ||
+        header.key_size != key.size())
+    {
+        return false;
+    }
+
+    std::string stored_key(header.key_size, '\0');
+    if (!file.read(&stored_key[0], stored_key.size()) || stored_key != key)
+        return false;
+
+    std::vector<char> const contents{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    if (file.bad() || contents.empty())
+        return false;
+
+    format = header.format;
+    binary = contents;
+    return true;
+}
+
+void mrg::ProgramBinaryCache::store(std::string const& key, GLenum format, std::vector<char> const& binary) const
+{
+    boost::system::error_code ignored;
+    bfs::create_directories(directory, ignored);
+
+    Header header;
+    memcpy(header.magic, file_magic, sizeof file_magic);
+    header.key_size = key.size();
+    header.format = format;
+
+    // Write a private file and rename it into place, so that other servers
+    // never see a partly written binary
+    auto const path = path_for(key);
+    auto const temporary = path + "." + std::to_string(getpid()) + ".tmp";
+
+    {
+        std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<char const*>(&header), sizeof header);
+        file.write(key.data(), key.size());
+        file.write(binary.data(), binary.size());
+        file.close();
+
+        if (!file)
+        {
+            bfs::remove(temporary, ignored);
+            return;
+        }
+    }
+
+    boost::system::error_code renamed;
+    bfs::rename(temporary, path, renamed);
+    if (renamed)
+        bfs::remove(temporary, ignored);
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_GL_PROGRAM_BINARY_CACHE_H_
+#define MIR_RENDERER_GL_PROGRAM_BINARY_CACHE_H_
+
+#include MIR_SERVER_GL_H
+#include <string>
+#include <vector>
+
+namespace mir
+{
+namespace renderer
+{
+namespace gl
+{
+
+/**
+ * Keeps linked program binaries (as returned by glGetProgramBinary) on disk,
+ * so that later runs of the server can skip compiling their shaders.
+ *
+ * Entries are looked up by a key that must identify everything the binary
+ * depends on: the driver and its version as well as the shader sources.
+ * A binary from a different driver is never returned, but the driver may
+ * still reject one (e.g. after an in-place upgrade), so callers must be
+ * prepared to fall back to compiling.
+ *
+ * Failing to read or write the cache is never an error.
+ */
+class ProgramBinaryCache
+{
+public:
+    explicit ProgramBinaryCache(std::string const& directory);
+
+    /// $XDG_CACHE_HOME/mir/gl-programs, or "" if there is no cache home
+    static std::string default_directory();
+
+    bool load(std::string const& key, GLenum& format, std::vector<char>& binary) const;
+    void store(std::string const& key, GLenum format, std::vector<char> const& binary) const;
+
+private:
+    std::string path_for(std::string const& key) const;
+
+    std::string const directory;
+};
+
+}
+}
+}
+
+#endif // MIR_RENDERER_GL_PROGRAM_BINARY_CACHE_H_
@@ -17,9 +17,14 @@
  */
 
 #include "program_family.h"
+#include "program_binary_cache.h"
 #include MIR_SERVER_GL_H
 #include MIR_SERVER_GLEXT_H
+#include <EGL/egl.h>
+#include <cstring>
 #include <mutex>
+#include <stdexcept>
+#include <vector>
 
 namespace mir
 {
@@ -28,6 +33,31 @@ namespace renderer
 namespace gl
 {
 
+namespace
+{
+// From GL_OES_get_program_binary / GL_ARB_get_program_binary, which not
+// every build's headers provide
+GLenum const program_binary_length = 0x8741;
+GLenum const num_program_binary_formats = 0x87FE;
+GLenum const program_binary_retrievable_hint = 0x8257;
+
+std::string gl_string(GLenum name)
+{
+    auto const value = reinterpret_cast<char const*>(glGetString(name));
+    return value ? value : "";
+}
+
+bool has_extension(std::string const& extensions, char const* extension)
+{
+    return (" " + extensions + " ").find(std::string{" "} + extension + " ") != std::string::npos;
+}
+}
+
+ProgramFamily::ProgramFamily(std::shared_ptr<ProgramBinaryCache> const& binary_cache)
+    : binary_cache{binary_cache}
+{
+}
+
 void ProgramFamily::Shader::init(GLenum type, const GLchar* src)
 {
     if (!id)
@@ -89,35 +119,129 @@ GLuint ProgramFamily::add_program(const GLchar* const vshader_src,
     static std::mutex lp1416482_mutex;
     std::lock_guard<decltype(lp1416482_mutex)> lock{lp1416482_mutex};
 
+    auto& p = program[{vshader_src, fshader_src}];
+    if (p.id)
+        return p.id;
+
+    std::string key;
+    if (binary_cache)
+    {
+        if (!binary_entry_points_resolved)
+        {
+            binary_entry_points_resolved = true;
+
+            GLint formats = 0;
+            glGetIntegerv(num_program_binary_formats, &formats);
+
+            auto const extensions = gl_string(GL_EXTENSIONS);
+            char const* suffix = nullptr;
+            if (has_extension(extensions, "GL_OES_get_program_binary"))
+                suffix = "OES";
+            else if (has_extension(extensions, "GL_ARB_get_program_binary"))
+                suffix = "";
+
+            if (suffix && formats > 0)
+            {
+                get_program_binary = reinterpret_cast<decltype(get_program_binary)>(
+                    eglGetProcAddress((std::string{"glGetProgramBinary"} + suffix).c_str()));
+                program_binary = reinterpret_cast<decltype(program_binary)>(
+                    eglGetProcAddress((std::string{"glProgramBinary"} + suffix).c_str()));
+
+                // ARB only promises a retrievable binary if asked before linking
+                if (!*suffix)
+                {
+                    program_parameteri = reinterpret_cast<decltype(program_parameteri)>(
+                        eglGetProcAddress("glProgramParameteri"));
+                    if (!program_parameteri)
+                        get_program_binary = nullptr;
+                }
+            }
+
+            driver = gl_string(GL_VENDOR) + '\n' +
+                     gl_string(GL_RENDERER) + '\n' +
+                     gl_string(GL_VERSION) + '\n';
+        }
+
+        if (get_program_binary && program_binary)
+        {
+            key = driver + vshader_src + '\0' + fshader_src;
+            p.id = load_binary(key);
+            if (p.id)
+                return p.id;
+        }
+    }
+
     auto& v = vshader[vshader_src];
     if (!v.id) v.init(GL_VERTEX_SHADER, vshader_src);
 
     auto& f = fshader[fshader_src];
     if (!f.id) f.init(GL_FRAGMENT_SHADER, fshader_src);
 
-    auto& p = program[{v.id, f.id}];
-    if (!p.id)
+    p.id = glCreateProgram();
+    if (!key.empty() && program_parameteri)
+        program_parameteri(p.id, program_binary_retrievable_hint, GL_TRUE);
+    glAttachShader(p.id, v.id);
+    glAttachShader(p.id, f.id);
+    glLinkProgram(p.id);
+    GLint ok;
+    glGetProgramiv(p.id, GL_LINK_STATUS, &ok);
+    if (!ok)
     {
-        p.id = glCreateProgram();
-        glAttachShader(p.id, v.id);
-        glAttachShader(p.id, f.id);
-        glLinkProgram(p.id);
-        GLint ok;
-        glGetProgramiv(p.id, GL_LINK_STATUS, &ok);
-        if (!ok)
-        {
-            GLchar log[1024];
-            glGetProgramInfoLog(p.id, sizeof log - 1, NULL, log);
-            log[sizeof log - 1] = '\0';
-            glDeleteShader(p.id);
-            p.id = 0;
-            throw std::runtime_error(std::string("Link failed: ")+log);
-        }
+        GLchar log[1024];
+        glGetProgramInfoLog(p.id, sizeof log - 1, NULL, log);
+        log[sizeof log - 1] = '\0';
+        glDeleteShader(p.id);
+        p.id = 0;
+        throw std::runtime_error(std::string("Link failed: ")+log);
     }
 
+    if (!key.empty())
+        store_binary(key, p.id);
+
     return p.id;
 }
 
+GLuint ProgramFamily::load_binary(std::string const& key)
+{
+    GLenum format;
+    std::vector<char> binary;
+    if (!binary_cache->load(key, format, binary))
+        return 0;
+
+    auto const id = glCreateProgram();
+    program_binary(id, format, binary.data(), binary.size());
+
+    // The driver may refuse a binary from before it was upgraded, in which
+    // case we compile as usual and replace it
+    GLint ok = GL_FALSE;
+    glGetProgramiv(id, GL_LINK_STATUS, &ok);
+    if (!ok)
+    {
+        glDeleteProgram(id);
+        return 0;
+    }
+
+    return id;
+}
+
+void ProgramFamily::store_binary(std::string const& key, GLuint id)
+{
+    GLint length = 0;
+    glGetProgramiv(id, program_binary_length, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    get_program_binary(id, length, &written, &format, binary.data());
+    if (written <= 0)
+        return;
+
+    binary.resize(written);
+    binary_cache->store(key, format, binary);
+}
+
 }
 }
 }
@@ -20,6 +20,8 @@
 #define MIR_RENDERER_GL_PROGRAM_FAMILY_H_
 
 #include MIR_SERVER_GL_H
+#include <memory>
+#include <string>
 #include <utility>
 #include <map>
 #include <unordered_map>
@@ -30,6 +32,7 @@ namespace renderer
 {
 namespace gl
 {
+class ProgramBinaryCache;
 
 /**
  * ProgramFamily represents a set of GLSL programs that are closely
@@ -38,11 +41,14 @@ namespace gl
  *   A secondary intention is that this class may be extended to allow the
  * different programs within the family to share common patterns of uniform
  * usage too.
+ *   If given a ProgramBinaryCache, and the driver supports
+ * GL_OES_get_program_binary or GL_ARB_get_program_binary, linked programs are
+ * loaded from and saved to it rather than compiled from source each time.
  */
 class ProgramFamily
 {
 public:
-    ProgramFamily() = default;
+    explicit ProgramFamily(std::shared_ptr<ProgramBinaryCache> const& binary_cache = nullptr);
     ProgramFamily(ProgramFamily const&) = delete;
     ProgramFamily& operator=(ProgramFamily const&) = delete;
     ~ProgramFamily() noexcept;
@@ -59,12 +65,23 @@ private:
     typedef std::unordered_map<const GLchar*, Shader> ShaderMap;
     ShaderMap vshader, fshader;
 
-    typedef std::pair<GLuint, GLuint> ShaderPair;
+    // Keyed by source, as a program loaded from a binary has no shaders
+    typedef std::pair<const GLchar*, const GLchar*> SourcePair;
     struct Program
     {
         GLuint id = 0;
     };
-    std::map<ShaderPair, Program> program;
+    std::map<SourcePair, Program> program;
+
+    GLuint load_binary(std::string const& key);
+    void store_binary(std::string const& key, GLuint id);
+
+    std::shared_ptr<ProgramBinaryCache> const binary_cache;
+    bool binary_entry_points_resolved = false;
+    std::string driver;
+    void (*get_program_binary)(GLuint, GLsizei, GLsizei*, GLenum*, void*) = nullptr;
+    void (*program_binary)(GLuint, GLenum, const void*, GLint) = nullptr;
+    void (*program_parameteri)(GLuint, GLenum, GLint) = nullptr;
 };
 
 }
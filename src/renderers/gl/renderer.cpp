@@ -24,6 +24,7 @@
 #include "mir/graphics/renderable.h"
 #include "mir/graphics/buffer.h"
 #include "mir/graphics/display_buffer.h"
+#include "mir/graphics/surface_layer.h"
 #include "mir/gl/tessellation_helpers.h"
 #include "mir/gl/texture_cache.h"
 #include "mir/gl/texture.h"
@@ -36,14 +37,108 @@
 #include <EGL/egl.h>
 
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 #include <stdexcept>
 #include <cmath>
+#include <limits>
+#include <tuple>
 
 namespace mg = mir::graphics;
 namespace mgl = mir::gl;
 namespace mrg = mir::renderer::gl;
 namespace geom = mir::geometry;
 
+namespace
+{
+// How many composited frames a layer must go unchanged for before it is
+// worth flattening: layers updating more often than this cost an extra draw.
+long long const settle_frames{30};
+
+mg::Renderable::ID surface_of(mg::Renderable const& renderable)
+{
+    auto const layer = dynamic_cast<mg::SurfaceLayer const*>(&renderable);
+    return layer ? layer->surface_id() : nullptr;
+}
+
+/*
+ * Here we provide a 3D perspective projection with a default 30 degrees
+ * vertical field of view. This projection matrix is carefully designed
+ * such that any vertices at depth z=0 will fit the screen coordinates. So
+ * client texels will fit screen pixels perfectly as long as the surface is
+ * at depth zero. But if you want to do anything fancy, you can also choose
+ * a different depth and it will appear to come out of or go into the
+ * screen.
+ */
+glm::mat4 screen_to_gl_coords_for(geom::Rectangle const& rect)
+{
+    auto screen_to_gl_coords = glm::translate(glm::mat4(1.0f), glm::vec3{-1.0f, 1.0f, 0.0f});
+
+    /*
+     * Perspective division is one thing that can't be done in a matrix
+     * multiplication. It happens after the matrix multiplications. GL just
+     * scales {x,y} by 1/w. So modify the final part of the projection matrix
+     * to set w ([3]) to be the incoming z coordinate ([2]).
+     */
+    screen_to_gl_coords[2][3] = -1.0f;
+
+    float const vertical_fov_degrees = 30.0f;
+    float const near =
+        (rect.size.height.as_int() / 2.0f) /
+        std::tan((vertical_fov_degrees * M_PI / 180.0f) / 2.0f);
+    float const far = -near;
+
+    screen_to_gl_coords = glm::scale(screen_to_gl_coords,
+            glm::vec3{2.0f / rect.size.width.as_int(),
+                      -2.0f / rect.size.height.as_int(),
+                      2.0f / (near - far)});
+    return glm::translate(screen_to_gl_coords,
+            glm::vec3{-rect.top_left.x.as_int(),
+                      -rect.top_left.y.as_int(),
+                      0.0f});
+}
+}
+
+struct mrg::Renderer::FlattenedLayers
+{
+    FlattenedLayers(geom::Size const& size) :
+        size{size}
+    {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.width.as_int(), size.height.as_int(),
+                     0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+        complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    ~FlattenedLayers()
+    {
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteTextures(1, &texture);
+    }
+
+    FlattenedLayers(FlattenedLayers const&) = delete;
+    FlattenedLayers& operator=(FlattenedLayers const&) = delete;
+
+    geom::Size const size;
+    GLuint texture{0};
+    GLuint fbo{0};
+    bool complete{false};
+
+    // What the texture holds: each layer, with the buffer and position (relative
+    // to the area) it was drawn with
+    geom::Rectangle area;
+    std::vector<std::tuple<mg::Renderable::ID, mg::BufferID, geom::Rectangle>> contents;
+    long long used_frameno{0};
+};
+
 mrg::CurrentRenderTarget::CurrentRenderTarget(mg::DisplayBuffer* display_buffer)
     : render_target{
         dynamic_cast<renderer::gl::RenderTarget*>(display_buffer->native_display_buffer())}
@@ -106,6 +201,18 @@ const GLchar* const mrg::Renderer::alpha_fshader =
     "}\n"
 };
 
+const GLchar* const mrg::Renderer::opaque_fshader =
+{   // For RGBX textures, whose alpha channel is possibly uninitialized
+    "#ifdef GL_ES\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "uniform sampler2D tex;\n"
+    "varying vec2 v_texcoord;\n"
+    "void main() {\n"
+    "   gl_FragColor = vec4(texture2D(tex, v_texcoord).rgb, 1.0);\n"
+    "}\n"
+};
+
 const GLchar* const mrg::Renderer::default_fshader =
 {   // This is the fastest fragment shader. Use it when you can.
     "#ifdef GL_ES\n"
@@ -132,12 +239,26 @@ mrg::Renderer::Program::Program(GLuint program_id)
 }
 
 mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
+    : Renderer(display_buffer,
+               mgl::DefaultProgramFactory().create_texture_cache(),
+               std::make_shared<ProgramFamily>())
+{
+}
+
+mrg::Renderer::Renderer(
+    graphics::DisplayBuffer& display_buffer,
+    std::shared_ptr<mgl::TextureCache> const& texture_cache,
+    std::shared_ptr<ProgramFamily> const& family,
+    bool flatten_layers)
     : render_target(&display_buffer),
       clear_color{0.0f, 0.0f, 0.0f, 0.0f},
-      default_program(family.add_program(vshader, default_fshader)),
-      alpha_program(family.add_program(vshader, alpha_fshader)),
-      texture_cache(mgl::DefaultProgramFactory().create_texture_cache()),
-      display_transform(1)
+      family(family),
+      default_program(family->add_program(vshader, default_fshader)),
+      alpha_program(family->add_program(vshader, alpha_fshader)),
+      opaque_program(family->add_program(vshader, opaque_fshader)),
+      texture_cache(texture_cache),
+      display_transform(1),
+      flatten_layers(flatten_layers)
 {
     eglBindAPI(MIR_SERVER_EGL_OPENGL_API);
     EGLDisplay disp = eglGetCurrentDisplay();
@@ -170,7 +291,6 @@ mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
         mir::log_info(std::string(s.label) + ": " + (val ? val : ""));
     }
 
-    GLint max_texture_size = 0;
     glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
     mir::log_info("GL max texture size = %d", max_texture_size);
 
@@ -203,28 +323,240 @@ void mrg::Renderer::tessellate(std::vector<mgl::Primitive>& primitives,
 
 void mrg::Renderer::render(mg::RenderableList const& renderables) const
 {
+    ++frameno;
+
+    // Flattening draws to other framebuffers, so happens before we start on this one
+    auto const runs = flatten_settled_layers(renderables);
+
     render_target.bind();
 
     glClearColor(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
     glClear(GL_COLOR_BUFFER_BIT);
 
-    ++frameno;
-    for (auto const& r : renderables)
-        draw(*r, r->alpha() < 1.0f ? alpha_program : default_program);
+    auto run = runs.begin();
+    for (size_t i = 0; i != renderables.size();)
+    {
+        if (run != runs.end() && run->begin == i)
+        {
+            draw(*run->flattened);
+            i = run->end;
+            ++run;
+        }
+        else
+        {
+            auto const& r = renderables[i++];
+            draw(*r, r->alpha() < 1.0f ? alpha_program : default_program);
+        }
+    }
 
     render_target.swap_buffers();
 
     // Deleting unused textures only requires the GL context. This clean-up
     // does not affect screen contents so can happen after swap_buffers...
     texture_cache->drop_unused();
+    for (auto i = flattened_layers.begin(); i != flattened_layers.end();)
+    {
+        if (i->second->used_frameno != frameno)
+            i = flattened_layers.erase(i);
+        else
+            ++i;
+    }
 
     while (auto const gl_error = glGetError())
         mir::log_debug("GL error: %d", gl_error);
 }
 
-void mrg::Renderer::draw(mg::Renderable const& renderable,
-                          Renderer::Program const& prog) const
+std::vector<mrg::Renderer::LayerRun>
+mrg::Renderer::flatten_settled_layers(mg::RenderableList const& renderables) const
+{
+    std::vector<LayerRun> runs;
+    if (!flatten_layers)
+        return runs;
+
+    // A layer has settled when its buffer hasn't changed for a while
+    std::vector<bool> settled(renderables.size());
+    for (size_t i = 0; i != renderables.size(); ++i)
+    {
+        auto const& renderable = *renderables[i];
+        if (!surface_of(renderable))
+            continue;
+
+        auto const buffer = renderable.buffer()->id();
+        auto& history = layer_history[renderable.id()];
+        if (history.seen_frameno == 0 || history.buffer != buffer)
+        {
+            history.buffer = buffer;
+            history.changed_frameno = frameno;
+        }
+        history.seen_frameno = frameno;
+
+        // Only opaque, untransformed layers look the same drawn via a texture
+        settled[i] = renderable.alpha() == 1.0f &&
+                     renderable.transformation() == glm::mat4(1) &&
+                     frameno - history.changed_frameno >= settle_frames;
+    }
+
+    for (auto i = layer_history.begin(); i != layer_history.end();)
+    {
+        if (i->second.seen_frameno != frameno)
+            i = layer_history.erase(i);
+        else
+            ++i;
+    }
+
+    for (size_t begin = 0; begin != renderables.size();)
+    {
+        auto end = begin + 1;
+        if (settled[begin])
+        {
+            auto const surface = surface_of(*renderables[begin]);
+            while (end != renderables.size() && settled[end] && surface_of(*renderables[end]) == surface)
+                ++end;
+
+            if (end - begin > 1)
+            {
+                if (auto const flattened = flatten(renderables, begin, end))
+                    runs.push_back({begin, end, flattened});
+            }
+        }
+        begin = end;
+    }
+
+    return runs;
+}
+
+mrg::Renderer::FlattenedLayers const* mrg::Renderer::flatten(
+    mg::RenderableList const& renderables, size_t begin, size_t end) const
+{
+    decltype(FlattenedLayers::contents) contents;
+    GLfloat left{std::numeric_limits<GLfloat>::max()}, top{left};
+    GLfloat right{std::numeric_limits<GLfloat>::lowest()}, bottom{right};
+    for (auto i = begin; i != end; ++i)
+    {
+        auto const& renderable = *renderables[i];
+        contents.emplace_back(renderable.id(), renderable.buffer()->id(), renderable.screen_position());
+
+        // Shells may tessellate beyond (or bend) the surface, so bound what is actually drawn
+        primitives.clear();
+        tessellate(primitives, renderable);
+        for (auto const& p : primitives)
+        {
+            for (int v = 0; v != p.nvertices; ++v)
+            {
+                auto const& position = p.vertices[v].position;
+                if (position[2] != 0.0f)
+                    return nullptr;
+
+                left = std::min(left, position[0]);
+                right = std::max(right, position[0]);
+                top = std::min(top, position[1]);
+                bottom = std::max(bottom, position[1]);
+            }
+        }
+    }
+
+    if (left > right || top > bottom)
+        return nullptr;
+
+    auto const x = static_cast<int>(std::floor(left));
+    auto const y = static_cast<int>(std::floor(top));
+    geom::Rectangle const area{
+        {x, y}, {static_cast<int>(std::ceil(right)) - x, static_cast<int>(std::ceil(bottom)) - y}};
+    if (area.size.width.as_int() <= 0 || area.size.height.as_int() <= 0 ||
+        area.size.width.as_int() > max_texture_size || area.size.height.as_int() > max_texture_size)
+        return nullptr;
+
+    // Moving the layers together only moves the texture
+    for (auto& layer : contents)
+        std::get<2>(layer).top_left = geom::Point{} + (std::get<2>(layer).top_left - area.top_left);
+
+    auto& flattened = flattened_layers[std::get<0>(contents.front())];
+    if (!flattened || flattened->size != area.size)
+        flattened = std::make_unique<FlattenedLayers>(area.size);
+
+    // Keep even an unusable framebuffer while the run lasts, rather than reallocating it every frame
+    flattened->used_frameno = frameno;
+    if (!flattened->complete)
+        return nullptr;
+
+    if (flattened->contents == contents)
+    {
+        flattened->area = area;
+        return flattened.get();
+    }
+
+    GLint saved_viewport[4]{0, 0, 0, 0};
+    glGetIntegerv(GL_VIEWPORT, saved_viewport);
+    auto const saved_screen_to_gl_coords = screen_to_gl_coords;
+    auto const saved_display_transform = display_transform;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, flattened->fbo);
+    glViewport(0, 0, area.size.width.as_int(), area.size.height.as_int());
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    screen_to_gl_coords = screen_to_gl_coords_for(area);
+    display_transform = glm::mat4(1);
+    default_program.last_used_frameno = opaque_program.last_used_frameno = 0;
+
+    // The texture's alpha is used when drawing it, so mustn't be left uninitialized
+    for (auto i = begin; i != end; ++i)
+        draw(*renderables[i], renderables[i]->shaped() ? default_program : opaque_program);
+
+    screen_to_gl_coords = saved_screen_to_gl_coords;
+    display_transform = saved_display_transform;
+    default_program.last_used_frameno = opaque_program.last_used_frameno = 0;
+    glViewport(saved_viewport[0], saved_viewport[1], saved_viewport[2], saved_viewport[3]);
+
+    flattened->area = area;
+    flattened->contents = std::move(contents);
+    return flattened.get();
+}
+
+void mrg::Renderer::draw(FlattenedLayers const& flattened) const
+{
+    auto const& prog = default_program;
+    use_program(prog);
+
+    glActiveTexture(GL_TEXTURE0);
+
+    auto const& rect = flattened.area;
+    GLfloat const left = rect.top_left.x.as_int();
+    GLfloat const right = left + rect.size.width.as_int();
+    GLfloat const top = rect.top_left.y.as_int();
+    GLfloat const bottom = top + rect.size.height.as_int();
+    glUniform2f(prog.centre_uniform, (left + right) / 2.0f, (top + bottom) / 2.0f);
+    glUniformMatrix4fv(prog.transform_uniform, 1, GL_FALSE, glm::value_ptr(glm::mat4(1)));
+
+    // The texture was drawn bottom-up, unlike client buffers
+    mgl::Vertex const vertices[4] = {
+        {{left,  top,    0.0f}, {0.0f, 1.0f}},
+        {{left,  bottom, 0.0f}, {0.0f, 0.0f}},
+        {{right, top,    0.0f}, {1.0f, 1.0f}},
+        {{right, bottom, 0.0f}, {1.0f, 0.0f}}};
+
+    glEnableVertexAttribArray(prog.position_attr);
+    glEnableVertexAttribArray(prog.texcoord_attr);
+
+    glBindTexture(GL_TEXTURE_2D, flattened.texture);
+    glVertexAttribPointer(prog.position_attr, 3, GL_FLOAT,
+                          GL_FALSE, sizeof(mgl::Vertex),
+                          &vertices[0].position);
+    glVertexAttribPointer(prog.texcoord_attr, 2, GL_FLOAT,
+                          GL_FALSE, sizeof(mgl::Vertex),
+                          &vertices[0].texcoord);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA,
+                        GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glDisableVertexAttribArray(prog.texcoord_attr);
+    glDisableVertexAttribArray(prog.position_attr);
+}
+
+void mrg::Renderer::use_program(Renderer::Program const& prog) const
 {
     glUseProgram(prog.id);
     if (prog.last_used_frameno != frameno)
@@ -236,6 +568,12 @@ void mrg::Renderer::draw(mg::Renderable const& renderable,
         glUniformMatrix4fv(prog.screen_to_gl_coords_uniform, 1, GL_FALSE,
                            glm::value_ptr(screen_to_gl_coords));
     }
+}
+
+void mrg::Renderer::draw(mg::Renderable const& renderable,
+                          Renderer::Program const& prog) const
+{
+    use_program(prog);
 
     glActiveTexture(GL_TEXTURE0);
 
@@ -341,40 +679,7 @@ void mrg::Renderer::set_viewport(geometry::Rectangle const& rect)
     if (rect == viewport)
         return;
 
-    /*
-     * Here we provide a 3D perspective projection with a default 30 degrees
-     * vertical field of view. This projection matrix is carefully designed
-     * such that any vertices at depth z=0 will fit the screen coordinates. So
-     * client texels will fit screen pixels perfectly as long as the surface is
-     * at depth zero. But if you want to do anything fancy, you can also choose
-     * a different depth and it will appear to come out of or go into the
-     * screen.
-     */
-    screen_to_gl_coords = glm::translate(glm::mat4(1.0f), glm::vec3{-1.0f, 1.0f, 0.0f});
-
-    /*
-     * Perspective division is one thing that can't be done in a matrix
-     * multiplication. It happens after the matrix multiplications. GL just
-     * scales {x,y} by 1/w. So modify the final part of the projection matrix
-     * to set w ([3]) to be the incoming z coordinate ([2]).
-     */
-    screen_to_gl_coords[2][3] = -1.0f;
-
-    float const vertical_fov_degrees = 30.0f;
-    float const near =
-        (rect.size.height.as_int() / 2.0f) /
-        std::tan((vertical_fov_degrees * M_PI / 180.0f) / 2.0f);
-    float const far = -near;
-
-    screen_to_gl_coords = glm::scale(screen_to_gl_coords,
-            glm::vec3{2.0f / rect.size.width.as_int(),
-                      -2.0f / rect.size.height.as_int(),
-                      2.0f / (near - far)});
-    screen_to_gl_coords = glm::translate(screen_to_gl_coords,
-            glm::vec3{-rect.top_left.x.as_int(),
-                      -rect.top_left.y.as_int(),
-                      0.0f});
-
+    screen_to_gl_coords = screen_to_gl_coords_for(rect);
     viewport = rect;
     update_gl_viewport();
 }
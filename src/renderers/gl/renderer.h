@@ -29,6 +29,7 @@
 #include "mir/renderer/gl/render_target.h"
 
 #include MIR_SERVER_GL_H
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -60,6 +61,20 @@ class Renderer : public renderer::Renderer
 {
 public:
     Renderer(graphics::DisplayBuffer& display_buffer);
+    /**
+     * \param [in] texture_cache  May draw on textures shared with other
+     *                            renderers whose GL contexts are in the same
+     *                            share group
+     * \param [in] family         Programs for this renderer alone, as it sets
+     *                            their uniforms
+     * \param [in] flatten_layers Whether to draw the layers of a surface
+     *                            that have stopped changing from a single
+     *                            cached texture
+     */
+    Renderer(graphics::DisplayBuffer& display_buffer,
+             std::shared_ptr<mir::gl::TextureCache> const& texture_cache,
+             std::shared_ptr<ProgramFamily> const& family,
+             bool flatten_layers = false);
     virtual ~Renderer();
 
     // These are called with a valid GL context:
@@ -97,7 +112,7 @@ protected:
 
     mutable long long frameno = 0;
 
-    ProgramFamily family;
+    std::shared_ptr<ProgramFamily> const family;
     struct Program
     {
        GLuint id = 0;
@@ -113,23 +128,53 @@ protected:
 
        Program(GLuint program_id);
     };
-    Program default_program, alpha_program;
+    Program default_program, alpha_program, opaque_program;
 
     static const GLchar* const vshader;
     static const GLchar* const default_fshader;
     static const GLchar* const alpha_fshader;
+    static const GLchar* const opaque_fshader;
 
     virtual void draw(graphics::Renderable const& renderable,
                       Renderer::Program const& prog) const;
 
 private:
     void update_gl_viewport();
+    void use_program(Program const& prog) const;
 
-    std::unique_ptr<mir::gl::TextureCache> const texture_cache;
+    std::shared_ptr<mir::gl::TextureCache> const texture_cache;
     geometry::Rectangle viewport;
-    glm::mat4 screen_to_gl_coords;
-    glm::mat4 display_transform;
+    glm::mat4 mutable screen_to_gl_coords;
+    glm::mat4 mutable display_transform;
     std::vector<mir::gl::Primitive> mutable primitives;
+
+    /*
+     * Surfaces made of several layers (e.g. Wayland subsurfaces) cost a draw
+     * per layer. Runs of a surface's layers that have stopped changing are
+     * instead drawn once into a texture and drawn from that until one of
+     * them changes.
+     */
+    struct FlattenedLayers;
+    struct LayerHistory
+    {
+        graphics::BufferID buffer;
+        long long changed_frameno{0};
+        long long seen_frameno{0};
+    };
+    struct LayerRun
+    {
+        size_t begin, end;
+        FlattenedLayers const* flattened;
+    };
+
+    std::vector<LayerRun> flatten_settled_layers(graphics::RenderableList const& renderables) const;
+    FlattenedLayers const* flatten(graphics::RenderableList const& renderables, size_t begin, size_t end) const;
+    void draw(FlattenedLayers const& flattened) const;
+
+    bool const flatten_layers;
+    GLint max_texture_size = 0;
+    std::unordered_map<graphics::Renderable::ID, LayerHistory> mutable layer_history;
+    std::unordered_map<graphics::Renderable::ID, std::unique_ptr<FlattenedLayers>> mutable flattened_layers;
 };
 
 }
@@ -19,12 +19,35 @@
 #include "renderer_factory.h"
 #include "renderer.h"
 #include "mir/graphics/display_buffer.h"
+#include "mir/gl/shared_texture_cache.h"
 
 namespace mrg = mir::renderer::gl;
+namespace mgl = mir::gl;
+
+mrg::RendererFactory::RendererFactory(
+    std::shared_ptr<ProgramBinaryCache> const& binary_cache,
+    bool flatten_layers)
+    : binary_cache{binary_cache},
+      flatten_layers{flatten_layers}
+{
+}
 
 std::unique_ptr<mir::renderer::Renderer>
 mrg::RendererFactory::create_renderer_for(
     graphics::DisplayBuffer& display_buffer)
 {
-    return std::make_unique<Renderer>(display_buffer);
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto textures = shared_textures.lock();
+    if (!textures)
+    {
+        textures = std::make_shared<mgl::SharedTextureCache>();
+        shared_textures = textures;
+    }
+
+    // Each renderer sets its own uniforms, so needs its own program objects
+    auto const family = std::make_shared<ProgramFamily>(binary_cache);
+
+    return std::make_unique<Renderer>(
+        display_buffer, textures->create_texture_cache(), family, flatten_layers);
 }
@@ -21,18 +21,47 @@
 
 #include "mir/renderer/renderer_factory.h"
 
+#include <memory>
+#include <mutex>
+
 namespace mir
 {
+namespace gl { class SharedTextureCache; }
 namespace renderer
 {
 namespace gl
 {
+class ProgramBinaryCache;
 
 class RendererFactory : public renderer::RendererFactory
 {
 public:
+    /**
+     * \param [in] binary_cache    Where to keep compiled programs, if anywhere
+     * \param [in] flatten_layers  Whether renderers cache the settled layers
+     *                             of a surface in a single texture
+     */
+    explicit RendererFactory(
+        std::shared_ptr<ProgramBinaryCache> const& binary_cache = nullptr,
+        bool flatten_layers = false);
+
     std::unique_ptr<renderer::Renderer> create_renderer_for(
         graphics::DisplayBuffer& display_buffer) override;
+
+private:
+    /*
+     * The display buffers we render to all have GL contexts shared with
+     * their graphics::Display, so the renderers can share their textures.
+     * These live only as long as some renderer uses them, ensuring they are
+     * destroyed with a current context. Programs are not shared, as each
+     * renderer keeps its own uniform values in them; the binary cache spares
+     * all but the first renderer from compiling them where the driver
+     * supports it.
+     */
+    std::shared_ptr<ProgramBinaryCache> const binary_cache;
+    bool const flatten_layers;
+    std::mutex mutex;
+    std::weak_ptr<mir::gl::SharedTextureCache> shared_textures;
 };
 
 }
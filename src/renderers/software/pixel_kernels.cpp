@@ -0,0 +1,203 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pixel_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace mrs = mir::renderer::software;
+
+namespace
+{
+uint32_t const alpha_mask{0xff000000};
+
+inline uint32_t swap_red_blue(uint32_t pixel)
+{
+    return (pixel & 0xff00ff00) | ((pixel >> 16) & 0xff) | ((pixel & 0xff) << 16);
+}
+
+inline uint32_t prepare(uint32_t pixel, bool swap_rb, bool force_opaque)
+{
+    if (swap_rb)
+        pixel = swap_red_blue(pixel);
+    if (force_opaque)
+        pixel |= alpha_mask;
+    return pixel;
+}
+
+// x·a/255, rounded exactly, for x and a in [0, 255]
+inline uint32_t mul_div255(uint32_t x, uint32_t a)
+{
+    auto const t = x * a + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+inline uint32_t scale_pixel(uint32_t pixel, uint32_t a)
+{
+    return mul_div255(pixel & 0xff, a) |
+           mul_div255((pixel >> 8) & 0xff, a) << 8 |
+           mul_div255((pixel >> 16) & 0xff, a) << 16 |
+           mul_div255(pixel >> 24, a) << 24;
+}
+
+inline uint32_t over(uint32_t src, uint32_t dst)
+{
+    auto const src_alpha = src >> 24;
+    if (src_alpha == 0xff)
+        return src;
+
+    // Both are premultiplied, so no channel of the sum can overflow
+    return src + scale_pixel(dst, 0xff - src_alpha);
+}
+
+#ifdef __SSE2__
+inline __m128i swap_red_blue(__m128i pixels)
+{
+    auto const green_alpha = _mm_and_si128(pixels, _mm_set1_epi32(0xff00ff00));
+    auto const red = _mm_and_si128(_mm_srli_epi32(pixels, 16), _mm_set1_epi32(0xff));
+    auto const blue = _mm_slli_epi32(_mm_and_si128(pixels, _mm_set1_epi32(0xff)), 16);
+    return _mm_or_si128(green_alpha, _mm_or_si128(red, blue));
+}
+
+inline __m128i prepare(__m128i pixels, bool swap_rb, bool force_opaque)
+{
+    if (swap_rb)
+        pixels = swap_red_blue(pixels);
+    if (force_opaque)
+        pixels = _mm_or_si128(pixels, _mm_set1_epi32(alpha_mask));
+    return pixels;
+}
+
+// The same rounding as mul_div255(), on eight 16-bit channels at once
+inline __m128i mul_div255(__m128i x, __m128i a)
+{
+    auto const t = _mm_add_epi16(_mm_mullo_epi16(x, a), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// Each pixel's alpha, repeated across its four 16-bit channels
+inline __m128i broadcast_alpha(__m128i unpacked)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(unpacked, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+inline __m128i scale_pixels(__m128i pixels, __m128i a)
+{
+    auto const zero = _mm_setzero_si128();
+    auto const lo = mul_div255(_mm_unpacklo_epi8(pixels, zero), a);
+    auto const hi = mul_div255(_mm_unpackhi_epi8(pixels, zero), a);
+    return _mm_packus_epi16(lo, hi);
+}
+
+inline __m128i over(__m128i src, __m128i dst)
+{
+    auto const zero = _mm_setzero_si128();
+    auto const inverse = _mm_set1_epi16(0xff);
+
+    auto const src_lo = _mm_unpacklo_epi8(src, zero);
+    auto const src_hi = _mm_unpackhi_epi8(src, zero);
+    auto const dst_lo = mul_div255(_mm_unpacklo_epi8(dst, zero), _mm_sub_epi16(inverse, broadcast_alpha(src_lo)));
+    auto const dst_hi = mul_div255(_mm_unpackhi_epi8(dst, zero), _mm_sub_epi16(inverse, broadcast_alpha(src_hi)));
+
+    return _mm_packus_epi16(_mm_add_epi16(src_lo, dst_lo), _mm_add_epi16(src_hi, dst_hi));
+}
+#endif
+}
+
+void mrs::fill_row(uint32_t* dst, size_t count, uint32_t value)
+{
+    std::fill_n(dst, count, value);
+}
+
+void mrs::copy_row(uint32_t* dst, uint32_t const* src, size_t count, bool swap_rb, bool force_opaque)
+{
+    if (!swap_rb && !force_opaque)
+    {
+        memcpy(dst, src, count * sizeof(*dst));
+        return;
+    }
+
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 4 <= count; i += 4)
+    {
+        auto const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), prepare(pixels, swap_rb, force_opaque));
+    }
+#endif
+    for (; i != count; ++i)
+        dst[i] = prepare(src[i], swap_rb, force_opaque);
+}
+
+void mrs::blend_row(
+    uint32_t* dst, uint32_t const* src, size_t count,
+    bool swap_rb, bool force_opaque, uint8_t alpha)
+{
+    if (alpha == 0)
+        return;
+
+    if (alpha == 0xff && force_opaque)
+    {
+        copy_row(dst, src, count, swap_rb, force_opaque);
+        return;
+    }
+
+    size_t i = 0;
+#ifdef __SSE2__
+    auto const constant_alpha = _mm_set1_epi16(alpha);
+    for (; i + 4 <= count; i += 4)
+    {
+        auto pixels = prepare(_mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i)), swap_rb, force_opaque);
+        if (alpha != 0xff)
+            pixels = scale_pixels(pixels, constant_alpha);
+
+        // Whole runs of opaque or transparent pixels are common; skip the arithmetic
+        auto const alphas = _mm_and_si128(pixels, _mm_set1_epi32(alpha_mask));
+        auto const opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(alphas, _mm_set1_epi32(alpha_mask)));
+        auto const transparent = _mm_movemask_epi8(_mm_cmpeq_epi32(pixels, _mm_setzero_si128()));
+
+        auto const out = reinterpret_cast<__m128i*>(dst + i);
+        if (opaque == 0xffff)
+            _mm_storeu_si128(out, pixels);
+        else if (transparent != 0xffff)
+            _mm_storeu_si128(out, over(pixels, _mm_loadu_si128(out)));
+    }
+#endif
+    for (; i != count; ++i)
+    {
+        auto pixel = prepare(src[i], swap_rb, force_opaque);
+        if (alpha != 0xff)
+            pixel = scale_pixel(pixel, alpha);
+        dst[i] = over(pixel, dst[i]);
+    }
+}
+
+void mrs::copy_strided_row(uint32_t* dst, uint32_t const* src, ptrdiff_t step, size_t count)
+{
+    if (step == 1)
+    {
+        memcpy(dst, src, count * sizeof(*dst));
+        return;
+    }
+
+    for (size_t i = 0; i != count; ++i, src += step)
+        dst[i] = *src;
+}
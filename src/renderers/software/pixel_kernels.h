@@ -0,0 +1,65 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_SOFTWARE_PIXEL_KERNELS_H_
+#define MIR_RENDERER_SOFTWARE_PIXEL_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mir
+{
+namespace renderer
+{
+namespace software
+{
+/*
+ * Row operations on 32-bit pixels with alpha in the top byte, as in
+ * mir_pixel_format_argb_8888 and friends.
+ *
+ * swap_rb exchanges the red and blue channels of the source on the way (to
+ * draw an ABGR buffer onto an ARGB target, for example). force_opaque treats
+ * the source alpha as 0xff, for buffers whose alpha channel is undefined.
+ */
+
+/// dst = value
+void fill_row(uint32_t* dst, size_t count, uint32_t value);
+
+/// dst = src
+void copy_row(uint32_t* dst, uint32_t const* src, size_t count, bool swap_rb, bool force_opaque);
+
+/**
+ * dst = src·alpha + dst·(1 - src_alpha·alpha)
+ *
+ * Porter-Duff "over" for a premultiplied source, additionally faded by a
+ * constant alpha (0xff for none).
+ */
+void blend_row(
+    uint32_t* dst, uint32_t const* src, size_t count,
+    bool swap_rb, bool force_opaque, uint8_t alpha);
+
+/**
+ * dst[i] = src[i·step]
+ *
+ * A copy with an arbitrary (possibly negative) source pixel step, as used to
+ * rotate and reflect an image by 90° multiples.
+ */
+void copy_strided_row(uint32_t* dst, uint32_t const* src, ptrdiff_t step, size_t count);
+}
+}
+}
+
+#endif /* MIR_RENDERER_SOFTWARE_PIXEL_KERNELS_H_ */
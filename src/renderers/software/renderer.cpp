@@ -0,0 +1,409 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define MIR_LOG_COMPONENT "SoftwareRenderer"
+
+#include "renderer.h"
+#include "pixel_kernels.h"
+#include "mir/renderer/sw/render_target.h"
+#include "mir/renderer/sw/pixel_source.h"
+#include "mir/graphics/buffer.h"
+#include "mir/graphics/display_buffer.h"
+#include "mir/report_exception.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace mg = mir::graphics;
+namespace mrs = mir::renderer::software;
+namespace geom = mir::geometry;
+
+namespace
+{
+// Beyond this many rectangles, repainting their bounding box is cheaper
+size_t const max_damage_rectangles{8};
+// Buffers older than this are repainted in full
+unsigned int const max_tracked_buffer_age{4};
+
+struct FormatInfo
+{
+    bool supported;
+    bool red_in_low_byte;
+    bool has_alpha;
+};
+
+FormatInfo format_info(MirPixelFormat format)
+{
+    switch (format)
+    {
+    case mir_pixel_format_abgr_8888: return {true, true, true};
+    case mir_pixel_format_xbgr_8888: return {true, true, false};
+    case mir_pixel_format_argb_8888: return {true, false, true};
+    case mir_pixel_format_xrgb_8888: return {true, false, false};
+    default:                         return {false, false, false};
+    }
+}
+
+/*
+ * The output transformation is given GL-style, for y pointing up. Expressed
+ * for screen coordinates (y pointing down) the sense of rotations reverses.
+ */
+struct ScreenTransform
+{
+    explicit ScreenTransform(glm::mat2 const& t)
+        : a{static_cast<int>(std::lround(t[0][0]))},
+          b{-static_cast<int>(std::lround(t[1][0]))},
+          c{-static_cast<int>(std::lround(t[0][1]))},
+          d{static_cast<int>(std::lround(t[1][1]))}
+    {
+    }
+
+    bool swaps_axes() const { return a == 0; }
+
+    // (x', y') = (a·x + b·y, c·x + d·y), about the centre of the output
+    int a, b, c, d;
+};
+
+bool is_supported(glm::mat2 const& t)
+{
+    for (auto col = 0; col != 2; ++col)
+        for (auto row = 0; row != 2; ++row)
+            if (t[col][row] != 0.0f && std::abs(t[col][row]) != 1.0f)
+                return false;
+
+    return (t[0][0] == 0.0f) == (t[1][1] == 0.0f);
+}
+
+void add_clipped(geom::Rectangles& damage, geom::Rectangle const& rect, geom::Rectangle const& clip)
+{
+    auto const clipped = rect.intersection_with(clip);
+    if (clipped.size.width.as_int() > 0 && clipped.size.height.as_int() > 0)
+        damage.add(clipped);
+}
+}
+
+mrs::Renderer::Renderer(mg::DisplayBuffer& display_buffer)
+    : target{dynamic_cast<RenderTarget*>(display_buffer.native_display_buffer())}
+{
+    if (!target)
+        BOOST_THROW_EXCEPTION(std::logic_error("DisplayBuffer does not support software rendering"));
+
+    if (!format_info(target->pixel_format()).supported)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Unsupported pixel format for software rendering"));
+
+    set_viewport(display_buffer.view_area());
+}
+
+void mrs::Renderer::set_viewport(geom::Rectangle const& rect)
+{
+    if (rect == viewport)
+        return;
+
+    viewport = rect;
+    repaint_all = true;
+}
+
+void mrs::Renderer::set_output_transform(glm::mat2 const& t)
+{
+    if (t == output_transform)
+        return;
+
+    if (!is_supported(t))
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Software rendering only supports 90° output rotations and reflections"));
+
+    output_transform = t;
+    repaint_all = true;
+}
+
+void mrs::Renderer::suspend()
+{
+    // Whatever happens to the target meanwhile, we don't know about it
+    repaint_all = true;
+}
+
+void mrs::Renderer::render(mg::RenderableList const& renderables) const
+{
+    auto const transform = ScreenTransform{output_transform};
+    auto const target_size = target->size();
+    auto const logical_size = transform.swaps_axes() ?
+        geom::Size{target_size.height.as_int(), target_size.width.as_int()} :
+        target_size;
+
+    if (logical_size != canvas_size)
+    {
+        canvas_size = logical_size;
+        repaint_all = true;
+    }
+
+    std::vector<DrawnRenderable> frame;
+    frame.reserve(renderables.size());
+    for (auto const& r : renderables)
+        frame.push_back({r->id(), r->buffer()->id(), r->screen_position(), r->alpha(), r->shaped()});
+
+    geom::Rectangle const canvas_area{viewport.top_left, canvas_size};
+    auto const frame_damage = repaint_all ? geom::Rectangles{canvas_area} : damage_since_last_frame(frame);
+
+    auto const mapping = target->map_back_buffer();
+    auto const target_pixels = reinterpret_cast<uint32_t*>(mapping.pixels);
+    auto const target_stride = mapping.stride.as_int() / static_cast<ptrdiff_t>(sizeof(uint32_t));
+
+    bool const direct = output_transform == glm::mat2{1};
+
+    Canvas canvas;
+    geom::Rectangles repaint;
+    if (direct)
+    {
+        canvas = {target_pixels, target_stride, canvas_area};
+        repaint = damage_for_buffer_age(frame_damage, mapping.age);
+    }
+    else
+    {
+        // The shadow buffer always holds the previous frame
+        shadow.resize(canvas_size.width.as_int() * canvas_size.height.as_int());
+        canvas = {shadow.data(), canvas_size.width.as_int(), canvas_area};
+        repaint = frame_damage;
+    }
+
+    if (repaint.size() > max_damage_rectangles)
+        repaint = geom::Rectangles{repaint.bounding_rectangle()};
+
+    for (auto const& region : repaint)
+    {
+        auto const clip = region.intersection_with(canvas_area);
+        auto const width = clip.size.width.as_int();
+        auto row = canvas.pixels +
+            (clip.top().as_int() - canvas_area.top().as_int()) * canvas.stride +
+            (clip.left().as_int() - canvas_area.left().as_int());
+
+        for (auto y = 0; y != clip.size.height.as_int(); ++y, row += canvas.stride)
+            fill_row(row, width, 0);
+
+        for (auto const& r : renderables)
+            draw(canvas, clip, *r);
+    }
+
+    if (!direct)
+    {
+        auto target_damage = damage_for_buffer_age(frame_damage, mapping.age);
+        if (target_damage.size() > max_damage_rectangles)
+            target_damage = geom::Rectangles{target_damage.bounding_rectangle()};
+
+        for (auto const& region : target_damage)
+            transform_to_target(target_pixels, target_stride, region);
+    }
+
+    target->swap_buffers();
+
+    damage_history.push_front(frame_damage);
+    if (damage_history.size() > max_tracked_buffer_age)
+        damage_history.pop_back();
+
+    last_frame = std::move(frame);
+    repaint_all = false;
+}
+
+geom::Rectangles mrs::Renderer::damage_since_last_frame(std::vector<DrawnRenderable> const& frame) const
+{
+    geom::Rectangle const canvas_area{viewport.top_left, canvas_size};
+    geom::Rectangles damage;
+
+    std::unordered_map<mg::Renderable::ID, size_t> previous;
+    for (size_t i = 0; i != last_frame.size(); ++i)
+        previous[last_frame[i].id] = i;
+
+    for (size_t i = 0; i != frame.size(); ++i)
+    {
+        auto const& now = frame[i];
+        auto const was = previous.find(now.id);
+
+        if (was == previous.end())
+        {
+            add_clipped(damage, now.position, canvas_area);
+            continue;
+        }
+
+        auto const& before = last_frame[was->second];
+        if (was->second != i ||
+            before.buffer != now.buffer ||
+            before.position != now.position ||
+            before.alpha != now.alpha ||
+            before.shaped != now.shaped)
+        {
+            add_clipped(damage, before.position, canvas_area);
+            add_clipped(damage, now.position, canvas_area);
+        }
+
+        previous.erase(was);
+    }
+
+    // Whatever is left has gone away
+    for (auto const& gone : previous)
+        add_clipped(damage, last_frame[gone.second].position, canvas_area);
+
+    return damage;
+}
+
+geom::Rectangles mrs::Renderer::damage_for_buffer_age(geom::Rectangles const& frame_damage, unsigned int age) const
+{
+    if (age == 0 || age - 1 > damage_history.size())
+        return geom::Rectangles{{viewport.top_left, canvas_size}};
+
+    auto damage = frame_damage;
+    for (auto i = 0u; i != age - 1; ++i)
+    {
+        for (auto const& rect : damage_history[i])
+            damage.add(rect);
+    }
+
+    return damage;
+}
+
+void mrs::Renderer::draw(Canvas const& canvas, geom::Rectangle const& clip, mg::Renderable const& renderable) const
+{
+    auto const position = renderable.screen_position();
+    auto const area = position.intersection_with(clip);
+    auto const width = area.size.width.as_int();
+    auto const height = area.size.height.as_int();
+    if (width <= 0 || height <= 0)
+        return;
+
+    auto const alpha = static_cast<uint8_t>(std::lround(std::min(std::max(renderable.alpha(), 0.0f), 1.0f) * 255));
+    if (alpha == 0)
+        return;
+
+    // If we fail to read the buffer, carry on with the rest of the frame
+    try
+    {
+        auto const buffer = renderable.buffer();
+        auto const source = dynamic_cast<PixelSource*>(buffer->native_buffer_base());
+        if (!source)
+            BOOST_THROW_EXCEPTION(std::logic_error("Buffer does not support software rendering"));
+
+        auto const format = format_info(buffer->pixel_format());
+        if (!format.supported)
+            BOOST_THROW_EXCEPTION(std::logic_error("Unsupported buffer pixel format for software rendering"));
+
+        bool const swap_rb = format.red_in_low_byte != format_info(target->pixel_format()).red_in_low_byte;
+        bool const force_opaque = !(renderable.shaped() && format.has_alpha);
+
+        auto const buffer_size = buffer->size();
+        auto const buffer_width = buffer_size.width.as_int();
+        auto const buffer_height = buffer_size.height.as_int();
+        auto const source_stride = source->stride().as_int() / static_cast<ptrdiff_t>(sizeof(uint32_t));
+        bool const scaled = buffer_size != position.size;
+
+        auto const left = area.left().as_int() - position.left().as_int();
+        auto const top = area.top().as_int() - position.top().as_int();
+        auto dest = canvas.pixels +
+            (area.top().as_int() - canvas.area.top().as_int()) * canvas.stride +
+            (area.left().as_int() - canvas.area.left().as_int());
+
+        source->read(
+            [&](unsigned char const* pixels)
+            {
+                auto const source_pixels = reinterpret_cast<uint32_t const*>(pixels);
+
+                if (!scaled)
+                {
+                    auto source_row = source_pixels + top * source_stride + left;
+                    for (auto y = 0; y != height; ++y, dest += canvas.stride, source_row += source_stride)
+                        blend_row(dest, source_row, width, swap_rb, force_opaque, alpha);
+                    return;
+                }
+
+                std::vector<int> columns(width);
+                for (auto x = 0; x != width; ++x)
+                    columns[x] = (left + x) * buffer_width / position.size.width.as_int();
+
+                std::vector<uint32_t> sampled(width);
+                for (auto y = 0; y != height; ++y, dest += canvas.stride)
+                {
+                    auto const source_y = (top + y) * buffer_height / position.size.height.as_int();
+                    auto const source_row = source_pixels + source_y * source_stride;
+                    for (auto x = 0; x != width; ++x)
+                        sampled[x] = source_row[columns[x]];
+
+                    blend_row(dest, sampled.data(), width, swap_rb, force_opaque, alpha);
+                }
+            });
+    }
+    catch (std::exception const&)
+    {
+        report_exception();
+    }
+}
+
+void mrs::Renderer::transform_to_target(uint32_t* pixels, ptrdiff_t stride, geom::Rectangle const& region) const
+{
+    geom::Rectangle const canvas_area{viewport.top_left, canvas_size};
+    auto const clip = region.intersection_with(canvas_area);
+    if (clip.size.width.as_int() <= 0 || clip.size.height.as_int() <= 0)
+        return;
+
+    auto const t = ScreenTransform{output_transform};
+    auto const logical_width = canvas_size.width.as_int();
+    auto const logical_height = canvas_size.height.as_int();
+    auto const physical_size = target->size();
+    auto const physical_width = physical_size.width.as_int();
+    auto const physical_height = physical_size.height.as_int();
+
+    /*
+     * Work in doubled coordinates relative to the centre, so pixel centres
+     * stay integral: X = 2x - (width - 1).
+     */
+    auto const to_physical =
+        [&](int x, int y, int& px, int& py)
+        {
+            auto const lx = 2 * x - (logical_width - 1);
+            auto const ly = 2 * y - (logical_height - 1);
+            px = (t.a * lx + t.b * ly + physical_width - 1) / 2;
+            py = (t.c * lx + t.d * ly + physical_height - 1) / 2;
+        };
+
+    auto const left = clip.left().as_int() - canvas_area.left().as_int();
+    auto const top = clip.top().as_int() - canvas_area.top().as_int();
+    auto const right = left + clip.size.width.as_int() - 1;
+    auto const bottom = top + clip.size.height.as_int() - 1;
+
+    int x0, y0, x1, y1;
+    to_physical(left, top, x0, y0);
+    to_physical(right, bottom, x1, y1);
+    if (x0 > x1) std::swap(x0, x1);
+    if (y0 > y1) std::swap(y0, y1);
+
+    // Moving one pixel right on the target moves by (a, b) in the shadow buffer
+    ptrdiff_t const step = t.a + t.b * static_cast<ptrdiff_t>(logical_width);
+    auto const count = x1 - x0 + 1;
+
+    for (auto py = y0; py <= y1; ++py)
+    {
+        // The transform is orthogonal, so its inverse is its transpose
+        auto const px2 = 2 * x0 - (physical_width - 1);
+        auto const py2 = 2 * py - (physical_height - 1);
+        auto const lx = (t.a * px2 + t.c * py2 + logical_width - 1) / 2;
+        auto const ly = (t.b * px2 + t.d * py2 + logical_height - 1) / 2;
+
+        copy_strided_row(
+            pixels + py * stride + x0,
+            shadow.data() + ly * static_cast<ptrdiff_t>(logical_width) + lx,
+            step,
+            count);
+    }
+}
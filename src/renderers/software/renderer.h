@@ -0,0 +1,105 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_SOFTWARE_RENDERER_H_
+#define MIR_RENDERER_SOFTWARE_RENDERER_H_
+
+#include <mir/renderer/renderer.h>
+#include <mir/geometry/rectangle.h>
+#include <mir/geometry/rectangles.h>
+#include <mir/graphics/buffer_id.h>
+#include <mir/graphics/renderable.h>
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace mir
+{
+namespace graphics { class DisplayBuffer; }
+namespace renderer
+{
+namespace software
+{
+class RenderTarget;
+
+/**
+ * Composites with the CPU, for systems without a usable GPU.
+ *
+ * Client buffers are read in place (they must be CPU-accessible, as SHM
+ * buffers are) and only the parts of the screen that changed since the target
+ * buffer was last drawn are repainted.
+ *
+ * Renderable transformations are not supported; those renderables are drawn
+ * untransformed. Renderables are scaled to their screen position with
+ * nearest-neighbour sampling.
+ */
+class Renderer : public renderer::Renderer
+{
+public:
+    Renderer(graphics::DisplayBuffer& display_buffer);
+
+    void set_viewport(geometry::Rectangle const& rect) override;
+    void set_output_transform(glm::mat2 const&) override;
+    void render(graphics::RenderableList const&) const override;
+    void suspend() override;
+
+private:
+    struct DrawnRenderable
+    {
+        graphics::Renderable::ID id;
+        graphics::BufferID buffer;
+        geometry::Rectangle position;
+        float alpha;
+        bool shaped;
+    };
+
+    struct Canvas
+    {
+        uint32_t* pixels;
+        ptrdiff_t stride;       // in pixels
+        geometry::Rectangle area;   // in screen coordinates
+    };
+
+    geometry::Rectangles damage_since_last_frame(std::vector<DrawnRenderable> const& frame) const;
+    geometry::Rectangles damage_for_buffer_age(geometry::Rectangles const& frame_damage, unsigned int age) const;
+    void draw(Canvas const& canvas, geometry::Rectangle const& clip, graphics::Renderable const& renderable) const;
+    void transform_to_target(
+        uint32_t* pixels, ptrdiff_t stride, geometry::Rectangle const& region) const;
+
+    RenderTarget* const target;
+    geometry::Rectangle viewport;
+    glm::mat2 output_transform{1};
+
+    // The logical (untransformed) size of the target
+    geometry::Size mutable canvas_size;
+
+    /*
+     * When the output is transformed we composite into this buffer and then
+     * rotate the result into the target.
+     */
+    std::vector<uint32_t> mutable shadow;
+
+    std::vector<DrawnRenderable> mutable last_frame;
+    std::deque<geometry::Rectangles> mutable damage_history;
+    bool mutable repaint_all{true};
+};
+
+}
+}
+}
+
+#endif /* MIR_RENDERER_SOFTWARE_RENDERER_H_ */
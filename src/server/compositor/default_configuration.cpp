@@ -23,6 +23,8 @@
 #include "default_display_buffer_compositor_factory.h"
 #include "multi_threaded_compositor.h"
 #include "gl/renderer_factory.h"
+#include "gl/program_binary_cache.h"
+#include "software/renderer_factory.h"
 #include "compositing_screencast.h"
 #include "mir/main_loop.h"
 
@@ -86,9 +88,28 @@ mir::DefaultServerConfiguration::the_compositor()
 std::shared_ptr<mir::renderer::RendererFactory> mir::DefaultServerConfiguration::the_renderer_factory()
 {
     return renderer_factory(
-        []()
+        [this]() -> std::shared_ptr<mir::renderer::RendererFactory>
         {
-            return std::make_shared<mir::renderer::gl::RendererFactory>();
+            auto const options = the_options();
+            auto const renderer = options->get<std::string>(options::renderer_opt);
+
+            if (renderer == "software")
+                return std::make_shared<mir::renderer::software::RendererFactory>();
+            else if (renderer == "gl")
+            {
+                auto const program_cache = options->is_set(options::gl_program_cache_opt) ?
+                    options->get<std::string>(options::gl_program_cache_opt) :
+                    mir::renderer::gl::ProgramBinaryCache::default_directory();
+
+                std::shared_ptr<mir::renderer::gl::ProgramBinaryCache> binary_cache;
+                if (!program_cache.empty() && program_cache != options::off_opt_value)
+                    binary_cache = std::make_shared<mir::renderer::gl::ProgramBinaryCache>(program_cache);
+
+                return std::make_shared<mir::renderer::gl::RendererFactory>(
+                    binary_cache, options->get<bool>(options::gl_flatten_layers_opt));
+            }
+
+            BOOST_THROW_EXCEPTION(std::runtime_error("Unknown renderer: " + renderer));
         });
 }
 
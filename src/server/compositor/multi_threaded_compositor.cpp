@@ -222,6 +222,11 @@ public:
         run_cv.notify_one();
     }
 
+    bool composites(mg::DisplaySyncGroup const& other) const
+    {
+        return &group == &other;
+    }
+
     void wait_until_started()
     {
         if (started_future.wait_for(10s) != std::future_status::ready)
@@ -361,22 +366,81 @@ void mc::MultiThreadedCompositor::stop()
     state = CompositorState::stopped;
 }
 
+void mc::MultiThreadedCompositor::reconfigure(
+    std::function<void(std::function<void(mg::DisplaySyncGroup&)> const& retiring)> const& change)
+{
+    auto started = CompositorState::started;
+
+    if (!state.compare_exchange_strong(started, CompositorState::reconfiguring))
+    {
+        // Nothing is compositing, so nothing needs to be retired
+        change([](mg::DisplaySyncGroup&) {});
+        return;
+    }
+
+    /* Restart compositing to whatever the display has now, even if the change throws */
+    auto const resume = [this]
+        {
+            try
+            {
+                create_compositing_threads();
+                scene->add_observer(observer);
+            }
+            catch (...)
+            {
+                destroy_compositing_threads();
+                state = CompositorState::stopped;
+                throw;
+            }
+
+            // Changes to the scene while we weren't observing it may have
+            // left clients blocked
+            schedule_compositing(1);
+
+            state = CompositorState::started;
+        };
+
+    /* Remove the observer before changing the compositing threads */
+    scene->remove_observer(observer);
+
+    try
+    {
+        change([this](mg::DisplaySyncGroup& group) { destroy_compositing_thread_for(group); });
+    }
+    catch (...)
+    {
+        resume();
+        throw;
+    }
+
+    resume();
+}
+
 void mc::MultiThreadedCompositor::create_compositing_threads()
 {
-    /* Start the display buffer compositing threads */
-    display->for_each_display_sync_group([this](mg::DisplaySyncGroup& group)
+    std::vector<mc::CompositingFunctor*> started_functors;
+
+    /* Start compositing threads for the display sync groups that have none */
+    display->for_each_display_sync_group([this, &started_functors](mg::DisplaySyncGroup& group)
     {
+        for (auto const& functor : thread_functors)
+        {
+            if (functor->composites(group))
+                return;
+        }
+
         auto thread_functor = std::make_unique<mc::CompositingFunctor>(
             display_buffer_compositor_factory, group, scene, display_listener,
             fixed_composite_delay, report);
 
         futures.push_back(thread_pool.run(std::ref(*thread_functor), &group));
+        started_functors.push_back(thread_functor.get());
         thread_functors.push_back(std::move(thread_functor));
     });
 
     thread_pool.shrink();
 
-    for (auto& functor : thread_functors)
+    for (auto const functor : started_functors)
         functor->wait_until_started();
 }
 
@@ -391,3 +455,19 @@ void mc::MultiThreadedCompositor::destroy_compositing_threads()
     thread_functors.clear();
     futures.clear();
 }
+
+void mc::MultiThreadedCompositor::destroy_compositing_thread_for(mg::DisplaySyncGroup& group)
+{
+    for (auto i = 0u; i != thread_functors.size(); ++i)
+    {
+        if (thread_functors[i]->composites(group))
+        {
+            thread_functors[i]->stop();
+            futures[i].wait();
+
+            thread_functors.erase(thread_functors.begin() + i);
+            futures.erase(futures.begin() + i);
+            return;
+        }
+    }
+}
@@ -35,6 +35,7 @@ namespace geometry { struct Rectangle; }
 namespace graphics
 {
 class Display;
+class DisplaySyncGroup;
 }
 namespace scene
 {
@@ -55,7 +56,8 @@ enum class CompositorState
     started,
     stopped,
     starting,
-    stopping
+    stopping,
+    reconfiguring
 };
 
 class MultiThreadedCompositor : public Compositor
@@ -73,10 +75,13 @@ public:
 
     void start();
     void stop();
+    void reconfigure(
+        std::function<void(std::function<void(graphics::DisplaySyncGroup&)> const& retiring)> const& change) override;
 
 private:
     void create_compositing_threads();
     void destroy_compositing_threads();
+    void destroy_compositing_thread_for(graphics::DisplaySyncGroup& group);
 
     std::shared_ptr<graphics::Display> const display;
     std::shared_ptr<Scene> const scene;
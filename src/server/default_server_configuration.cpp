@@ -26,6 +26,7 @@
 #include "mir/default_configuration.h"
 #include "mir/cookie/authority.h"
 
+#include "mir/logging/async_logger.h"
 #include "mir/logging/dumb_console_logger.h"
 #include "mir/options/program_option.h"
 #include "mir/frontend/session_credentials.h"
@@ -45,6 +46,9 @@
 #include "mir/scene/coordinate_translator.h"
 #include "mir/console_services.h"
 
+#include <boost/throw_exception.hpp>
+
+#include <stdexcept>
 #include <type_traits>
 
 namespace mc = mir::compositor;
@@ -73,6 +77,30 @@ mir::DefaultServerConfiguration::DefaultServerConfiguration(std::shared_ptr<mo::
 {
 }
 
+auto mir::DefaultServerConfiguration::start_parallel_initialization()
+-> std::vector<std::future<std::shared_ptr<void>>>
+{
+    // Resolve the state the workers share before starting them
+    auto const options = the_options();
+    the_main_loop();
+    the_console_services();
+    the_shared_library_prober_report();
+
+    std::vector<std::future<std::shared_ptr<void>>> result;
+
+    auto const start = [&result](std::function<std::shared_ptr<void>()> const& make)
+        {
+            result.push_back(std::async(std::launch::async, make));
+        };
+
+    if (options->get<bool>(options::enable_input_opt) && !options->is_set(options::host_socket_opt))
+        start([this] { return the_input_platform_module(); });
+
+    start([this] { return the_cursor_images(); });
+
+    return result;
+}
+
 auto mir::DefaultServerConfiguration::the_options() const
 ->std::shared_ptr<options::Option>
 {
@@ -198,12 +226,19 @@ std::shared_ptr<mir::EmergencyCleanup> mir::DefaultServerConfiguration::the_emer
 std::shared_ptr<mir::cookie::Authority> mir::DefaultServerConfiguration::the_cookie_authority()
 {
     return cookie_authority(
-        []()
+        [this]()
         {
             static_assert(secret_size >= mir::cookie::Authority::minimum_secret_size,
                           "Secret size is smaller then the minimum secret size");
 
-            return mir::cookie::Authority::create();
+            auto const format_name = the_options()->get<std::string>(options::cookie_format_opt);
+
+            if (format_name == "siphash")
+                return mir::cookie::Authority::create(mir::cookie::Format::siphash_2_4);
+            else if (format_name == "hmac-sha256")
+                return mir::cookie::Authority::create(mir::cookie::Format::hmac_sha_256);
+
+            BOOST_THROW_EXCEPTION(std::runtime_error("Unknown cookie format: " + format_name));
         });
 }
 
@@ -225,8 +260,11 @@ auto mir::DefaultServerConfiguration::the_logger()
     -> std::shared_ptr<ml::Logger>
 {
     return logger(
-        []() -> std::shared_ptr<ml::Logger>
+        [this]() -> std::shared_ptr<ml::Logger>
         {
+            if (the_options()->get<bool>(options::async_logging_opt))
+                return std::make_shared<ml::AsyncLogger>();
+
             return std::make_shared<ml::DumbConsoleLogger>();
         });
 }
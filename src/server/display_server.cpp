@@ -31,6 +31,7 @@
 #include "mir/input/input_manager.h"
 #include "mir/input/input_dispatcher.h"
 #include "mir/log.h"
+#include "mir/startup_trace.h"
 #include "mir/unwind_helpers.h"
 
 #include <boost/exception/diagnostic_information.hpp>
@@ -222,12 +223,18 @@ void mir::DisplayServer::run()
 
     auto const& server = *p.load();
 
-    server.compositor->start();
-    server.input_manager->start();
-    server.input_dispatcher->start();
-    server.prompt_connector->start();
-    server.connector->start();
-    server.wayland_connector->start();
+    auto const start = [](char const* name, auto const& subsystem)
+        {
+            StartupTraceSpan const span{name};
+            subsystem->start();
+        };
+
+    start("start compositor", server.compositor);
+    start("start input manager", server.input_manager);
+    start("start input dispatcher", server.input_dispatcher);
+    start("start prompt connector", server.prompt_connector);
+    start("start connector", server.connector);
+    start("start wayland connector", server.wayland_connector);
 
     server.server_status_listener->started();
 
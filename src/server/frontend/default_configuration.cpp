@@ -21,6 +21,7 @@
 
 #include "default_ipc_factory.h"
 #include "published_socket_connector.h"
+#include "request_scheduler.h"
 #include "session_mediator_observer_multiplexer.h"
 
 #include "mir/graphics/platform.h"
@@ -32,6 +33,7 @@
 
 namespace mf = mir::frontend;
 namespace mg = mir::graphics;
+namespace mfd = mir::frontend::detail;
 namespace ms = mir::scene;
 
 std::shared_ptr<mf::ConnectionCreator>
@@ -44,20 +46,33 @@ mir::DefaultServerConfiguration::the_connection_creator()
                 new_ipc_factory(session_authorizer),
                 session_authorizer,
                 the_graphics_platform()->make_ipc_operations(),
-                the_message_processor_report());
+                the_message_processor_report(),
+                new_request_scheduler());
         });
 }
 
+std::shared_ptr<mfd::RequestScheduler>
+mir::DefaultServerConfiguration::new_request_scheduler()
+{
+    return std::make_shared<mfd::RequestScheduler>(
+        the_options()->get<int>(options::frontend_threads_opt),
+        the_session_event_handler_register(),
+        the_message_processor_report());
+}
+
 std::shared_ptr<mf::Connector>
 mir::DefaultServerConfiguration::the_connector()
 {
     return connector(
         [&,this]() -> std::shared_ptr<mf::Connector>
         {
+            auto const threads = the_options()->get<int>(options::frontend_threads_opt);
+
             if (the_options()->is_set(options::no_server_socket_opt))
             {
                 return std::make_shared<mf::BasicConnector>(
                     the_connection_creator(),
+                    threads,
                     the_connector_report());
             }
             else
@@ -65,6 +80,7 @@ mir::DefaultServerConfiguration::the_connector()
                 auto const result = std::make_shared<mf::PublishedSocketConnector>(
                     the_socket_file(),
                     the_connection_creator(),
+                    threads,
                     *the_emergency_cleanup(),
                     the_connector_report());
 
@@ -124,7 +140,8 @@ mir::DefaultServerConfiguration::the_prompt_connection_creator()
                 new_ipc_factory(session_authorizer),
                 session_authorizer,
                 the_graphics_platform()->make_ipc_operations(),
-                the_message_processor_report());
+                the_message_processor_report(),
+                new_request_scheduler());
         });
 }
 
@@ -134,11 +151,14 @@ mir::DefaultServerConfiguration::the_prompt_connector()
     return prompt_connector(
         [&,this]() -> std::shared_ptr<mf::Connector>
         {
+            auto const threads = the_options()->get<int>(options::frontend_threads_opt);
+
             if (the_options()->is_set(options::prompt_socket_opt))
             {
                 return std::make_shared<mf::PublishedSocketConnector>(
                     the_socket_file() + "_trusted",
                     the_prompt_connection_creator(),
+                    threads,
                     *the_emergency_cleanup(),
                     the_connector_report());
             }
@@ -146,6 +166,7 @@ mir::DefaultServerConfiguration::the_prompt_connector()
             {
                 return std::make_shared<mf::BasicConnector>(
                     the_prompt_connection_creator(),
+                    threads,
                     the_connector_report());
             }
         });
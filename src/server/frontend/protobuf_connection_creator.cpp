@@ -27,8 +27,11 @@
 #include "socket_connection.h"
 
 #include "protobuf_ipc_factory.h"
+#include "request_scheduler.h"
 #include "mir/frontend/session_authorizer.h"
 
+#include <boost/version.hpp>
+
 namespace mf = mir::frontend;
 namespace mfd = mir::frontend::detail;
 namespace ba = boost::asio;
@@ -37,11 +40,13 @@ mf::ProtobufConnectionCreator::ProtobufConnectionCreator(
     std::shared_ptr<ProtobufIpcFactory> const& ipc_factory,
     std::shared_ptr<SessionAuthorizer> const& session_authorizer,
     std::shared_ptr<mir::graphics::PlatformIpcOperations> const& operations,
-    std::shared_ptr<MessageProcessorReport> const& report)
+    std::shared_ptr<MessageProcessorReport> const& report,
+    std::shared_ptr<detail::RequestScheduler> const& scheduler)
 :   ipc_factory(ipc_factory),
     session_authorizer(session_authorizer),
     operations(operations),
     report(report),
+    scheduler(scheduler),
     next_session_id(0),
     connections(std::make_shared<mfd::Connections<mfd::SocketConnection>>())
 {
@@ -75,6 +80,20 @@ public:
 private:
     std::shared_ptr<mir::graphics::PlatformIpcOperations> const ops;
 };
+
+// A connection's requests run on the IPC threads serving its socket
+auto executor_for(std::shared_ptr<ba::local::stream_protocol::socket> const& socket)
+    -> mfd::RequestScheduler::Executor
+{
+    return [socket](std::function<void()>&& work)
+        {
+#if BOOST_VERSION >= 106600
+            ba::post(socket->get_executor(), std::move(work));
+#else
+            socket->get_io_service().post(std::move(work));
+#endif
+        };
+}
 }
 
 void mf::ProtobufConnectionCreator::create_connection_for(
@@ -100,7 +119,12 @@ void mf::ProtobufConnectionCreator::create_connection_for(
                 connection_context),
             report);
 
-        auto const& connection = std::make_shared<mfd::SocketConnection>(messenger, next_id(), connections, msg_processor);
+        auto const& connection = std::make_shared<mfd::SocketConnection>(
+            messenger,
+            next_id(),
+            connections,
+            msg_processor,
+            scheduler ? scheduler->add_client(creds.pid(), executor_for(socket)) : nullptr);
         connections->add(connection);
         connection->read_next_message();
     }
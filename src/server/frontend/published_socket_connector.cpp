@@ -30,6 +30,7 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 
@@ -124,9 +125,10 @@ std::shared_ptr<boost::asio::local::stream_protocol::socket> make_socket_self_co
 mf::PublishedSocketConnector::PublishedSocketConnector(
     const std::string& socket_file,
     std::shared_ptr<ConnectionCreator> const& connection_creator,
+    int threads,
     EmergencyCleanupRegistry& emergency_cleanup_registry,
     std::shared_ptr<ConnectorReport> const& report)
-:   BasicConnector(connection_creator, report),
+:   BasicConnector(connection_creator, threads, report),
     socket_file(remove_if_stale(socket_file)),
     acceptor(*io_service, socket_file)
 {
@@ -189,10 +191,12 @@ auto mir::frontend::PublishedSocketConnector::socket_name() const -> optional_va
 
 mf::BasicConnector::BasicConnector(
     std::shared_ptr<ConnectionCreator> const& connection_creator,
+    int threads,
     std::shared_ptr<ConnectorReport> const& report)
 :   io_service(std::make_shared<boost::asio::io_service>()),
     work(*io_service),
     report(report),
+    io_service_threads(std::max(threads, 1)),
     connection_creator{connection_creator}
 {
 }
@@ -216,7 +220,10 @@ void mf::BasicConnector::start()
         }
     };
 
-    io_service_thread = std::thread(run_io_service);
+    for (auto& thread : io_service_threads)
+    {
+        thread = std::thread(run_io_service);
+    }
 }
 
 void mf::BasicConnector::stop()
@@ -224,9 +231,12 @@ void mf::BasicConnector::stop()
     /* Stop processing new requests */
     io_service->stop();
 
-    /* Wait for io processing thread to finish */
-    if (io_service_thread.joinable())
-        io_service_thread.join();
+    /* Wait for io processing threads to finish */
+    for (auto& thread : io_service_threads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
 
     /* Prepare for a potential restart */
     io_service->reset();
@@ -26,6 +26,7 @@
 #include <thread>
 #include <string>
 #include <functional>
+#include <vector>
 
 namespace google
 {
@@ -45,11 +46,18 @@ class ConnectionCreator;
 class ConnectorReport;
 
 /// provides a client-side socket fd for each connection
+///
+/// Requests are processed on a pool of \a threads threads. Each connection
+/// only ever has one read outstanding and issues the next one after the
+/// current message has been dispatched, so a connection's messages are
+/// handled one at a time and in order, whichever thread picks them up.
+/// Different connections are serviced in parallel.
 class BasicConnector : public Connector
 {
 public:
     explicit BasicConnector(
         std::shared_ptr<ConnectionCreator> const& connection_creator,
+        int threads,
         std::shared_ptr<ConnectorReport> const& report);
     ~BasicConnector() noexcept;
     void start() override;
@@ -68,7 +76,7 @@ protected:
     std::shared_ptr<ConnectorReport> const report;
 
 private:
-    std::thread io_service_thread;
+    std::vector<std::thread> io_service_threads;
     std::shared_ptr<ConnectionCreator> const connection_creator;
 };
 
@@ -79,6 +87,7 @@ public:
     explicit PublishedSocketConnector(
         const std::string& socket_file,
         std::shared_ptr<ConnectionCreator> const& connection_creator,
+        int threads,
         EmergencyCleanupRegistry& emergency_cleanup_registry,
         std::shared_ptr<ConnectorReport> const& report);
     ~PublishedSocketConnector() noexcept;
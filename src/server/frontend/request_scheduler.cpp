@@ -0,0 +1,268 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "request_scheduler.h"
+
+#include "mir/frontend/message_processor_report.h"
+#include "mir/scene/session.h"
+#include "mir/scene/session_event_handler_register.h"
+#include "mir/scene/session_event_sink.h"
+
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <tuple>
+
+namespace mf = mir::frontend;
+namespace mfd = mir::frontend::detail;
+namespace ms = mir::scene;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// The virtual time a request costs its client
+uint64_t const request_cost{4};
+uint64_t const focused_request_cost{1};
+
+auto const report_interval = std::chrono::seconds{1};
+
+struct Request
+{
+    mfd::RequestScheduler::Priority priority;
+    Clock::time_point queued;
+    std::function<void()> work;
+};
+}
+
+struct mfd::RequestScheduler::ClientState
+{
+    ClientState(pid_t pid, Executor const& executor) :
+        pid{pid},
+        executor{executor}
+    {
+    }
+
+    pid_t const pid;
+    Executor const executor;
+
+    std::deque<Request> requests;
+    bool running{false};
+    bool closed{false};
+    std::thread::id runner;
+    uint64_t finish_tag{0};
+
+    Clock::time_point interval_start{Clock::now()};
+    unsigned int requests_in_interval{0};
+    Clock::duration longest_wait{0};
+};
+
+struct mfd::RequestScheduler::SessionObserver : ms::SessionEventSink
+{
+    explicit SessionObserver(RequestScheduler* self) : self{self} {}
+
+    void handle_focus_change(std::shared_ptr<ms::Session> const& session) override
+    {
+        self->set_focused_client(session->process_id());
+    }
+
+    void handle_no_focus() override
+    {
+        self->set_focused_client(0);
+    }
+
+    void handle_session_stopping(std::shared_ptr<ms::Session> const&) override
+    {
+    }
+
+    RequestScheduler* const self;
+};
+
+mfd::RequestScheduler::RequestScheduler(
+    int threads,
+    std::shared_ptr<ms::SessionEventHandlerRegister> const& session_event_handler_register,
+    std::shared_ptr<MessageProcessorReport> const& report) :
+    threads{static_cast<unsigned int>(std::max(threads, 1))},
+    session_event_handler_register{session_event_handler_register},
+    report{report},
+    session_observer{std::make_unique<SessionObserver>(this)}
+{
+    session_event_handler_register->add(session_observer.get());
+}
+
+mfd::RequestScheduler::~RequestScheduler()
+{
+    session_event_handler_register->remove(session_observer.get());
+}
+
+auto mfd::RequestScheduler::add_client(pid_t client_pid, Executor const& executor) -> std::unique_ptr<Client>
+{
+    return std::unique_ptr<Client>{
+        new Client{shared_from_this(), std::make_shared<ClientState>(client_pid, executor)}};
+}
+
+void mfd::RequestScheduler::set_focused_client(pid_t client_pid)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    focused_pid = client_pid;
+}
+
+void mfd::RequestScheduler::run_next()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+
+    // The client that was waiting may since have been closed
+    if (waiting.empty())
+    {
+        --runs;
+        return;
+    }
+
+    auto const start_tag = [this](ClientState const& client)
+        {
+            return std::max(client.finish_tag, virtual_time);
+        };
+
+    auto const rank = [&](ClientState const& client)
+        {
+            auto const start = static_cast<int64_t>(start_tag(client));
+            auto const boost = client.requests.front().priority == Priority::latency_critical ?
+                static_cast<int64_t>(request_cost) : 0;
+            return std::make_tuple(start - boost, client.pid != focused_pid);
+        };
+
+    auto const next = std::min_element(begin(waiting), end(waiting),
+        [&](std::shared_ptr<ClientState> const& lhs, std::shared_ptr<ClientState> const& rhs)
+        {
+            return rank(*lhs) < rank(*rhs);
+        });
+
+    auto const client = *next;
+    *next = waiting.back();
+    waiting.pop_back();
+
+    auto const start = start_tag(*client);
+    virtual_time = start;
+    client->finish_tag = start + (client->pid == focused_pid ? focused_request_cost : request_cost);
+
+    auto const request = std::move(client->requests.front());
+    client->requests.pop_front();
+    client->running = true;
+    client->runner = std::this_thread::get_id();
+
+    auto const now = Clock::now();
+    client->longest_wait = std::max(client->longest_wait, now - request.queued);
+    ++client->requests_in_interval;
+
+    auto const elapsed = now - client->interval_start;
+    auto const report_due = elapsed >= report_interval;
+    auto const requests_per_second =
+        client->requests_in_interval / std::chrono::duration<double>(elapsed).count();
+    auto const longest_wait = std::chrono::duration_cast<std::chrono::microseconds>(client->longest_wait);
+
+    if (report_due)
+    {
+        client->interval_start = now;
+        client->requests_in_interval = 0;
+        client->longest_wait = Clock::duration::zero();
+    }
+
+    lock.unlock();
+
+    if (report_due)
+        report->request_rate(client->pid, requests_per_second, longest_wait);
+
+    auto const finish = [&]
+        {
+            lock.lock();
+            client->running = false;
+            if (!client->closed && !client->requests.empty())
+                waiting.push_back(client);
+
+            Executor executor;
+            if (waiting.empty())
+                --runs;
+            else
+                executor = waiting.back()->executor;
+            lock.unlock();
+
+            finished.notify_all();
+
+            if (executor)
+                executor([self = shared_from_this()] { self->run_next(); });
+        };
+
+    try
+    {
+        request.work();
+    }
+    catch (...)
+    {
+        finish();
+        throw;
+    }
+
+    finish();
+}
+
+mfd::RequestScheduler::Client::Client(
+    std::shared_ptr<RequestScheduler> const& scheduler,
+    std::shared_ptr<ClientState> const& state) :
+    scheduler{scheduler},
+    state{state}
+{
+}
+
+mfd::RequestScheduler::Client::~Client()
+{
+    std::deque<Request> dropped;
+    std::unique_lock<std::mutex> lock{scheduler->mutex};
+
+    state->closed = true;
+    dropped.swap(state->requests);
+
+    auto& waiting = scheduler->waiting;
+    waiting.erase(std::remove(begin(waiting), end(waiting), state), end(waiting));
+
+    // A request running elsewhere may still use whatever owns us; a request
+    // that destroys its own client has nothing to wait for
+    scheduler->finished.wait(lock,
+        [this] { return !state->running || state->runner == std::this_thread::get_id(); });
+}
+
+void mfd::RequestScheduler::Client::enqueue(Priority priority, std::function<void()>&& request)
+{
+    bool start_run{false};
+    {
+        std::lock_guard<std::mutex> lock{scheduler->mutex};
+
+        state->requests.push_back(Request{priority, Clock::now(), std::move(request)});
+
+        if (!state->running && state->requests.size() == 1)
+        {
+            scheduler->waiting.push_back(state);
+
+            if (scheduler->runs < scheduler->threads)
+            {
+                ++scheduler->runs;
+                start_run = true;
+            }
+        }
+    }
+
+    if (start_run)
+        state->executor([scheduler = scheduler] { scheduler->run_next(); });
+}
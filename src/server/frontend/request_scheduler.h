@@ -0,0 +1,125 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_REQUEST_SCHEDULER_H_
+#define MIR_FRONTEND_REQUEST_SCHEDULER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace mir
+{
+namespace scene
+{
+class SessionEventHandlerRegister;
+}
+namespace frontend
+{
+class MessageProcessorReport;
+
+namespace detail
+{
+/**
+ * Decides the order in which the requests of different clients are
+ * dispatched, rather than leaving it to the order they were read.
+ *
+ * Each client has its own queue. Whenever a client has a request waiting
+ * a "run next" task is handed to that client's executor (one of the IPC
+ * threads); the task runs whichever waiting request should go first, which
+ * need not be the one that caused it to be queued.
+ *
+ * The choice is weighted fair queuing: clients are charged virtual time for
+ * each request, the focused client at a quarter of the rate of the others,
+ * and the client that has been charged least goes next. Latency critical
+ * requests (submit_buffer, pong) jump ahead of one normal request's worth of
+ * virtual time, so they go before background traffic but a client cannot
+ * use them to starve the others.
+ *
+ * A client's own requests are always dispatched one at a time, in order.
+ *
+ * Only as many "run next" tasks as there are IPC threads are handed out at
+ * once, so the reads that queue further requests are not stuck behind them.
+ */
+class RequestScheduler : public std::enable_shared_from_this<RequestScheduler>
+{
+    struct ClientState;
+
+public:
+    enum class Priority
+    {
+        normal,
+        latency_critical
+    };
+
+    /// Runs work later, on a thread serving the client
+    using Executor = std::function<void(std::function<void()>&& work)>;
+
+    /// A client's queue. Destroying it drops any requests still waiting.
+    class Client
+    {
+    public:
+        ~Client();
+
+        void enqueue(Priority priority, std::function<void()>&& request);
+
+    private:
+        friend class RequestScheduler;
+        Client(std::shared_ptr<RequestScheduler> const& scheduler, std::shared_ptr<ClientState> const& state);
+
+        std::shared_ptr<RequestScheduler> const scheduler;
+        std::shared_ptr<ClientState> const state;
+    };
+
+    RequestScheduler(
+        int threads,
+        std::shared_ptr<scene::SessionEventHandlerRegister> const& session_event_handler_register,
+        std::shared_ptr<MessageProcessorReport> const& report);
+    ~RequestScheduler();
+
+    auto add_client(pid_t client_pid, Executor const& executor) -> std::unique_ptr<Client>;
+
+    /// The requests of this process's clients are favoured
+    void set_focused_client(pid_t client_pid);
+
+private:
+    struct SessionObserver;
+
+    void run_next();
+
+    unsigned int const threads;
+    std::shared_ptr<scene::SessionEventHandlerRegister> const session_event_handler_register;
+    std::shared_ptr<MessageProcessorReport> const report;
+    std::unique_ptr<SessionObserver> const session_observer;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<std::shared_ptr<ClientState>> waiting;
+    unsigned int runs{0};
+    uint64_t virtual_time{0};
+    pid_t focused_pid{0};
+};
+}
+}
+}
+
+#endif /* MIR_FRONTEND_REQUEST_SCHEDULER_H_ */
@@ -374,8 +374,25 @@ void mf::SessionMediator::create_surface(
         response->mutable_buffer_stream()->set_pixel_format(legacy_stream->pixel_format());
         response->mutable_buffer_stream()->set_buffer_usage(request->buffer_usage());
         legacy_default_stream_map[surf_id] = buffer_stream_id;
+
+        // Clients that don't know about initial_buffer fall back to allocate_buffers()
+        response->mutable_buffer_stream()->set_preallocated_buffers(request->initial_buffer_size());
     }
     done->Run();
+
+    // The client sets up its stream on receiving the response, so it is
+    // ready for these by the time they arrive...
+    if (legacy_stream)
+    {
+        for (auto const& initial : request->initial_buffer())
+        {
+            auto buffer_request = initial;
+            buffer_request.set_width(client_size.width.as_int());
+            buffer_request.set_height(client_size.height.as_int());
+            allocate_buffer(*session, buffer_request, buffer_stream_id);
+        }
+    }
+
     // ...then uncork the message sender, sending all buffered surface events.
     buffering_sender->uncork();
 }
@@ -484,71 +501,81 @@ bool validate_buffer_request(mir::protobuf::BufferStreamParameters const& req)
 }
 }
 
-void mf::SessionMediator::allocate_buffers(
-    mir::protobuf::BufferAllocation const* request,
-    mir::protobuf::Void*,
-    google::protobuf::Closure* done)
+void mf::SessionMediator::allocate_buffer(
+    Session& session,
+    mir::protobuf::BufferStreamParameters const& req,
+    mir::optional_value<BufferStreamId> const& stream_id)
 {
-    auto session = weak_session.lock();
-    if (!session)
-        BOOST_THROW_EXCEPTION(std::logic_error("Invalid application session"));
-
-    observer->session_allocate_buffers_called(session->name());
-    for (auto i = 0; i < request->buffer_requests().size(); i++)
+    std::shared_ptr<mg::Buffer> buffer;
+    try
     {
-        auto const& req = request->buffer_requests(i);
-        std::shared_ptr<mg::Buffer> buffer;
-        try
+        if (!validate_buffer_request(req))
         {
-            if (!validate_buffer_request(req))
-            {
-                BOOST_THROW_EXCEPTION(std::logic_error("Invalid buffer request"));
-            }
+            BOOST_THROW_EXCEPTION(std::logic_error("Invalid buffer request"));
+        }
 
-            if (req.has_flags() && req.has_native_format())
+        if (req.has_flags() && req.has_native_format())
+        {
+            buffer = allocator->alloc_buffer(
+                {req.width(), req.height()},
+                req.native_format(),
+                req.flags());
+        }
+        else
+        {
+            auto const usage = static_cast<mg::BufferUsage>(req.buffer_usage());
+            geom::Size const size{req.width(), req.height()};
+            auto const pf = static_cast<MirPixelFormat>(req.pixel_format());
+            if (usage == mg::BufferUsage::software)
             {
-                buffer = allocator->alloc_buffer(
-                    {req.width(), req.height()},
-                    req.native_format(),
-                    req.flags());
+                buffer = allocator->alloc_software_buffer(size, pf);
             }
             else
             {
-                auto const usage = static_cast<mg::BufferUsage>(req.buffer_usage());
-                geom::Size const size{req.width(), req.height()};
-                auto const pf = static_cast<MirPixelFormat>(req.pixel_format());
-                if (usage == mg::BufferUsage::software)
-                {
-                    buffer = allocator->alloc_software_buffer(size, pf);
-                }
-                else
-                {
-                    //legacy route, server-selected pf and usage
-                    buffer =
-                        allocator->alloc_buffer(mg::BufferProperties{size, pf, mg::BufferUsage::hardware});
-                }
-            }
-
-            if (request->has_id())
-            {
-                auto const stream_id = mf::BufferStreamId{request->id().value()};
-                // We don't need the stream, but we *do* need to know it exists
-                auto stream = session->get_buffer_stream(stream_id);
-                stream_associated_buffers.insert(std::make_pair(stream_id, buffer->id()));
+                //legacy route, server-selected pf and usage
+                buffer =
+                    allocator->alloc_buffer(mg::BufferProperties{size, pf, mg::BufferUsage::hardware});
             }
-
-            // TODO: Throw if insert fails (duplicate ID)?
-            buffer_cache.insert(std::make_pair(buffer->id(), buffer));
-            event_sink->add_buffer(*buffer);
         }
-        catch (std::exception const& err)
+
+        if (stream_id.is_set())
         {
-            event_sink->error_buffer(
-                geom::Size{req.width(), req.height()},
-                static_cast<MirPixelFormat>(req.pixel_format()),
-                err.what());
+            // We don't need the stream, but we *do* need to know it exists
+            auto stream = session.get_buffer_stream(stream_id.value());
+            stream_associated_buffers.insert(std::make_pair(stream_id.value(), buffer->id()));
         }
+
+        // TODO: Throw if insert fails (duplicate ID)?
+        buffer_cache.insert(std::make_pair(buffer->id(), buffer));
+        event_sink->add_buffer(*buffer);
     }
+    catch (std::exception const& err)
+    {
+        event_sink->error_buffer(
+            geom::Size{req.width(), req.height()},
+            static_cast<MirPixelFormat>(req.pixel_format()),
+            err.what());
+    }
+}
+
+void mf::SessionMediator::allocate_buffers(
+    mir::protobuf::BufferAllocation const* request,
+    mir::protobuf::Void*,
+    google::protobuf::Closure* done)
+{
+    auto session = weak_session.lock();
+    if (!session)
+        BOOST_THROW_EXCEPTION(std::logic_error("Invalid application session"));
+
+    observer->session_allocate_buffers_called(session->name());
+
+    mir::optional_value<mf::BufferStreamId> stream_id;
+    if (request->has_id())
+        stream_id = mf::BufferStreamId{request->id().value()};
+
+    for (auto i = 0; i < request->buffer_requests().size(); i++)
+        allocate_buffer(*session, request->buffer_requests(i), stream_id);
+
     done->Run();
 }
  
@@ -30,6 +30,7 @@
 #include "mir/graphics/platform_ipc_operations.h"
 #include "mir/graphics/buffer_id.h"
 #include "mir/protobuf/display_server_debug.h"
+#include "mir/optional_value.h"
 #include "mir_toolkit/common.h"
 
 #include <functional>
@@ -284,6 +285,12 @@ private:
 
     void destroy_screencast_sessions();
 
+    /// Allocates a buffer for the client and sends it, or the failure, through event_sink
+    void allocate_buffer(
+        Session& session,
+        protobuf::BufferStreamParameters const& request,
+        optional_value<BufferStreamId> const& stream_id);
+
     pid_t client_pid_;
     std::shared_ptr<Shell> const shell;
     std::shared_ptr<graphics::PlatformIpcOperations> const ipc_operations;
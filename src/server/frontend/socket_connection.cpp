@@ -39,15 +39,25 @@ namespace bs = boost::system;
 
 namespace mfd = mir::frontend::detail;
 
+namespace
+{
+bool is_latency_critical(std::string const& method)
+{
+    return method == "submit_buffer" || method == "pong";
+}
+}
+
 mfd::SocketConnection::SocketConnection(
     std::shared_ptr<mfd::MessageReceiver> const& message_receiver,
     int id_,
     std::shared_ptr<Connections<SocketConnection>> const& connections,
-    std::shared_ptr<MessageProcessor> const& processor)
+    std::shared_ptr<MessageProcessor> const& processor,
+    std::unique_ptr<RequestScheduler::Client> scheduled)
      : message_receiver(message_receiver),
        id_(id_),
        connections(connections),
-       processor(processor)
+       processor(processor),
+       scheduled(std::move(scheduled))
 {
 }
 
@@ -90,36 +100,64 @@ void mfd::SocketConnection::on_read_size(const boost::system::error_code& error)
 }
 
 void mfd::SocketConnection::on_new_message(const boost::system::error_code& error)
-try
 {
-    if (error)
-    {
-        BOOST_THROW_EXCEPTION(std::runtime_error(error.message()));
-    }
-
     mir::protobuf::wire::Invocation invocation;
-    invocation.ParseFromArray(body.data(), body.size());
-
-    int const v = invocation.has_protocol_version() ?
-                  invocation.protocol_version() :
-                  -1;
-    if (v <  mir::protobuf::oldest_compatible_protocol_version() ||
-        v >= mir::protobuf::next_incompatible_protocol_version())
-        BOOST_THROW_EXCEPTION(std::runtime_error("Unsupported protocol version"));
-
     std::vector<mir::Fd> fds;
-    if (invocation.side_channel_fds() > 0)
+
+    try
+    {
+        if (error)
+        {
+            BOOST_THROW_EXCEPTION(std::runtime_error(error.message()));
+        }
+
+        invocation.ParseFromArray(body.data(), body.size());
+
+        int const v = invocation.has_protocol_version() ?
+                      invocation.protocol_version() :
+                      -1;
+        if (v <  mir::protobuf::oldest_compatible_protocol_version() ||
+            v >= mir::protobuf::next_incompatible_protocol_version())
+            BOOST_THROW_EXCEPTION(std::runtime_error("Unsupported protocol version"));
+
+        if (invocation.side_channel_fds() > 0)
+        {
+            fds.resize(invocation.side_channel_fds());
+            message_receiver->receive_fds(fds);
+        }
+
+        if (!client_pid)
+        {
+            client_pid = message_receiver->client_creds().pid();
+            processor->client_pid(client_pid);
+        }
+    }
+    catch (std::exception& e)
     {
-        fds.resize(invocation.side_channel_fds());
-        message_receiver->receive_fds(fds);
+        connections->remove(id());
+        mir::log_warning("Rejected and disconnected a client (%s)", e.what());
+        throw;
     }
 
-    if (!client_pid)
+    if (scheduled)
+    {
+        auto const priority = is_latency_critical(invocation.method_name()) ?
+            RequestScheduler::Priority::latency_critical :
+            RequestScheduler::Priority::normal;
+
+        scheduled->enqueue(priority, [this, invocation, fds] { dispatch(invocation, fds); });
+    }
+    else
     {
-        client_pid = message_receiver->client_creds().pid();
-        processor->client_pid(client_pid);
+        dispatch(invocation, fds);
     }
+}
 
+void mfd::SocketConnection::dispatch(
+    mir::protobuf::wire::Invocation const& invocation,
+    std::vector<mir::Fd> const& fds)
+try
+{
     if (processor->dispatch(invocation, fds))
     {
         read_next_message();
@@ -21,11 +21,18 @@
 #define MIR_FRONTEND_DETAIL_SOCKET_CONNECTION_H_
 
 #include "mir/frontend/connections.h"
+#include "request_scheduler.h"
 
 #include <boost/asio.hpp>
 
 #include <sys/types.h>
 
+namespace mir
+{
+class Fd;
+namespace protobuf { namespace wire { class Invocation; } }
+}
+
 namespace mir
 {
 namespace frontend
@@ -42,7 +49,8 @@ public:
         std::shared_ptr<MessageReceiver> const& message_receiver,
         int id_,
         std::shared_ptr<Connections<SocketConnection>> const& connections,
-        std::shared_ptr<MessageProcessor> const& processor);
+        std::shared_ptr<MessageProcessor> const& processor,
+        std::unique_ptr<RequestScheduler::Client> scheduled);
 
     ~SocketConnection() noexcept;
 
@@ -54,6 +62,7 @@ private:
     void on_response_sent(boost::system::error_code const& error, std::size_t);
     void on_new_message(const boost::system::error_code& ec);
     void on_read_size(const boost::system::error_code& ec);
+    void dispatch(protobuf::wire::Invocation const& invocation, std::vector<Fd> const& fds);
 
     std::shared_ptr<MessageReceiver> const message_receiver;
     int const id_;
@@ -65,6 +74,9 @@ private:
     std::vector<char> body;
 
     int client_pid = 0;
+
+    // Null if requests are dispatched as soon as they are read
+    std::unique_ptr<RequestScheduler::Client> const scheduled;
 };
 
 }
@@ -0,0 +1,188 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ordered_worker_pool.h"
+
+#include "mir/log.h"
+#include "mir/signal_blocker.h"
+#include "mir/thread_name.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <system_error>
+
+#include <signal.h>
+
+namespace mf = mir::frontend;
+
+class mf::OrderedWorkerPool::Strand : public mir::Executor, public std::enable_shared_from_this<Strand>
+{
+public:
+    explicit Strand(OrderedWorkerPool* pool)
+        : pool{pool}
+    {
+    }
+
+    void spawn(std::function<void()>&& work) override
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            tasks.emplace_back(std::move(work));
+
+            // A drain is already queued or running, and will pick this up
+            if (scheduled)
+                return;
+
+            scheduled = true;
+        }
+
+        pool->enqueue([self = shared_from_this()]() { self->drain(); });
+    }
+
+private:
+    void drain()
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        while (!tasks.empty())
+        {
+            auto task = std::move(tasks.front());
+            tasks.pop_front();
+
+            lock.unlock();
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                mir::log(
+                    mir::logging::Severity::critical,
+                    MIR_LOG_COMPONENT,
+                    std::current_exception(),
+                    "Exception processing Wayland worker item");
+            }
+            // Captured resources may have non-trivial destructors; run them outside the lock
+            task = nullptr;
+            lock.lock();
+        }
+        scheduled = false;
+    }
+
+    /*
+     * The pool is owned by the WaylandConnector, which outlives all clients
+     * and drains outstanding work on destruction.
+     */
+    OrderedWorkerPool* const pool;
+
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+    bool scheduled{false};
+};
+
+namespace
+{
+/*
+ * Signals raised by the faulting thread itself. The workers read client shm
+ * pools, and libwayland recovers from a client truncating one by handling
+ * the SIGBUS; if it is blocked the kernel kills the process instead.
+ */
+void unblock_fault_signals()
+{
+    sigset_t faults;
+    sigemptyset(&faults);
+    for (auto const signal : {SIGBUS, SIGSEGV, SIGFPE, SIGILL, SIGTRAP})
+        sigaddset(&faults, signal);
+
+    if (auto error = pthread_sigmask(SIG_UNBLOCK, &faults, nullptr))
+        BOOST_THROW_EXCEPTION((
+            std::system_error{error, std::system_category(), "Failed to unblock fault signals"}));
+}
+}
+
+mf::OrderedWorkerPool::OrderedWorkerPool(unsigned int thread_count)
+{
+    /*
+     * Block all signals but synchronous faults on the worker threads.
+     *
+     * Threads inherit their parent's signal mask, so use a SignalBlocker to block
+     * all signals *before* spawning the threads (and then restore the signal mask
+     * when this constructor completes).
+     */
+    mir::SignalBlocker blocker;
+    unblock_fault_signals();
+
+    for (auto i = 0u; i != std::max(thread_count, 1u); ++i)
+    {
+        threads.emplace_back([this]() { do_work(); });
+    }
+}
+
+mf::OrderedWorkerPool::~OrderedWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    work_available.notify_all();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+auto mf::OrderedWorkerPool::make_strand() -> std::shared_ptr<Executor>
+{
+    return std::make_shared<Strand>(this);
+}
+
+unsigned int mf::OrderedWorkerPool::default_thread_count()
+{
+    // Leave the rest of the machine to the compositor and the clients themselves
+    return std::max(2u, std::thread::hardware_concurrency() / 2);
+}
+
+void mf::OrderedWorkerPool::enqueue(std::function<void()>&& work)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        work_queue.emplace_back(std::move(work));
+    }
+    work_available.notify_one();
+}
+
+void mf::OrderedWorkerPool::do_work() noexcept
+{
+    mir::set_thread_name("Mir/Wayland/Wk");
+
+    std::unique_lock<std::mutex> lock{mutex};
+    for (;;)
+    {
+        work_available.wait(lock, [this]() { return stopping || !work_queue.empty(); });
+
+        if (work_queue.empty())
+            return;
+
+        auto work = std::move(work_queue.front());
+        work_queue.pop_front();
+
+        lock.unlock();
+        work();
+        work = nullptr;
+        lock.lock();
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_ORDERED_WORKER_POOL_H
+#define MIR_FRONTEND_ORDERED_WORKER_POOL_H
+
+#include "mir/executor.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mir
+{
+namespace frontend
+{
+/**
+ * A fixed set of threads for work that should stay off the Wayland event loop
+ *
+ * Work is not spawned on the pool directly; instead each client gets a strand
+ * from make_strand(). Work spawned on a strand runs in the order it was spawned
+ * and never concurrently with other work on the same strand, but different
+ * strands make progress in parallel.
+ *
+ * \note    The pool must outlive any work spawned on its strands. Work still
+ *          queued when the pool is destroyed is run before the threads exit.
+ */
+class OrderedWorkerPool
+{
+public:
+    explicit OrderedWorkerPool(unsigned int thread_count);
+    ~OrderedWorkerPool();
+
+    OrderedWorkerPool(OrderedWorkerPool const&) = delete;
+    OrderedWorkerPool& operator=(OrderedWorkerPool const&) = delete;
+
+    std::shared_ptr<Executor> make_strand();
+
+    static unsigned int default_thread_count();
+
+private:
+    class Strand;
+
+    void enqueue(std::function<void()>&& work);
+    void do_work() noexcept;
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::deque<std::function<void()>> work_queue;
+    bool stopping{false};
+    std::vector<std::thread> threads;
+};
+}
+}
+
+#endif // MIR_FRONTEND_ORDERED_WORKER_POOL_H
@@ -31,6 +31,7 @@
 #include "null_event_sink.h"
 #include "output_manager.h"
 #include "wayland_executor.h"
+#include "ordered_worker_pool.h"
 #include "wlshmbuffer.h"
 
 #include "generated/wayland_wrapper.h"
@@ -101,9 +102,13 @@ namespace
 {
 struct ClientPrivate
 {
-    ClientPrivate(std::shared_ptr<mf::Session> const& session, mf::Shell* shell)
+    ClientPrivate(
+        std::shared_ptr<mf::Session> const& session,
+        mf::Shell* shell,
+        std::shared_ptr<mir::Executor> const& worker)
         : session{session},
-          shell{shell}
+          shell{shell},
+          worker{worker}
     {
     }
 
@@ -124,6 +129,7 @@ struct ClientPrivate
      * This shell is owned by the ClientSessionConstructor, which outlives all clients.
      */
     mf::Shell* const shell;
+    std::shared_ptr<mir::Executor> const worker;
 };
 
 static_assert(
@@ -146,10 +152,12 @@ struct ClientSessionConstructor
 {
     ClientSessionConstructor(std::shared_ptr<mf::Shell> const& shell,
                              std::shared_ptr<mf::SessionAuthorizer> const& session_authorizer,
-                             std::unordered_map<int, std::function<void(std::shared_ptr<Session> const& session)>>* connect_handlers)
+                             std::unordered_map<int, std::function<void(std::shared_ptr<Session> const& session)>>* connect_handlers,
+                             OrderedWorkerPool* worker_pool)
         : shell{shell},
           session_authorizer{session_authorizer},
-          connect_handlers{connect_handlers}
+          connect_handlers{connect_handlers},
+          worker_pool{worker_pool}
     {
     }
 
@@ -158,7 +166,10 @@ struct ClientSessionConstructor
     std::shared_ptr<mf::Shell> const shell;
     std::shared_ptr<mf::SessionAuthorizer> const session_authorizer;
     std::unordered_map<int, std::function<void(std::shared_ptr<Session> const& session)>>* connect_handlers;
-
+    /*
+     * The worker pool is owned by the WaylandConnector, which outlives the wl_display.
+     */
+    OrderedWorkerPool* const worker_pool;
 };
 
 static_assert(
@@ -200,7 +211,10 @@ void create_client_session(wl_listener* listener, void* data)
         "",
         std::make_shared<NullEventSink>());
 
-    auto client_context = new ClientPrivate{session, construction_context->shell.get()};
+    auto client_context = new ClientPrivate{
+        session,
+        construction_context->shell.get(),
+        construction_context->worker_pool->make_strand()};
     client_context->destroy_listener.notify = &cleanup_private;
     wl_client_add_destroy_listener(client, &client_context->destroy_listener);
 
@@ -217,9 +231,10 @@ void cleanup_client_handler(wl_listener* listener, void*)
 
 void setup_new_client_handler(wl_display* display, std::shared_ptr<mf::Shell> const& shell,
                               std::shared_ptr<mf::SessionAuthorizer> const& session_authorizer,
-                              std::unordered_map<int, std::function<void(std::shared_ptr<Session> const& session)>>* connect_handlers)
+                              std::unordered_map<int, std::function<void(std::shared_ptr<Session> const& session)>>* connect_handlers,
+                              OrderedWorkerPool* worker_pool)
 {
-    auto context = new ClientSessionConstructor{shell, session_authorizer, connect_handlers};
+    auto context = new ClientSessionConstructor{shell, session_authorizer, connect_handlers, worker_pool};
     context->construction_listener.notify = &create_client_session;
 
     wl_display_add_client_created_listener(display, &context->construction_listener);
@@ -253,6 +268,16 @@ std::shared_ptr<mir::frontend::Session> get_session(wl_client* client)
     return nullptr;
 }
 
+std::shared_ptr<mir::Executor> get_worker(wl_client* client)
+{
+    auto listener = wl_client_get_destroy_listener(client, &cleanup_private);
+
+    if (listener)
+        return private_from_listener(listener)->worker;
+
+    return nullptr;
+}
+
 int64_t mir_input_event_get_event_time_ms(const MirInputEvent* event)
 {
     return mir_input_event_get_event_time(event) / 1000000;
@@ -620,7 +645,8 @@ mf::WaylandConnector::WaylandConnector(
     std::shared_ptr<mg::GraphicBufferAllocator> const& allocator,
     std::shared_ptr<mf::SessionAuthorizer> const& session_authorizer,
     bool arw_socket)
-    : display{wl_display_create(), &cleanup_display},
+    : worker_pool{std::make_unique<OrderedWorkerPool>(OrderedWorkerPool::default_thread_count())},
+      display{wl_display_create(), &cleanup_display},
       pause_signal{eventfd(0, EFD_CLOEXEC | EFD_SEMAPHORE)},
       allocator{allocator_for_display(allocator, display.get())}
 {
@@ -691,7 +717,7 @@ mf::WaylandConnector::WaylandConnector(
 
     auto wayland_loop = wl_display_get_event_loop(display.get());
 
-    setup_new_client_handler(display.get(), shell, session_authorizer, &connect_handlers);
+    setup_new_client_handler(display.get(), shell, session_authorizer, &connect_handlers, worker_pool.get());
 
     pause_source = wl_event_loop_add_fd(wayland_loop, pause_signal, WL_EVENT_READABLE, &halt_eventloop, display.get());
 }
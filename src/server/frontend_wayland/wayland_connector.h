@@ -52,6 +52,7 @@ class WlShell;
 class XdgShellV6;
 class WlSeat;
 class OutputManager;
+class OrderedWorkerPool;
 
 class Shell;
 class DisplayChanger;
@@ -86,6 +87,8 @@ public:
     auto socket_name() const -> optional_value<std::string> override;
 
 private:
+    // Declared first so that it outlives the wl_display and all the clients' work
+    std::unique_ptr<OrderedWorkerPool> const worker_pool;
     std::unique_ptr<wl_display, void(*)(wl_display*)> const display;
     mir::Fd const pause_signal;
     std::unique_ptr<WlCompositor> compositor_global;
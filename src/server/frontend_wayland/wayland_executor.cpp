@@ -25,10 +25,10 @@
 
 #include <boost/throw_exception.hpp>
 
+#include <atomic>
 #include <cstring>
-#include <deque>
 #include <functional>
-#include <mutex>
+#include <memory>
 #include <system_error>
 
 namespace
@@ -36,12 +36,37 @@ namespace
 class WaylandExecutor : public mir::Executor
 {
 public:
+    ~WaylandExecutor()
+    {
+        // Anything still queued will never run; just free it.
+        auto node = workqueue.exchange(nullptr);
+        while (node)
+        {
+            std::unique_ptr<WorkItem> const item{node};
+            node = item->next;
+        }
+    }
+
     void spawn (std::function<void ()>&& work) override
     {
+        auto const item = new WorkItem{std::move(work), nullptr};
+        auto head = workqueue.load(std::memory_order_relaxed);
+        do
         {
-            std::lock_guard<std::recursive_mutex> lock{mutex};
-            workqueue.emplace_back(std::move(work));
+            item->next = head;
         }
+        while (!workqueue.compare_exchange_weak(head, item, std::memory_order_release, std::memory_order_relaxed));
+
+        /*
+         * Only the spawn that finds the queue empty needs to wake the event loop;
+         * on_notify() takes the whole queue at once, so everything pushed after
+         * this and before it runs is handled by the same wakeup.
+         *
+         * (item may already have been run and freed by now, so don't touch it.)
+         */
+        if (head)
+            return;
+
         if (auto err = eventfd_write(notify_fd, 1))
         {
             BOOST_THROW_EXCEPTION((std::system_error{err, std::system_category(), "eventfd_write failed to notify event loop"}));
@@ -70,8 +95,19 @@ public:
     }
 
 private:
+    /*
+     * Work is pushed onto an intrusive singly-linked list, so spawn() from any
+     * thread needs no lock. The list is LIFO; the event loop reverses each batch
+     * it takes to run the work in the order it was spawned.
+     */
+    struct WorkItem
+    {
+        std::function<void()> work;
+        WorkItem* next;
+    };
+
     WaylandExecutor(wl_event_loop* loop)
-        : notify_fd{eventfd(0, EFD_CLOEXEC | EFD_SEMAPHORE | EFD_NONBLOCK)},
+        : notify_fd{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)},
         notify_source{wl_event_loop_add_fd(loop, notify_fd, WL_EVENT_READABLE, &on_notify, this)}
     {
         if (notify_fd == mir::Fd::invalid)
@@ -83,22 +119,29 @@ private:
         }
     }
 
-    std::function<void()> get_work()
+    WorkItem* take_work()
     {
-        std::lock_guard<std::recursive_mutex> lock{mutex};
-        if (!workqueue.empty())
+        auto head = workqueue.exchange(nullptr, std::memory_order_acquire);
+
+        WorkItem* reversed{nullptr};
+        while (head)
         {
-            auto const work = std::move(workqueue.front());
-            workqueue.pop_front();
-            return work;
+            auto const next = head->next;
+            head->next = reversed;
+            reversed = head;
+            head = next;
         }
-        return {};
+        return reversed;
     }
 
     static int on_notify(int fd, uint32_t, void* data)
     {
         auto executor = static_cast<WaylandExecutor*>(data);
 
+        /*
+         * Consume the wakeup *before* taking the queue: a spawn() racing with us
+         * either lands in this batch or sees an empty queue and signals again.
+         */
         eventfd_t unused;
         if (auto err = eventfd_read(fd, &unused))
         {
@@ -108,11 +151,15 @@ private:
                 err);
         }
 
-        while (auto work = executor->get_work())
+        auto item = executor->take_work();
+        while (item)
         {
+            std::unique_ptr<WorkItem> const current{item};
+            item = current->next;
+
             try
             {
-                work();
+                current->work();
             }
             catch(...)
             {
@@ -132,16 +179,12 @@ private:
         DestructionShim* shim;
         shim = wl_container_of(listener, shim, destruction_listener);
 
-        {
-            std::lock_guard<std::recursive_mutex> lock{shim->executor->mutex};
-            wl_event_source_remove(shim->executor->notify_source);
-        }
+        wl_event_source_remove(shim->executor->notify_source);
         delete shim;
     }
 
-    std::recursive_mutex mutex;
     mir::Fd const notify_fd;
-    std::deque<std::function<void()>> workqueue;
+    std::atomic<WorkItem*> workqueue{nullptr};
 
     wl_event_source* const notify_source;
 
@@ -28,6 +28,8 @@ struct MirInputEvent;
 
 namespace mir
 {
+class Executor;
+
 namespace frontend
 {
 class Session;
@@ -45,6 +47,13 @@ inline auto run_unless(std::shared_ptr<bool> const& condition, Callable&& callab
 
 std::shared_ptr<frontend::Session> get_session(wl_client* client);
 
+/**
+ * Get the client's executor for work that should not block the Wayland event loop
+ *
+ * Work spawned on it runs on a worker thread in the order it was spawned.
+ */
+std::shared_ptr<Executor> get_worker(wl_client* client);
+
 int64_t mir_input_event_get_event_time_ms(const MirInputEvent* event);
 
 }
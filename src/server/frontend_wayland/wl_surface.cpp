@@ -75,6 +75,7 @@ mf::WlSurface::WlSurface(
         stream{session->get_buffer_stream(stream_id)},
         allocator{allocator},
         executor{executor},
+        worker{mf::get_worker(client)},
         null_role{this},
         role{&null_role},
         destroyed{std::make_shared<bool>(false)}
@@ -296,6 +297,26 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
     if (state.input_shape)
         input_shape = state.input_shape.value();
 
+    /*
+     * An earlier buffer may still be waiting on the worker to be copied and
+     * submitted, so callbacks for a commit without a new buffer go through the
+     * worker too, rather than overtaking it.
+     */
+    auto const send_frame_callbacks_after_queued_buffers =
+        [this, worker = worker, executor = executor, destroyed = destroyed]()
+        {
+            worker->spawn(
+                [this, executor, destroyed]()
+                {
+                    executor->spawn(run_unless(
+                        destroyed,
+                        [this]()
+                        {
+                            send_frame_callbacks();
+                        }));
+                });
+        };
+
     if (state.buffer)
     {
         wl_resource * buffer = *state.buffer;
@@ -304,7 +325,7 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
         {
             // TODO: unmap surface, and unmap all subsurfaces
             buffer_size_ = std::experimental::nullopt;
-            send_frame_callbacks();
+            send_frame_callbacks_after_queued_buffers();
         }
         else
         {
@@ -319,11 +340,13 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
                 };
 
             std::shared_ptr<graphics::Buffer> mir_buffer;
+            std::shared_ptr<WlShmBuffer> shm_buffer;
 
             if (wl_shm_buffer_get(buffer))
             {
-                mir_buffer = WlShmBuffer::mir_buffer_from_wl_buffer(
+                mir_buffer = shm_buffer = WlShmBuffer::mir_buffer_from_wl_buffer(
                     buffer,
+                    executor,
                     std::move(executor_send_frame_callbacks));
             }
             else
@@ -357,13 +380,26 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
                 state.invalidate_surface_data(); // input shape needs to be recalculated for the new size
             }
             buffer_size_ = mir_buffer->size();
-            stream->resize(buffer_size_.value());
-            stream->submit_buffer(mir_buffer);
+
+            /*
+             * Copying a large SHM buffer can take milliseconds, so do it (and the
+             * submission that must follow it) on the client's worker rather than
+             * holding up every other client on the Wayland thread. Everything
+             * is submitted through the worker to keep this client's buffers in order.
+             */
+            worker->spawn(
+                [stream = stream, mir_buffer, shm_buffer, size = buffer_size_.value()]()
+                {
+                    if (shm_buffer)
+                        shm_buffer->copy_contents();
+                    stream->resize(size);
+                    stream->submit_buffer(mir_buffer);
+                });
         }
     }
     else
     {
-        send_frame_callbacks();
+        send_frame_callbacks_after_queued_buffers();
     }
 
     for (WlSubsurface* child: children)
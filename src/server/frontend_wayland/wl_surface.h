@@ -150,6 +150,7 @@ public:
 private:
     std::shared_ptr<mir::graphics::WaylandAllocator> const allocator;
     std::shared_ptr<mir::Executor> const executor;
+    std::shared_ptr<mir::Executor> const worker;
 
     NullWlSurfaceRole null_role;
     WlSurfaceRole* role;
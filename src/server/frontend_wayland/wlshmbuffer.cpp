@@ -20,6 +20,7 @@
 
 #include "wlshmbuffer.h"
 
+#include <mir/executor.h>
 #include <mir/log.h>
 
 #include <wayland-server-protocol.h>
@@ -129,13 +130,15 @@ using namespace mir::geometry;
 mf::WlShmBuffer::~WlShmBuffer()
 {
     std::lock_guard <std::mutex> lock{*buffer_mutex};
+    release_pool();
     if (buffer) {
         wl_resource_queue_event(resource, WL_BUFFER_RELEASE);
     }
 }
 
-std::shared_ptr<mg::Buffer> mf::WlShmBuffer::mir_buffer_from_wl_buffer(
+std::shared_ptr<mf::WlShmBuffer> mf::WlShmBuffer::mir_buffer_from_wl_buffer(
     wl_resource *buffer,
+    std::shared_ptr<Executor> const& wayland_executor,
     std::function<void()> &&on_consumed)
 {
     std::shared_ptr <WlShmBuffer> mir_buffer;
@@ -152,11 +155,11 @@ std::shared_ptr<mg::Buffer> mf::WlShmBuffer::mir_buffer_from_wl_buffer(
              *
              * Recreate a new WlShmBuffer to track the new compositor lifetime.
              */
-            mir_buffer = std::shared_ptr < WlShmBuffer > {new WlShmBuffer{buffer, std::move(on_consumed)}};
+            mir_buffer = std::shared_ptr < WlShmBuffer > {new WlShmBuffer{buffer, wayland_executor, std::move(on_consumed)}};
             shim->associated_buffer = mir_buffer;
         }
     } else {
-        mir_buffer = std::shared_ptr < WlShmBuffer > {new WlShmBuffer{buffer, std::move(on_consumed)}};
+        mir_buffer = std::shared_ptr < WlShmBuffer > {new WlShmBuffer{buffer, wayland_executor, std::move(on_consumed)}};
         shim = new DestructionShim;
         shim->destruction_listener.notify = &on_buffer_destroyed;
         shim->associated_buffer = mir_buffer;
@@ -225,6 +228,27 @@ void mf::WlShmBuffer::secure_for_render()
 {
 }
 
+void mf::WlShmBuffer::update_bound_texture()
+{
+    GLenum format, type;
+
+    if (get_gl_pixel_format(
+        format_,
+        format,
+        type)) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        read(
+            [this, format, type](unsigned char const *pixels)
+            {
+                auto const size = this->size();
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                                size.width.as_int(), size.height.as_int(),
+                                format, type, pixels);
+            });
+    }
+}
+
 void mf::WlShmBuffer::write(unsigned char const *pixels, size_t size)
 {
     std::lock_guard <std::mutex> lock{*buffer_mutex};
@@ -255,12 +279,41 @@ Stride mf::WlShmBuffer::stride() const
     return stride_;
 }
 
+void mf::WlShmBuffer::copy_contents()
+{
+    std::lock_guard <std::mutex> lock{*buffer_mutex};
+    if (!pool) {
+        return;
+    }
+
+    if (buffer) {
+        wl_shm_buffer_begin_access(buffer);
+        std::memcpy(data.get(), wl_shm_buffer_get_data(buffer), size_.height.as_int() * stride_.as_int());
+        wl_shm_buffer_end_access(buffer);
+    } else {
+        log_warning("WlShmBuffer destroyed by the client before its contents were read");
+    }
+
+    release_pool();
+}
+
+void mf::WlShmBuffer::release_pool()
+{
+    if (pool) {
+        wayland_executor->spawn([pool = pool]() { wl_shm_pool_unref(pool); });
+        pool = nullptr;
+    }
+}
+
 mf::WlShmBuffer::WlShmBuffer(
     wl_resource *buffer,
+    std::shared_ptr<Executor> const& wayland_executor,
     std::function<void()> &&on_consumed)
     :
     buffer{shm_buffer_from_resource_checked(buffer)},
     resource{buffer},
+    pool{nullptr},
+    wayland_executor{wayland_executor},
     size_{wl_shm_buffer_get_width(this->buffer), wl_shm_buffer_get_height(this->buffer)},
     stride_{wl_shm_buffer_get_stride(this->buffer)},
     format_{wl_format_to_mir_format(wl_shm_buffer_get_format(this->buffer))},
@@ -280,9 +333,7 @@ mf::WlShmBuffer::WlShmBuffer(
                                   std::runtime_error{"Buffer has invalid stride"}));
     }
 
-    wl_shm_buffer_begin_access(this->buffer);
-    std::memcpy(data.get(), wl_shm_buffer_get_data(this->buffer), size_.height.as_int() * stride_.as_int());
-    wl_shm_buffer_end_access(this->buffer);
+    pool = wl_shm_buffer_ref_pool(this->buffer);
 }
 
 void mf::WlShmBuffer::on_buffer_destroyed(wl_listener *listener, void *)
@@ -32,6 +32,8 @@
 
 namespace mir
 {
+class Executor;
+
 namespace frontend
 {
 
@@ -39,15 +41,27 @@ class WlShmBuffer :
     public graphics::BufferBasic,
     public graphics::NativeBufferBase,
     public renderer::gl::TextureSource,
+    public renderer::gl::TextureUpdateSource,
     public renderer::software::PixelSource
 {
 public:
     ~WlShmBuffer();
 
-    static std::shared_ptr <graphics::Buffer> mir_buffer_from_wl_buffer(
+    static std::shared_ptr <WlShmBuffer> mir_buffer_from_wl_buffer(
         wl_resource *buffer,
+        std::shared_ptr<Executor> const& wayland_executor,
         std::function<void()> &&on_consumed);
 
+    /**
+     * Take a copy of the client's pixels
+     *
+     * This may be called from any thread, so that large buffers need not be
+     * copied on the Wayland event loop; the buffer must not be submitted for
+     * rendering until it returns. Buffers that were already holding the current
+     * contents when returned by mir_buffer_from_wl_buffer() are not copied again.
+     */
+    void copy_contents();
+
     std::shared_ptr <graphics::NativeBuffer> native_buffer_handle() const override;
 
     geometry::Size size() const override;
@@ -62,6 +76,8 @@ public:
 
     void secure_for_render() override;
 
+    void update_bound_texture() override;
+
     void write(unsigned char const *pixels, size_t size) override;
 
     void read(std::function<void(unsigned char const *)> const &do_with_pixels) override;
@@ -71,8 +87,11 @@ public:
 private:
     WlShmBuffer(
         wl_resource *buffer,
+        std::shared_ptr<Executor> const& wayland_executor,
         std::function<void()> &&on_consumed);
 
+    void release_pool();
+
     static void on_buffer_destroyed(wl_listener *listener, void *);
 
     struct DestructionShim
@@ -87,6 +106,14 @@ private:
     wl_shm_buffer *buffer;
     wl_resource *const resource;
 
+    /*
+     * Held from construction until copy_contents() so the client can't resize
+     * (and so remap) the pool under a copy running off the Wayland thread.
+     * Must only be released on the Wayland thread.
+     */
+    wl_shm_pool *pool;
+    std::shared_ptr<Executor> const wayland_executor;
+
     geometry::Size const size_;
     geometry::Stride const stride_;
     MirPixelFormat const format_;
@@ -48,6 +48,7 @@
 
 #include <boost/throw_exception.hpp>
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 
@@ -189,15 +190,23 @@ mir::DefaultServerConfiguration::the_display()
     return display(
         [this]() -> std::shared_ptr<mg::Display>
         {
-            if (the_options()->is_set(options::offscreen_opt))
+            auto const options = the_options();
+            if (options->is_set(options::offscreen_opt))
             {
                 if (auto egl_access = dynamic_cast<mir::renderer::gl::EGLPlatform*>(
                     the_graphics_platform()->native_rendering_platform()))
                 {
+                    mg::offscreen::DisplaySettings settings;
+                    settings.render_targets = std::max(options->get<int>(options::offscreen_render_targets_opt), 1);
+                    if (auto const hz = options->get<int>(options::offscreen_refresh_rate_opt))
+                        settings.refresh_interval = std::chrono::nanoseconds{1000000000 / std::max(hz, 1)};
+                    settings.frame_sink_slots = std::max(options->get<int>(options::offscreen_frame_sink_opt), 0);
+
                     return std::make_shared<mg::offscreen::Display>(
                         egl_access->egl_native_display(),
                         the_display_configuration_policy(),
-                        the_display_report());
+                        the_display_report(),
+                        settings);
                 }
                 else
                 {
@@ -27,6 +27,7 @@
 #include "mir/graphics/egl_error.h"
 #include "buffer.h"
 
+#include <algorithm>
 #include <sstream>
 #include <boost/throw_exception.hpp>
 #include <stdexcept>
@@ -37,6 +38,38 @@ namespace geom = mir::geometry;
 
 namespace
 {
+// Each passed-through renderable costs a chain on the host
+size_t const max_passthrough_surfaces{8};
+
+// Whether the union of rects (all inside area) covers area. Their edges split
+// area into cells that each rect either covers or misses entirely.
+bool covers(geom::Rectangle const& area, std::vector<geom::Rectangle> const& rects)
+{
+    std::vector<geom::X> xs{area.left(), area.right()};
+    std::vector<geom::Y> ys{area.top(), area.bottom()};
+    for (auto const& rect : rects)
+    {
+        xs.insert(xs.end(), {rect.left(), rect.right()});
+        ys.insert(ys.end(), {rect.top(), rect.bottom()});
+    }
+    std::sort(xs.begin(), xs.end());
+    std::sort(ys.begin(), ys.end());
+
+    for (size_t i = 0; i + 1 < xs.size(); ++i)
+    {
+        for (size_t j = 0; j + 1 < ys.size(); ++j)
+        {
+            if (xs[i] == xs[i + 1] || ys[j] == ys[j + 1])
+                continue;
+
+            geom::Point const cell{xs[i], ys[j]};
+            if (std::none_of(rects.begin(), rects.end(), [&](auto const& rect) { return rect.contains(cell); }))
+                return false;
+        }
+    }
+    return true;
+}
+
 std::shared_ptr<mgn::HostStream> create_host_stream(
     mgn::HostConnection& connection,
     mg::DisplayConfigurationOutput const& output)
@@ -68,7 +101,6 @@ mgn::detail::DisplayBuffer::DisplayBuffer(
     host_stream{create_host_stream(*host_connection, best_output)},
     host_surface{create_host_surface(*host_connection, host_stream, best_output)},
     host_connection{host_connection},
-    host_chain{nullptr},
     egl_config{egl_display.choose_windowed_config(best_output.current_format)},
     egl_context{egl_display, eglCreateContext(egl_display, egl_config, egl_display.egl_context(), nested_egl_context_attribs)},
     area{best_output.extents()},
@@ -105,9 +137,10 @@ void mgn::detail::DisplayBuffer::swap_buffers()
         spec->add_stream(*host_stream, geom::Displacement{0,0}, area.size);
         content = BackingContent::stream;
         host_surface->apply_spec(*spec);
-        //if the host_chain is not released, a buffer of the passthrough surface might get caught
-        //up in the host server, resulting a drop in nbuffers available to the client
-        host_chain = nullptr;
+        //if the host chains are not released, a buffer of the passthrough surfaces might get caught
+        //up in the host server, resulting a drop in nbuffers available to the clients
+        passthroughs.clear();
+        arrangement.clear();
     }
 }
 
@@ -117,65 +150,119 @@ void mgn::detail::DisplayBuffer::bind()
 
 bool mgn::detail::DisplayBuffer::overlay(RenderableList const& list)
 {
-    if ((passthrough_option == mgn::PassthroughOption::disabled) ||
-        list.empty())
-    {
-        //could not represent scene with subsurfaces
+    if (passthrough_option == mgn::PassthroughOption::disabled)
         return false;
-    }
 
-    auto const topmost = list.back();
-
-    if ((topmost->screen_position() != area) ||
-        (topmost->alpha() != 1.0f) ||
-        (topmost->shaped()) ||
-        (topmost->transformation() != identity))
+    // Pass renderables through from the top down until they cover the
+    // output; anything below that is hidden.
+    RenderableList shown;
+    std::vector<mgn::NativeBuffer*> natives;
+    std::vector<geom::Rectangle> positions;
+    bool covered{false};
+    for (auto renderable = list.rbegin(); renderable != list.rend() && !covered; ++renderable)
     {
-        //could not represent scene with subsurfaces
-        return false;
+        auto const position = (*renderable)->screen_position();
+        auto const native = dynamic_cast<mgn::NativeBuffer*>(
+            (*renderable)->buffer()->native_buffer_handle().get());
+
+        if ((shown.size() == max_passthrough_surfaces) ||
+            !area.contains(position) ||
+            ((*renderable)->alpha() != 1.0f) ||
+            ((*renderable)->shaped()) ||
+            ((*renderable)->transformation() != identity) ||
+            !native ||
+            (std::find(natives.begin(), natives.end(), native) != natives.end()))
+        {
+            //could not represent scene with subsurfaces
+            return false;
+        }
+
+        shown.insert(shown.begin(), *renderable);
+        natives.insert(natives.begin(), native);
+        positions.push_back(position);
+        covered = covers(area, positions);
     }
 
-    auto passthrough_buffer = topmost->buffer();
-    auto native = dynamic_cast<mgn::NativeBuffer*>(passthrough_buffer->native_buffer_handle().get());
-    if (!native)
+    if (!covered)
         return false;
 
-    if (!host_chain)
-        host_chain = host_connection->create_chain();
+    std::vector<Renderable::ID> ids;
+    for (auto const& renderable : shown)
+        ids.push_back(renderable->id());
 
+    bool rearranged{content != BackingContent::chain || ids != arrangement};
+    for (size_t i = 0; i != shown.size(); ++i)
     {
-        std::unique_lock<std::mutex> lk(mutex);
-        SubmissionInfo submission_info{native->client_handle(), host_chain->handle()};
-        auto submitted = submitted_buffers.find(submission_info);
-        if ((submission_info != last_submitted) && (submitted != submitted_buffers.end()))
-            BOOST_THROW_EXCEPTION(std::logic_error("cannot resubmit buffer that has not been returned by host server"));
-        if ((submission_info == last_submitted) && (submitted != submitted_buffers.end()))
-            return true;
+        auto passthrough = passthroughs.find(ids[i]);
+        if (passthrough == passthroughs.end())
+        {
+            passthrough = passthroughs.emplace(
+                ids[i], Passthrough{host_connection->create_chain(), {}, {nullptr, nullptr}}).first;
+        }
 
-        if (topmost->swap_interval() == 0)
-            host_chain->set_submission_mode(mgn::SubmissionMode::dropping);
-        else
-            host_chain->set_submission_mode(mgn::SubmissionMode::queueing);
+        auto const position = shown[i]->screen_position();
+        if (passthrough->second.position != position)
+        {
+            passthrough->second.position = position;
+            rearranged = true;
+        }
 
-        submitted_buffers[submission_info] = passthrough_buffer;
-        last_submitted = submission_info;
+        submit(passthrough->second, *shown[i], *natives[i]);
     }
 
-    native->on_ownership_notification(
-        std::bind(&mgn::detail::DisplayBuffer::release_buffer, this,
-        native->client_handle(), host_chain->handle()));
-    host_chain->submit_buffer(*native);
-
-    if (content != BackingContent::chain)
+    if (rearranged)
     {
         auto spec = host_connection->create_surface_spec();
-        spec->add_chain(*host_chain, geom::Displacement{0,0}, area.size);
+        for (auto const id : ids)
+        {
+            auto const& passthrough = passthroughs.at(id);
+            auto const& position = passthrough.position;
+            spec->add_chain(*passthrough.chain, position.top_left - area.top_left, position.size);
+        }
         content = BackingContent::chain;
         host_surface->apply_spec(*spec);
+        arrangement = std::move(ids);
+
+        // Only release chains the host surface no longer shows
+        for (auto passthrough = passthroughs.begin(); passthrough != passthroughs.end();)
+        {
+            if (std::find(arrangement.begin(), arrangement.end(), passthrough->first) == arrangement.end())
+                passthrough = passthroughs.erase(passthrough);
+            else
+                ++passthrough;
+        }
     }
     return true;
 }
 
+void mgn::detail::DisplayBuffer::submit(
+    Passthrough& passthrough, Renderable const& renderable, mgn::NativeBuffer& native)
+{
+    auto& host_chain = *passthrough.chain;
+    {
+        std::unique_lock<std::mutex> lk(mutex);
+        SubmissionInfo submission_info{native.client_handle(), host_chain.handle()};
+        auto submitted = submitted_buffers.find(submission_info);
+        if ((submission_info != passthrough.last_submitted) && (submitted != submitted_buffers.end()))
+            BOOST_THROW_EXCEPTION(std::logic_error("cannot resubmit buffer that has not been returned by host server"));
+        if ((submission_info == passthrough.last_submitted) && (submitted != submitted_buffers.end()))
+            return;
+
+        if (renderable.swap_interval() == 0)
+            host_chain.set_submission_mode(mgn::SubmissionMode::dropping);
+        else
+            host_chain.set_submission_mode(mgn::SubmissionMode::queueing);
+
+        submitted_buffers[submission_info] = renderable.buffer();
+        passthrough.last_submitted = submission_info;
+    }
+
+    native.on_ownership_notification(
+        std::bind(&mgn::detail::DisplayBuffer::release_buffer, this,
+        native.client_handle(), host_chain.handle()));
+    host_chain.submit_buffer(native);
+}
+
 void mgn::detail::DisplayBuffer::release_buffer(MirBuffer* b, MirPresentationChain *c)
 {
     std::unique_lock<std::mutex> lk(mutex);
@@ -27,6 +27,7 @@
 #include "host_chain.h"
 
 #include <map>
+#include <vector>
 #include <glm/glm.hpp>
 #include <EGL/egl.h>
 
@@ -73,7 +74,6 @@ private:
     std::shared_ptr<HostStream> const host_stream;
     std::shared_ptr<HostSurface> const host_surface;
     std::shared_ptr<HostConnection> const host_connection;
-    std::unique_ptr<HostChain> host_chain;
     EGLConfig const egl_config;
     EGLContextStore const egl_context;
     geometry::Rectangle const area;
@@ -93,8 +93,20 @@ private:
     std::mutex mutex;
     typedef std::tuple<MirBuffer*, MirPresentationChain*> SubmissionInfo;
     std::map<SubmissionInfo, std::shared_ptr<graphics::Buffer>> submitted_buffers;
-    SubmissionInfo last_submitted { nullptr, nullptr };
 
+    // A host chain showing one passed-through renderable
+    struct Passthrough
+    {
+        std::unique_ptr<HostChain> chain;
+        geometry::Rectangle position;
+        SubmissionInfo last_submitted;
+    };
+    // Kept per renderable, as the host owns buffers submitted to a chain
+    std::map<Renderable::ID, Passthrough> passthroughs;
+    // Bottom to top, as arranged on the host surface
+    std::vector<Renderable::ID> arrangement;
+
+    void submit(Passthrough& passthrough, Renderable const& renderable, NativeBuffer& native);
     void release_buffer(MirBuffer* b, MirPresentationChain* c);
 };
 }
@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cursor.h"
+#include "mir/graphics/cursor_image.h"
+
+namespace mg = mir::graphics;
+namespace mgo = mg::offscreen;
+namespace geom = mir::geometry;
+
+mgo::Cursor::Cursor(std::function<void(CursorSprite const&)> const& changed) :
+    changed{changed}
+{
+}
+
+void mgo::Cursor::show()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (visible || !pixels)
+        return;
+
+    visible = true;
+    changed_locked();
+}
+
+void mgo::Cursor::show(CursorImage const& cursor_image)
+{
+    auto const argb = static_cast<uint32_t const*>(cursor_image.as_argb_8888());
+    auto const new_size = cursor_image.size();
+    auto const new_pixels = std::make_shared<std::vector<uint32_t> const>(
+        argb, argb + new_size.width.as_uint32_t() * new_size.height.as_uint32_t());
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    visible = true;
+    hotspot = cursor_image.hotspot();
+    size = new_size;
+    pixels = new_pixels;
+    changed_locked();
+}
+
+void mgo::Cursor::hide()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (!visible)
+        return;
+
+    visible = false;
+    changed_locked();
+}
+
+void mgo::Cursor::move_to(geom::Point new_position)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    position = new_position;
+
+    if (visible)
+        changed_locked();
+}
+
+void mgo::Cursor::changed_locked()
+{
+    // Notifying under the lock keeps the outputs' idea of the cursor in order
+    changed(CursorSprite{{position - hotspot, size}, visible ? pixels : nullptr});
+}
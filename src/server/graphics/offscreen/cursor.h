@@ -0,0 +1,76 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_OFFSCREEN_CURSOR_H_
+#define MIR_GRAPHICS_OFFSCREEN_CURSOR_H_
+
+#include "mir/graphics/cursor.h"
+#include "mir/geometry/rectangle.h"
+#include "mir/geometry/displacement.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mir
+{
+namespace graphics
+{
+namespace offscreen
+{
+struct CursorSprite
+{
+    geometry::Rectangle area;
+    /// Premultiplied ARGB, or null while the cursor is hidden
+    std::shared_ptr<std::vector<uint32_t> const> pixels;
+};
+
+/**
+ * A cursor the offscreen outputs draw over the frames they publish, instead
+ * of it being composited with the scene. Any change is passed to \a changed
+ * so the outputs can republish their latest frame with the cursor redrawn,
+ * without a new frame being composited.
+ */
+class Cursor : public graphics::Cursor
+{
+public:
+    explicit Cursor(std::function<void(CursorSprite const&)> const& changed);
+
+    void show() override;
+    void show(CursorImage const& cursor_image) override;
+    void hide() override;
+
+    void move_to(geometry::Point position) override;
+
+private:
+    void changed_locked();
+
+    std::function<void(CursorSprite const&)> const changed;
+
+    std::mutex mutex;
+    bool visible{false};
+    geometry::Point position;
+    geometry::Displacement hotspot;
+    geometry::Size size;
+    std::shared_ptr<std::vector<uint32_t> const> pixels;
+};
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_OFFSCREEN_CURSOR_H_ */
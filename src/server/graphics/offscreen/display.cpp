@@ -73,11 +73,19 @@ mgo::detail::EGLDisplayHandle::~EGLDisplayHandle() noexcept
         eglTerminate(egl_display);
 }
 
-mgo::detail::DisplaySyncGroup::DisplaySyncGroup(std::unique_ptr<mg::DisplayBuffer> output) :
-    output(std::move(output))
+mgo::detail::DisplaySyncGroup::DisplaySyncGroup(
+    std::unique_ptr<mgo::DisplayBuffer> output,
+    DisplayConfigurationOutputId output_id,
+    std::chrono::nanoseconds refresh_interval) :
+    output_id{output_id},
+    output(std::move(output)),
+    refresh_interval{refresh_interval},
+    next_vsync{Frame::Timestamp::now(CLOCK_MONOTONIC)}
 {
 }
 
+mgo::detail::DisplaySyncGroup::~DisplaySyncGroup() = default;
+
 void mgo::detail::DisplaySyncGroup::for_each_display_buffer(
     std::function<void(mg::DisplayBuffer&)> const& f)
 {
@@ -86,6 +94,28 @@ void mgo::detail::DisplaySyncGroup::for_each_display_buffer(
 
 void mgo::detail::DisplaySyncGroup::post()
 {
+    auto frame = last_frame.load();
+    ++frame.msc;
+
+    if (refresh_interval.count() > 0)
+    {
+        auto const now = Frame::Timestamp::now(CLOCK_MONOTONIC);
+
+        // Like real hardware, a late frame waits for the next vblank rather than catching up
+        if (next_vsync < now)
+            next_vsync = now + (refresh_interval - (now - next_vsync) % refresh_interval);
+
+        mir::time::sleep_until(next_vsync);
+        frame.ust = next_vsync;
+        next_vsync = next_vsync + refresh_interval;
+    }
+    else
+    {
+        frame.ust = Frame::Timestamp::now(CLOCK_MONOTONIC);
+    }
+
+    last_frame.store(frame);
+    output->frame_presented(frame);
 }
 
 std::chrono::milliseconds
@@ -94,11 +124,18 @@ mgo::detail::DisplaySyncGroup::recommended_sleep() const
     return std::chrono::milliseconds::zero();
 }
 
+void mgo::detail::DisplaySyncGroup::set_cursor(CursorSprite const& sprite)
+{
+    output->set_cursor(sprite);
+}
+
 mgo::Display::Display(
     EGLNativeDisplayType egl_native_display,
     std::shared_ptr<DisplayConfigurationPolicy> const& initial_conf_policy,
-    std::shared_ptr<DisplayReport> const&)
+    std::shared_ptr<DisplayReport> const&,
+    DisplaySettings const& settings)
     : egl_display{create_and_initialize_display(egl_native_display)},
+      settings(settings),
       egl_context_shared{egl_display, EGL_NO_CONTEXT},
       current_display_configuration{geom::Size{1024,768}}
 {
@@ -153,10 +190,17 @@ void mgo::Display::configure(mg::DisplayConfiguration const& conf)
                 eglBindAPI(MIR_SERVER_EGL_OPENGL_API);
                 auto raw_db = new mgo::DisplayBuffer{
                     SurfacelessEGLContext{egl_display, egl_context_shared},
-                    output.extents()};
+                    egl_display,
+                    output.extents(),
+                    settings.render_targets,
+                    settings.frame_sink_slots};
+                raw_db->set_cursor(cursor);
 
                 display_sync_groups.emplace_back(
-                    new mgo::detail::DisplaySyncGroup(std::unique_ptr<mg::DisplayBuffer>(raw_db)));
+                    new mgo::detail::DisplaySyncGroup(
+                        std::unique_ptr<mgo::DisplayBuffer>(raw_db),
+                        output.id,
+                        settings.refresh_interval));
             }
         });
 }
@@ -184,7 +228,20 @@ void mgo::Display::resume()
 
 std::shared_ptr<mg::Cursor> mgo::Display::create_hardware_cursor()
 {
-    return {};
+    // The cursor is drawn over published frames, so without a frame sink it couldn't be seen
+    if (settings.frame_sink_slots == 0)
+        return {};
+
+    return std::make_shared<mgo::Cursor>([this](CursorSprite const& sprite) { set_cursor(sprite); });
+}
+
+void mgo::Display::set_cursor(CursorSprite const& sprite)
+{
+    std::lock_guard<std::mutex> lock{configuration_mutex};
+
+    cursor = sprite;
+    for (auto& group : display_sync_groups)
+        group->set_cursor(sprite);
 }
 
 std::unique_ptr<mir::renderer::gl::Context> mgo::Display::create_gl_context()
@@ -198,8 +255,16 @@ mg::NativeDisplay* mgo::Display::native_display()
     return this;
 }
 
-mg::Frame mgo::Display::last_frame_on(unsigned) const
+mg::Frame mgo::Display::last_frame_on(unsigned output_id) const
 {
+    std::lock_guard<std::mutex> lock{configuration_mutex};
+
+    for (auto const& group : display_sync_groups)
+    {
+        if (group->output_id == DisplayConfigurationOutputId{static_cast<int>(output_id)})
+            return group->last_frame.load();
+    }
+
     return {};
 }
 
@@ -20,10 +20,13 @@
 #define MIR_GRAPHICS_OFFSCREEN_DISPLAY_H_
 
 #include "mir/graphics/display.h"
+#include "mir/graphics/atomic_frame.h"
 #include "display_configuration.h"
+#include "cursor.h"
 #include "mir/graphics/surfaceless_egl_context.h"
 #include "mir/renderer/gl/context_source.h"
 
+#include <chrono>
 #include <mutex>
 #include <vector>
 
@@ -39,6 +42,18 @@ class DisplayReport;
 
 namespace offscreen
 {
+class DisplayBuffer;
+
+struct DisplaySettings
+{
+    /// Framebuffers each output cycles through, so rendering can run ahead of the GPU
+    unsigned int render_targets{2};
+    /// Simulated vsync interval; zero means posting never waits
+    std::chrono::nanoseconds refresh_interval{0};
+    /// Frames each output keeps available to consumers; zero disables the frame sink
+    unsigned int frame_sink_slots{0};
+};
+
 namespace detail
 {
 
@@ -62,12 +77,24 @@ private:
 class DisplaySyncGroup : public graphics::DisplaySyncGroup
 {
 public:
-    DisplaySyncGroup(std::unique_ptr<DisplayBuffer> output);
-    void for_each_display_buffer(std::function<void(DisplayBuffer&)> const&) override;
+    DisplaySyncGroup(
+        std::unique_ptr<offscreen::DisplayBuffer> output,
+        DisplayConfigurationOutputId output_id,
+        std::chrono::nanoseconds refresh_interval);
+    ~DisplaySyncGroup();
+    void for_each_display_buffer(std::function<void(graphics::DisplayBuffer&)> const&) override;
     void post() override;
     std::chrono::milliseconds recommended_sleep() const override;
+
+    void set_cursor(CursorSprite const& sprite);
+
+    DisplayConfigurationOutputId const output_id;
+    AtomicFrame last_frame;
+
 private:
-    std::unique_ptr<DisplayBuffer> const output;
+    std::unique_ptr<offscreen::DisplayBuffer> const output;
+    std::chrono::nanoseconds const refresh_interval;
+    Frame::Timestamp next_vsync;
 };
 
 }
@@ -79,7 +106,8 @@ class Display : public graphics::Display,
 public:
     Display(EGLNativeDisplayType egl_native_display,
             std::shared_ptr<DisplayConfigurationPolicy> const& initial_conf_policy,
-            std::shared_ptr<DisplayReport> const& listener);
+            std::shared_ptr<DisplayReport> const& listener,
+            DisplaySettings const& settings = DisplaySettings{});
     ~Display() noexcept;
 
     void for_each_display_sync_group(std::function<void(DisplaySyncGroup&)> const& f) override;
@@ -99,7 +127,7 @@ public:
     void pause() override;
     void resume() override;
 
-    std::shared_ptr<Cursor> create_hardware_cursor() override;
+    std::shared_ptr<graphics::Cursor> create_hardware_cursor() override;
     std::unique_ptr<VirtualOutput> create_virtual_output(int width, int height) override;
 
     NativeDisplay* native_display() override;
@@ -108,11 +136,15 @@ public:
     std::unique_ptr<renderer::gl::Context> create_gl_context() override;
     bool apply_if_configuration_preserves_display_buffers(graphics::DisplayConfiguration const& conf) override;
 private:
+    void set_cursor(CursorSprite const& sprite);
+
     detail::EGLDisplayHandle const egl_display;
+    DisplaySettings const settings;
     SurfacelessEGLContext const egl_context_shared;
     mutable std::mutex configuration_mutex;
     DisplayConfiguration current_display_configuration;
-    std::vector<std::unique_ptr<DisplaySyncGroup>> display_sync_groups;
+    std::vector<std::unique_ptr<detail::DisplaySyncGroup>> display_sync_groups;
+    CursorSprite cursor;
 };
 
 }
@@ -19,9 +19,13 @@
 #include "display_buffer.h"
 #include "mir/graphics/gl_extensions_base.h"
 #include "mir/raii.h"
+#include "mir/log.h"
 
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 #include <stdexcept>
+#include <cstring>
+#include <unistd.h>
 
 #include MIR_SERVER_GL_H
 #include MIR_SERVER_GLEXT_H
@@ -43,6 +47,41 @@ public:
     }
 };
 
+std::unique_ptr<mgo::detail::FenceSyncExtensions const> load_fence_sync(EGLDisplay egl_display)
+{
+    auto const extensions = eglQueryString(egl_display, EGL_EXTENSIONS);
+    if (!extensions || !mg::GLExtensionsBase{extensions}.support("EGL_KHR_fence_sync"))
+        return nullptr;
+
+    auto const create = reinterpret_cast<PFNEGLCREATESYNCKHRPROC>(eglGetProcAddress("eglCreateSyncKHR"));
+    auto const destroy = reinterpret_cast<PFNEGLDESTROYSYNCKHRPROC>(eglGetProcAddress("eglDestroySyncKHR"));
+    auto const wait = reinterpret_cast<PFNEGLCLIENTWAITSYNCKHRPROC>(eglGetProcAddress("eglClientWaitSyncKHR"));
+
+    if (!create || !destroy || !wait)
+        return nullptr;
+
+    return std::unique_ptr<mgo::detail::FenceSyncExtensions const>{
+        new mgo::detail::FenceSyncExtensions{create, destroy, wait}};
+}
+
+// Blends a premultiplied ARGB cursor pixel over a frame pixel, in the frame's
+// channel order
+uint32_t blend(uint32_t dst, uint32_t src, bool abgr)
+{
+    if (abgr)
+        src = (src & 0xff00ff00) | ((src & 0xff) << 16) | ((src >> 16) & 0xff);
+
+    auto const inverse_alpha = 255 - (src >> 24);
+    uint32_t result = 0;
+    for (auto const shift : {0, 8, 16, 24})
+    {
+        auto const s = (src >> shift) & 0xff;
+        auto const d = (dst >> shift) & 0xff;
+        result |= std::min(255u, s + (d * inverse_alpha + 127) / 255) << shift;
+    }
+    return result;
+}
+
 }
 
 mgo::detail::GLFramebufferObject::GLFramebufferObject(geom::Size const& size)
@@ -117,11 +156,34 @@ void mgo::detail::GLFramebufferObject::unbind() const
 }
 
 mgo::DisplayBuffer::DisplayBuffer(SurfacelessEGLContext egl_context,
-                                  geom::Rectangle const& area)
+                                  EGLDisplay egl_display,
+                                  geom::Rectangle const& area,
+                                  unsigned int render_targets,
+                                  unsigned int frame_sink_slots)
     : egl_context{std::move(egl_context)},
-      fbo{area.size},
-      area(area)
+      egl_display{egl_display},
+      area(area),
+      fence_sync{load_fence_sync(egl_display)},
+      frame_sink_slots{frame_sink_slots}
 {
+    // Without fences there is nothing to tell us when a framebuffer is free
+    if (!fence_sync)
+        render_targets = 1;
+
+    for (auto i = 0u; i != std::max(render_targets, 1u); ++i)
+    {
+        in_flight.push_back(InFlightFrame{
+            std::make_unique<detail::GLFramebufferObject>(area.size), EGL_NO_SYNC_KHR, false, {}});
+    }
+}
+
+mgo::DisplayBuffer::~DisplayBuffer() noexcept
+{
+    for (auto& frame : in_flight)
+    {
+        if (frame.fence != EGL_NO_SYNC_KHR)
+            fence_sync->eglDestroySyncKHR(egl_display, frame.fence);
+    }
 }
 
 geom::Rectangle mgo::DisplayBuffer::view_area() const
@@ -136,18 +198,218 @@ void mgo::DisplayBuffer::make_current()
 
 void mgo::DisplayBuffer::bind()
 {
-    fbo.bind();
+    // Only now do we need the previous contents of this framebuffer to be done with
+    retire(in_flight[current]);
+    in_flight[current].fbo->bind();
 }
 
 void mgo::DisplayBuffer::release_current()
 {
-    fbo.unbind();
+    in_flight[current].fbo->unbind();
     egl_context.release_current();
 }
 
 void mgo::DisplayBuffer::swap_buffers()
 {
-    glFinish();
+    // A software renderer has nothing to wait for, nor a current context
+    if (!pixels.empty())
+        return;
+
+    auto& done = in_flight[current];
+
+    // In case the renderer drew without calling bind()
+    retire(done);
+
+    if (fence_sync)
+        done.fence = fence_sync->eglCreateSyncKHR(egl_display, EGL_SYNC_FENCE_KHR, nullptr);
+    done.rendered = true;
+    done.frame = {};
+
+    // Make sure the GPU actually starts on the frame rather than waiting for more
+    glFlush();
+
+    last_swapped = current;
+    current = (current + 1) % in_flight.size();
+}
+
+void mgo::DisplayBuffer::retire(InFlightFrame& frame)
+{
+    if (!frame.rendered)
+        return;
+
+    if (frame.fence != EGL_NO_SYNC_KHR)
+    {
+        fence_sync->eglClientWaitSyncKHR(
+            egl_display, frame.fence, EGL_SYNC_FLUSH_COMMANDS_BIT_KHR, EGL_FOREVER_KHR);
+        fence_sync->eglDestroySyncKHR(egl_display, frame.fence);
+        frame.fence = EGL_NO_SYNC_KHR;
+    }
+    else
+    {
+        glFinish();
+    }
+
+    frame.rendered = false;
+
+    if (frame_sink_slots == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock{sink_mutex};
+
+    if (!sink)
+    {
+        sink = std::make_unique<FrameSink>(
+            area.size, mir_pixel_format_abgr_8888, FrameRingHeader::bottom_up, frame_sink_slots);
+        sink_bottom_up = true;
+        log_sink();
+    }
+
+    auto const frame_pixels = sink->begin_frame();
+    frame.fbo->bind();
+    glReadPixels(
+        0, 0, area.size.width.as_int(), area.size.height.as_int(),
+        GL_RGBA, GL_UNSIGNED_BYTE, frame_pixels);
+    frame.fbo->unbind();
+
+    cursor_drawn = {};
+    draw_cursor(frame_pixels);
+    sink->end_frame(frame.frame);
+    last_published = frame.frame;
+}
+
+void mgo::DisplayBuffer::frame_presented(Frame const& frame)
+{
+    if (pixels.empty())
+    {
+        in_flight[last_swapped].frame = frame;
+        return;
+    }
+
+    // Software frames are complete as soon as they are swapped
+    if (frame_sink_slots == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock{sink_mutex};
+
+    if (!sink)
+    {
+        sink = std::make_unique<FrameSink>(area.size, pixel_format(), 0, frame_sink_slots);
+        log_sink();
+    }
+
+    auto const frame_pixels = sink->begin_frame();
+    std::memcpy(frame_pixels, pixels.data(), pixels.size() * sizeof(pixels[0]));
+
+    cursor_drawn = {};
+    draw_cursor(frame_pixels);
+    sink->end_frame(frame);
+    last_published = frame;
+}
+
+void mgo::DisplayBuffer::log_sink() const
+{
+    mir::log_info(
+        "Offscreen output %dx%d%+d%+d publishes frames at /proc/%d/fd/%d",
+        area.size.width.as_int(), area.size.height.as_int(),
+        area.top_left.x.as_int(), area.top_left.y.as_int(),
+        getpid(), sink->fd());
+}
+
+auto mgo::DisplayBuffer::frame_sink() const -> FrameSink const*
+{
+    return sink.get();
+}
+
+void mgo::DisplayBuffer::set_cursor(CursorSprite const& sprite)
+{
+    std::lock_guard<std::mutex> lock{sink_mutex};
+
+    cursor = sprite;
+
+    if (!sink || !sink->latest_frame())
+        return;
+
+    // Rather than composite a frame, republish the latest with the cursor redrawn
+    auto const latest = sink->latest_frame();
+    auto const frame_pixels = sink->begin_frame();
+    if (frame_pixels != latest)
+        std::memcpy(frame_pixels, latest, sink->stride().as_uint32_t() * area.size.height.as_uint32_t());
+
+    erase_cursor(frame_pixels);
+    draw_cursor(frame_pixels);
+    sink->end_frame(last_published);
+}
+
+void mgo::DisplayBuffer::draw_cursor(unsigned char* frame_pixels)
+{
+    if (!cursor.pixels)
+        return;
+
+    geom::Rectangle const sprite_area{geom::Point{0, 0} + (cursor.area.top_left - area.top_left), cursor.area.size};
+    cursor_drawn = sprite_area.intersection_with({{0, 0}, area.size});
+
+    auto const width = cursor_drawn.size.width.as_int();
+    auto const height = cursor_drawn.size.height.as_int();
+    auto const sprite_width = sprite_area.size.width.as_int();
+    auto const from = cursor_drawn.top_left - sprite_area.top_left;
+    auto const abgr = sink_bottom_up;
+
+    under_cursor.resize(width * height);
+
+    for (int y = 0; y != height; ++y)
+    {
+        auto const screen_y = cursor_drawn.top_left.y.as_int() + y;
+        auto const row = sink_bottom_up ? area.size.height.as_int() - 1 - screen_y : screen_y;
+        auto const dst = reinterpret_cast<uint32_t*>(frame_pixels + row * sink->stride().as_int()) +
+            cursor_drawn.top_left.x.as_int();
+        auto const src = cursor.pixels->data() + (from.dy.as_int() + y) * sprite_width + from.dx.as_int();
+
+        std::copy(dst, dst + width, under_cursor.begin() + y * width);
+        for (int x = 0; x != width; ++x)
+            dst[x] = blend(dst[x], src[x], abgr);
+    }
+}
+
+void mgo::DisplayBuffer::erase_cursor(unsigned char* frame_pixels)
+{
+    auto const width = cursor_drawn.size.width.as_int();
+    auto const height = cursor_drawn.size.height.as_int();
+
+    for (int y = 0; y != height; ++y)
+    {
+        auto const screen_y = cursor_drawn.top_left.y.as_int() + y;
+        auto const row = sink_bottom_up ? area.size.height.as_int() - 1 - screen_y : screen_y;
+        auto const dst = reinterpret_cast<uint32_t*>(frame_pixels + row * sink->stride().as_int()) +
+            cursor_drawn.top_left.x.as_int();
+
+        std::copy(under_cursor.begin() + y * width, under_cursor.begin() + (y + 1) * width, dst);
+    }
+
+    cursor_drawn = {};
+}
+
+geom::Size mgo::DisplayBuffer::size() const
+{
+    return area.size;
+}
+
+MirPixelFormat mgo::DisplayBuffer::pixel_format() const
+{
+    return mir_pixel_format_argb_8888;
+}
+
+auto mgo::DisplayBuffer::map_back_buffer() -> Mapping
+{
+    auto const width = area.size.width.as_int();
+    unsigned int age = 1;
+
+    if (pixels.empty())
+    {
+        pixels.resize(width * area.size.height.as_int());
+        age = 0;
+    }
+
+    return {reinterpret_cast<unsigned char*>(pixels.data()), geom::Stride{width * sizeof(uint32_t)}, age};
 }
 
 bool mgo::DisplayBuffer::overlay(RenderableList const&)
@@ -20,13 +20,22 @@
 #define MIR_GRAPHICS_OFFSCREEN_DISPLAY_BUFFER_H_
 
 #include "mir/graphics/surfaceless_egl_context.h"
+#include "frame_sink.h"
+#include "cursor.h"
 
 #include "mir/graphics/display_buffer.h"
 #include "mir/geometry/size.h"
 #include "mir/geometry/rectangle.h"
 #include "mir/renderer/gl/render_target.h"
+#include "mir/renderer/sw/render_target.h"
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace mir
 {
@@ -55,15 +64,41 @@ private:
     unsigned int fbo;
 };
 
+struct FenceSyncExtensions
+{
+    PFNEGLCREATESYNCKHRPROC const eglCreateSyncKHR;
+    PFNEGLDESTROYSYNCKHRPROC const eglDestroySyncKHR;
+    PFNEGLCLIENTWAITSYNCKHRPROC const eglClientWaitSyncKHR;
+};
+
 }
 
+/**
+ * An offscreen output
+ *
+ * Rather than waiting for the GPU at the end of every frame, the output
+ * cycles through several framebuffers, each guarded by an EGL fence. A
+ * framebuffer is only waited for when it comes round to be drawn again, so
+ * the compositor can queue up to render_targets - 1 frames ahead of the GPU.
+ *
+ * If frame_sink_slots is non-zero, finished frames are published through a
+ * FrameSink. GL frames reach the sink when their framebuffer is recycled,
+ * so the newest frames only appear once later ones have been composited.
+ * The cursor is drawn over frames as they are published, and when it changes
+ * the latest frame is published again with the cursor redrawn.
+ */
 class DisplayBuffer : public graphics::DisplayBuffer,
                       public graphics::NativeDisplayBuffer,
-                      public renderer::gl::RenderTarget
+                      public renderer::gl::RenderTarget,
+                      public renderer::software::RenderTarget
 {
 public:
     DisplayBuffer(SurfacelessEGLContext egl_context,
-                  geometry::Rectangle const& area);
+                  EGLDisplay egl_display,
+                  geometry::Rectangle const& area,
+                  unsigned int render_targets,
+                  unsigned int frame_sink_slots);
+    ~DisplayBuffer() noexcept;
 
     geometry::Rectangle view_area() const override;
     bool overlay(RenderableList const& renderlist) override;
@@ -73,10 +108,53 @@ public:
     void bind() override;
     void release_current() override;
     void swap_buffers() override;
+
+    geometry::Size size() const override;
+    MirPixelFormat pixel_format() const override;
+    Mapping map_back_buffer() override;
+
+    /// Called once the last swapped frame has been presented
+    void frame_presented(Frame const& frame);
+
+    /// The sink finished frames are published through, if any (yet)
+    FrameSink const* frame_sink() const;
+
+    void set_cursor(CursorSprite const& sprite);
+
 private:
+    struct InFlightFrame
+    {
+        std::unique_ptr<detail::GLFramebufferObject> fbo;
+        EGLSyncKHR fence;
+        bool rendered;
+        Frame frame;
+    };
+
+    void retire(InFlightFrame& frame);
+    void log_sink() const;
+    void draw_cursor(unsigned char* frame_pixels);
+    void erase_cursor(unsigned char* frame_pixels);
+
     SurfacelessEGLContext const egl_context;
-    detail::GLFramebufferObject const fbo;
+    EGLDisplay const egl_display;
     geometry::Rectangle const area;
+    std::unique_ptr<detail::FenceSyncExtensions const> const fence_sync;
+    std::vector<InFlightFrame> in_flight;
+    size_t current{0};
+    size_t last_swapped{0};
+
+    unsigned int const frame_sink_slots;
+    std::mutex sink_mutex;
+    std::unique_ptr<FrameSink> sink;
+    bool sink_bottom_up{false};
+    Frame last_published;
+
+    CursorSprite cursor;
+    geometry::Rectangle cursor_drawn;   // Where the latest frame has the cursor, saved in under_cursor
+    std::vector<uint32_t> under_cursor;
+
+    // Only allocated if a software renderer draws into us
+    std::vector<uint32_t> pixels;
 };
 
 }
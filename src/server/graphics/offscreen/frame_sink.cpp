@@ -0,0 +1,141 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_sink.h"
+
+#include <boost/throw_exception.hpp>
+#include <stdexcept>
+
+namespace mg = mir::graphics;
+namespace mgo = mg::offscreen;
+namespace geom = mir::geometry;
+
+uint32_t const mgo::FrameRingHeader::magic_value;
+uint32_t const mgo::FrameRingHeader::bottom_up;
+
+namespace
+{
+uint64_t const alignment{64};
+
+uint64_t aligned(uint64_t bytes)
+{
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+// Rows are tightly packed, as glReadPixels() on GLES has no way to pad them
+uint64_t stride_for(geom::Size const& size, MirPixelFormat format)
+{
+    return size.width.as_uint32_t() * MIR_BYTES_PER_PIXEL(format);
+}
+
+uint64_t header_size()
+{
+    return aligned(sizeof(mgo::FrameRingHeader));
+}
+
+uint64_t pixel_offset()
+{
+    return aligned(sizeof(mgo::FrameSlotHeader));
+}
+
+uint64_t slot_size(geom::Size const& size, MirPixelFormat format)
+{
+    return aligned(pixel_offset() + stride_for(size, format) * size.height.as_uint32_t());
+}
+
+size_t file_size(geom::Size const& size, MirPixelFormat format, unsigned int slot_count)
+{
+    if (slot_count == 0)
+        BOOST_THROW_EXCEPTION(std::logic_error("Frame sink needs at least one slot"));
+
+    return header_size() + slot_size(size, format) * slot_count;
+}
+}
+
+mgo::FrameSink::FrameSink(
+    geom::Size const& size,
+    MirPixelFormat format,
+    uint32_t flags,
+    unsigned int slot_count)
+    : file{file_size(size, format, slot_count)}
+{
+    // The file is zero filled, so every slot starts out incomplete
+    auto& h = header();
+    h.magic = FrameRingHeader::magic_value;
+    h.version = 1;
+    h.width = size.width.as_uint32_t();
+    h.height = size.height.as_uint32_t();
+    h.stride = stride_for(size, format);
+    h.pixel_format = format;
+    h.flags = flags;
+    h.slot_count = slot_count;
+    h.header_size = header_size();
+    h.slot_size = slot_size(size, format);
+    h.pixel_offset = pixel_offset();
+    h.latest.store(0, std::memory_order_release);
+}
+
+int mgo::FrameSink::fd() const
+{
+    return file.fd();
+}
+
+geom::Stride mgo::FrameSink::stride() const
+{
+    return geom::Stride{header().stride};
+}
+
+unsigned char* mgo::FrameSink::begin_frame()
+{
+    auto& s = slot(next_sequence);
+    s.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    return reinterpret_cast<unsigned char*>(&s) + header().pixel_offset;
+}
+
+void mgo::FrameSink::end_frame(Frame const& frame)
+{
+    auto& s = slot(next_sequence);
+    s.msc = frame.msc;
+    s.ust_ns = frame.ust.nanoseconds.count();
+    s.sequence.store(next_sequence, std::memory_order_release);
+    header().latest.store(next_sequence, std::memory_order_release);
+
+    ++next_sequence;
+}
+
+unsigned char const* mgo::FrameSink::latest_frame() const
+{
+    if (next_sequence == 1)
+        return nullptr;
+
+    return reinterpret_cast<unsigned char const*>(&slot(next_sequence - 1)) + header().pixel_offset;
+}
+
+auto mgo::FrameSink::header() const -> FrameRingHeader&
+{
+    return *static_cast<FrameRingHeader*>(file.base_ptr());
+}
+
+auto mgo::FrameSink::slot(uint64_t sequence) const -> FrameSlotHeader&
+{
+    auto const& h = header();
+    auto const base = static_cast<unsigned char*>(file.base_ptr());
+    auto const index = (sequence - 1) % h.slot_count;
+
+    return *reinterpret_cast<FrameSlotHeader*>(base + h.header_size + index * h.slot_size);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_OFFSCREEN_FRAME_SINK_H_
+#define MIR_GRAPHICS_OFFSCREEN_FRAME_SINK_H_
+
+#include "mir/anonymous_shm_file.h"
+#include "mir/geometry/size.h"
+#include "mir/geometry/dimensions.h"
+#include "mir/graphics/frame.h"
+#include "mir_toolkit/common.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace mir
+{
+namespace graphics
+{
+namespace offscreen
+{
+/**
+ * Layout of the shared memory ring written by FrameSink
+ *
+ * The file starts with a FrameRingHeader. Slot i starts at
+ * header_size + i * slot_size and holds a FrameSlotHeader followed, at
+ * pixel_offset from the start of the slot, by height rows of stride bytes.
+ *
+ * Frame n (counting from 1) is written to slot (n - 1) % slot_count. A slot's
+ * sequence is 0 while the slot is being written and n once frame n is
+ * complete, so a consumer copies a slot out and then checks that its sequence
+ * has not changed in the meantime.
+ */
+struct FrameRingHeader
+{
+    static uint32_t const magic_value{0x4d495246}; // "MIRF"
+    static uint32_t const bottom_up{1};            // Rows are stored last row first
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t pixel_format;                          // A MirPixelFormat
+    uint32_t flags;
+    uint32_t slot_count;
+    uint64_t header_size;
+    uint64_t slot_size;
+    uint64_t pixel_offset;
+    std::atomic<uint64_t> latest;                   // Newest complete frame, 0 if none
+};
+
+struct FrameSlotHeader
+{
+    std::atomic<uint64_t> sequence;
+    int64_t msc;
+    int64_t ust_ns;
+};
+
+/**
+ * Publishes completed offscreen frames through a ring of memfd-backed slots,
+ * for recorders and test harnesses. The writer never waits for consumers;
+ * slow consumers simply miss frames.
+ */
+class FrameSink
+{
+public:
+    FrameSink(geometry::Size const& size, MirPixelFormat format, uint32_t flags, unsigned int slot_count);
+
+    FrameSink(FrameSink const&) = delete;
+    FrameSink& operator=(FrameSink const&) = delete;
+
+    int fd() const;
+    geometry::Stride stride() const;
+
+    /// Pixels of the slot the next frame goes to. Call end_frame() once written.
+    unsigned char* begin_frame();
+    void end_frame(Frame const& frame);
+
+    /// Pixels of the newest complete frame, or null if there is none yet
+    unsigned char const* latest_frame() const;
+
+private:
+    FrameRingHeader& header() const;
+    FrameSlotHeader& slot(uint64_t sequence) const;
+
+    AnonymousShmFile const file;
+    uint64_t next_sequence{1};
+};
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_OFFSCREEN_FRAME_SINK_H_ */
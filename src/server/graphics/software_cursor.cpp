@@ -26,6 +26,7 @@
 #include "mir/renderer/sw/pixel_source.h"
 
 #include <boost/throw_exception.hpp>
+#include <cstring>
 #include <stdexcept>
 #include <mutex>
 
@@ -53,6 +54,20 @@ MirPixelFormat get_8888_format(std::vector<MirPixelFormat> const& formats)
     return mir_pixel_format_invalid;
 }
 
+// Enough for a cursor theme's shapes, or the frames of an animated cursor
+size_t const max_cached_images{64};
+
+size_t hash_of(unsigned char const* pixels, size_t size)
+{
+    // FNV-1a
+    uint64_t hash{14695981039346656037ull};
+    for (auto p = pixels; p != pixels + size; ++p)
+    {
+        hash ^= *p;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
 }
 
 class mg::detail::CursorRenderable : public mg::Renderable
@@ -77,6 +92,7 @@ public:
 
     std::shared_ptr<mg::Buffer> buffer() const override
     {
+        std::lock_guard<std::mutex> lock{position_mutex};
         return buffer_;
     }
 
@@ -107,9 +123,16 @@ public:
         position = new_position;
     }
 
+    void set_image(std::shared_ptr<mg::Buffer> const& buffer, geom::Point new_position)
+    {
+        std::lock_guard<std::mutex> lock{position_mutex};
+        buffer_ = buffer;
+        position = new_position;
+    }
+
 private:
-    std::shared_ptr<mg::Buffer> const buffer_;
     mutable std::mutex position_mutex;
+    std::shared_ptr<mg::Buffer> buffer_;
     geom::Point position;
 };
 
@@ -143,39 +166,35 @@ void mg::SoftwareCursor::show()
 
 void mg::SoftwareCursor::show(CursorImage const& cursor_image)
 {
-    std::shared_ptr<detail::CursorRenderable> new_renderable;
-    std::shared_ptr<detail::CursorRenderable> old_renderable;
-    bool old_visibility = false;
-    // Do a lock dance to make this function threadsafe,
-    // while avoiding calling scene methods under lock
+    bool needs_adding = false;
     {
-        geom::Point position{0,0};
         std::lock_guard<std::mutex> lg{guard};
-        if (renderable)
-            position = renderable->screen_position().top_left;
-        new_renderable = create_renderable_for(cursor_image, position);
-        old_visibility = visible;
-        visible = true;
-    }
+        auto const buffer = buffer_for(cursor_image);
 
-    // Add the new renderable first, then remove the old one to avoid
-    // visual glitches
-    scene->add_input_visualization(new_renderable);
+        // Keep the hotspot where it was, and the same renderable, so that the
+        // scene just sees it change
+        if (renderable)
+        {
+            auto const position = renderable->screen_position().top_left + hotspot - cursor_image.hotspot();
+            renderable->set_image(buffer, position);
+        }
+        else
+        {
+            renderable = std::make_shared<detail::CursorRenderable>(buffer, geom::Point{0,0} - cursor_image.hotspot());
+        }
 
-    // The second part of the lock dance
-    {
-        std::lock_guard<std::mutex> lg{guard};
-        old_renderable = renderable;
-        renderable = new_renderable;
         hotspot = cursor_image.hotspot();
+        needs_adding = !visible;
+        visible = true;
     }
 
-    if (old_renderable && old_visibility)
-        scene->remove_input_visualization(old_renderable);
+    if (needs_adding)
+        scene->add_input_visualization(renderable);
+    else
+        scene->emit_scene_changed();
 }
 
-std::shared_ptr<mg::detail::CursorRenderable>
-mg::SoftwareCursor::create_renderable_for(CursorImage const& cursor_image, geom::Point position)
+std::shared_ptr<mg::Buffer> mg::SoftwareCursor::buffer_for(CursorImage const& cursor_image)
 {
     size_t const pixels_size =
         cursor_image.size().width.as_uint32_t() *
@@ -185,19 +204,37 @@ mg::SoftwareCursor::create_renderable_for(CursorImage const& cursor_image, geom:
     if (pixels_size == 0)
         BOOST_THROW_EXCEPTION(std::logic_error("zero sized software cursor image is invalid"));
 
-    auto new_renderable = std::make_shared<detail::CursorRenderable>(
-        allocator->alloc_buffer({cursor_image.size(), format, mg::BufferUsage::software}),
-        position + hotspot - cursor_image.hotspot());
+    auto const pixels = static_cast<unsigned char const*>(cursor_image.as_argb_8888());
+    auto const hash = hash_of(pixels, pixels_size);
+
+    for (auto cached = cache.begin(); cached != cache.end(); ++cached)
+    {
+        if (cached->hash == hash &&
+            cached->size == cursor_image.size() &&
+            memcmp(cached->pixels.data(), pixels, pixels_size) == 0)
+        {
+            cache.splice(cache.begin(), cache, cached);
+            return cached->buffer;
+        }
+    }
+
+    auto const buffer = allocator->alloc_buffer({cursor_image.size(), format, mg::BufferUsage::software});
 
     // TODO: The buffer pixel format may not be argb_8888, leading to
     // incorrect cursor colors. We need to transform the data to match
     // the buffer pixel format.
-    auto pixel_source = dynamic_cast<mrs::PixelSource*>(new_renderable->buffer()->native_buffer_base());
+    auto pixel_source = dynamic_cast<mrs::PixelSource*>(buffer->native_buffer_base());
     if (pixel_source)
-        pixel_source->write(static_cast<unsigned char const*>(cursor_image.as_argb_8888()), pixels_size);
+        pixel_source->write(pixels, pixels_size);
     else
         BOOST_THROW_EXCEPTION(std::logic_error("could not write to buffer for software cursor"));
-    return new_renderable;
+
+    // Cached buffers are never written again, so may still be on screen
+    cache.push_front({hash, cursor_image.size(), {pixels, pixels + pixels_size}, buffer});
+    if (cache.size() > max_cached_images)
+        cache.pop_back();
+
+    return buffer;
 }
 
 void mg::SoftwareCursor::hide()
@@ -22,13 +22,18 @@
 #include "mir/graphics/cursor.h"
 #include "mir_toolkit/client_types.h"
 #include "mir/geometry/displacement.h"
+#include "mir/geometry/size.h"
+
+#include <list>
 #include <mutex>
+#include <vector>
 
 namespace mir
 {
 namespace input { class Scene; }
 namespace graphics
 {
+class Buffer;
 class GraphicBufferAllocator;
 class Renderable;
 
@@ -51,8 +56,18 @@ public:
     void move_to(geometry::Point position) override;
 
 private:
-    std::shared_ptr<detail::CursorRenderable> create_renderable_for(
-        CursorImage const& cursor_image, geometry::Point position);
+    // Images recently shown, with their pixels written to a buffer. Switching
+    // between them (as when hovering over different UI elements, or animating)
+    // reuses the buffer rather than allocating and writing another.
+    struct CachedImage
+    {
+        size_t hash;
+        geometry::Size size;
+        std::vector<unsigned char> pixels;
+        std::shared_ptr<Buffer> buffer;
+    };
+
+    std::shared_ptr<Buffer> buffer_for(CursorImage const& cursor_image);
 
     std::shared_ptr<GraphicBufferAllocator> const allocator;
     std::shared_ptr<input::Scene> const scene;
@@ -61,6 +76,7 @@ private:
     std::shared_ptr<detail::CursorRenderable> renderable;
     bool visible;
     geometry::Displacement hotspot;
+    std::list<CachedImage> cache; // Most recently used first
 };
 
 }
@@ -25,6 +25,8 @@
 #include "mir/scene/observer.h"
 #include "mir/scene/null_surface_observer.h"
 #include "mir/scene/surface.h"
+#include "mir/time/alarm.h"
+#include "mir/time/alarm_factory.h"
 
 #include <mutex>
 #include <map>
@@ -193,15 +195,23 @@ bool is_empty(std::shared_ptr<mg::CursorImage> const& image)
     auto const size = image->size();
     return size.width.as_int() == 0 || size.height.as_int() == 0;
 }
+
+std::shared_ptr<mg::AnimatedCursorImage> as_animation(std::shared_ptr<mg::CursorImage> const& image)
+{
+    auto const animated = std::dynamic_pointer_cast<mg::AnimatedCursorImage>(image);
+    return animated && animated->frames() > 1 ? animated : nullptr;
+}
 }
 
 mi::CursorController::CursorController(std::shared_ptr<mi::Scene> const& input_targets,
     std::shared_ptr<mg::Cursor> const& cursor,
-    std::shared_ptr<mg::CursorImage> const& default_cursor_image) :
+    std::shared_ptr<mg::CursorImage> const& default_cursor_image,
+    std::shared_ptr<time::AlarmFactory> const& alarm_factory) :
         input_targets(input_targets),
         cursor(cursor),
         default_cursor_image(default_cursor_image),
-        current_cursor(default_cursor_image)
+        current_cursor(default_cursor_image),
+        animation(alarm_factory->create_alarm([this] { show_next_frame(); }))
 {
     // TODO: Add observer could return weak_ptr to eliminate this
     // pattern
@@ -214,6 +224,7 @@ mi::CursorController::~CursorController()
 {
     try 
     {
+        animation->cancel();
         input_targets->remove_observer(observer);
     }
     catch (...)
@@ -231,6 +242,19 @@ void mi::CursorController::set_cursor_image_locked(std::unique_lock<std::mutex>&
     }
 
     current_cursor = image;
+    ++cursor_generation;
+
+    // Animations are driven here rather than by clients, so that cursors
+    // animate without any client round trips
+    if (auto const animated = as_animation(image))
+    {
+        animation_frame = 0;
+        animation->reschedule_in(animated->frame_delay(animation_frame));
+    }
+    else
+    {
+        animation->cancel();
+    }
 
     lock.unlock();
 
@@ -240,9 +264,42 @@ void mi::CursorController::set_cursor_image_locked(std::unique_lock<std::mutex>&
         cursor->hide();
 }
 
+void mi::CursorController::show_next_frame()
+{
+    std::shared_ptr<mg::AnimatedCursorImage> animated;
+    size_t frame;
+    unsigned long generation;
+    {
+        std::lock_guard<std::mutex> lock(cursor_state_guard);
+
+        animated = as_animation(current_cursor);
+        if (!animated)
+            return;
+
+        animation_frame = (animation_frame + 1) % animated->frames();
+        animation->reschedule_in(animated->frame_delay(animation_frame));
+
+        frame = animation_frame;
+        generation = cursor_generation;
+    }
+
+    // Showing the cursor may update the scene, and so call back into us: it
+    // can't be done under the lock. Drop the frame if the image has changed
+    // meanwhile, as the new image is shown instead.
+    if (generation == cursor_generation)
+        cursor->show(animated->frame(frame));
+}
+
 void mi::CursorController::update_cursor_image_locked(std::unique_lock<std::mutex>& lock)
 {
-    auto surface = topmost_surface_containing_point(input_targets, cursor_location);
+    set_cursor_image_for_locked(lock, topmost_surface_containing_point(input_targets, cursor_location));
+}
+
+void mi::CursorController::set_cursor_image_for_locked(std::unique_lock<std::mutex>& lock,
+    std::shared_ptr<mi::Surface> const& surface)
+{
+    surface_under_cursor = surface.get();
+
     if (surface)
     {
         set_cursor_image_locked(lock, surface->cursor_image());
@@ -268,7 +325,11 @@ void mi::CursorController::cursor_moved_to(float abs_x, float abs_y)
 
         cursor_location = new_location;
 
-        update_cursor_image_locked(lock);
+        // Changes to the surface's cursor image come through the observers,
+        // so there's only something to do on motion when entering another
+        auto const surface = topmost_surface_containing_point(input_targets, cursor_location);
+        if (surface.get() != surface_under_cursor)
+            set_cursor_image_for_locked(lock, surface);
     }
 
     cursor->move_to(new_location);
@@ -22,11 +22,17 @@
 #include "mir/input/cursor_listener.h"
 #include "mir/geometry/point.h"
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 
 namespace mir
 {
+namespace time
+{
+class Alarm;
+class AlarmFactory;
+}
 namespace graphics
 {
 class Cursor;
@@ -40,13 +46,15 @@ class Observer;
 namespace input
 {
 class Scene;
+class Surface;
 
 class CursorController : public CursorListener
 {
 public:
     CursorController(std::shared_ptr<Scene> const& input_targets,
         std::shared_ptr<graphics::Cursor> const& cursor,
-        std::shared_ptr<graphics::CursorImage> const& default_cursor_image);
+        std::shared_ptr<graphics::CursorImage> const& default_cursor_image,
+        std::shared_ptr<time::AlarmFactory> const& alarm_factory);
     virtual ~CursorController();
 
     void cursor_moved_to(float abs_x, float abs_y);
@@ -63,12 +71,19 @@ private:
     std::mutex cursor_state_guard;
     geometry::Point cursor_location;
     std::shared_ptr<graphics::CursorImage> current_cursor;
+    // Only for comparison: changes to it, or its removal, update the cursor image
+    Surface const* surface_under_cursor{nullptr};
+    size_t animation_frame{0};
+    // Counts changes of current_cursor, so that a frame shown unlocked can tell it is stale
+    std::atomic<unsigned long> cursor_generation{0};
 
     std::weak_ptr<scene::Observer> observer;
-    
+    std::unique_ptr<time::Alarm> const animation;
 
     void update_cursor_image_locked(std::unique_lock<std::mutex>&);
+    void set_cursor_image_for_locked(std::unique_lock<std::mutex>&, std::shared_ptr<Surface> const& surface);
     void set_cursor_image_locked(std::unique_lock<std::mutex>&, std::shared_ptr<graphics::CursorImage> const& image);
+    void show_next_frame();
 };
 
 }
@@ -31,6 +31,7 @@
 #include "default_input_manager.h"
 #include "surface_input_dispatcher.h"
 #include "basic_seat.h"
+#include "recording_seat.h"
 #include "seat_observer_multiplexer.h"
 #include "../graphics/nested/input_platform.h"
 
@@ -52,6 +53,10 @@
 
 #include "mir_toolkit/cursors.h"
 
+#include <boost/throw_exception.hpp>
+
+#include <fstream>
+
 namespace mi = mir::input;
 namespace mr = mir::report;
 namespace ms = mir::scene;
@@ -134,7 +139,8 @@ mir::DefaultServerConfiguration::the_cursor_listener()
             return wrap_cursor_listener(std::make_shared<mi::CursorController>(
                     the_input_scene(),
                     the_cursor(),
-                    the_default_cursor_image()));
+                    the_default_cursor_image(),
+                    the_main_loop()));
         });
 
 }
@@ -218,24 +224,29 @@ mir::DefaultServerConfiguration::the_input_manager()
 
                 // Maybe the graphics platform also supplies input (e.g. mesa-x11 or nested)
                 // NB this makes the (valid) assumption that graphics initializes before input
-                auto platform = mi::input_platform_from_graphics_module(
-                    *the_graphics_platform(),
-                    *options,
-                    emergency_cleanup,
-                    device_registry,
-                    the_console_services(),
-                    input_report);
+                // An input recording to replay takes its place.
+                mir::UniqueModulePtr<mi::Platform> platform;
+                if (!options->is_set(options::input_replay_opt))
+                {
+                    platform = mi::input_platform_from_graphics_module(
+                        *the_graphics_platform(),
+                        *options,
+                        emergency_cleanup,
+                        device_registry,
+                        the_console_services(),
+                        input_report);
+                }
 
                 // otherwise (usually) we probe for it
                 if (!platform)
                 {
-                    platform = probe_input_platforms(
+                    platform = mi::input_platform_from_module(
+                        *the_input_platform_module(),
                         *options,
                         emergency_cleanup,
                         device_registry,
                         the_console_services(),
-                        input_report,
-                        *the_shared_library_prober_report());
+                        input_report);
                 }
 
                 return std::make_shared<mi::DefaultInputManager>(the_input_reading_multiplexer(), std::move(platform));
@@ -244,6 +255,19 @@ mir::DefaultServerConfiguration::the_input_manager()
     );
 }
 
+std::shared_ptr<mir::SharedLibrary>
+mir::DefaultServerConfiguration::the_input_platform_module()
+{
+    return input_platform_module(
+        [this]
+        {
+            return mi::select_input_platform_module(
+                *the_options(),
+                the_console_services(),
+                *the_shared_library_prober_report());
+        });
+}
+
 std::shared_ptr<mir::dispatch::MultiplexingDispatchable>
 mir::DefaultServerConfiguration::the_input_reading_multiplexer()
 {
@@ -293,8 +317,21 @@ std::shared_ptr<mi::DefaultInputDeviceHub> mir::DefaultServerConfiguration::the_
        {
            auto input_dispatcher = the_input_dispatcher();
            auto key_repeater = std::dynamic_pointer_cast<mi::KeyRepeatDispatcher>(input_dispatcher);
+           std::shared_ptr<mi::Seat> seat = the_seat();
+
+           auto const options = the_options();
+           if (options->is_set(options::input_record_opt))
+           {
+               auto const path = options->get<std::string>(options::input_record_opt);
+               auto recording = std::make_unique<std::ofstream>(path);
+               if (!*recording)
+                   BOOST_THROW_EXCEPTION(mir::AbnormalExit("Failed to open input recording: " + path));
+
+               seat = std::make_shared<mi::RecordingSeat>(seat, std::move(recording));
+           }
+
            auto hub = std::make_shared<mi::DefaultInputDeviceHub>(
-               the_seat(),
+               seat,
                the_input_reading_multiplexer(),
                the_cookie_authority(),
                the_key_mapper(),
@@ -26,24 +26,25 @@
 #include "mir/shared_library.h"
 #include "mir/log.h"
 #include "mir/libname.h"
+#include "mir/startup_trace.h"
 
 #include <stdexcept>
 
 namespace mi = mir::input;
 namespace mo = mir::options;
 
-namespace
-{
-mir::UniqueModulePtr<mi::Platform> create_input_platform(
+auto mi::input_platform_from_module(
     mir::SharedLibrary const& lib, mir::options::Option const& options,
     std::shared_ptr<mir::EmergencyCleanupRegistry> const& cleanup_registry,
     std::shared_ptr<mi::InputDeviceRegistry> const& registry,
     std::shared_ptr<mir::ConsoleServices> const& console,
     std::shared_ptr<mi::InputReport> const& report)
+-> mir::UniqueModulePtr<Platform>
 {
     auto desc = lib.load_function<mi::DescribeModule>("describe_input_module", MIR_SERVER_INPUT_PLATFORM_VERSION)();
     auto create = lib.load_function<mi::CreatePlatform>("create_input_platform", MIR_SERVER_INPUT_PLATFORM_VERSION);
 
+    mir::StartupTraceSpan const span{std::string{"create_input_platform "} + desc->name};
     auto result = create(options, cleanup_registry, registry, console, report);
 
     mir::log_info(
@@ -52,17 +53,14 @@ mir::UniqueModulePtr<mi::Platform> create_input_platform(
 
     return result;
 }
-}
 
-mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
+auto mi::select_input_platform_module(
     mo::Option const& options,
-    std::shared_ptr<EmergencyCleanupRegistry> const& emergency_cleanup,
-    std::shared_ptr<mi::InputDeviceRegistry> const& device_registry,
     std::shared_ptr<mir::ConsoleServices> const& console,
-    std::shared_ptr<mi::InputReport> const& input_report,
     mir::SharedLibraryProberReport& prober_report)
+-> std::shared_ptr<mir::SharedLibrary>
 {
-    auto reject_platform_priority = mi::PlatformPriority::dummy;
+    auto selected_priority = mi::PlatformPriority::dummy;
 
     std::shared_ptr<mir::SharedLibrary> platform_module;
     std::vector<std::string> module_names;
@@ -74,12 +72,16 @@ mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
                 auto const probe = module->load_function<mi::ProbePlatform>(
                     "probe_input_platform", MIR_SERVER_INPUT_PLATFORM_VERSION);
 
-                if (probe(options, *console) > reject_platform_priority)
+                // The highest priority module is used, the first of any equals; none can beat the best
+                auto const priority = probe(options, *console);
+                if (priority > selected_priority)
                 {
                     platform_module = module;
+                    selected_priority = priority;
+                }
 
+                if (selected_priority >= mi::PlatformPriority::best)
                     return Selection::quit;
-                }
             }
             catch (std::runtime_error const&)
             {
@@ -91,7 +93,7 @@ mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
 
     if (options.is_set(mo::platform_input_lib))
     {
-        reject_platform_priority = PlatformPriority::unsupported;
+        selected_priority = PlatformPriority::unsupported;
         module_selector(std::make_shared<mir::SharedLibrary>(options.get<std::string>(mo::platform_input_lib)));
     }
     else
@@ -102,7 +104,20 @@ mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
     if (!platform_module)
         BOOST_THROW_EXCEPTION(std::runtime_error{"No appropriate input platform module found"});
 
-    return create_input_platform(*platform_module, options, emergency_cleanup, device_registry, console, input_report);
+    return platform_module;
+}
+
+mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
+    mo::Option const& options,
+    std::shared_ptr<EmergencyCleanupRegistry> const& emergency_cleanup,
+    std::shared_ptr<mi::InputDeviceRegistry> const& device_registry,
+    std::shared_ptr<mir::ConsoleServices> const& console,
+    std::shared_ptr<mi::InputReport> const& input_report,
+    mir::SharedLibraryProberReport& prober_report)
+{
+    auto const platform_module = select_input_platform_module(options, console, prober_report);
+
+    return input_platform_from_module(*platform_module, options, emergency_cleanup, device_registry, console, input_report);
 }
 
 auto mi::input_platform_from_graphics_module(
@@ -120,7 +135,7 @@ auto mi::input_platform_from_graphics_module(
         auto* const vtab = (void*&)(graphics_platform);
         SharedLibrary const platform_module{detail::libname_impl(vtab)};
 
-        return create_input_platform(platform_module, options, emergency_cleanup, device_registry, console, input_report);
+        return input_platform_from_module(platform_module, options, emergency_cleanup, device_registry, console, input_report);
     }
     catch (std::runtime_error const&)
     {
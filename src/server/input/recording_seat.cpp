@@ -0,0 +1,196 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "recording_seat.h"
+
+#include "mir/input/device.h"
+#include "mir/input/input_sink.h"
+
+#include <algorithm>
+
+namespace mi = mir::input;
+namespace mir_rec = mir::input::recording;
+
+namespace
+{
+std::chrono::nanoseconds now()
+{
+    // The same clock (CLOCK_MONOTONIC) as input event timestamps
+    return std::chrono::steady_clock::now().time_since_epoch();
+}
+}
+
+mi::RecordingSeat::RecordingSeat(std::shared_ptr<Seat> const& seat, std::unique_ptr<std::ostream> recording) :
+    seat{seat},
+    recording{std::move(recording)},
+    writer{*this->recording}
+{
+}
+
+mi::RecordingSeat::~RecordingSeat()
+{
+    recording->flush();
+}
+
+void mi::RecordingSeat::add_device(Device const& device)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+
+        record.type = mir_rec::RecordType::device_added;
+        record.device = device.id();
+        record.info = InputDeviceInfo{device.name(), device.unique_id(), device.capabilities()};
+        write(record, now());
+    }
+
+    seat->add_device(device);
+}
+
+void mi::RecordingSeat::remove_device(Device const& device)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+
+        record.type = mir_rec::RecordType::device_removed;
+        record.device = device.id();
+        write(record, now());
+        recording->flush();
+    }
+
+    seat->remove_device(device);
+}
+
+void mi::RecordingSeat::dispatch_event(std::shared_ptr<MirEvent> const& event)
+{
+    if (mir_event_get_type(event.get()) == mir_event_type_input)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+
+        auto const input_event = mir_event_get_input_event(event.get());
+        record.device = mir_input_event_get_device_id(input_event);
+
+        bool recorded{true};
+        switch (mir_input_event_get_type(input_event))
+        {
+        case mir_input_event_type_key:
+        {
+            auto const key = mir_input_event_get_keyboard_event(input_event);
+            record.type = mir_rec::RecordType::key;
+            record.key_action = mir_keyboard_event_action(key);
+            record.keysym = mir_keyboard_event_key_code(key);
+            record.scan_code = mir_keyboard_event_scan_code(key);
+            break;
+        }
+
+        case mir_input_event_type_pointer:
+        {
+            auto const pointer = mir_input_event_get_pointer_event(input_event);
+            record.type = mir_rec::RecordType::pointer;
+            record.pointer_action = mir_pointer_event_action(pointer);
+            record.buttons = mir_pointer_event_buttons(pointer);
+            record.hscroll = mir_pointer_event_axis_value(pointer, mir_pointer_axis_hscroll);
+            record.vscroll = mir_pointer_event_axis_value(pointer, mir_pointer_axis_vscroll);
+            record.dx = mir_pointer_event_axis_value(pointer, mir_pointer_axis_relative_x);
+            record.dy = mir_pointer_event_axis_value(pointer, mir_pointer_axis_relative_y);
+            break;
+        }
+
+        case mir_input_event_type_touch:
+        {
+            auto const touch = mir_input_event_get_touch_event(input_event);
+            record.type = mir_rec::RecordType::touch;
+            record.contacts.clear();
+            for (size_t i = 0, count = mir_touch_event_point_count(touch); i != count; ++i)
+            {
+                record.contacts.push_back(events::ContactState{
+                    mir_touch_event_id(touch, i),
+                    mir_touch_event_action(touch, i),
+                    mir_touch_event_tooltype(touch, i),
+                    mir_touch_event_axis_value(touch, i, mir_touch_axis_x),
+                    mir_touch_event_axis_value(touch, i, mir_touch_axis_y),
+                    mir_touch_event_axis_value(touch, i, mir_touch_axis_pressure),
+                    mir_touch_event_axis_value(touch, i, mir_touch_axis_touch_major),
+                    mir_touch_event_axis_value(touch, i, mir_touch_axis_touch_minor),
+                    0.0f});
+            }
+            break;
+        }
+
+        default:
+            recorded = false;
+            break;
+        }
+
+        if (recorded)
+            write(record, std::chrono::nanoseconds{mir_input_event_get_event_time(input_event)});
+    }
+
+    seat->dispatch_event(event);
+}
+
+void mi::RecordingSeat::write(recording::Record& record, std::chrono::nanoseconds time)
+{
+    if (!started)
+    {
+        start = time;
+        started = true;
+    }
+
+    // Event timestamps come from the devices, so may lag slightly behind device changes
+    last = std::max(last, time - start);
+    record.time = last;
+    writer.write(record);
+}
+
+mir::EventUPtr mi::RecordingSeat::create_device_state()
+{
+    return seat->create_device_state();
+}
+
+void mi::RecordingSeat::set_key_state(Device const& dev, std::vector<uint32_t> const& scan_codes)
+{
+    seat->set_key_state(dev, scan_codes);
+}
+
+void mi::RecordingSeat::set_pointer_state(Device const& dev, MirPointerButtons buttons)
+{
+    seat->set_pointer_state(dev, buttons);
+}
+
+void mi::RecordingSeat::set_cursor_position(float cursor_x, float cursor_y)
+{
+    seat->set_cursor_position(cursor_x, cursor_y);
+}
+
+void mi::RecordingSeat::set_confinement_regions(geometry::Rectangles const& regions)
+{
+    seat->set_confinement_regions(regions);
+}
+
+void mi::RecordingSeat::reset_confinement_regions()
+{
+    seat->reset_confinement_regions();
+}
+
+mir::geometry::Rectangle mi::RecordingSeat::bounding_rectangle() const
+{
+    return seat->bounding_rectangle();
+}
+
+mi::OutputInfo mi::RecordingSeat::output_info(uint32_t output_id) const
+{
+    return seat->output_info(output_id);
+}
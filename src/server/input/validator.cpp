@@ -20,7 +20,6 @@
 #include "mir/events/event_builders.h"
 #include "mir_toolkit/event.h"
 
-#include <set>
 #include <algorithm>
 
 namespace mi = mir::input;
@@ -28,14 +27,43 @@ namespace mev = mir::events;
 
 namespace
 {
-std::vector<mev::ContactState> get_contact_state(MirTouchEvent const* event)
+static_assert(mev::max_contacts < 32, "Touch contacts are tracked in a 32 bit mask");
+
+uint32_t bit(unsigned int index)
+{
+    return 1u << index;
+}
+
+// The index of the contact with the lowest touch ID among those in mask
+template<typename Contacts>
+unsigned int lowest_id(Contacts const& contacts, uint32_t mask)
+{
+    unsigned int lowest = contacts.size();
+    for (unsigned int i = 0; i != contacts.size(); ++i)
+    {
+        if ((mask & bit(i)) && (lowest == contacts.size() || contacts[i].touch_id < contacts[lowest].touch_id))
+            lowest = i;
+    }
+    return lowest;
+}
+
+template<typename State>
+unsigned int find_contact(State const& state, MirTouchId touch_id)
 {
-    std::vector<mev::ContactState> ret;
-    ret.reserve(mir_touch_event_point_count(event));
+    unsigned int i = 0;
+    while (i != state.count && state.contacts[i].touch_id != touch_id)
+        ++i;
+    return i;
+}
+
+template<typename State>
+void get_contact_state(MirTouchEvent const* event, State& state)
+{
+    state.count = std::min<size_t>(mir_touch_event_point_count(event), state.contacts.size());
 
-    for (size_t i = 0, count = mir_touch_event_point_count(event); i != count; ++i)
+    for (size_t i = 0; i != state.count; ++i)
     {
-        ret.push_back(mev::ContactState{
+        state.contacts[i] = mev::ContactState{
                       mir_touch_event_id(event, i),
                       mir_touch_event_action(event, i),
                       mir_touch_event_tooltype(event, i),
@@ -45,10 +73,8 @@ std::vector<mev::ContactState> get_contact_state(MirTouchEvent const* event)
                       mir_touch_event_axis_value(event, i, mir_touch_axis_touch_major),
                       mir_touch_event_axis_value(event, i, mir_touch_axis_touch_minor),
                       0.0f
-                      });
+                      };
     }
-
-    return ret;
 }
 }
 
@@ -83,10 +109,9 @@ void mi::Validator::validate_and_dispatch(MirEvent const& event)
 //     2. A touch point can not appear without coming down.
 // Our algorithm to ensure a candidate event can be dispatched is as follows:
 //
-//     First we look at the last event to build a set of expected touch ID's. That is to say
-// each touch point in the last event which did not have touch_action_up (signifying its dissapearance)
-// is expected to be in the candidate event. Likewise we go through the candidate event can produce a set of events
-// we have found.
+//     First we look at the last event: each touch point in it (points with touch_action_up are not kept)
+// is expected to be in the candidate event. We go through the candidate event marking the expected touch points
+// we have found, and the touch points that changed without being expected.
 //
 //     We now check for expected events which were not found, e.g. touch points which are missing a release.
 // For each of these touch points we can take the coordinates for these points from the last event
@@ -95,54 +120,97 @@ void mi::Validator::validate_and_dispatch(MirEvent const& event)
 //     Now we check for found touch points which were not expected. If these show up with mir_touch_action_down
 // things are fine. On the other hand if they show up with mir_touch_action_change then a touch point
 // has appeared before its gone down and thus we must inject an event signifying this touch going down.
+//
+//     The touch points are kept in fixed size arrays and the sets above are bitmasks over their indices, so
+// validating a well-formed event does not allocate.
 void mi::Validator::ensure_stream_validity_locked(
-    std::lock_guard<std::mutex> const&,
-    std::vector<mev::ContactState> const& new_event,
-    std::vector<mev::ContactState>& last_state,
-    std::function<void(std::vector<mev::ContactState> const&)> const& dispatch)
+    std::lock_guard<std::mutex> const& lg,
+    MirInputDeviceId id,
+    MirTouchEvent const* touch_event,
+    TouchState const& new_state,
+    TouchState& last_state)
 {
-    using TouchSet = std::set<MirTouchId>;
-    TouchSet expected;
-    for (auto const& contact : last_state)
-        expected.insert(contact.touch_id);
-
-    TouchSet in_next_event;
-    TouchSet changed_in_next_event;
-    for (auto const& contact : new_event)
+    uint32_t const expected = bit(last_state.count) - 1;
+    uint32_t found = 0;
+    uint32_t changed_unexpectedly = 0;
+
+    for (unsigned int i = 0; i != new_state.count; ++i)
     {
-        in_next_event.insert(contact.touch_id);
-        if (contact.action != mir_touch_action_down)
-            changed_in_next_event.insert(contact.touch_id);
-    }
+        auto const& contact = new_state.contacts[i];
+        auto const last = find_contact(last_state, contact.touch_id);
 
-    std::vector<MirTouchId> missing_up;
-    set_difference(begin(expected), end(expected),
-                   begin(in_next_event), end(in_next_event),
-                   std::back_inserter(missing_up));
+        if (last != last_state.count)
+            found |= bit(last);
+        else if (contact.action != mir_touch_action_down)
+            changed_unexpectedly |= bit(i);
+    }
 
-    std::vector<MirTouchId> missing_down;
-    set_difference(begin(changed_in_next_event), end(changed_in_next_event),
-                   begin(expected), end(expected),
-                   std::back_inserter(missing_down));
+    if (!(expected & ~found) && !changed_unexpectedly)
+        return;
 
-    for (auto touch_id : missing_up)
+    uint32_t missing_up = expected & ~found;
+    uint32_t released = 0;
+    while (missing_up)
     {
         // TODO on purpose we only send out one state change per event..
-        auto pos = find_if(begin(last_state), end(last_state), [touch_id](auto& item){return item.touch_id == touch_id;});
-        pos->action = mir_touch_action_up;
-        dispatch(last_state);
-        last_state.erase(pos);
+        auto const i = lowest_id(last_state.contacts, missing_up);
+        last_state.contacts[i].action = mir_touch_action_up;
+        dispatch_synthesized_locked(lg, id, touch_event, last_state, released);
+        missing_up &= ~bit(i);
+        released |= bit(i);
+    }
+
+    if (released)
+    {
+        unsigned int kept = 0;
+        for (unsigned int i = 0; i != last_state.count; ++i)
+        {
+            if (!(released & bit(i)))
+                last_state.contacts[kept++] = last_state.contacts[i];
+        }
+        last_state.count = kept;
     }
 
-    for (auto touch_id : missing_down)
+    while (changed_unexpectedly)
     {
+        auto const i = lowest_id(new_state.contacts, changed_unexpectedly);
+        changed_unexpectedly &= ~bit(i);
+
+        auto const& contact = new_state.contacts[i];
+        if (find_contact(last_state, contact.touch_id) != last_state.count ||
+            last_state.count == last_state.contacts.size())
+            continue;
+
         // TODO on purpose we only send out one state change per event..
-        auto pos = find_if(begin(new_event), end(new_event), [touch_id](auto& item){return item.touch_id == touch_id;});
-        last_state.push_back(*pos);
-        last_state.back().action = mir_touch_action_down;
-        dispatch(last_state);
-        last_state.back().action = mir_touch_action_change;
+        auto& inserted = last_state.contacts[last_state.count++];
+        inserted = contact;
+        inserted.action = mir_touch_action_down;
+        dispatch_synthesized_locked(lg, id, touch_event, last_state, 0);
+        inserted.action = mir_touch_action_change;
+    }
+}
+
+void mi::Validator::dispatch_synthesized_locked(
+    std::lock_guard<std::mutex> const&,
+    MirInputDeviceId id,
+    MirTouchEvent const* touch_event,
+    TouchState const& state,
+    uint32_t excluded)
+{
+    synthesized_contacts.clear();
+    for (unsigned int i = 0; i != state.count; ++i)
+    {
+        if (!(excluded & bit(i)))
+            synthesized_contacts.push_back(state.contacts[i]);
     }
+
+    dispatch_valid_event(*mev::make_event(
+            id,
+            std::chrono::nanoseconds{mir_touch_event_modifiers(touch_event)},
+            std::vector<uint8_t>{},
+            mir_touch_event_modifiers(touch_event),
+            synthesized_contacts
+            ));
 }
 
 void mi::Validator::handle_touch_event(MirEvent const& event)
@@ -152,37 +220,22 @@ void mi::Validator::handle_touch_event(MirEvent const& event)
     auto const input_event = mir_event_get_input_event(&event);
     auto const id = mir_input_event_get_device_id(input_event);
     auto const touch_event = mir_input_event_get_touch_event(input_event);
-    auto new_state = get_contact_state(touch_event);
+    get_contact_state(touch_event, next_state);
 
-    ensure_stream_validity_locked(
-        lg,
-        new_state,
-        last_event_by_device[id],
-        [this, touch_event, id](std::vector<events::ContactState> const& contacts)
-        {
-            dispatch_valid_event(*mev::make_event(
-                    id,
-                    std::chrono::nanoseconds{mir_touch_event_modifiers(touch_event)},
-                    std::vector<uint8_t>{},
-                    mir_touch_event_modifiers(touch_event),
-                    contacts
-                    ));
-        });
+    auto& last_state = last_event_by_device[id];
+    ensure_stream_validity_locked(lg, id, touch_event, next_state, last_state);
 
     dispatch_valid_event(event);
 
-    new_state.erase(
-        remove_if(
-            begin(new_state),
-            end(new_state),
-            [](auto& item)
-            {
-                if (item.action == mir_touch_action_down)
-                   item.action = mir_touch_action_change;
-                return item.action == mir_touch_action_up;
-            }),
-        end(new_state)
-        );
-
-    last_event_by_device[id] = new_state;
+    last_state.count = 0;
+    for (unsigned int i = 0; i != next_state.count; ++i)
+    {
+        auto const& contact = next_state.contacts[i];
+        if (contact.action == mir_touch_action_up)
+            continue;
+
+        auto& kept = last_state.contacts[last_state.count++];
+        kept = contact;
+        kept.action = mir_touch_action_change;
+    }
 }
@@ -162,3 +162,12 @@ void mrl::MessageProcessorReport::exception_handled(void const* mediator, std::e
     if (pm != mediators.end())
         mediators.erase(mediator);
 }
+
+void mrl::MessageProcessorReport::request_rate(
+    int client_pid, double requests_per_second, std::chrono::microseconds longest_wait)
+{
+    std::ostringstream out;
+    out << "client pid=" << client_pid << ": " << requests_per_second << " requests/s, longest wait="
+        << longest_wait.count() << "µs";
+    log->log(ml::Severity::informational, out.str(), component);
+}
@@ -72,6 +72,8 @@ public:
 
     void exception_handled(void const* mediator, std::exception const& error);
 
+    void request_rate(int client_pid, double requests_per_second, std::chrono::microseconds longest_wait);
+
     ~MessageProcessorReport() noexcept(true);
 
 private:
@@ -53,3 +53,9 @@ void mir::report::lttng::MessageProcessorReport::exception_handled(
 {
     mir_tracepoint(mir_server_msgproc, exception_handled_wo_invocation, mediator, error.what());
 }
+
+void mir::report::lttng::MessageProcessorReport::request_rate(
+    int client_pid, double requests_per_second, std::chrono::microseconds longest_wait)
+{
+    mir_tracepoint(mir_server_msgproc, request_rate, client_pid, requests_per_second, longest_wait.count());
+}
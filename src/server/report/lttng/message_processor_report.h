@@ -38,6 +38,7 @@ public:
     void unknown_method(void const* mediator, int id, std::string const& method);
     void exception_handled(void const* mediator, int id, std::exception const& error);
     void exception_handled(void const* mediator, std::exception const& error);
+    void request_rate(int client_pid, double requests_per_second, std::chrono::microseconds longest_wait);
 
 private:
     ServerTracepointProvider tp_provider;
@@ -85,6 +85,17 @@ TRACEPOINT_EVENT(
         )
     )
 
+TRACEPOINT_EVENT(
+    mir_server_msgproc,
+    request_rate,
+    TP_ARGS(int, client_pid, double, requests_per_second, int64_t, longest_wait_us),
+    TP_FIELDS(
+        ctf_integer(int, client_pid, client_pid)
+        ctf_float(double, requests_per_second, requests_per_second)
+        ctf_integer(int64_t, longest_wait_us, longest_wait_us)
+        )
+    )
+
 #endif /* MIR_LTTNG_MESSAGE_PROCESSOR_REPORT_TP_H_ */
 
 #include <lttng/tracepoint-event.h>
@@ -39,3 +39,7 @@ void mrn::MessageProcessorReport::exception_handled(void const*, int, std::excep
 void mrn::MessageProcessorReport::exception_handled(void const*, std::exception const&)
 {
 }
+
+void mrn::MessageProcessorReport::request_rate(int, double, std::chrono::microseconds)
+{
+}
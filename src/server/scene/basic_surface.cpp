@@ -25,6 +25,7 @@
 #include "mir/graphics/buffer.h"
 #include "mir/graphics/cursor_image.h"
 #include "mir/graphics/pixel_format_utils.h"
+#include "mir/graphics/surface_layer.h"
 #include "mir/geometry/displacement.h"
 #include "mir/renderer/sw/pixel_source.h"
 
@@ -770,7 +771,7 @@ std::shared_ptr<ms::Surface> ms::BasicSurface::parent() const
 namespace
 {
 //This class avoids locking for long periods of time by copying (or lazy-copying)
-class SurfaceSnapshot : public mg::Renderable
+class SurfaceSnapshot : public mg::Renderable, public mg::SurfaceLayer
 {
 public:
     SurfaceSnapshot(
@@ -779,13 +780,15 @@ public:
         geom::Rectangle const& position,
         glm::mat4 const& transform,
         float alpha,
-        mg::Renderable::ID id)
+        mg::Renderable::ID id,
+        mg::Renderable::ID surface_id)
     : underlying_buffer_stream{stream},
       compositor_id{compositor_id},
       alpha_{alpha},
       screen_position_(position),
       transformation_(transform),
-      id_(id)
+      id_(id),
+      surface_id_(surface_id)
     {
     }
 
@@ -819,6 +822,9 @@ public:
 
     mg::Renderable::ID id() const override
     { return id_; }
+
+    mg::Renderable::ID surface_id() const override
+    { return surface_id_; }
 private:
     std::shared_ptr<mc::BufferStream> const underlying_buffer_stream;
     std::shared_ptr<mg::Buffer> mutable compositor_buffer;
@@ -827,6 +833,7 @@ private:
     geom::Rectangle const screen_position_;
     glm::mat4 const transformation_;
     mg::Renderable::ID const id_;
+    mg::Renderable::ID const surface_id_;
 };
 }
 
@@ -895,7 +902,7 @@ mg::RenderableList ms::BasicSurface::generate_renderables(mc::CompositorID id) c
             list.emplace_back(std::make_shared<SurfaceSnapshot>(
                 info.stream, id,
                 geom::Rectangle{surface_rect.top_left + info.displacement, std::move(size)},
-                transformation_matrix, surface_alpha, info.stream.get()));
+                transformation_matrix, surface_alpha, info.stream.get(), this));
         }
     }
     return list;
@@ -101,28 +101,6 @@ public:
         return mir_display_configuration_error_rejected_by_hardware;
     }
 };
-
-class ApplyNowAndRevertOnScopeExit
-{
-public:
-    ApplyNowAndRevertOnScopeExit(std::function<void()> const& apply,
-                                 std::function<void()> const& revert)
-        : revert{revert}
-    {
-        apply();
-    }
-
-    ~ApplyNowAndRevertOnScopeExit()
-    {
-        revert();
-    }
-
-private:
-    ApplyNowAndRevertOnScopeExit(ApplyNowAndRevertOnScopeExit const&) = delete;
-    ApplyNowAndRevertOnScopeExit& operator=(ApplyNowAndRevertOnScopeExit const&) = delete;
-
-    std::function<void()> const revert;
-};
 }
 
 struct ms::MediatingDisplayChanger::SessionObserver : ms::SessionEventSink
@@ -474,10 +452,12 @@ void ms::MediatingDisplayChanger::apply_config(
         if (configuration_has_new_outputs_enabled(*display->configuration(), *conf) ||
             !display->apply_if_configuration_preserves_display_buffers(*conf))
         {
-            ApplyNowAndRevertOnScopeExit comp{
-                [this] { compositor->stop(); },
-                [this] { compositor->start(); }};
-            display->configure(*conf);
+            // Outputs the change leaves alone carry on compositing
+            compositor->reconfigure(
+                [this, &conf](std::function<void(mg::DisplaySyncGroup&)> const& retiring)
+                {
+                    display->configure_keeping_unchanged_groups(*conf, retiring);
+                });
         }
 
         observer->configuration_applied(conf);
@@ -494,10 +474,11 @@ void ms::MediatingDisplayChanger::apply_config(
              * was one that has been successfully display->configure()d, or it was the
              * configuration that existed at Mir startup. Which presumably worked!
              */
-            ApplyNowAndRevertOnScopeExit comp{
-                [this] { compositor->stop(); },
-                [this] { compositor->start(); }};
-            display->configure(*existing_configuration);
+            compositor->reconfigure(
+                [this, &existing_configuration](std::function<void(mg::DisplaySyncGroup&)> const& retiring)
+                {
+                    display->configure_keeping_unchanged_groups(*existing_configuration, retiring);
+                });
         }
         catch (std::exception const& e)
         {
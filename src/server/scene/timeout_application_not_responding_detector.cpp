@@ -21,10 +21,20 @@
 #include "mir/scene/session.h"
 
 #include "mir/time/alarm_factory.h"
+#include "mir/time/clock.h"
+
+#include <algorithm>
 
 namespace ms = mir::scene;
 namespace mt = mir::time;
 
+namespace
+{
+// Each slot of the wheel covers this fraction of the period
+int const wheel_slots{16};
+int64_t const unscheduled{-1};
+}
+
 struct ms::TimeoutApplicationNotRespondingDetector::ANRContext
 {
     ANRContext(std::function<void()> const& pinger)
@@ -37,6 +47,10 @@ struct ms::TimeoutApplicationNotRespondingDetector::ANRContext
     std::function<void()> const pinger;
     bool replied_since_last_ping;
     bool flagged_as_unresponsive;
+
+    // The tick the session is next due, and its position in that tick's slot
+    Tick due{unscheduled};
+    size_t slot_index{0};
 };
 
 void ms::TimeoutApplicationNotRespondingDetector::ANRObservers::session_unresponsive(
@@ -53,8 +67,13 @@ void ms::TimeoutApplicationNotRespondingDetector::ANRObservers::session_now_resp
 
 ms::TimeoutApplicationNotRespondingDetector::TimeoutApplicationNotRespondingDetector(
     mt::AlarmFactory& alarms,
+    std::shared_ptr<mt::Clock> const& clock,
     std::chrono::milliseconds period)
-    : period{period},
+    : clock{clock},
+      epoch{clock->now()},
+      tick{std::max(std::chrono::duration_cast<mt::Duration>(period) / wheel_slots, mt::Duration{1})},
+      wheel(wheel_slots),
+      processed_through{0},
       alarm{alarms.create_alarm(std::bind(&TimeoutApplicationNotRespondingDetector::handle_ping_cycle, this))}
 {
 }
@@ -66,50 +85,59 @@ ms::TimeoutApplicationNotRespondingDetector::~TimeoutApplicationNotRespondingDet
 void ms::TimeoutApplicationNotRespondingDetector::register_session(
     frontend::Session const* session, std::function<void()> const& pinger)
 {
-    bool alarm_needs_schedule;
+    auto const scene_session = dynamic_cast<Session const*>(session);
+    Tick due;
     {
         std::lock_guard<std::mutex> lock{session_mutex};
-        sessions[dynamic_cast<Session const*>(session)] = std::make_unique<ANRContext>(pinger);
-        alarm_needs_schedule = alarm->state() != mt::Alarm::State::pending;
-    }
-    if (alarm_needs_schedule)
-    {
-        alarm->reschedule_in(period);
+
+        auto& context = sessions[scene_session];
+        if (context)
+            unschedule(*context);
+
+        context = std::make_shared<ANRContext>(pinger);
+        schedule(scene_session, *context, a_period_from_now());
+        due = context->due;
     }
+    arm_alarm(due);
 }
 
 void ms::TimeoutApplicationNotRespondingDetector::unregister_session(
     frontend::Session const* session)
 {
     std::lock_guard<std::mutex> lock{session_mutex};
-    sessions.erase(dynamic_cast<Session const*>(session));
+
+    auto const i = sessions.find(dynamic_cast<Session const*>(session));
+    if (i != sessions.end())
+    {
+        unschedule(*i->second);
+        sessions.erase(i);
+    }
 }
 
 void ms::TimeoutApplicationNotRespondingDetector::pong_received(
    frontend::Session const* received_for)
 {
+    auto const scene_session = dynamic_cast<Session const*>(received_for);
     bool needs_now_responsive_notification{false};
-    bool alarm_needs_rescheduling;
+    Tick due{unscheduled};
     {
         std::lock_guard<std::mutex> lock{session_mutex};
 
-        auto& session_ctx = sessions.at(dynamic_cast<Session const*>(received_for));
-        if (session_ctx->flagged_as_unresponsive)
+        auto& session_ctx = *sessions.at(scene_session);
+        if (session_ctx.flagged_as_unresponsive)
         {
-            session_ctx->flagged_as_unresponsive = false;
+            // Unresponsive sessions are out of the wheel until they reply
+            session_ctx.flagged_as_unresponsive = false;
             needs_now_responsive_notification = true;
+            schedule(scene_session, session_ctx, a_period_from_now());
+            due = session_ctx.due;
         }
-        session_ctx->replied_since_last_ping = true;
-
-        alarm_needs_rescheduling = alarm->state() != mt::Alarm::State::pending;
+        session_ctx.replied_since_last_ping = true;
     }
     if (needs_now_responsive_notification)
     {
-        observers.session_now_responsive(dynamic_cast<Session const*>(received_for));
-    }
-    if (alarm_needs_rescheduling)
-    {
-        alarm->reschedule_in(period);
+        observers.session_now_responsive(scene_session);
+        arm_alarm(due);
     }
 }
 
@@ -144,32 +172,70 @@ void ms::TimeoutApplicationNotRespondingDetector::unregister_observer(
 
 void ms::TimeoutApplicationNotRespondingDetector::handle_ping_cycle()
 {
-    bool needs_rearm{false};
+    Tick next_due{unscheduled};
     {
         std::lock_guard<std::mutex> lock{session_mutex};
-        for (auto const& session_pair : sessions)
-        {
-            bool const newly_unresponsive =
-                !session_pair.second->replied_since_last_ping &&
-                !session_pair.second->flagged_as_unresponsive;
-            bool const needs_ping =
-                session_pair.second->replied_since_last_ping;
 
-            if (newly_unresponsive)
+        auto const now = now_tick();
+        auto const slots = static_cast<Tick>(wheel.size());
+
+        // A late wakeup may have several slots due, but need visit each at most once
+        for (auto t = processed_through + 1; t <= std::min(now, processed_through + slots); ++t)
+        {
+            auto& slot = wheel[t % slots];
+            for (size_t i = 0; i < slot.size();)
             {
-                session_pair.second->flagged_as_unresponsive = true;
-                unresponsive_sessions_temporary.push_back(session_pair.first);
+                auto const session = slot[i];
+                auto const& context = sessions.at(session);
+
+                // Due a whole turn of the wheel later
+                if (context->due > now)
+                {
+                    ++i;
+                    continue;
+                }
+
+                // Replaces slot[i] with another of the slot's sessions
+                unschedule(*context);
+
+                if (context->replied_since_last_ping)
+                {
+                    context->replied_since_last_ping = false;
+                    sessions_to_ping_temporary.push_back(context);
+
+                    schedule(session, *context, now + slots);
+                }
+                else
+                {
+                    context->flagged_as_unresponsive = true;
+                    unresponsive_sessions_temporary.push_back(session);
+                }
             }
-            else if (needs_ping)
+        }
+
+        processed_through = now;
+
+        if (scheduled)
+        {
+            for (auto t = now + 1; t <= now + slots; ++t)
             {
-                session_pair.second->pinger();
-                session_pair.second->replied_since_last_ping = false;
-                needs_rearm = true;
+                if (!wheel[t % slots].empty())
+                {
+                    next_due = t;
+                    break;
+                }
             }
         }
     }
 
-    // Dispatch notifications outside the lock.
+    // Ping and dispatch notifications outside the lock.
+    for (auto const& session : sessions_to_ping_temporary)
+    {
+        session->pinger();
+    }
+
+    sessions_to_ping_temporary.clear();
+
     for (auto const& unresponsive_session : unresponsive_sessions_temporary)
     {
         observers.session_unresponsive(unresponsive_session);
@@ -177,8 +243,53 @@ void ms::TimeoutApplicationNotRespondingDetector::handle_ping_cycle()
 
     unresponsive_sessions_temporary.clear();
 
-    if (needs_rearm)
+    if (next_due != unscheduled)
+    {
+        alarm->reschedule_for(epoch + next_due * tick);
+    }
+}
+
+auto ms::TimeoutApplicationNotRespondingDetector::now_tick() const -> Tick
+{
+    return (clock->now() - epoch) / tick;
+}
+
+auto ms::TimeoutApplicationNotRespondingDetector::a_period_from_now() const -> Tick
+{
+    // Round up, so a session is never due less than a period after it is scheduled
+    auto const elapsed = clock->now() - epoch;
+    return (elapsed + tick - mt::Duration{1}) / tick + static_cast<Tick>(wheel.size());
+}
+
+void ms::TimeoutApplicationNotRespondingDetector::schedule(Session const* session, ANRContext& context, Tick due)
+{
+    auto& slot = wheel[due % wheel.size()];
+    context.due = due;
+    context.slot_index = slot.size();
+    slot.push_back(session);
+    ++scheduled;
+}
+
+void ms::TimeoutApplicationNotRespondingDetector::unschedule(ANRContext& context)
+{
+    if (context.due == unscheduled)
+        return;
+
+    auto& slot = wheel[context.due % wheel.size()];
+    auto const moved = slot.back();
+    slot[context.slot_index] = moved;
+    sessions.at(moved)->slot_index = context.slot_index;
+    slot.pop_back();
+
+    context.due = unscheduled;
+    --scheduled;
+}
+
+void ms::TimeoutApplicationNotRespondingDetector::arm_alarm(Tick due)
+{
+    // A pending alarm is never later than a newly scheduled session is due
+    if (alarm->state() != mt::Alarm::State::pending)
     {
-        this->alarm->reschedule_in(this->period);
+        alarm->reschedule_for(epoch + due * tick);
     }
 }
@@ -21,10 +21,13 @@
 
 #include "mir/scene/application_not_responding_detector.h"
 #include "mir/basic_observers.h"
+#include "mir/time/types.h"
 
 #include <chrono>
+#include <cstdint>
 #include <unordered_map>
 #include <functional>
+#include <vector>
 
 namespace mir
 {
@@ -32,22 +35,35 @@ namespace time
 {
 class Alarm;
 class AlarmFactory;
+class Clock;
 }
 
 namespace scene
 {
+/**
+ * Pings each session once a period, and reports sessions that have not
+ * replied to the previous ping by the time the next is due.
+ *
+ * Sessions are kept in a timer wheel: a ring of slots each covering a
+ * fraction of the period. The alarm only wakes for slots that hold sessions,
+ * and each wakeup only visits the sessions due, so the cost is constant per
+ * session per period rather than a scan of every session every period.
+ * Unresponsive sessions leave the wheel until they reply.
+ */
 class TimeoutApplicationNotRespondingDetector : public ApplicationNotRespondingDetector
 {
 public:
     TimeoutApplicationNotRespondingDetector(
         time::AlarmFactory& alarms,
+        std::shared_ptr<time::Clock> const& clock,
         std::chrono::milliseconds period);
 
     template<typename Rep, typename Period>
     TimeoutApplicationNotRespondingDetector(
         time::AlarmFactory& alarms,
+        std::shared_ptr<time::Clock> const& clock,
         std::chrono::duration<Rep, Period> period)
-        : TimeoutApplicationNotRespondingDetector(alarms,
+        : TimeoutApplicationNotRespondingDetector(alarms, clock,
               std::chrono::duration_cast<std::chrono::milliseconds>(period))
     {
     }
@@ -64,10 +80,18 @@ public:
     void register_observer(std::shared_ptr<Observer> const& observer) override;
     void unregister_observer(std::shared_ptr<Observer> const& observer) override;
 private:
+    using Tick = int64_t;
+
     void handle_ping_cycle();
 
     struct ANRContext;
 
+    Tick now_tick() const;
+    Tick a_period_from_now() const;
+    void schedule(Session const* session, ANRContext& context, Tick due);
+    void unschedule(ANRContext& context);
+    void arm_alarm(Tick due);
+
     class ANRObservers : public Observer, private BasicObservers<Observer>
     {
     public:
@@ -79,10 +103,17 @@ private:
     } observers;
 
     std::mutex session_mutex;
-    std::unordered_map<Session const*, std::unique_ptr<ANRContext>> sessions;
+    std::unordered_map<Session const*, std::shared_ptr<ANRContext>> sessions;
     std::vector<Session const*> unresponsive_sessions_temporary;
+    std::vector<std::shared_ptr<ANRContext>> sessions_to_ping_temporary;
+
+    std::shared_ptr<time::Clock> const clock;
+    time::Timestamp const epoch;
+    time::Duration const tick;
+    std::vector<std::vector<Session const*>> wheel;
+    size_t scheduled{0};
+    Tick processed_through;
 
-    std::chrono::milliseconds const period;
     std::unique_ptr<time::Alarm> const alarm;
 };
 }
@@ -33,6 +33,7 @@
 #include "mir/main_loop.h"
 #include "mir/report_exception.h"
 #include "mir/run_mir.h"
+#include "mir/startup_trace.h"
 #include "mir/cookie/authority.h"
 
 // TODO these are used to frig a stub renderer when running headless
@@ -42,6 +43,7 @@
 
 #include "frontend_wayland/wayland_connector.h"
 
+#include <fstream>
 #include <iostream>
 
 namespace mo = mir::options;
@@ -391,8 +393,13 @@ void mir::Server::run()
 {
     try
     {
-        mir::log_info("Starting");
         verify_accessing_allowed(self->server_config);
+        auto const options = self->server_config->the_options();
+
+        if (options->is_set(mo::startup_trace_opt))
+            start_startup_trace();
+
+        mir::log_info("Starting");
 
         auto const emergency_cleanup = self->server_config->the_emergency_cleanup();
         auto const composite_event_filter = self->server_config->the_composite_event_filter();
@@ -407,10 +414,35 @@ void mir::Server::run()
 
         self->pre_init_callback();
 
+        // keep the components constructed in parallel alive while the server is running
+        auto const parallel_initialization = options->get<bool>(mo::parallel_startup_opt) ?
+            self->server_config->start_parallel_initialization() :
+            decltype(self->server_config->start_parallel_initialization()){};
+
         run_mir(
             *self->server_config,
             [&](DisplayServer&)
-                { self->init_callback(); },
+                {
+                    self->init_callback();
+
+                    if (startup_trace_running())
+                    {
+                        // Startup is complete once the main loop is running
+                        auto const trace_file = options->get<std::string>(mo::startup_trace_opt);
+                        self->server_config->the_main_loop()->enqueue(
+                            this,
+                            [trace_file]
+                            {
+                                std::ofstream out{trace_file};
+                                out << stop_startup_trace();
+
+                                if (out)
+                                    mir::log_info("Wrote startup trace to %s", trace_file.c_str());
+                                else
+                                    mir::log_warning("Failed to write startup trace to %s", trace_file.c_str());
+                            });
+                    }
+                },
             self->terminator);
 
         self->exit_status = true;
@@ -42,6 +42,8 @@ public:
     std::unique_ptr<time::Alarm> create_alarm(
         std::unique_ptr<LockableCallback> callback) override;
 
+    std::shared_ptr<time::Clock> the_clock() const;
+
     void advance_by(time::Duration step);
     void advance_smoothly_by(time::Duration step);
     int wakeup_count() const;
@@ -23,6 +23,7 @@
 
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#include <X11/extensions/Xrender.h>
 
 namespace mir
 {
@@ -90,6 +91,23 @@ public:
     MOCK_METHOD3(XInternAtom, Atom(Display*, const char*, Bool));
     MOCK_METHOD4(XSetWMProtocols, Status(Display*, Window, Atom*, int));
     MOCK_METHOD9(XGetGeometry, Status(Display*, Drawable, Window*, int*, int*, unsigned int*, unsigned int*, unsigned int*, unsigned int*));
+    MOCK_METHOD5(XCreateBitmapFromData, Pixmap(Display*, Drawable, const char*, unsigned int, unsigned int));
+    MOCK_METHOD7(XCreatePixmapCursor, Cursor(Display*, Pixmap, Pixmap, XColor*, XColor*, unsigned int, unsigned int));
+    MOCK_METHOD5(XCreatePixmap, Pixmap(Display*, Drawable, unsigned int, unsigned int, unsigned int));
+    MOCK_METHOD2(XFreePixmap, int(Display*, Pixmap));
+    MOCK_METHOD4(XCreateGC, GC(Display*, Drawable, unsigned long, XGCValues*));
+    MOCK_METHOD2(XFreeGC, int(Display*, GC));
+    MOCK_METHOD1(XInitImage, Status(XImage*));
+    MOCK_METHOD10(XPutImage, int(Display*, Drawable, GC, XImage*, int, int, int, int, unsigned int, unsigned int));
+    MOCK_METHOD3(XDefineCursor, int(Display*, Window, Cursor));
+    MOCK_METHOD2(XUndefineCursor, int(Display*, Window));
+    MOCK_METHOD2(XFreeCursor, int(Display*, Cursor));
+    MOCK_METHOD1(XFlush, int(Display*));
+    MOCK_METHOD3(XRenderQueryExtension, Bool(Display*, int*, int*));
+    MOCK_METHOD2(XRenderFindStandardFormat, XRenderPictFormat*(Display*, int));
+    MOCK_METHOD5(XRenderCreatePicture, Picture(Display*, Drawable, XRenderPictFormat const*, unsigned long, XRenderPictureAttributes const*));
+    MOCK_METHOD2(XRenderFreePicture, void(Display*, Picture));
+    MOCK_METHOD4(XRenderCreateCursor, Cursor(Display*, Picture, unsigned int, unsigned int));
 
     FakeX11Resources fake_x11;
 };
@@ -152,6 +152,11 @@ std::unique_ptr<mt::Alarm> mtd::FakeAlarmFactory::create_alarm(
     throw std::logic_error{"Lockable alarm creation not implemented for fake alarms"};
 }
 
+std::shared_ptr<mt::Clock> mtd::FakeAlarmFactory::the_clock() const
+{
+    return clock;
+}
+
 void mtd::FakeAlarmFactory::advance_by(mt::Duration step)
 {
     clock->advance_by(step);
@@ -254,3 +254,93 @@ Status XGetGeometry(Display* display, Drawable d,
                                      width_return, height_return,
                                      border_width_return, depth_return);
 }
+
+Pixmap XCreateBitmapFromData(Display* display, Drawable d, const char* data, unsigned int width, unsigned int height)
+{
+    return global_mock->XCreateBitmapFromData(display, d, data, width, height);
+}
+
+Cursor XCreatePixmapCursor(Display* display, Pixmap source, Pixmap mask,
+                           XColor* foreground_color, XColor* background_color,
+                           unsigned int x, unsigned int y)
+{
+    return global_mock->XCreatePixmapCursor(display, source, mask, foreground_color, background_color, x, y);
+}
+
+Pixmap XCreatePixmap(Display* display, Drawable d, unsigned int width, unsigned int height, unsigned int depth)
+{
+    return global_mock->XCreatePixmap(display, d, width, height, depth);
+}
+
+int XFreePixmap(Display* display, Pixmap pixmap)
+{
+    return global_mock->XFreePixmap(display, pixmap);
+}
+
+GC XCreateGC(Display* display, Drawable d, unsigned long valuemask, XGCValues* values)
+{
+    return global_mock->XCreateGC(display, d, valuemask, values);
+}
+
+int XFreeGC(Display* display, GC gc)
+{
+    return global_mock->XFreeGC(display, gc);
+}
+
+Status XInitImage(XImage* image)
+{
+    return global_mock->XInitImage(image);
+}
+
+int XPutImage(Display* display, Drawable d, GC gc, XImage* image,
+              int src_x, int src_y, int dest_x, int dest_y,
+              unsigned int width, unsigned int height)
+{
+    return global_mock->XPutImage(display, d, gc, image, src_x, src_y, dest_x, dest_y, width, height);
+}
+
+int XDefineCursor(Display* display, Window w, Cursor cursor)
+{
+    return global_mock->XDefineCursor(display, w, cursor);
+}
+
+int XUndefineCursor(Display* display, Window w)
+{
+    return global_mock->XUndefineCursor(display, w);
+}
+
+int XFreeCursor(Display* display, Cursor cursor)
+{
+    return global_mock->XFreeCursor(display, cursor);
+}
+
+int XFlush(Display* display)
+{
+    return global_mock->XFlush(display);
+}
+
+Bool XRenderQueryExtension(Display* display, int* event_base_return, int* error_base_return)
+{
+    return global_mock->XRenderQueryExtension(display, event_base_return, error_base_return);
+}
+
+XRenderPictFormat* XRenderFindStandardFormat(Display* display, int format)
+{
+    return global_mock->XRenderFindStandardFormat(display, format);
+}
+
+Picture XRenderCreatePicture(Display* display, Drawable drawable, XRenderPictFormat const* format,
+                             unsigned long valuemask, XRenderPictureAttributes const* attributes)
+{
+    return global_mock->XRenderCreatePicture(display, drawable, format, valuemask, attributes);
+}
+
+void XRenderFreePicture(Display* display, Picture picture)
+{
+    global_mock->XRenderFreePicture(display, picture);
+}
+
+Cursor XRenderCreateCursor(Display* display, Picture source, unsigned int x, unsigned int y)
+{
+    return global_mock->XRenderCreateCursor(display, source, x, y);
+}
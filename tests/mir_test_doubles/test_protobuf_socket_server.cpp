@@ -46,7 +46,9 @@ std::shared_ptr<mf::Connector> make_connector(
             factory,
             std::make_shared<mtd::StubSessionAuthorizer>(),
             std::make_shared<mtd::NullPlatformIpcOperations>(),
-            mr::null_message_processor_report()),
+            mr::null_message_processor_report(),
+            nullptr),
+        1,
         null_emergency_cleanup,
         report);
 }
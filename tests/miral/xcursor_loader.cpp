@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "xcursor_loader.h"
+
+#include <mir/graphics/cursor_image.h>
+#include <mir_test_framework/executable_path.h>
+#include <mir_test_framework/temporary_environment_value.h>
+#include <mir_toolkit/cursors.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+
+namespace mi = mir::input;
+namespace mtf = mir_test_framework;
+namespace geom = mir::geometry;
+
+using namespace testing;
+
+namespace
+{
+struct XCursorLoader : Test
+{
+    mtf::TemporaryEnvironmentValue const cursor_path{
+        "XCURSOR_PATH", (mtf::test_data_path() + "/testing-cursor-theme").c_str()};
+
+    miral::XCursorLoader loader{"default"};
+};
+
+uint32_t first_pixel(mir::graphics::CursorImage const& image)
+{
+    return *static_cast<uint32_t const*>(image.as_argb_8888());
+}
+}
+
+TEST_F(XCursorLoader, loads_cursors_from_the_theme)
+{
+    auto const red = loader.image("red", mi::default_cursor_size);
+    auto const blue = loader.image("blue", mi::default_cursor_size);
+
+    ASSERT_THAT(red, NotNull());
+    ASSERT_THAT(blue, NotNull());
+
+    EXPECT_THAT(red->size(), Eq(mi::default_cursor_size));
+    EXPECT_THAT(first_pixel(*red) & 0xffffff, Eq(0xff0000u));
+    EXPECT_THAT(first_pixel(*blue) & 0xffffff, Eq(0x0000ffu));
+}
+
+TEST_F(XCursorLoader, reuses_loaded_cursors)
+{
+    auto const first = loader.image("red", mi::default_cursor_size);
+    auto const second = loader.image("red", mi::default_cursor_size);
+
+    EXPECT_THAT(first, Eq(second));
+}
+
+TEST_F(XCursorLoader, unknown_cursors_fall_back_to_arrow)
+{
+    auto const arrow = loader.image(mir_arrow_cursor_name, mi::default_cursor_size);
+
+    ASSERT_THAT(arrow, NotNull());
+    EXPECT_THAT(loader.image("no-such-cursor", mi::default_cursor_size), Eq(arrow));
+}
+
+TEST_F(XCursorLoader, loads_each_requested_size_separately)
+{
+    geom::Size const hidpi_size{48, 48};
+
+    auto const normal = loader.image("green", mi::default_cursor_size);
+    auto const hidpi = loader.image("green", hidpi_size);
+
+    ASSERT_THAT(normal, NotNull());
+    ASSERT_THAT(hidpi, NotNull());
+    EXPECT_THAT(hidpi, Ne(normal));
+    EXPECT_THAT(loader.image("green", hidpi_size), Eq(hidpi));
+}
@@ -22,7 +22,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
 
 namespace mtf = mir_test_framework;
 
@@ -41,19 +45,19 @@ struct ClientStartupPerformance : testing::Test, mtf::AsyncServerRunner
     {
         stop_server();
     }
+};
 
-    MirConnection* create_connection()
+MirConnection* create_connection(std::string const& connect_string)
+{
+    auto conn = mir_connect_sync(connect_string.c_str(), "Perf test");
+    if (!mir_connection_is_valid(conn))
     {
-        auto conn = mir_connect_sync(new_connection().c_str(), "Perf test");
-        if (!mir_connection_is_valid(conn))
-        {
-            std::string error_msg{"Could not create connection: "};
-            error_msg.append(mir_connection_get_error_message(conn));
-            throw std::runtime_error(error_msg);
-        }
-        return conn;
+        std::string error_msg{"Could not create connection: "};
+        error_msg.append(mir_connection_get_error_message(conn));
+        throw std::runtime_error(error_msg);
     }
-};
+    return conn;
+}
 
 MirPixelFormat find_pixel_format(MirConnection* connection)
 {
@@ -86,14 +90,12 @@ MirWindow* make_surface(MirConnection* connection)
     }
     return window;
 }
-}
 
-TEST_F(ClientStartupPerformance, create_surface_and_swap)
+std::chrono::milliseconds time_to_first_frame(std::string const& connect_string)
 {
-    using namespace std::chrono_literals;
     auto start = std::chrono::steady_clock::now();
 
-    auto conn = create_connection();
+    auto conn = create_connection(connect_string);
     auto window = make_surface(conn);
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -109,13 +111,65 @@ TEST_F(ClientStartupPerformance, create_surface_and_swap)
     mir_buffer_stream_swap_buffers_sync(stream);
 
     auto end = std::chrono::steady_clock::now();
-    auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(end-start);
+
+    mir_window_release_sync(window);
+    mir_connection_release(conn);
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end-start);
+}
+}
+
+TEST_F(ClientStartupPerformance, create_surface_and_swap)
+{
+    using namespace std::chrono_literals;
+
+    auto diff = time_to_first_frame(new_connection());
 
     //NOTE: Ideally, the expected number should vary according to platform
     auto max_expected_time = 80ms;
     EXPECT_THAT(diff.count(), Lt(max_expected_time.count()));
-
-    mir_window_release_sync(window);
-    mir_connection_release(conn);
 }
 
+TEST_F(ClientStartupPerformance, many_clients_reach_first_frame)
+{
+    using namespace std::chrono_literals;
+    auto const client_count = 50;
+
+    std::vector<std::string> connect_strings;
+    for (auto i = 0; i != client_count; ++i)
+        connect_strings.push_back(new_connection());
+
+    std::vector<std::chrono::milliseconds> times(client_count, std::chrono::milliseconds::max());
+    std::vector<std::thread> clients;
+    for (auto i = 0; i != client_count; ++i)
+    {
+        clients.emplace_back(
+            [&times, &connect_strings, i]
+            {
+                try
+                {
+                    times[i] = time_to_first_frame(connect_strings[i]);
+                }
+                catch (std::exception const& error)
+                {
+                    ADD_FAILURE() << error.what();
+                }
+            });
+    }
+
+    for (auto& client : clients)
+        client.join();
+
+    std::sort(times.begin(), times.end());
+    auto const median = times[client_count / 2];
+    auto const slowest = times.back();
+
+    printf("Time to first frame for %d parallel clients: median %lldms, max %lldms\n",
+           client_count,
+           static_cast<long long>(median.count()),
+           static_cast<long long>(slowest.count()));
+
+    //NOTE: Ideally, the expected number should vary according to platform
+    auto max_expected_time = 1000ms;
+    EXPECT_THAT(slowest.count(), Lt(max_expected_time.count()));
+}
@@ -156,6 +156,23 @@ TEST_F(BufferVault, creates_all_buffers_on_start)
     make_vault();
 }
 
+TEST_F(BufferVault, only_requests_buffers_the_server_did_not_preallocate)
+{
+    unsigned int const preallocated{2};
+
+    EXPECT_CALL(mock_requests, allocate_buffer(size, format, usage))
+        .Times(initial_nbuffers - preallocated);
+
+    mcl::BufferVault vault{
+        mt::fake_shared(mock_platform_factory), mt::fake_shared(buffer_factory),
+        mt::fake_shared(mock_requests), surface_map,
+        size, format, usage, initial_nbuffers, preallocated};
+
+    // ...but is still ready for the preallocated ones
+    EXPECT_THAT(buffer_factory.generate_buffer(package), NotNull());
+    EXPECT_THAT(buffer_factory.generate_buffer(package2), NotNull());
+}
+
 TEST_F(BufferVault, withdrawing_and_never_filling_up_will_timeout)
 {
     using namespace std::literals::chrono_literals;
@@ -621,3 +638,88 @@ TEST_F(StartedBufferVault, can_increase_count_after_resize)
         vault.wire_transfer_inbound(package4.buffer_id());
     }
 }
+
+TEST_F(StartedBufferVault, adaptive_vault_allocates_extra_buffer_when_withdraw_blocks)
+{
+    EXPECT_CALL(mock_requests, allocate_buffer(size,_,_))
+        .Times(1);
+
+    vault.set_adaptive(true);
+    for (auto i = 0u; i < initial_nbuffers; i++)
+        vault.withdraw().get();
+    auto blocked = vault.withdraw();
+
+    Mock::VerifyAndClearExpectations(&mock_requests);
+    vault.disconnected();
+}
+
+TEST_F(StartedBufferVault, fixed_vault_does_not_grow_when_withdraw_blocks)
+{
+    EXPECT_CALL(mock_requests, allocate_buffer(_,_,_))
+        .Times(0);
+
+    for (auto i = 0u; i < initial_nbuffers; i++)
+        vault.withdraw().get();
+    auto blocked = vault.withdraw();
+
+    Mock::VerifyAndClearExpectations(&mock_requests);
+    vault.disconnected();
+}
+
+TEST_F(BufferVault, adaptive_vault_does_not_grow_while_initial_buffers_are_allocated)
+{
+    EXPECT_CALL(mock_requests, allocate_buffer(_,_,_))
+        .Times(initial_nbuffers);
+
+    auto vault = make_vault();
+    vault->set_adaptive(true);
+    auto blocked = vault->withdraw();
+
+    Mock::VerifyAndClearExpectations(&mock_requests);
+    vault.reset();
+}
+
+TEST_F(StartedBufferVault, mailbox_interval_reuses_adaptively_allocated_buffer)
+{
+    EXPECT_CALL(mock_requests, allocate_buffer(_,_,_))
+        .Times(1);
+
+    vault.set_adaptive(true);
+    for (auto i = 0u; i < initial_nbuffers; i++)
+        vault.withdraw().get();
+    auto blocked = vault.withdraw();
+    vault.set_interval(0);
+
+    Mock::VerifyAndClearExpectations(&mock_requests);
+    vault.disconnected();
+}
+
+TEST_F(StartedBufferVault, adaptive_vault_frees_extra_buffer_once_it_stays_spare)
+{
+    vault.set_adaptive(true);
+    std::vector<std::shared_ptr<mcl::MirBuffer>> withdrawn;
+    for (auto i = 0u; i < initial_nbuffers; i++)
+        withdrawn.push_back(vault.withdraw().get());
+    auto blocked = vault.withdraw();
+
+    for (auto const& buffer : withdrawn)
+    {
+        vault.deposit(buffer);
+        vault.wire_transfer_outbound(buffer, []{});
+        vault.wire_transfer_inbound(buffer->rpc_id());
+    }
+    auto held = blocked.get();
+
+    EXPECT_CALL(mock_requests, free_buffer(_))
+        .Times(1);
+
+    for (auto i = 0u; i < 200u; i++)
+    {
+        auto buffer = vault.withdraw().get();
+        vault.deposit(buffer);
+        vault.wire_transfer_outbound(buffer, []{});
+        vault.wire_transfer_inbound(buffer->rpc_id());
+    }
+
+    Mock::VerifyAndClearExpectations(&mock_requests);
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/client/motion_resampler.h"
+#include "mir/events/event_builders.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cmath>
+
+namespace mcl = mir::client;
+namespace mev = mir::events;
+
+using namespace ::testing;
+using namespace ::std::chrono_literals;
+using std::chrono::nanoseconds;
+
+namespace
+{
+MirInputDeviceId const mouse{1};
+MirInputDeviceId const touchscreen{2};
+
+mir::EventUPtr pointer(nanoseconds time, float x, float y, MirPointerAction action = mir_pointer_action_motion,
+                       float dx = 0, float dy = 0)
+{
+    return mev::make_event(mouse, time, std::vector<uint8_t>{}, mir_input_event_modifier_none,
+                           action, 0, x, y, 0, 0, dx, dy);
+}
+
+mir::EventUPtr touch(nanoseconds time, float x, float y, MirTouchAction action = mir_touch_action_change)
+{
+    auto event = mev::make_event(touchscreen, time, std::vector<uint8_t>{}, mir_input_event_modifier_none);
+    mev::add_touch(*event, 0, action, mir_touch_tooltype_finger, x, y, 1, 1, 1, 1);
+    return event;
+}
+
+float x_of(MirEvent const& event)
+{
+    auto const input = mir_event_get_input_event(&event);
+    if (mir_input_event_get_type(input) == mir_input_event_type_touch)
+        return mir_touch_event_axis_value(mir_input_event_get_touch_event(input), 0, mir_touch_axis_x);
+
+    return mir_pointer_event_axis_value(mir_input_event_get_pointer_event(input), mir_pointer_axis_x);
+}
+
+float pointer_axis(MirEvent const& event, MirPointerAxis axis)
+{
+    return mir_pointer_event_axis_value(mir_input_event_get_pointer_event(mir_event_get_input_event(&event)), axis);
+}
+
+struct MotionResampler : Test
+{
+    mcl::MotionResampler resampler;
+};
+}
+
+TEST_F(MotionResampler, keeps_only_motion)
+{
+    EXPECT_TRUE(resampler.add(*pointer(0ms, 0, 0)));
+    EXPECT_TRUE(resampler.add(*touch(0ms, 0, 0)));
+
+    EXPECT_FALSE(resampler.add(*pointer(1ms, 0, 0, mir_pointer_action_button_down)));
+    EXPECT_FALSE(resampler.add(*touch(1ms, 0, 0, mir_touch_action_up)));
+    EXPECT_FALSE(resampler.add(*mev::make_event(mir::frontend::SurfaceId{1}, mir::geometry::Size{1, 1})));
+}
+
+TEST_F(MotionResampler, delivers_one_event_per_device_with_the_raw_events)
+{
+    resampler.add(*pointer(0ms, 0, 0));
+    resampler.add(*touch(1ms, 0, 0));
+    resampler.add(*pointer(2ms, 2, 0));
+    resampler.add(*pointer(4ms, 4, 0));
+
+    auto const motion = resampler.resample(16ms);
+
+    ASSERT_THAT(motion.size(), Eq(2u));
+    EXPECT_THAT(motion[0].raw.size(), Eq(1u));
+    EXPECT_THAT(motion[1].raw.size(), Eq(3u));
+    EXPECT_THAT(x_of(motion[1].raw.back()), FloatEq(4));
+    EXPECT_TRUE(resampler.empty());
+}
+
+TEST_F(MotionResampler, interpolates_to_shortly_before_the_frame)
+{
+    resampler.add(*pointer(0ms, 0, 0));
+    resampler.add(*pointer(10ms, 100, 0));
+    resampler.add(*pointer(20ms, 200, 0));
+
+    auto const motion = resampler.resample(13ms);
+
+    ASSERT_THAT(motion.size(), Eq(1u));
+    EXPECT_THAT(x_of(motion[0].event), FloatEq(80));
+    EXPECT_THAT(mir_input_event_get_event_time(mir_event_get_input_event(&motion[0].event)), Eq(8000000));
+}
+
+TEST_F(MotionResampler, extrapolates_only_a_short_way)
+{
+    resampler.add(*touch(0ms, 0, 0));
+    resampler.add(*touch(10ms, 100, 0));
+
+    auto const motion = resampler.resample(30ms);
+
+    ASSERT_THAT(motion.size(), Eq(1u));
+    EXPECT_THAT(x_of(motion[0].event), FloatEq(150));
+}
+
+TEST_F(MotionResampler, resamples_using_motion_of_the_previous_frame)
+{
+    resampler.add(*pointer(0ms, 0, 0));
+    resampler.resample(4ms);
+
+    resampler.add(*pointer(10ms, 100, 0));
+    auto const motion = resampler.resample(13ms);
+
+    ASSERT_THAT(motion.size(), Eq(1u));
+    EXPECT_THAT(x_of(motion[0].event), FloatEq(80));
+}
+
+TEST_F(MotionResampler, does_not_resample_across_gestures)
+{
+    resampler.add(*touch(0ms, 0, 0));
+    resampler.add(*touch(5ms, 50, 0, mir_touch_action_up));
+    resampler.add(*touch(10ms, 100, 0));
+
+    auto const motion = resampler.resample(30ms);
+
+    ASSERT_THAT(motion.size(), Eq(1u));
+    EXPECT_THAT(x_of(motion[0].event), FloatEq(100));
+}
+
+TEST_F(MotionResampler, sums_relative_motion)
+{
+    resampler.add(*pointer(0ms, 0, 0, mir_pointer_action_motion, 1, 2));
+    resampler.add(*pointer(4ms, 0, 0, mir_pointer_action_motion, 3, 4));
+
+    auto const motion = resampler.resample(16ms);
+
+    ASSERT_THAT(motion.size(), Eq(1u));
+    EXPECT_THAT(pointer_axis(motion[0].event, mir_pointer_axis_relative_x), FloatEq(4));
+    EXPECT_THAT(pointer_axis(motion[0].event, mir_pointer_axis_relative_y), FloatEq(6));
+}
+
+TEST_F(MotionResampler, flush_delivers_the_latest_sample)
+{
+    resampler.add(*pointer(0ms, 0, 0));
+    resampler.add(*pointer(10ms, 100, 0));
+
+    auto const motion = resampler.flush();
+
+    ASSERT_THAT(motion.size(), Eq(1u));
+    EXPECT_THAT(x_of(motion[0].event), FloatEq(100));
+    EXPECT_TRUE(resampler.empty());
+}
+
+TEST_F(MotionResampler, flushing_keeps_only_the_samples_the_next_frame_needs)
+{
+    for (auto time = 0ms; time != 1000ms; time += 1ms)
+    {
+        resampler.add(*pointer(time, time.count(), 0));
+        resampler.flush();
+    }
+
+    EXPECT_THAT(resampler.samples_kept(), Le(2u));
+}
+
+// What the frame-uniformity benchmark measures: how far what the client sees
+// at each frame is from the true position, and how much that varies
+TEST_F(MotionResampler, resampled_motion_is_more_uniform_than_the_latest_sample)
+{
+    auto const frame = 16666667ns;
+    auto const input_interval = 7ms;
+    float const speed = 1.0f / 1000000;  // px/ns (1000 px/s)
+
+    double latest_lag_sum{0}, latest_lag_squares{0};
+    double resampled_lag_sum{0}, resampled_lag_squares{0};
+    int frames{0};
+
+    nanoseconds next_input{0};
+    for (auto frame_time = frame; frame_time < 2s; frame_time += frame)
+    {
+        float latest_x{0};
+        for (; next_input <= frame_time; next_input += input_interval)
+        {
+            latest_x = speed * next_input.count();
+            resampler.add(*touch(next_input, latest_x, 0));
+        }
+
+        auto const motion = resampler.resample(frame_time);
+        if (motion.empty())
+            continue;
+
+        auto const true_x = speed * frame_time.count();
+        auto const latest_lag = true_x - latest_x;
+        auto const resampled_lag = true_x - x_of(motion[0].event);
+
+        latest_lag_sum += latest_lag;
+        latest_lag_squares += latest_lag * latest_lag;
+        resampled_lag_sum += resampled_lag;
+        resampled_lag_squares += resampled_lag * resampled_lag;
+        ++frames;
+    }
+
+    auto const deviation = [&](double sum, double squares)
+        {
+            auto const mean = sum / frames;
+            return std::sqrt(squares / frames - mean * mean);
+        };
+
+    EXPECT_THAT(deviation(resampled_lag_sum, resampled_lag_squares),
+                Lt(deviation(latest_lag_sum, latest_lag_squares) / 4));
+}
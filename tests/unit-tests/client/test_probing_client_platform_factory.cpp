@@ -19,8 +19,10 @@
 #include "mir/client/client_platform.h"
 #include "src/client/probing_client_platform_factory.h"
 #include "src/server/report/null_report_factory.h"
+#include "mir/shared_library_prober_report.h"
 
 #include "mir/test/doubles/mock_client_context.h"
+#include "mir/test/fake_shared.h"
 #include "mir_test_framework/executable_path.h"
 #include "mir_test_framework/stub_platform_helpers.h"
 
@@ -31,9 +33,19 @@
 
 namespace mtf = mir_test_framework;
 namespace mtd = mir::test::doubles;
+namespace mt = mir::test;
 
 namespace
 {
+class MockSharedLibraryProberReport : public mir::SharedLibraryProberReport
+{
+public:
+    MOCK_METHOD1(probing_path, void(boost::filesystem::path const&));
+    MOCK_METHOD2(probing_failed, void(boost::filesystem::path const&, std::exception const&));
+    MOCK_METHOD1(loading_library, void(boost::filesystem::path const&));
+    MOCK_METHOD2(loading_failed, void(boost::filesystem::path const&, std::exception const&));
+};
+
 
 void populate_graphics_module_for(MirModuleProperties& props, mir::SharedLibrary const& server_library)
 {
@@ -332,3 +344,31 @@ TEST(ProbingClientPlatformFactory, IgnoresNonClientPlatformModules)
 
     auto platform = factory.create_client_platform(&context);
 }
+
+TEST(ProbingClientPlatformFactory, ReusesTheModuleSelectedForTheSameServerPlatform)
+{
+    using namespace testing;
+
+    auto const fixture = dummy_fixture();
+    auto const path = boost::filesystem::path{fixture.client_module_filename}.parent_path().string();
+
+    NiceMock<mtd::MockClientContext> context;
+    fixture.setup_context(context);
+
+    {
+        mir::client::ProbingClientPlatformFactory factory(
+            mir::report::null_shared_library_prober_report(),
+            {}, {path}, nullptr);
+        factory.create_client_platform(&context);
+    }
+
+    NiceMock<MockSharedLibraryProberReport> report;
+    EXPECT_CALL(report, probing_path(_)).Times(0);
+    EXPECT_CALL(report, loading_library(_)).Times(1);
+
+    mir::client::ProbingClientPlatformFactory factory(
+        mt::fake_shared(report),
+        {}, {path}, nullptr);
+
+    EXPECT_THAT(factory.create_client_platform(&context), NotNull());
+}
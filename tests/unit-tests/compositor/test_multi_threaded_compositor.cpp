@@ -93,6 +93,29 @@ private:
     std::vector<StubDisplaySyncGroup> buffers;
 };
 
+class StubDisplayWithReplaceableGroups : public mtd::NullDisplay
+{
+public:
+    StubDisplayWithReplaceableGroups(std::vector<geom::Rectangle> const& areas)
+    {
+        for (auto const& area : areas)
+            add_group(area);
+    }
+
+    void for_each_display_sync_group(std::function<void(mg::DisplaySyncGroup&)> const& f) override
+    {
+        for (auto& group : groups)
+            f(*group);
+    }
+
+    void add_group(geom::Rectangle const& area)
+    {
+        groups.push_back(std::make_unique<mtd::StubDisplaySyncGroup>(std::vector<geom::Rectangle>{area}));
+    }
+
+    std::vector<std::unique_ptr<mtd::StubDisplaySyncGroup>> groups;
+};
+
 class StubScene : public mtd::StubScene
 {
 public:
@@ -944,3 +967,88 @@ TEST(MultiThreadedCompositor, can_schedule_from_display_observer_when_removing_d
         display, stub_scene, db_compositor_factory, mock_display_listener, mock_report, default_delay, true};
     compositor.start();
 }
+
+TEST(MultiThreadedCompositor, reconfigure_only_restarts_compositing_to_retired_groups)
+{
+    using namespace testing;
+    geom::Rectangle const kept_area{{0, 0}, {640, 480}};
+    geom::Rectangle const retired_area{{640, 0}, {640, 480}};
+    geom::Rectangle const added_area{{1280, 0}, {640, 480}};
+    auto display = std::make_shared<StubDisplayWithReplaceableGroups>(
+        std::vector<geom::Rectangle>{kept_area, retired_area});
+    auto stub_scene = std::make_shared<NiceMock<StubScene>>();
+    auto mock_display_listener = std::make_shared<NiceMock<MockDisplayListener>>();
+    auto db_compositor_factory = std::make_shared<mtd::NullDisplayBufferCompositorFactory>();
+    auto mock_report = std::make_shared<testing::NiceMock<mtd::MockCompositorReport>>();
+
+    mc::MultiThreadedCompositor compositor{
+        display, stub_scene, db_compositor_factory, mock_display_listener, mock_report, default_delay, true};
+
+    compositor.start();
+
+    EXPECT_CALL(*mock_display_listener, remove_display(retired_area));
+    EXPECT_CALL(*mock_display_listener, add_display(added_area));
+    EXPECT_CALL(*mock_display_listener, remove_display(kept_area)).Times(0);
+    EXPECT_CALL(*mock_display_listener, add_display(kept_area)).Times(0);
+
+    compositor.reconfigure(
+        [&](std::function<void(mg::DisplaySyncGroup&)> const& retiring)
+        {
+            retiring(*display->groups.back());
+            display->groups.pop_back();
+            display->add_group(added_area);
+        });
+
+    Mock::VerifyAndClearExpectations(mock_display_listener.get());
+}
+
+TEST(MultiThreadedCompositor, reconfigure_resumes_compositing_when_the_change_throws)
+{
+    using namespace testing;
+    geom::Rectangle const area{{0, 0}, {640, 480}};
+    auto display = std::make_shared<StubDisplayWithReplaceableGroups>(std::vector<geom::Rectangle>{area});
+    auto stub_scene = std::make_shared<NiceMock<StubScene>>();
+    auto mock_display_listener = std::make_shared<NiceMock<MockDisplayListener>>();
+    auto db_compositor_factory = std::make_shared<mtd::NullDisplayBufferCompositorFactory>();
+    auto mock_report = std::make_shared<testing::NiceMock<mtd::MockCompositorReport>>();
+
+    mc::MultiThreadedCompositor compositor{
+        display, stub_scene, db_compositor_factory, mock_display_listener, mock_report, default_delay, true};
+
+    compositor.start();
+
+    EXPECT_CALL(*mock_display_listener, remove_display(area));
+    EXPECT_CALL(*mock_display_listener, add_display(area));
+
+    EXPECT_THROW(
+        compositor.reconfigure(
+            [&](std::function<void(mg::DisplaySyncGroup&)> const& retiring)
+            {
+                retiring(*display->groups.front());
+                BOOST_THROW_EXCEPTION(std::runtime_error("Failed to configure display"));
+            }),
+        std::runtime_error);
+
+    Mock::VerifyAndClearExpectations(mock_display_listener.get());
+}
+
+TEST(MultiThreadedCompositor, reconfigure_does_not_start_a_stopped_compositor)
+{
+    using namespace testing;
+    auto display = std::make_shared<StubDisplayWithReplaceableGroups>(
+        std::vector<geom::Rectangle>{{{0, 0}, {640, 480}}});
+    auto stub_scene = std::make_shared<NiceMock<StubScene>>();
+    auto mock_display_listener = std::make_shared<NiceMock<MockDisplayListener>>();
+    auto db_compositor_factory = std::make_shared<mtd::NullDisplayBufferCompositorFactory>();
+    auto mock_report = std::make_shared<testing::NiceMock<mtd::MockCompositorReport>>();
+
+    mc::MultiThreadedCompositor compositor{
+        display, stub_scene, db_compositor_factory, mock_display_listener, mock_report, default_delay, true};
+
+    EXPECT_CALL(*mock_display_listener, add_display(_)).Times(0);
+
+    bool changed{false};
+    compositor.reconfigure([&](std::function<void(mg::DisplaySyncGroup&)> const&) { changed = true; });
+
+    EXPECT_TRUE(changed);
+}
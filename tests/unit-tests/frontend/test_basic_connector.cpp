@@ -24,6 +24,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <atomic>
+
 namespace mt = mir::test;
 
 namespace
@@ -39,6 +41,16 @@ struct StubConnectorReport : mir::report::null::ConnectorReport
     std::string thread_name;
 };
 
+struct CountingConnectorReport : mir::report::null::ConnectorReport
+{
+    void thread_start()
+    {
+        ++threads_started;
+    }
+
+    std::atomic<int> threads_started{0};
+};
+
 }
 
 TEST(BasicConnector, names_ipc_threads)
@@ -47,10 +59,24 @@ TEST(BasicConnector, names_ipc_threads)
 
     StubConnectorReport report;
 
-    mir::frontend::BasicConnector connector{{}, mt::fake_shared(report)};
+    mir::frontend::BasicConnector connector{{}, 1, mt::fake_shared(report)};
 
     connector.start();
     connector.stop();
 
     EXPECT_THAT(report.thread_name, Eq("Mir/IPC"));
 }
+
+TEST(BasicConnector, runs_requested_number_of_ipc_threads)
+{
+    using namespace testing;
+
+    CountingConnectorReport report;
+
+    mir::frontend::BasicConnector connector{{}, 3, mt::fake_shared(report)};
+
+    connector.start();
+    connector.stop();
+
+    EXPECT_THAT(report.threads_started, Eq(3));
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/ordered_worker_pool.h"
+
+#include "mir/anonymous_shm_file.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <future>
+#include <vector>
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace mf = mir::frontend;
+
+namespace
+{
+/*
+ * Recovers from reading a truncated mapping the way libwayland does for
+ * client shm pools: by mapping zeroed memory over the faulting page.
+ */
+void map_zeroes_over_fault(int, siginfo_t* info, void*)
+{
+    auto const page_size = sysconf(_SC_PAGESIZE);
+    auto const page = reinterpret_cast<uintptr_t>(info->si_addr) & ~(page_size - 1);
+
+    if (mmap(reinterpret_cast<void*>(page), page_size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_FIXED | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+    {
+        _exit(EXIT_FAILURE);
+    }
+}
+
+struct OrderedWorkerPoolTest : testing::Test
+{
+    OrderedWorkerPoolTest()
+    {
+        struct sigaction action{};
+        action.sa_sigaction = &map_zeroes_over_fault;
+        action.sa_flags = SA_SIGINFO | SA_NODEFER;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGBUS, &action, &previous_action);
+    }
+
+    ~OrderedWorkerPoolTest()
+    {
+        sigaction(SIGBUS, &previous_action, nullptr);
+    }
+
+    struct sigaction previous_action{};
+    mf::OrderedWorkerPool pool{2};
+};
+}
+
+TEST_F(OrderedWorkerPoolTest, runs_work_on_a_strand_in_order)
+{
+    auto const strand = pool.make_strand();
+    std::vector<int> order;
+    std::promise<void> done;
+
+    for (auto i = 0; i != 100; ++i)
+        strand->spawn([&order, i] { order.push_back(i); });
+    strand->spawn([&done] { done.set_value(); });
+
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds{5}));
+    ASSERT_EQ(100u, order.size());
+    for (auto i = 0; i != 100; ++i)
+        EXPECT_EQ(i, order[i]);
+}
+
+TEST_F(OrderedWorkerPoolTest, worker_reading_a_truncated_pool_reaches_the_sigbus_handler)
+{
+    auto const page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    mir::AnonymousShmFile pool_file{page_size};
+    auto const contents = static_cast<unsigned char volatile*>(pool_file.base_ptr());
+    contents[0] = 0xff;
+
+    // What a client may do to a pool it has shared with the server
+    ASSERT_EQ(0, ftruncate(pool_file.fd(), 0));
+
+    std::promise<unsigned char> read;
+    pool.make_strand()->spawn([&read, contents] { read.set_value(static_cast<unsigned char>(contents[0])); });
+
+    auto result = read.get_future();
+    ASSERT_EQ(std::future_status::ready, result.wait_for(std::chrono::seconds{5}));
+    EXPECT_EQ(0, result.get());
+}
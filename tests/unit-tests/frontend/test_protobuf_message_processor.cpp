@@ -60,6 +60,9 @@ struct StubMessageProcessorReport : mf::MessageProcessorReport
     void exception_handled(void const*, std::exception const&) override
     {
     }
+    void request_rate(int, double, std::chrono::microseconds) override
+    {
+    }
 };
 
 struct StubDisplayServer : mtd::StubDisplayServer
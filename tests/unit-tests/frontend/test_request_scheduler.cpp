@@ -0,0 +1,202 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend/request_scheduler.h"
+#include "src/server/report/null_report_factory.h"
+
+#include "mir/scene/session_event_handler_register.h"
+#include "mir/scene/session_event_sink.h"
+
+#include "mir/test/doubles/mock_scene_session.h"
+#include "mir/test/fake_shared.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace mfd = mir::frontend::detail;
+namespace ms = mir::scene;
+namespace mt = mir::test;
+namespace mtd = mir::test::doubles;
+
+using namespace testing;
+
+namespace
+{
+struct StubSessionEventHandlerRegister : ms::SessionEventHandlerRegister
+{
+    void add(ms::SessionEventSink* handler) override { sink = handler; }
+    void remove(ms::SessionEventSink*) override { sink = nullptr; }
+
+    ms::SessionEventSink* sink{nullptr};
+};
+
+struct ManualExecutor
+{
+    mfd::RequestScheduler::Executor executor()
+    {
+        return [this](std::function<void()>&& work) { tasks.push_back(std::move(work)); };
+    }
+
+    void run_all()
+    {
+        while (!tasks.empty())
+        {
+            auto const task = std::move(tasks.front());
+            tasks.pop_front();
+            task();
+        }
+    }
+
+    std::deque<std::function<void()>> tasks;
+};
+
+struct RequestScheduler : Test
+{
+    StubSessionEventHandlerRegister session_event_register;
+    std::shared_ptr<mfd::RequestScheduler> const scheduler = std::make_shared<mfd::RequestScheduler>(
+        1,
+        mt::fake_shared(session_event_register),
+        mir::report::null_message_processor_report());
+
+    ManualExecutor ipc_thread;
+    std::vector<std::string> dispatched;
+
+    std::function<void()> request(std::string const& name)
+    {
+        return [this, name] { dispatched.push_back(name); };
+    }
+
+    void focus(pid_t pid)
+    {
+        auto const session = std::make_shared<NiceMock<mtd::MockSceneSession>>();
+        ON_CALL(*session, process_id()).WillByDefault(Return(pid));
+        session_event_register.sink->handle_focus_change(session);
+    }
+
+    mfd::RequestScheduler::Priority const normal{mfd::RequestScheduler::Priority::normal};
+    mfd::RequestScheduler::Priority const latency_critical{mfd::RequestScheduler::Priority::latency_critical};
+};
+}
+
+TEST_F(RequestScheduler, dispatches_a_clients_requests_in_order)
+{
+    auto const client = scheduler->add_client(1, ipc_thread.executor());
+
+    client->enqueue(normal, request("first"));
+    client->enqueue(latency_critical, request("second"));
+    client->enqueue(normal, request("third"));
+    ipc_thread.run_all();
+
+    EXPECT_THAT(dispatched, ElementsAre("first", "second", "third"));
+}
+
+TEST_F(RequestScheduler, dispatches_the_focused_clients_requests_first)
+{
+    auto const background = scheduler->add_client(1, ipc_thread.executor());
+    auto const focused = scheduler->add_client(2, ipc_thread.executor());
+    focus(2);
+
+    background->enqueue(normal, request("background"));
+    focused->enqueue(normal, request("focused"));
+    ipc_thread.run_all();
+
+    EXPECT_THAT(dispatched, ElementsAre("focused", "background"));
+}
+
+TEST_F(RequestScheduler, dispatches_latency_critical_requests_first)
+{
+    auto const one = scheduler->add_client(1, ipc_thread.executor());
+    auto const other = scheduler->add_client(2, ipc_thread.executor());
+
+    one->enqueue(normal, request("modify_surface"));
+    other->enqueue(latency_critical, request("submit_buffer"));
+    ipc_thread.run_all();
+
+    EXPECT_THAT(dispatched, ElementsAre("submit_buffer", "modify_surface"));
+}
+
+TEST_F(RequestScheduler, busy_client_does_not_hold_up_others)
+{
+    auto const busy = scheduler->add_client(1, ipc_thread.executor());
+    auto const quiet = scheduler->add_client(2, ipc_thread.executor());
+
+    for (auto i = 0; i != 10; ++i)
+        busy->enqueue(normal, request("busy"));
+    quiet->enqueue(normal, request("quiet"));
+    ipc_thread.run_all();
+
+    ASSERT_THAT(dispatched.size(), Eq(11u));
+    EXPECT_THAT(std::find(begin(dispatched), end(dispatched), "quiet") - begin(dispatched), Le(2));
+}
+
+TEST_F(RequestScheduler, focused_client_gets_more_turns_than_others)
+{
+    auto const background = scheduler->add_client(1, ipc_thread.executor());
+    auto const focused = scheduler->add_client(2, ipc_thread.executor());
+    focus(2);
+
+    for (auto i = 0; i != 8; ++i)
+    {
+        background->enqueue(normal, request("background"));
+        focused->enqueue(normal, request("focused"));
+    }
+    ipc_thread.run_all();
+
+    std::vector<std::string> const first_half{begin(dispatched), begin(dispatched) + 8};
+    EXPECT_THAT(std::count(begin(first_half), end(first_half), "focused"), Gt(4));
+}
+
+TEST_F(RequestScheduler, drops_requests_of_a_destroyed_client)
+{
+    auto client = scheduler->add_client(1, ipc_thread.executor());
+
+    client->enqueue(normal, request("dropped"));
+    client.reset();
+    ipc_thread.run_all();
+
+    EXPECT_THAT(dispatched, IsEmpty());
+}
+
+TEST_F(RequestScheduler, a_request_may_destroy_its_own_client)
+{
+    auto client = scheduler->add_client(1, ipc_thread.executor());
+
+    client->enqueue(normal, [&] { client.reset(); dispatched.push_back("disconnect"); });
+    client->enqueue(normal, request("dropped"));
+    ipc_thread.run_all();
+
+    EXPECT_THAT(dispatched, ElementsAre("disconnect"));
+}
+
+TEST_F(RequestScheduler, hands_out_no_more_runs_than_there_are_threads)
+{
+    auto const one = scheduler->add_client(1, ipc_thread.executor());
+    auto const other = scheduler->add_client(2, ipc_thread.executor());
+
+    one->enqueue(normal, request("one"));
+    other->enqueue(normal, request("other"));
+
+    EXPECT_THAT(ipc_thread.tasks.size(), Eq(1u));
+
+    ipc_thread.run_all();
+
+    EXPECT_THAT(dispatched, UnorderedElementsAre("one", "other"));
+}
@@ -892,6 +892,34 @@ TEST_F(SessionMediator, allocates_native_buffers)
     EXPECT_THAT(allocator->allocated_buffers.size(), Eq(1));
 }
 
+TEST_F(SessionMediator, allocates_initial_buffers_with_the_surface)
+{
+    using namespace testing;
+
+    auto sink = std::make_shared<NiceMock<mtd::MockEventSink>>();
+    auto mediator = create_session_mediator_with_event_sink(sink);
+
+    mediator->connect(&connect_parameters, &connection, null_callback.get());
+
+    auto const num_requests = 3;
+    auto parameters = surface_parameters;
+    for (auto i = 0; i < num_requests; i++)
+    {
+        auto buffer_request = parameters.add_initial_buffer();
+        buffer_request->set_width(surface_parameters.width());
+        buffer_request->set_height(surface_parameters.height());
+        buffer_request->set_pixel_format(mir_pixel_format_abgr_8888);
+        buffer_request->set_buffer_usage(static_cast<int>(mg::BufferUsage::software));
+    }
+
+    EXPECT_CALL(*sink, add_buffer(_)).Times(num_requests);
+    EXPECT_CALL(*sink, error_buffer(_,_,_)).Times(0);
+    mediator->create_surface(&parameters, &surface_response, null_callback.get());
+
+    EXPECT_THAT(surface_response.buffer_stream().preallocated_buffers(), Eq(num_requests));
+    EXPECT_THAT(allocator->allocated_buffers.size(), Eq(num_requests));
+}
+
 TEST_F(SessionMediator, removes_buffer)
 {
     using namespace testing;
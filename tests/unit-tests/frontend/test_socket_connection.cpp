@@ -129,7 +129,7 @@ struct SocketConnection : public Test
     std::shared_ptr<mfd::Connections<mfd::SocketConnection>> null_sessions;
     mf::SessionCredentials client_creds{1, 1, 1};
 
-    mfd::SocketConnection connection{mt::fake_shared(stub_receiver), 0, null_sessions, mt::fake_shared(mock_processor)};
+    mfd::SocketConnection connection{mt::fake_shared(stub_receiver), 0, null_sessions, mt::fake_shared(mock_processor), nullptr};
 
     void SetUp()
     {
@@ -0,0 +1,317 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/gl/shared_texture_cache.h"
+#include "mir/test/doubles/mock_gl_buffer.h"
+#include "mir/test/doubles/mock_renderable.h"
+#include "mir/test/doubles/mock_gl.h"
+#include <gtest/gtest.h>
+
+namespace mtd=mir::test::doubles;
+namespace mgl=mir::gl;
+namespace mg=mir::graphics;
+namespace geom=mir::geometry;
+
+using namespace testing;
+
+namespace
+{
+struct MockShmGLBuffer : mtd::MockGLBuffer, mir::renderer::gl::TextureUpdateSource
+{
+    using MockGLBuffer::MockGLBuffer;
+
+    MOCK_METHOD0(update_bound_texture, void());
+};
+
+struct SharedTextureCache : Test
+{
+    SharedTextureCache()
+    {
+        ON_CALL(*renderable, id())
+            .WillByDefault(Return(renderable.get()));
+        ON_CALL(*renderable, buffer())
+            .WillByDefault(Return(buffer_a));
+        ON_CALL(*buffer_a, id())
+            .WillByDefault(Return(mg::BufferID(1)));
+        ON_CALL(*buffer_b, id())
+            .WillByDefault(Return(mg::BufferID(2)));
+    }
+
+    NiceMock<mtd::MockGL> mock_gl;
+    geom::Size const size{16, 16};
+    size_t const bytes_per_buffer{16 * 16 * 4};
+    std::shared_ptr<mtd::MockGLBuffer> const buffer_a{
+        std::make_shared<NiceMock<mtd::MockGLBuffer>>(size, geom::Stride{64}, mir_pixel_format_abgr_8888)};
+    std::shared_ptr<mtd::MockGLBuffer> const buffer_b{
+        std::make_shared<NiceMock<mtd::MockGLBuffer>>(size, geom::Stride{64}, mir_pixel_format_abgr_8888)};
+    std::shared_ptr<NiceMock<mtd::MockRenderable>> const renderable{
+        std::make_shared<NiceMock<mtd::MockRenderable>>()};
+};
+}
+
+TEST_F(SharedTextureCache, uploads_buffer_once_for_all_renderers)
+{
+    EXPECT_CALL(*buffer_a, bind())
+        .Times(1);
+
+    auto const shared = std::make_shared<mgl::SharedTextureCache>();
+    auto const left = shared->create_texture_cache();
+    auto const right = shared->create_texture_cache();
+
+    // Two outputs compositing the same renderable
+    auto const first = left->load(*renderable);
+    left->drop_unused();
+    auto const second = right->load(*renderable);
+    right->drop_unused();
+
+    EXPECT_THAT(first, Eq(second));
+}
+
+TEST_F(SharedTextureCache, uploads_again_when_a_renderable_returns_to_a_buffer)
+{
+    EXPECT_CALL(*buffer_a, bind())
+        .Times(2);
+    EXPECT_CALL(*buffer_b, bind())
+        .Times(1);
+
+    auto const shared = std::make_shared<mgl::SharedTextureCache>();
+    auto const cache = shared->create_texture_cache();
+
+    cache->load(*renderable);
+    cache->drop_unused();
+
+    ON_CALL(*renderable, buffer())
+        .WillByDefault(Return(buffer_b));
+    cache->load(*renderable);
+    cache->drop_unused();
+
+    ON_CALL(*renderable, buffer())
+        .WillByDefault(Return(buffer_a));
+    cache->load(*renderable);
+    cache->load(*renderable);
+    cache->drop_unused();
+}
+
+TEST_F(SharedTextureCache, invalidated_textures_are_reloaded)
+{
+    EXPECT_CALL(*buffer_a, bind())
+        .Times(2);
+
+    auto const shared = std::make_shared<mgl::SharedTextureCache>();
+    auto const cache = shared->create_texture_cache();
+    cache->load(*renderable);
+    cache->load(*renderable);
+    cache->invalidate();
+    cache->load(*renderable);
+}
+
+TEST_F(SharedTextureCache, flushes_uploads_for_other_contexts)
+{
+    EXPECT_CALL(mock_gl, glFlush())
+        .Times(1);
+
+    auto const shared = std::make_shared<mgl::SharedTextureCache>();
+    auto const cache = shared->create_texture_cache();
+    cache->load(*renderable);
+    cache->load(*renderable);
+}
+
+TEST_F(SharedTextureCache, holds_buffers_till_drop)
+{
+    auto old_use_count = buffer_a.use_count();
+    auto const shared = std::make_shared<mgl::SharedTextureCache>();
+    auto const cache = shared->create_texture_cache();
+    cache->load(*renderable);
+    EXPECT_EQ(old_use_count+1, buffer_a.use_count());
+    cache->drop_unused();
+    EXPECT_EQ(old_use_count, buffer_a.use_count());
+}
+
+TEST_F(SharedTextureCache, frees_textures_that_have_been_idle)
+{
+    unsigned int const idle_limit{3};
+    auto const shared = std::make_shared<mgl::SharedTextureCache>(
+        mgl::SharedTextureCache::default_byte_budget, idle_limit);
+    auto const cache = shared->create_texture_cache();
+
+    cache->load(*renderable);
+    for (auto i = 0u; i != idle_limit; ++i)
+        cache->drop_unused();
+
+    EXPECT_THAT(shared->statistics().textures, Eq(1u));
+
+    EXPECT_CALL(mock_gl, glDeleteTextures(1, _));
+    cache->drop_unused();
+
+    EXPECT_THAT(shared->statistics().textures, Eq(0u));
+    EXPECT_THAT(shared->statistics().evictions, Eq(1u));
+}
+
+TEST_F(SharedTextureCache, frees_least_recently_used_textures_over_budget)
+{
+    auto const shared = std::make_shared<mgl::SharedTextureCache>(
+        bytes_per_buffer, mgl::SharedTextureCache::default_idle_limit);
+    auto const cache = shared->create_texture_cache();
+
+    auto const other = std::make_shared<NiceMock<mtd::MockRenderable>>();
+    ON_CALL(*other, id())
+        .WillByDefault(Return(other.get()));
+    ON_CALL(*other, buffer())
+        .WillByDefault(Return(buffer_b));
+
+    // Textures used in the frame being drawn are kept whatever the budget
+    cache->load(*renderable);
+    cache->load(*other);
+    cache->drop_unused();
+
+    EXPECT_THAT(shared->statistics().bytes, Eq(2 * bytes_per_buffer));
+
+    cache->load(*other);
+    cache->drop_unused();
+
+    auto const stats = shared->statistics();
+    EXPECT_THAT(stats.bytes, Eq(bytes_per_buffer));
+    EXPECT_THAT(stats.evictions, Eq(1u));
+
+    EXPECT_CALL(*buffer_b, bind())
+        .Times(0);
+    cache->load(*other);
+}
+
+TEST_F(SharedTextureCache, counts_hits_and_uploads)
+{
+    auto const shared = std::make_shared<mgl::SharedTextureCache>();
+    auto const cache = shared->create_texture_cache();
+
+    cache->load(*renderable);
+    cache->drop_unused();
+    cache->load(*renderable);
+    cache->load(*renderable);
+
+    auto const stats = shared->statistics();
+    EXPECT_THAT(stats.uploads, Eq(1u));
+    EXPECT_THAT(stats.hits, Eq(2u));
+    EXPECT_THAT(stats.textures, Eq(1u));
+    EXPECT_THAT(stats.bytes, Eq(bytes_per_buffer));
+}
+
+TEST_F(SharedTextureCache, updates_cpu_buffer_textures_in_place)
+{
+    auto const shm_buffer = std::make_shared<NiceMock<MockShmGLBuffer>>(
+        size, geom::Stride{64}, mir_pixel_format_abgr_8888);
+    ON_CALL(*shm_buffer, id())
+        .WillByDefault(Return(mg::BufferID(3)));
+
+    InSequence seq;
+    EXPECT_CALL(*shm_buffer, bind());
+    EXPECT_CALL(*shm_buffer, update_bound_texture());
+    EXPECT_CALL(*shm_buffer, bind())
+        .Times(0);
+
+    auto const shared = std::make_shared<mgl::SharedTextureCache>();
+    auto const cache = shared->create_texture_cache();
+
+    ON_CALL(*renderable, buffer())
+        .WillByDefault(Return(shm_buffer));
+    cache->load(*renderable);
+    cache->drop_unused();
+
+    ON_CALL(*renderable, buffer())
+        .WillByDefault(Return(buffer_a));
+    cache->load(*renderable);
+    cache->drop_unused();
+
+    ON_CALL(*renderable, buffer())
+        .WillByDefault(Return(shm_buffer));
+    cache->load(*renderable);
+}
+
+TEST_F(SharedTextureCache, reallocates_cpu_buffer_textures_after_invalidation)
+{
+    auto const shm_buffer = std::make_shared<NiceMock<MockShmGLBuffer>>(
+        size, geom::Stride{64}, mir_pixel_format_abgr_8888);
+    ON_CALL(*renderable, buffer())
+        .WillByDefault(Return(shm_buffer));
+
+    EXPECT_CALL(*shm_buffer, bind())
+        .Times(2);
+    EXPECT_CALL(*shm_buffer, update_bound_texture())
+        .Times(0);
+
+    auto const shared = std::make_shared<mgl::SharedTextureCache>();
+    auto const cache = shared->create_texture_cache();
+    cache->load(*renderable);
+    cache->invalidate();
+    cache->load(*renderable);
+}
+
+TEST_F(SharedTextureCache, keeps_textures_another_renderer_still_uses)
+{
+    unsigned int const idle_limit{3};
+    auto const shared = std::make_shared<mgl::SharedTextureCache>(
+        mgl::SharedTextureCache::default_byte_budget, idle_limit);
+    auto const drawing = shared->create_texture_cache();
+    auto const idle = shared->create_texture_cache();
+
+    drawing->load(*renderable);
+    idle->load(*renderable);
+
+    // However many outputs there are, each counts only its own frames
+    for (auto i = 0u; i != 2 * idle_limit; ++i)
+        idle->drop_unused();
+
+    EXPECT_THAT(shared->statistics().textures, Eq(1u));
+
+    for (auto i = 0u; i != idle_limit + 1; ++i)
+        drawing->drop_unused();
+
+    EXPECT_THAT(shared->statistics().textures, Eq(0u));
+}
+
+TEST_F(SharedTextureCache, holds_buffers_till_every_renderer_using_them_drops)
+{
+    auto old_use_count = buffer_a.use_count();
+    auto const shared = std::make_shared<mgl::SharedTextureCache>();
+    auto const drawing = shared->create_texture_cache();
+    auto const done = shared->create_texture_cache();
+
+    drawing->load(*renderable);
+    done->load(*renderable);
+    done->drop_unused();
+
+    EXPECT_EQ(old_use_count+1, buffer_a.use_count());
+
+    drawing->drop_unused();
+
+    EXPECT_EQ(old_use_count, buffer_a.use_count());
+}
+
+TEST_F(SharedTextureCache, invalidation_reloads_textures_for_that_renderer_only)
+{
+    EXPECT_CALL(*buffer_a, bind())
+        .Times(2);
+
+    auto const shared = std::make_shared<mgl::SharedTextureCache>();
+    auto const suspended = shared->create_texture_cache();
+    auto const running = shared->create_texture_cache();
+
+    suspended->load(*renderable);
+    running->load(*renderable);
+    suspended->invalidate();
+    running->load(*renderable);
+    suspended->load(*renderable);
+    suspended->load(*renderable);
+}
@@ -1,7 +1,10 @@
 #include "mir/graphics/display_buffer.h"
 
 #include "src/server/graphics/offscreen/display.h"
+#include "src/server/graphics/offscreen/display_buffer.h"
 #include "mir/graphics/default_display_configuration_policy.h"
+#include "mir/graphics/cursor.h"
+#include "mir/graphics/cursor_image.h"
 #include "mir/renderer/gl/render_target.h"
 #include "src/server/report/null_report_factory.h"
 
@@ -13,6 +16,10 @@
 #include <gtest/gtest.h>
 
 #include <stdexcept>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
 
 namespace mg=mir::graphics;
 namespace mgo=mir::graphics::offscreen;
@@ -23,6 +30,15 @@ namespace mt = mir::test;
 namespace
 {
 
+struct OpaqueCursorImage : mg::CursorImage
+{
+    void const* as_argb_8888() const override { return pixels.data(); }
+    mir::geometry::Size size() const override { return {2, 2}; }
+    mir::geometry::Displacement hotspot() const override { return {0, 0}; }
+
+    std::vector<uint32_t> const pixels = std::vector<uint32_t>(4, 0xffffffff);
+};
+
 class OffscreenDisplayTest : public ::testing::Test
 {
 public:
@@ -41,9 +57,34 @@ public:
             .WillByDefault(Return(GL_FRAMEBUFFER_COMPLETE));
     }
 
+    void provide_fence_sync()
+    {
+        using namespace ::testing;
+
+        ON_CALL(mock_egl, eglQueryString(_,EGL_EXTENSIONS))
+            .WillByDefault(Return("EGL_KHR_fence_sync"));
+        ON_CALL(mock_egl, eglCreateSyncKHR(_,EGL_SYNC_FENCE_KHR,_))
+            .WillByDefault(InvokeWithoutArgs(
+                [this]
+                {
+                    fences.push_back(0);
+                    return reinterpret_cast<EGLSyncKHR>(fences.size());
+                }));
+    }
+
+    void for_each_offscreen_buffer(mgo::Display& display, std::function<void(mgo::DisplayBuffer&)> const& f)
+    {
+        display.for_each_display_sync_group([&](mg::DisplaySyncGroup& group) {
+            group.for_each_display_buffer([&](mg::DisplayBuffer& db) {
+                f(dynamic_cast<mgo::DisplayBuffer&>(db));
+            });
+        });
+    }
+
     ::testing::NiceMock<mtd::MockEGL> mock_egl;
     ::testing::NiceMock<mtd::MockGL> mock_gl;
     EGLNativeDisplayType const native_display{reinterpret_cast<EGLNativeDisplayType>(0x12345)};
+    std::vector<int> fences;
 };
 
 }
@@ -173,3 +214,205 @@ TEST_F(OffscreenDisplayTest, restores_previous_state_on_fbo_setup_failure)
             mr::null_display_report());
     }, std::runtime_error);
 }
+
+TEST_F(OffscreenDisplayTest, does_not_stall_for_the_gpu_after_each_frame)
+{
+    using namespace ::testing;
+    provide_fence_sync();
+
+    mgo::Display display{
+        native_display,
+        std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
+        mr::null_display_report()};
+
+    EXPECT_CALL(mock_gl, glFinish()).Times(0);
+    EXPECT_CALL(mock_egl, eglClientWaitSyncKHR(_,_,_,_)).Times(0);
+
+    for_each_offscreen_buffer(display, [&](mgo::DisplayBuffer& db) {
+        EXPECT_CALL(mock_egl, eglCreateSyncKHR(_,EGL_SYNC_FENCE_KHR,_));
+
+        db.make_current();
+        db.bind();
+        db.swap_buffers();
+    });
+}
+
+TEST_F(OffscreenDisplayTest, waits_for_fence_before_drawing_into_a_framebuffer_again)
+{
+    using namespace ::testing;
+    provide_fence_sync();
+
+    mgo::DisplaySettings settings;
+    settings.render_targets = 2;
+
+    mgo::Display display{
+        native_display,
+        std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
+        mr::null_display_report(),
+        settings};
+
+    for_each_offscreen_buffer(display, [&](mgo::DisplayBuffer& db) {
+        fences.clear();
+        db.make_current();
+
+        for (auto i = 0; i != 2; ++i)
+        {
+            db.bind();
+            db.swap_buffers();
+        }
+
+        auto const first_fence = reinterpret_cast<EGLSyncKHR>(1);
+        InSequence seq;
+        EXPECT_CALL(mock_egl, eglClientWaitSyncKHR(_,first_fence,_,_));
+        EXPECT_CALL(mock_egl, eglDestroySyncKHR(_,first_fence));
+        EXPECT_CALL(mock_gl, glBindFramebuffer(_,_));
+
+        db.bind();
+
+        Mock::VerifyAndClearExpectations(&mock_egl);
+        Mock::VerifyAndClearExpectations(&mock_gl);
+    });
+}
+
+TEST_F(OffscreenDisplayTest, simulates_vsync_at_the_configured_refresh_rate)
+{
+    auto const interval = std::chrono::milliseconds{5};
+
+    mgo::DisplaySettings settings;
+    settings.refresh_interval = interval;
+
+    mgo::Display display{
+        native_display,
+        std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
+        mr::null_display_report(),
+        settings};
+
+    unsigned int output_id{0};
+    display.configuration()->for_each_output(
+        [&](mg::DisplayConfigurationOutput const& output) { output_id = output.id.as_value(); });
+
+    auto const post_all = [&] {
+        display.for_each_display_sync_group([](mg::DisplaySyncGroup& group) { group.post(); });
+    };
+
+    post_all();
+    auto const first = display.last_frame_on(output_id);
+    post_all();
+    auto const second = display.last_frame_on(output_id);
+
+    EXPECT_EQ(first.msc + 1, second.msc);
+    EXPECT_EQ(interval, second.ust - first.ust);
+}
+
+TEST_F(OffscreenDisplayTest, publishes_finished_frames_to_frame_sink)
+{
+    using namespace ::testing;
+    provide_fence_sync();
+
+    mgo::DisplaySettings settings;
+    settings.render_targets = 1;
+    settings.frame_sink_slots = 2;
+
+    mgo::Display display{
+        native_display,
+        std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
+        mr::null_display_report(),
+        settings};
+
+    int groups = 0;
+    display.for_each_display_sync_group([&](mg::DisplaySyncGroup& group) {
+        ++groups;
+        group.for_each_display_buffer([&](mg::DisplayBuffer& base) {
+            auto& db = dynamic_cast<mgo::DisplayBuffer&>(base);
+
+            db.make_current();
+            db.bind();
+            db.swap_buffers();
+            group.post();
+
+            EXPECT_THAT(db.frame_sink(), IsNull());
+
+            EXPECT_CALL(mock_gl, glReadPixels(0, 0, _, _, GL_RGBA, GL_UNSIGNED_BYTE, NotNull()));
+            db.bind();
+
+            ASSERT_THAT(db.frame_sink(), NotNull());
+
+            auto const ring = static_cast<mgo::FrameRingHeader*>(
+                mmap(nullptr, sizeof(mgo::FrameRingHeader), PROT_READ, MAP_SHARED, db.frame_sink()->fd(), 0));
+            ASSERT_THAT(ring, Ne(MAP_FAILED));
+
+            EXPECT_THAT(ring->magic, Eq(mgo::FrameRingHeader::magic_value));
+            EXPECT_THAT(ring->slot_count, Eq(2u));
+            EXPECT_THAT(ring->latest.load(), Eq(1u));
+
+            munmap(ring, sizeof(mgo::FrameRingHeader));
+        });
+    });
+
+    EXPECT_TRUE(groups);
+}
+
+TEST_F(OffscreenDisplayTest, moving_cursor_republishes_latest_frame_without_compositing)
+{
+    using namespace ::testing;
+    provide_fence_sync();
+
+    mgo::DisplaySettings settings;
+    settings.render_targets = 1;
+    settings.frame_sink_slots = 2;
+
+    mgo::Display display{
+        native_display,
+        std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
+        mr::null_display_report(),
+        settings};
+
+    auto const cursor = display.create_hardware_cursor();
+    ASSERT_THAT(cursor, NotNull());
+
+    display.for_each_display_sync_group([&](mg::DisplaySyncGroup& group) {
+        group.for_each_display_buffer([&](mg::DisplayBuffer& base) {
+            auto& db = dynamic_cast<mgo::DisplayBuffer&>(base);
+
+            db.make_current();
+            db.bind();
+            db.swap_buffers();
+            group.post();
+            db.bind();
+        });
+    });
+
+    EXPECT_CALL(mock_gl, glReadPixels(_, _, _, _, _, _, _)).Times(0);
+
+    OpaqueCursorImage const image;
+    cursor->show(image);
+    cursor->move_to({10, 20});
+
+    for_each_offscreen_buffer(display, [&](mgo::DisplayBuffer& db) {
+        ASSERT_THAT(db.frame_sink(), NotNull());
+
+        auto const ring_size = lseek(db.frame_sink()->fd(), 0, SEEK_END);
+        auto const ring = static_cast<mgo::FrameRingHeader*>(
+            mmap(nullptr, ring_size, PROT_READ, MAP_SHARED, db.frame_sink()->fd(), 0));
+        ASSERT_THAT(ring, Ne(MAP_FAILED));
+
+        // Showing and moving the cursor each republished the composited frame
+        auto const latest = ring->latest.load();
+        EXPECT_THAT(latest, Eq(3u));
+
+        auto const slot = reinterpret_cast<unsigned char const*>(ring) +
+            ring->header_size + (latest - 1) % ring->slot_count * ring->slot_size;
+        auto const pixel_at = [&](int x, int y)
+            {
+                auto const row = ring->height - 1 - y;  // GL frames are bottom up
+                return reinterpret_cast<uint32_t const*>(slot + ring->pixel_offset + row * ring->stride)[x];
+            };
+
+        EXPECT_THAT(pixel_at(10, 20), Eq(0xffffffff));
+        EXPECT_THAT(pixel_at(11, 21), Eq(0xffffffff));
+        EXPECT_THAT(pixel_at(0, 0), Eq(0u));
+        EXPECT_THAT(pixel_at(12, 20), Eq(0u));
+
+        munmap(ring, ring_size);
+    });
+}
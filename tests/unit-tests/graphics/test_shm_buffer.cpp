@@ -199,3 +199,18 @@ TEST_F(ShmBufferTest, uploads_abgr_8888_correctly)
     PlatformlessShmBuffer buf(std::make_unique<StubShmFile>(), size, mir_pixel_format_abgr_8888);
     buf.gl_bind_to_texture();
 }
+
+TEST_F(ShmBufferTest, updates_bound_texture_without_reallocating_it)
+{
+    EXPECT_CALL(mock_gl, glTexImage2D(_, _, _, _, _, _, _, _, _))
+        .Times(0);
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+    EXPECT_CALL(mock_gl, glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                                         size.width.as_int(), size.height.as_int(),
+                                         GL_RGBA, GL_UNSIGNED_BYTE,
+                                         stub_shm_file->fake_mapping));
+#endif
+
+    PlatformlessShmBuffer buf(std::make_unique<StubShmFile>(), size, mir_pixel_format_abgr_8888);
+    buf.update_bound_texture();
+}
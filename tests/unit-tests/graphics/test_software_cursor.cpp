@@ -49,14 +49,19 @@ struct MockInputScene : mtd::StubInputScene
 
 struct StubCursorImage : mg::CursorImage
 {
-    StubCursorImage(geom::Displacement const& hotspot)
+    StubCursorImage(geom::Displacement const& hotspot, unsigned char value = 0x55)
         : hotspot_{hotspot},
           pixels(
             size().width.as_uint32_t() * size().height.as_uint32_t() * bytes_per_pixel,
-            0x55)
+            value)
     {
     }
 
+    void fill(unsigned char value)
+    {
+        std::fill(pixels.begin(), pixels.end(), value);
+    }
+
     void const* as_argb_8888() const
     {
         return pixels.data();
@@ -78,10 +83,18 @@ private:
     std::vector<unsigned char> pixels;
 };
 
+struct MockBufferAllocator : public mg::GraphicBufferAllocator
+{
+    MOCK_METHOD1(alloc_buffer, std::shared_ptr<mg::Buffer>(mg::BufferProperties const&));
+    MOCK_METHOD2(alloc_software_buffer, std::shared_ptr<mg::Buffer>(geom::Size, MirPixelFormat));
+    MOCK_METHOD3(alloc_buffer, std::shared_ptr<mg::Buffer>(geom::Size, uint32_t, uint32_t));
+    std::vector<MirPixelFormat> supported_pixel_formats() { return {mir_pixel_format_abgr_8888}; } 
+};
+
 struct SoftwareCursor : testing::Test
 {
     StubCursorImage stub_cursor_image{{3,4}};
-    StubCursorImage another_stub_cursor_image{{10,9}};
+    StubCursorImage another_stub_cursor_image{{10,9}, 0x77};
     mtd::StubBufferAllocator stub_buffer_allocator;
     testing::NiceMock<MockInputScene> mock_input_scene;
 
@@ -253,66 +266,115 @@ TEST_F(SoftwareCursor, does_not_hide_or_move_when_already_hidden)
     cursor.move_to({3,4});
 }
 
-TEST_F(SoftwareCursor, creates_new_renderable_for_new_cursor_image)
+TEST_F(SoftwareCursor, reuses_renderable_for_new_cursor_image)
 {
     using namespace testing;
 
-    std::shared_ptr<mg::Renderable> first_cursor_renderable;
+    std::shared_ptr<mg::Renderable> cursor_renderable;
 
     EXPECT_CALL(mock_input_scene, add_input_visualization(_)).
-        WillOnce(SaveArg<0>(&first_cursor_renderable));
+        WillOnce(SaveArg<0>(&cursor_renderable));
 
     cursor.show(stub_cursor_image);
 
     Mock::VerifyAndClearExpectations(&mock_input_scene);
 
-    EXPECT_CALL(mock_input_scene,
-                remove_input_visualization(WeakPtrEq(first_cursor_renderable)));
-    EXPECT_CALL(mock_input_scene, add_input_visualization(Ne(first_cursor_renderable)));
+    EXPECT_CALL(mock_input_scene, remove_input_visualization(_)).Times(0);
+    EXPECT_CALL(mock_input_scene, add_input_visualization(_)).Times(0);
+    EXPECT_CALL(mock_input_scene, emit_scene_changed());
 
     cursor.show(another_stub_cursor_image);
 
     Mock::VerifyAndClearExpectations(&mock_input_scene);
+
+    auto buffer = static_cast<mtd::StubBuffer*>(cursor_renderable->buffer().get());
+    EXPECT_THAT(buffer->written_pixels[0], Eq(0x77));
 }
 
-TEST_F(SoftwareCursor, places_new_cursor_renderable_at_correct_position)
+TEST_F(SoftwareCursor, places_new_cursor_image_at_correct_position)
 {
     using namespace testing;
 
     auto const cursor_position = geom::Point{3, 4};
 
+    std::shared_ptr<mg::Renderable> cursor_renderable;
+
+    EXPECT_CALL(mock_input_scene, add_input_visualization(_)).
+        WillOnce(SaveArg<0>(&cursor_renderable));
+
     cursor.show(stub_cursor_image);
     cursor.move_to(cursor_position);
+    cursor.show(another_stub_cursor_image);
 
-    Mock::VerifyAndClearExpectations(&mock_input_scene);
+    EXPECT_THAT(cursor_renderable->screen_position().top_left,
+                Eq(cursor_position - another_stub_cursor_image.hotspot()));
+}
 
-    auto const renderable_position =
-        cursor_position - another_stub_cursor_image.hotspot();
-    EXPECT_CALL(mock_input_scene,
-                add_input_visualization(RenderableWithPosition(renderable_position)));
+TEST_F(SoftwareCursor, reuses_buffer_of_image_shown_before)
+{
+    using namespace testing;
+
+    MockBufferAllocator mock_allocator;
+
+    EXPECT_CALL(mock_allocator, alloc_buffer(_))
+        .Times(2)
+        .WillRepeatedly(InvokeWithoutArgs([] { return std::make_shared<mtd::StubBuffer>(); }));
+
+    std::shared_ptr<mg::Renderable> cursor_renderable;
+
+    EXPECT_CALL(mock_input_scene, add_input_visualization(_)).
+        WillOnce(SaveArg<0>(&cursor_renderable));
+
+    mg::SoftwareCursor cursor{
+        mt::fake_shared(mock_allocator),
+        mt::fake_shared(mock_input_scene)};
+
+    cursor.show(stub_cursor_image);
+    auto const first_buffer = cursor_renderable->buffer();
 
     cursor.show(another_stub_cursor_image);
+    cursor.show(stub_cursor_image);
+
+    EXPECT_THAT(cursor_renderable->buffer(), Eq(first_buffer));
+}
+
+TEST_F(SoftwareCursor, reuses_buffer_of_identical_image)
+{
+    using namespace testing;
+
+    MockBufferAllocator mock_allocator;
+
+    EXPECT_CALL(mock_allocator, alloc_buffer(_))
+        .Times(1)
+        .WillRepeatedly(Return(std::make_shared<mtd::StubBuffer>()));
+
+    mg::SoftwareCursor cursor{
+        mt::fake_shared(mock_allocator),
+        mt::fake_shared(mock_input_scene)};
+
+    StubCursorImage const same_pixels_as_stub{{10,9}};
+
+    cursor.show(stub_cursor_image);
+    cursor.show(same_pixels_as_stub);
 }
 
 //lp: #1413211
-TEST_F(SoftwareCursor, new_buffer_on_each_show)
+TEST_F(SoftwareCursor, new_buffer_when_image_content_changes)
 {
-    struct MockBufferAllocator : public mg::GraphicBufferAllocator
-    {
-        MOCK_METHOD1(alloc_buffer, std::shared_ptr<mg::Buffer>(mg::BufferProperties const&));
-        MOCK_METHOD2(alloc_software_buffer, std::shared_ptr<mg::Buffer>(geom::Size, MirPixelFormat));
-        MOCK_METHOD3(alloc_buffer, std::shared_ptr<mg::Buffer>(geom::Size, uint32_t, uint32_t));
-        std::vector<MirPixelFormat> supported_pixel_formats() { return {mir_pixel_format_abgr_8888}; } 
-    } mock_allocator;
-
-    EXPECT_CALL(mock_allocator, alloc_buffer(testing::_))
-        .Times(3)
-        .WillRepeatedly(testing::Return(std::make_shared<mtd::StubBuffer>()));;
+    using namespace testing;
+
+    MockBufferAllocator mock_allocator;
+
+    EXPECT_CALL(mock_allocator, alloc_buffer(_))
+        .Times(2)
+        .WillRepeatedly(InvokeWithoutArgs([] { return std::make_shared<mtd::StubBuffer>(); }));
+
     mg::SoftwareCursor cursor{
         mt::fake_shared(mock_allocator),
         mt::fake_shared(mock_input_scene)};
-    cursor.show(another_stub_cursor_image);
-    cursor.show(another_stub_cursor_image);
+
+    cursor.show(stub_cursor_image);
+    stub_cursor_image.fill(0x33);
     cursor.show(stub_cursor_image);
 }
 
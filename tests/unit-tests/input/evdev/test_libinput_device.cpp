@@ -628,6 +628,32 @@ TEST_F(LibInputDeviceOnTouchScreen, sends_complete_events)
     process_events(touch_screen);
 }
 
+TEST_F(LibInputDeviceOnTouchScreen, drops_contacts_beyond_the_tracked_slots)
+{
+    MirTouchId const tracked_slot = 0;
+    MirTouchId const untracked_slot = mev::max_contacts;
+    float major = 6;
+    float minor = 5;
+    float orientation = 0;
+    float pressure = 0.6f;
+    float x = 100;
+    float y = 7;
+
+    std::vector<mev::ContactState> contacts{
+        {tracked_slot, mir_touch_action_down, mir_touch_tooltype_finger, x, y, pressure,
+            major, minor, orientation}};
+
+    EXPECT_CALL(mock_builder, touch_event(time_stamp_1, contacts));
+
+    touch_screen.start(&mock_sink, &mock_builder);
+    env.mock_libinput.setup_touch_event(fake_device, LIBINPUT_EVENT_TOUCH_DOWN, event_time_1, tracked_slot, x, y,
+                                        major, minor, pressure, orientation);
+    env.mock_libinput.setup_touch_event(fake_device, LIBINPUT_EVENT_TOUCH_DOWN, event_time_1, untracked_slot, x, y,
+                                        major, minor, pressure, orientation);
+    env.mock_libinput.setup_touch_frame(fake_device, event_time_1);
+    process_events(touch_screen);
+}
+
 TEST_F(LibInputDeviceOnLaptopKeyboard, provides_no_pointer_settings_for_non_pointing_devices)
 {
     auto settings = keyboard.get_pointer_settings();
@@ -0,0 +1,184 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/platforms/replay/platform.h"
+#include "src/server/input/default_event_builder.h"
+
+#include "mir/dispatch/dispatchable.h"
+#include "mir/input/input_device.h"
+#include "mir/input/input_device_info.h"
+#include "mir/cookie/authority.h"
+
+#include "mir/test/doubles/mock_input_device_registry.h"
+#include "mir/test/doubles/mock_input_seat.h"
+#include "mir/test/doubles/mock_input_sink.h"
+#include "mir/test/event_matchers.h"
+#include "mir/test/fake_shared.h"
+#include "mir/test/fd_utils.h"
+
+#include <boost/filesystem.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <memory>
+#include <system_error>
+
+#include <stdlib.h>
+
+namespace mi = mir::input;
+namespace md = mir::dispatch;
+namespace mt = mir::test;
+namespace mtd = mir::test::doubles;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct ReplayPlatform : Test
+{
+    ReplayPlatform()
+    {
+        std::unique_ptr<char[]> tmp_name{new char[]{"/tmp/mir-input-replay-XXXXXX"}};
+        if (mkdtemp(tmp_name.get()) == NULL)
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+
+        temporary_directory = tmp_name.get();
+    }
+
+    ~ReplayPlatform()
+    {
+        boost::filesystem::remove_all(temporary_directory);
+    }
+
+    std::string recording_of(std::string const& records)
+    {
+        auto const path = temporary_directory + "/recording";
+        std::ofstream{path} << "mir-input-recording 1\n" << records;
+        return path;
+    }
+
+    void dispatch_until_idle(mi::Platform& platform)
+    {
+        auto const dispatchable = platform.dispatchable();
+        while (mt::fd_becomes_readable(dispatchable->watch_fd(), 100ms))
+            dispatchable->dispatch(md::FdEvent::readable);
+    }
+
+    std::string temporary_directory;
+    NiceMock<mtd::MockInputDeviceRegistry> registry;
+};
+}
+
+TEST_F(ReplayPlatform, rejects_a_missing_recording)
+{
+    EXPECT_THROW(
+        mi::replay::Platform(mt::fake_shared(registry), temporary_directory + "/missing", 1.0),
+        std::runtime_error);
+}
+
+TEST_F(ReplayPlatform, rejects_a_file_that_is_not_a_recording)
+{
+    auto const path = temporary_directory + "/not-a-recording";
+    std::ofstream{path} << "hello\n";
+
+    EXPECT_THROW(
+        mi::replay::Platform(mt::fake_shared(registry), path, 1.0),
+        std::runtime_error);
+}
+
+TEST_F(ReplayPlatform, adds_and_removes_recorded_devices)
+{
+    mi::replay::Platform platform{
+        mt::fake_shared(registry),
+        recording_of(
+            "0 add 1 4 \"usb-1\" \"keyboard\"\n"
+            "1000 remove 1\n"),
+        1.0};
+
+    std::shared_ptr<mi::InputDevice> added;
+    InSequence seq;
+    EXPECT_CALL(registry, add_device(_)).WillOnce(SaveArg<0>(&added));
+    EXPECT_CALL(registry, remove_device(Truly([&](std::shared_ptr<mi::InputDevice> const& device)
+        { return device == added; })));
+
+    platform.start();
+    dispatch_until_idle(platform);
+    platform.stop();
+
+    ASSERT_THAT(added, NotNull());
+    EXPECT_THAT(added->get_device_info().name, Eq("keyboard"));
+    EXPECT_THAT(added->get_device_info().unique_id, Eq("usb-1"));
+}
+
+TEST_F(ReplayPlatform, removes_devices_still_present_on_stop)
+{
+    mi::replay::Platform platform{
+        mt::fake_shared(registry),
+        recording_of("0 add 1 4 \"usb-1\" \"keyboard\"\n"),
+        1.0};
+
+    EXPECT_CALL(registry, add_device(_));
+    EXPECT_CALL(registry, remove_device(_));
+
+    platform.start();
+    dispatch_until_idle(platform);
+    platform.stop();
+}
+
+TEST_F(ReplayPlatform, replays_events_of_a_started_device)
+{
+    mi::replay::Platform platform{
+        mt::fake_shared(registry),
+        recording_of(
+            "0 add 1 4 \"usb-1\" \"keyboard\"\n"
+            "5000000 key 1 1 97 30\n"
+            "10000000 key 1 0 97 30\n"),
+        1.0};
+
+    NiceMock<mtd::MockInputSink> sink;
+    NiceMock<mtd::MockInputSeat> seat;
+    mi::DefaultEventBuilder builder{MirInputDeviceId{1}, mir::cookie::Authority::create(), mt::fake_shared(seat)};
+    EXPECT_CALL(registry, add_device(_)).WillOnce(Invoke([&](std::shared_ptr<mi::InputDevice> const& device)
+        { device->start(&sink, &builder); }));
+
+    InSequence seq;
+    EXPECT_CALL(sink, handle_input(AllOf(mt::KeyDownEvent(), mt::KeyOfScanCode(30))));
+    EXPECT_CALL(sink, handle_input(AllOf(mt::KeyUpEvent(), mt::KeyOfScanCode(30))));
+
+    platform.start();
+    dispatch_until_idle(platform);
+    platform.stop();
+}
+
+TEST_F(ReplayPlatform, replays_faster_when_sped_up)
+{
+    // At normal speed this would outlast dispatch_until_idle()
+    mi::replay::Platform platform{
+        mt::fake_shared(registry),
+        recording_of(
+            "0 add 1 4 \"usb-1\" \"keyboard\"\n"
+            "1000000000 remove 1\n"),
+        100.0};
+
+    EXPECT_CALL(registry, add_device(_));
+    EXPECT_CALL(registry, remove_device(_));
+
+    platform.start();
+    dispatch_until_idle(platform);
+}
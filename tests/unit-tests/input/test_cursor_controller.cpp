@@ -17,6 +17,9 @@
  */
 
 #include "src/server/input/cursor_controller.h"
+#include "src/server/graphics/software_cursor.h"
+#include "src/server/scene/surface_stack.h"
+#include "src/server/report/null_report_factory.h"
 
 #include "mir/thread_safe_list.h"
 #include "mir/input/surface.h"
@@ -32,6 +35,8 @@
 #include "mir/test/fake_shared.h"
 #include "mir/test/doubles/stub_scene_surface.h"
 #include "mir/test/doubles/stub_input_scene.h"
+#include "mir/test/doubles/fake_alarm_factory.h"
+#include "mir/test/doubles/stub_buffer_allocator.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -66,6 +71,58 @@ struct NamedCursorImage : public mg::CursorImage
     std::string const cursor_name;
 };
 
+struct NamedCursorAnimation : public mg::AnimatedCursorImage
+{
+    NamedCursorAnimation(std::initializer_list<std::string> names, std::chrono::milliseconds delay)
+        : delay{delay}
+    {
+        for (auto const& name : names)
+            frames_.push_back(std::make_unique<NamedCursorImage>(name));
+    }
+
+    void const* as_argb_8888() const override { return nullptr; }
+    geom::Size size() const override { return geom::Size{16, 16}; }
+    geom::Displacement hotspot() const override { return geom::Displacement{0, 0}; }
+
+    size_t frames() const override { return frames_.size(); }
+    mg::CursorImage const& frame(size_t index) const override { return *frames_[index]; }
+    std::chrono::milliseconds frame_delay(size_t) const override { return delay; }
+
+    std::chrono::milliseconds const delay;
+    std::vector<std::unique_ptr<NamedCursorImage>> frames_;
+};
+
+// An animation a SoftwareCursor can draw
+struct SolidCursorAnimation : public mg::AnimatedCursorImage
+{
+    struct Frame : mg::CursorImage
+    {
+        Frame(uint32_t colour) : pixels(16 * 16, colour) {}
+
+        void const* as_argb_8888() const override { return pixels.data(); }
+        geom::Size size() const override { return geom::Size{16, 16}; }
+        geom::Displacement hotspot() const override { return geom::Displacement{0, 0}; }
+
+        std::vector<uint32_t> const pixels;
+    };
+
+    SolidCursorAnimation(std::chrono::milliseconds delay)
+        : delay{delay}
+    {
+    }
+
+    void const* as_argb_8888() const override { return frames_[0].as_argb_8888(); }
+    geom::Size size() const override { return frames_[0].size(); }
+    geom::Displacement hotspot() const override { return frames_[0].hotspot(); }
+
+    size_t frames() const override { return 2; }
+    mg::CursorImage const& frame(size_t index) const override { return frames_[index]; }
+    std::chrono::milliseconds frame_delay(size_t) const override { return delay; }
+
+    std::chrono::milliseconds const delay;
+    Frame const frames_[2]{{0xff000000}, {0xffffffff}};
+};
+
 struct ZeroSizedCursorImage : public mg::CursorImage
 {
     void const* as_argb_8888() const override { return nullptr; }
@@ -75,6 +132,10 @@ struct ZeroSizedCursorImage : public mg::CursorImage
 
 bool cursor_is_named(mg::CursorImage const& i, std::string const& name)
 {
+    // As a CursorImage an animation is its first frame
+    if (auto animation = dynamic_cast<mg::AnimatedCursorImage const*>(&i))
+        return cursor_is_named(animation->frame(0), name);
+
     auto image = dynamic_cast<NamedCursorImage const*>(&i);
     assert(image);
 
@@ -247,6 +308,7 @@ struct TestCursorController : public testing::Test
 
     MockCursor cursor;
     std::shared_ptr<mg::CursorImage> const default_cursor_image;
+    mtd::FakeAlarmFactory alarm_factory;
 };
 
 }
@@ -258,7 +320,7 @@ TEST_F(TestCursorController, moves_cursor)
     StubScene targets({});
 
     mi::CursorController controller(mt::fake_shared(targets),
-        mt::fake_shared(cursor), default_cursor_image);
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
 
     InSequence seq;
     EXPECT_CALL(cursor, move_to(geom::Point{geom::X{1.0f}, geom::Y{1.0f}}));
@@ -277,7 +339,7 @@ TEST_F(TestCursorController, updates_cursor_image_when_entering_surface)
     StubScene targets({mt::fake_shared(surface)});
 
     mi::CursorController controller(mt::fake_shared(targets),
-        mt::fake_shared(cursor), default_cursor_image);
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
 
     EXPECT_CALL(cursor, move_to(_)).Times(AnyNumber());
     EXPECT_CALL(cursor, show(CursorNamed(cursor_name_1))).Times(1);
@@ -294,7 +356,7 @@ TEST_F(TestCursorController, surface_with_no_cursor_image_hides_cursor)
     StubScene targets({mt::fake_shared(surface)});
 
     mi::CursorController controller(mt::fake_shared(targets),
-        mt::fake_shared(cursor), default_cursor_image);
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
 
     EXPECT_CALL(cursor, move_to(_)).Times(AnyNumber());
     EXPECT_CALL(cursor, hide()).Times(1);
@@ -311,7 +373,7 @@ TEST_F(TestCursorController, takes_cursor_image_from_topmost_surface)
     StubScene targets({mt::fake_shared(surface_1), mt::fake_shared(surface_2)});
 
     mi::CursorController controller(mt::fake_shared(targets),
-        mt::fake_shared(cursor), default_cursor_image);
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
 
     EXPECT_CALL(cursor, move_to(_)).Times(AnyNumber());
     EXPECT_CALL(cursor, show(CursorNamed(cursor_name_2))).Times(1);
@@ -328,7 +390,7 @@ TEST_F(TestCursorController, restores_cursor_when_leaving_surface)
     StubScene targets({mt::fake_shared(surface)});
 
     mi::CursorController controller(mt::fake_shared(targets),
-        mt::fake_shared(cursor), default_cursor_image);
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
 
     EXPECT_CALL(cursor, move_to(_)).Times(AnyNumber());
 
@@ -351,7 +413,7 @@ TEST_F(TestCursorController, change_in_cursor_request_triggers_image_update_with
     StubScene targets({mt::fake_shared(surface)});
 
     mi::CursorController controller(mt::fake_shared(targets),
-        mt::fake_shared(cursor), default_cursor_image);
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
 
     EXPECT_CALL(cursor, move_to(_)).Times(AnyNumber());
     {
@@ -374,7 +436,7 @@ TEST_F(TestCursorController, change_in_scene_triggers_image_update)
     StubScene targets({});
 
     mi::CursorController controller(mt::fake_shared(targets),
-        mt::fake_shared(cursor), default_cursor_image);
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
 
     EXPECT_CALL(cursor, move_to(_)).Times(AnyNumber());
     EXPECT_CALL(cursor, show(CursorNamed(cursor_name_1))).Times(1);
@@ -394,7 +456,7 @@ TEST_F(TestCursorController, cursor_image_not_reset_needlessly)
     StubScene targets({});
 
     mi::CursorController controller(mt::fake_shared(targets),
-        mt::fake_shared(cursor), default_cursor_image);
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
 
     EXPECT_CALL(cursor, move_to(_)).Times(AnyNumber());
     EXPECT_CALL(cursor, show(CursorNamed(cursor_name_1))).Times(1);
@@ -416,7 +478,7 @@ TEST_F(TestCursorController, updates_cursor_image_when_surface_posts_first_frame
     EXPECT_CALL(cursor, show(CursorNamed(cursor_name_1))).Times(1);
 
     mi::CursorController controller(mt::fake_shared(targets),
-        mt::fake_shared(cursor), default_cursor_image);
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
 
     Mock::VerifyAndClearExpectations(&cursor);
 
@@ -444,10 +506,82 @@ TEST_F(TestCursorController, zero_sized_image_hides_cursor)
     StubScene targets({});
 
     mi::CursorController controller(mt::fake_shared(targets),
-        mt::fake_shared(cursor), default_cursor_image);
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
 
     EXPECT_CALL(cursor, move_to(_)).Times(AnyNumber());
     EXPECT_CALL(cursor, hide()).Times(1);
 
     targets.add_surface(mt::fake_shared(surface));
 }
+
+TEST_F(TestCursorController, animates_cursor_image_on_timer)
+{
+    using namespace ::testing;
+
+    std::chrono::milliseconds const delay{50};
+    StubInputSurface surface{rect_1_1_1_1,
+        std::make_shared<NamedCursorAnimation>(std::initializer_list<std::string>{cursor_name_1, cursor_name_2}, delay)};
+    StubScene targets({mt::fake_shared(surface)});
+
+    mi::CursorController controller(mt::fake_shared(targets),
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
+
+    EXPECT_CALL(cursor, move_to(_)).Times(AnyNumber());
+    {
+        InSequence seq;
+        EXPECT_CALL(cursor, show(CursorNamed(cursor_name_1))).Times(1);
+        EXPECT_CALL(cursor, show(CursorNamed(cursor_name_2))).Times(1);
+        EXPECT_CALL(cursor, show(CursorNamed(cursor_name_1))).Times(1);
+    }
+
+    controller.cursor_moved_to(1.0f, 1.0f);
+    alarm_factory.advance_by(delay + std::chrono::milliseconds{1});
+    alarm_factory.advance_by(delay + std::chrono::milliseconds{1});
+}
+
+TEST_F(TestCursorController, stops_animating_when_leaving_surface)
+{
+    using namespace ::testing;
+
+    std::chrono::milliseconds const delay{50};
+    StubInputSurface surface{rect_1_1_1_1,
+        std::make_shared<NamedCursorAnimation>(std::initializer_list<std::string>{cursor_name_1, cursor_name_2}, delay)};
+    StubScene targets({mt::fake_shared(surface)});
+
+    mi::CursorController controller(mt::fake_shared(targets),
+        mt::fake_shared(cursor), default_cursor_image, mt::fake_shared(alarm_factory));
+
+    EXPECT_CALL(cursor, move_to(_)).Times(AnyNumber());
+    {
+        InSequence seq;
+        EXPECT_CALL(cursor, show(CursorNamed(cursor_name_1))).Times(1);
+        EXPECT_CALL(cursor, show(DefaultCursorImage())).Times(1);
+    }
+
+    controller.cursor_moved_to(1.0f, 1.0f);
+    controller.cursor_moved_to(2.0f, 2.0f);
+    alarm_factory.advance_by(delay + std::chrono::milliseconds{1});
+}
+
+// Regression test: a SoftwareCursor shows a frame by changing the scene,
+// which the controller observes
+TEST_F(TestCursorController, animates_a_software_cursor_in_the_scene_it_observes)
+{
+    using namespace ::testing;
+
+    std::chrono::milliseconds const delay{50};
+    auto const animation = std::make_shared<SolidCursorAnimation>(delay);
+
+    ms::SurfaceStack scene{mir::report::null_scene_report()};
+    mtd::StubBufferAllocator allocator;
+    auto const software_cursor = std::make_shared<mg::SoftwareCursor>(
+        mt::fake_shared(allocator), mt::fake_shared(scene));
+    scene.add_surface(std::make_shared<StubInputSurface>(rect_1_1_1_1, animation), mi::InputReceptionMode::normal);
+
+    mi::CursorController controller(mt::fake_shared(scene),
+        software_cursor, std::make_shared<SolidCursorAnimation::Frame>(0xff0000ff), mt::fake_shared(alarm_factory));
+
+    controller.cursor_moved_to(1.0f, 1.0f);
+    alarm_factory.advance_by(delay + std::chrono::milliseconds{1});
+    alarm_factory.advance_by(delay + std::chrono::milliseconds{1});
+}
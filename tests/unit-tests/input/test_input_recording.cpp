@@ -0,0 +1,161 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/input_recording.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+namespace mir_rec = mir::input::recording;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct InputRecording : Test
+{
+    mir_rec::Record round_trip(mir_rec::Record const& record)
+    {
+        std::stringstream stream;
+        mir_rec::Writer{stream}.write(record);
+
+        mir_rec::Reader reader{stream};
+        mir_rec::Record read;
+        EXPECT_TRUE(reader.read(read));
+
+        mir_rec::Record end;
+        EXPECT_FALSE(reader.read(end));
+        return read;
+    }
+
+    mir_rec::Record record_of(mir_rec::RecordType type)
+    {
+        mir_rec::Record record;
+        record.time = 1500us;
+        record.type = type;
+        record.device = 3;
+        return record;
+    }
+};
+}
+
+TEST_F(InputRecording, round_trips_an_added_device)
+{
+    auto record = record_of(mir_rec::RecordType::device_added);
+    record.info = mi::InputDeviceInfo{"Logitech \"Mouse\"", "usb-0000:00:14.0-1/input0",
+                                      mi::DeviceCapability::pointer};
+
+    auto const read = round_trip(record);
+
+    EXPECT_THAT(read.type, Eq(mir_rec::RecordType::device_added));
+    EXPECT_THAT(read.time, Eq(record.time));
+    EXPECT_THAT(read.device, Eq(record.device));
+    EXPECT_THAT(read.info.name, Eq(record.info.name));
+    EXPECT_THAT(read.info.unique_id, Eq(record.info.unique_id));
+    EXPECT_THAT(read.info.capabilities, Eq(record.info.capabilities));
+}
+
+TEST_F(InputRecording, round_trips_a_key)
+{
+    auto record = record_of(mir_rec::RecordType::key);
+    record.key_action = mir_keyboard_action_up;
+    record.keysym = 0x61;
+    record.scan_code = 30;
+
+    auto const read = round_trip(record);
+
+    EXPECT_THAT(read.type, Eq(mir_rec::RecordType::key));
+    EXPECT_THAT(read.key_action, Eq(record.key_action));
+    EXPECT_THAT(read.keysym, Eq(record.keysym));
+    EXPECT_THAT(read.scan_code, Eq(record.scan_code));
+}
+
+TEST_F(InputRecording, round_trips_pointer_motion_exactly)
+{
+    auto record = record_of(mir_rec::RecordType::pointer);
+    record.buttons = mir_pointer_button_primary;
+    record.dx = 0.1f;
+    record.dy = -1.0f/3;
+    record.vscroll = 2.5f;
+
+    auto const read = round_trip(record);
+
+    EXPECT_THAT(read.type, Eq(mir_rec::RecordType::pointer));
+    EXPECT_THAT(read.buttons, Eq(record.buttons));
+    EXPECT_THAT(read.dx, Eq(record.dx));
+    EXPECT_THAT(read.dy, Eq(record.dy));
+    EXPECT_THAT(read.vscroll, Eq(record.vscroll));
+    EXPECT_THAT(read.hscroll, Eq(record.hscroll));
+}
+
+TEST_F(InputRecording, round_trips_touch_contacts)
+{
+    auto record = record_of(mir_rec::RecordType::touch);
+    record.contacts = {
+        mev::ContactState{0, mir_touch_action_change, mir_touch_tooltype_finger, 10.5f, 20, 0.5f, 4, 3, 0},
+        mev::ContactState{1, mir_touch_action_down, mir_touch_tooltype_stylus, 100, 200, 1, 2, 1, 0}};
+
+    auto const read = round_trip(record);
+
+    ASSERT_THAT(read.contacts.size(), Eq(2u));
+    EXPECT_THAT(read.contacts[0].x, Eq(10.5f));
+    EXPECT_THAT(read.contacts[0].pressure, Eq(0.5f));
+    EXPECT_THAT(read.contacts[1].touch_id, Eq(1));
+    EXPECT_THAT(read.contacts[1].action, Eq(mir_touch_action_down));
+    EXPECT_THAT(read.contacts[1].tooltype, Eq(mir_touch_tooltype_stylus));
+}
+
+TEST_F(InputRecording, reader_skips_comments_and_empty_lines)
+{
+    std::istringstream stream{
+        "mir-input-recording 1\n"
+        "# generated\n"
+        "\n"
+        "250 remove 2\n"};
+
+    mir_rec::Reader reader{stream};
+    mir_rec::Record read;
+
+    ASSERT_TRUE(reader.read(read));
+    EXPECT_THAT(read.type, Eq(mir_rec::RecordType::device_removed));
+    EXPECT_THAT(read.time, Eq(250ns));
+    EXPECT_THAT(read.device, Eq(2));
+}
+
+TEST_F(InputRecording, reader_rejects_a_stream_without_a_header)
+{
+    std::istringstream stream{"0 remove 2\n"};
+
+    EXPECT_THROW(mir_rec::Reader{stream}, std::runtime_error);
+}
+
+TEST_F(InputRecording, reader_rejects_a_malformed_record)
+{
+    std::istringstream stream{
+        "mir-input-recording 1\n"
+        "0 key 1 0\n"};
+
+    mir_rec::Reader reader{stream};
+    mir_rec::Record read;
+
+    EXPECT_THROW(reader.read(read), std::runtime_error);
+}
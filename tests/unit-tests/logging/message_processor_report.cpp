@@ -177,3 +177,13 @@ TEST_F(MessageProcessorReport, logs_incomplete_calls_on_destruction)
     report.received_invocation(this, 1, __PRETTY_FUNCTION__);
 }
 
+
+TEST_F(MessageProcessorReport, logs_client_request_rate)
+{
+    EXPECT_CALL(logger, log(
+        ml::Severity::informational,
+        "client pid=42: 120 requests/s, longest wait=350µs",
+        "frontend::MessageProcessor")).Times(1);
+
+    report.request_rate(42, 120, std::chrono::microseconds{350});
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_logger.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace ml = mir::logging;
+
+using namespace testing;
+
+namespace
+{
+struct CapturedStream
+{
+    explicit CapturedStream(std::ostream& stream) :
+        stream{stream},
+        original{stream.rdbuf(captured.rdbuf())}
+    {
+    }
+
+    ~CapturedStream()
+    {
+        stream.rdbuf(original);
+    }
+
+    std::string str() const { return captured.str(); }
+
+    std::ostream& stream;
+    std::ostringstream captured;
+    std::streambuf* const original;
+};
+
+struct AsyncLogger : Test
+{
+    CapturedStream out{std::cout};
+    CapturedStream err{std::cerr};
+};
+}
+
+TEST_F(AsyncLogger, writes_messages_by_the_time_it_is_destroyed)
+{
+    {
+        ml::AsyncLogger async_logger;
+        ml::Logger& logger = async_logger;
+
+        logger.log(ml::Severity::informational, "first", "test");
+        logger.log("test", ml::Severity::warning, "second %d", 2);
+    }
+
+    EXPECT_THAT(out.str(), HasSubstr("] test: first\n"));
+    EXPECT_THAT(err.str(), HasSubstr("] <WARNING> test: second 2\n"));
+}
+
+TEST_F(AsyncLogger, keeps_messages_from_a_thread_in_order)
+{
+    {
+        ml::AsyncLogger async_logger;
+        ml::Logger& logger = async_logger;
+
+        for (auto i = 0; i != 100; ++i)
+            logger.log("test", ml::Severity::informational, "message %d", i);
+    }
+
+    auto const output = out.str();
+    EXPECT_THAT(output.find("message 10\n"), Lt(output.find("message 11\n")));
+    EXPECT_THAT(output.find("message 98\n"), Lt(output.find("message 99\n")));
+}
+
+TEST_F(AsyncLogger, writes_messages_logged_by_threads_that_have_exited)
+{
+    {
+        ml::AsyncLogger async_logger;
+        ml::Logger& logger = async_logger;
+
+        std::thread{[&] { logger.log(ml::Severity::informational, "from a thread", "test"); }}.join();
+    }
+
+    EXPECT_THAT(out.str(), HasSubstr("] test: from a thread\n"));
+}
+
+TEST_F(AsyncLogger, collapses_repeated_messages)
+{
+    {
+        ml::AsyncLogger async_logger;
+        ml::Logger& logger = async_logger;
+
+        for (auto i = 0; i != 10; ++i)
+            logger.log(ml::Severity::informational, "again", "test");
+    }
+
+    auto const output = out.str();
+    EXPECT_THAT(output, HasSubstr("] test: again\n"));
+    EXPECT_THAT(output.find("] test: again\n"), Eq(output.rfind("] test: again\n")));
+    EXPECT_THAT(output, HasSubstr("last message repeated 9 times"));
+}
+
+TEST_F(AsyncLogger, drops_messages_rather_than_wait_for_the_writer)
+{
+    {
+        ml::AsyncLogger async_logger{1024};
+        ml::Logger& logger = async_logger;
+
+        for (auto i = 0; i != 1000; ++i)
+            logger.log("test", ml::Severity::informational, "message %d", i);
+    }
+
+    EXPECT_THAT(err.str(), HasSubstr("messages dropped"));
+}
+
+TEST_F(AsyncLogger, writes_critical_messages_immediately)
+{
+    ml::AsyncLogger async_logger;
+    ml::Logger& logger = async_logger;
+
+    logger.log(ml::Severity::informational, "queued", "test");
+    logger.log(ml::Severity::critical, "fatal", "test");
+
+    EXPECT_THAT(out.str(), HasSubstr("] test: queued\n"));
+    EXPECT_THAT(err.str(), HasSubstr("] <CRITICAL> test: fatal\n"));
+}
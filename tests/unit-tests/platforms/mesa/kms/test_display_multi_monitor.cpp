@@ -40,6 +40,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <algorithm>
 #include <unordered_set>
 #include <fcntl.h>
 
@@ -594,3 +595,54 @@ TEST_F(MesaDisplayMultiMonitorTest, resume_clears_unused_connected_outputs)
                         .Times(1);
     }
 }
+
+TEST_F(MesaDisplayMultiMonitorTest, configure_keeping_unchanged_groups_only_retires_changed_groups)
+{
+    using namespace testing;
+
+    int const num_connected_outputs{3};
+    int const num_disconnected_outputs{0};
+
+    setup_outputs(num_connected_outputs, num_disconnected_outputs);
+
+    auto display = create_display_side_by_side(create_platform());
+
+    std::vector<mg::DisplaySyncGroup*> initial_groups;
+    display->for_each_display_sync_group(
+        [&](mg::DisplaySyncGroup& group) { initial_groups.push_back(&group); });
+
+    ASSERT_THAT(initial_groups.size(), Eq(3u));
+
+    /* Turn off the rightmost output */
+    auto conf = display->configuration();
+
+    int rightmost{0};
+    conf->for_each_output(
+        [&](mg::UserDisplayConfigurationOutput& output)
+        {
+            rightmost = std::max(rightmost, output.top_left.x.as_int());
+        });
+
+    conf->for_each_output(
+        [&](mg::UserDisplayConfigurationOutput& output)
+        {
+            if (output.top_left.x.as_int() == rightmost)
+                output.used = false;
+        });
+
+    std::vector<mg::DisplaySyncGroup*> retired_groups;
+    display->configure_keeping_unchanged_groups(
+        *conf,
+        [&](mg::DisplaySyncGroup& group) { retired_groups.push_back(&group); });
+
+    std::vector<mg::DisplaySyncGroup*> groups;
+    display->for_each_display_sync_group(
+        [&](mg::DisplaySyncGroup& group) { groups.push_back(&group); });
+
+    ASSERT_THAT(retired_groups.size(), Eq(1u));
+    EXPECT_THAT(groups.size(), Eq(2u));
+    EXPECT_THAT(groups, Not(Contains(retired_groups.front())));
+
+    for (auto const group : groups)
+        EXPECT_THAT(initial_groups, Contains(group));
+}
@@ -23,6 +23,8 @@
 #include "src/server/report/null/display_report.h"
 
 #include "mir/graphics/display_configuration.h"
+#include "mir/graphics/cursor.h"
+#include "mir/graphics/cursor_image.h"
 
 #include "mir/test/doubles/mock_egl.h"
 #include "mir/test/doubles/mock_x11.h"
@@ -41,6 +43,14 @@ using namespace testing;
 namespace
 {
 
+struct StubCursorImage : mg::CursorImage
+{
+    void const* as_argb_8888() const override { return pixels.data(); }
+    geom::Size size() const override { return {16, 16}; }
+    geom::Displacement hotspot() const override { return {3, 4}; }
+
+    std::vector<uint32_t> const pixels = std::vector<uint32_t>(16 * 16, 0xff000000);
+};
 
 class X11DisplayTest : public ::testing::Test
 {
@@ -246,3 +256,51 @@ TEST_F(X11DisplayTest, updates_scale_property_correctly)
 
     EXPECT_THAT(new_scale, Eq(scale));
 }
+
+TEST_F(X11DisplayTest, uses_a_software_cursor_without_xrender)
+{
+    ON_CALL(mock_x11, XRenderQueryExtension(mock_x11.fake_x11.display,_,_))
+        .WillByDefault(Return(False));
+
+    auto display = create_display();
+
+    EXPECT_THAT(display->create_hardware_cursor(), IsNull());
+}
+
+TEST_F(X11DisplayTest, shows_cursor_as_the_windows_x_cursor)
+{
+    Cursor const x_cursor{42};
+    StubCursorImage const image;
+
+    ON_CALL(mock_x11, XRenderQueryExtension(mock_x11.fake_x11.display,_,_))
+        .WillByDefault(Return(True));
+    EXPECT_CALL(mock_x11, XRenderCreateCursor(mock_x11.fake_x11.display, _, 3, 4))
+        .WillOnce(Return(x_cursor));
+    EXPECT_CALL(mock_x11, XDefineCursor(mock_x11.fake_x11.display, mock_x11.fake_x11.window, _))
+        .Times(AnyNumber());
+    EXPECT_CALL(mock_x11, XDefineCursor(mock_x11.fake_x11.display, mock_x11.fake_x11.window, x_cursor));
+
+    auto display = create_display();
+    auto cursor = display->create_hardware_cursor();
+    ASSERT_THAT(cursor, NotNull());
+
+    cursor->show(image);
+}
+
+TEST_F(X11DisplayTest, moving_cursor_makes_no_x_requests)
+{
+    StubCursorImage const image;
+
+    ON_CALL(mock_x11, XRenderQueryExtension(mock_x11.fake_x11.display,_,_))
+        .WillByDefault(Return(True));
+
+    auto display = create_display();
+    auto cursor = display->create_hardware_cursor();
+    ASSERT_THAT(cursor, NotNull());
+    cursor->show(image);
+
+    EXPECT_CALL(mock_x11, XDefineCursor(_,_,_)).Times(0);
+    EXPECT_CALL(mock_x11, XFlush(_)).Times(0);
+
+    cursor->move_to({12, 34});
+}
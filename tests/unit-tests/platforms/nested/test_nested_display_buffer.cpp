@@ -148,6 +148,81 @@ struct MockNestedBuffer : StubNestedBuffer
     MOCK_METHOD1(on_ownership_notification, void(std::function<void()> const&));
 };
 
+// A renderable that keeps its id as it moves
+struct MovingRenderable : mtd::StubRenderable
+{
+    MovingRenderable(std::shared_ptr<mg::Buffer> const& buffer, geom::Rectangle const& position) :
+        mtd::StubRenderable(buffer, position),
+        position{position}
+    {
+    }
+
+    geom::Rectangle screen_position() const override { return position; }
+
+    geom::Rectangle position;
+};
+
+// Records the chains created, the buffers submitted to them and the
+// arrangement of each applied spec
+struct ArrangementHostConnection : mtd::StubHostConnection
+{
+    using mtd::StubHostConnection::StubHostConnection;
+
+    using Submission = std::tuple<MirPresentationChain*, MirBuffer*>;
+
+    std::unique_ptr<mgn::HostChain> create_chain() const override
+    {
+        struct RecordingHostChain : mgn::HostChain
+        {
+            RecordingHostChain(std::vector<Submission>& submissions) :
+                submissions(submissions)
+            {
+            }
+
+            void submit_buffer(mgn::NativeBuffer& buffer) override
+            {
+                submissions.emplace_back(handle(), buffer.client_handle());
+            }
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+            MirRenderSurface* rs() const override { return nullptr; }
+#pragma GCC diagnostic pop
+            MirPresentationChain* handle() override { return reinterpret_cast<MirPresentationChain*>(this); }
+            void set_submission_mode(mgn::SubmissionMode) override {}
+
+            std::vector<Submission>& submissions;
+        };
+        ++chains_created;
+        return std::make_unique<RecordingHostChain>(submissions);
+    }
+
+    std::unique_ptr<mgn::HostSurfaceSpec> create_surface_spec() override
+    {
+        struct ArrangementSpec : mgn::HostSurfaceSpec
+        {
+            ArrangementSpec(std::vector<geom::Rectangle>& arrangement) :
+                arrangement(arrangement)
+            {
+            }
+
+            void add_chain(mgn::HostChain&, geom::Displacement disp, geom::Size size) override
+            {
+                arrangement.push_back({geom::Point{} + disp, size});
+            }
+            void add_stream(mgn::HostStream&, geom::Displacement, geom::Size) override {}
+            MirWindowSpec* handle() override { return nullptr; }
+
+            std::vector<geom::Rectangle>& arrangement;
+        };
+        arrangements.emplace_back();
+        return std::make_unique<ArrangementSpec>(arrangements.back());
+    }
+
+    int mutable chains_created{0};
+    std::vector<Submission> mutable submissions;
+    std::vector<std::vector<geom::Rectangle>> arrangements;
+};
+
 
 struct NestedDisplayBuffer : Test
 {
@@ -417,12 +492,57 @@ TEST_F(NestedDisplayBuffer, rejects_list_containing_buffers_with_different_size_
     EXPECT_FALSE(display_buffer->overlay(list));
 }
 
-/* Once we have synchronous MirWindow scene updates, we can probably
- * passthrough more than one renderable if needed
- */
-TEST_F(NestedDisplayBuffer, rejects_list_containing_multiple_onscreen_renderables)
+TEST_F(NestedDisplayBuffer, passes_through_stacked_renderables_as_separate_chains)
 {
-    StubNestedBuffer nested_buffer; 
+    StubNestedBuffer nested_buffer1;
+    StubNestedBuffer nested_buffer2;
+    geom::Rectangle small_rect { {10, 20}, { 5, 5 }};
+    mg::RenderableList list = {
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer1), rectangle),
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer2), small_rect) };
+
+    ArrangementHostConnection connection;
+    auto display_buffer = create_display_buffer(mt::fake_shared(connection));
+    EXPECT_TRUE(display_buffer->overlay(list));
+
+    EXPECT_THAT(connection.chains_created, Eq(2));
+    ASSERT_THAT(connection.arrangements.size(), Eq(1u));
+    EXPECT_THAT(connection.arrangements.back(), ElementsAre(rectangle, small_rect));
+}
+
+TEST_F(NestedDisplayBuffer, passes_through_tiled_renderables_as_separate_chains)
+{
+    StubNestedBuffer nested_buffer1;
+    StubNestedBuffer nested_buffer2;
+    geom::Rectangle const left{ {0, 0}, {512, 768} };
+    geom::Rectangle const right{ {512, 0}, {512, 768} };
+    mg::RenderableList list = {
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer1), left),
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer2), right) };
+
+    ArrangementHostConnection connection;
+    auto display_buffer = create_display_buffer(mt::fake_shared(connection));
+    EXPECT_TRUE(display_buffer->overlay(list));
+
+    ASSERT_THAT(connection.arrangements.size(), Eq(1u));
+    EXPECT_THAT(connection.arrangements.back(), ElementsAre(left, right));
+}
+
+TEST_F(NestedDisplayBuffer, rejects_list_leaving_part_of_output_uncovered)
+{
+    StubNestedBuffer nested_buffer1;
+    StubNestedBuffer nested_buffer2;
+    mg::RenderableList list = {
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer1), geom::Rectangle{{0, 0}, {512, 768}}),
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer2), geom::Rectangle{{513, 0}, {511, 768}}) };
+
+    auto display_buffer = create_display_buffer(host_connection);
+    EXPECT_FALSE(display_buffer->overlay(list));
+}
+
+TEST_F(NestedDisplayBuffer, rejects_list_showing_a_buffer_twice)
+{
+    StubNestedBuffer nested_buffer;
     geom::Rectangle small_rect { {0, 0}, { 5, 5 }};
     mg::RenderableList list = {
         std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer), rectangle),
@@ -432,6 +552,56 @@ TEST_F(NestedDisplayBuffer, rejects_list_containing_multiple_onscreen_renderable
     EXPECT_FALSE(display_buffer->overlay(list));
 }
 
+TEST_F(NestedDisplayBuffer, reapplies_spec_only_when_passthrough_arrangement_changes)
+{
+    StubNestedBuffer nested_buffer1;
+    StubNestedBuffer nested_buffer2;
+    auto const moving = std::make_shared<MovingRenderable>(
+        mt::fake_shared(nested_buffer2), geom::Rectangle{{10, 20}, {5, 5}});
+    mg::RenderableList list = {
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer1), rectangle),
+        moving };
+
+    ArrangementHostConnection connection;
+    auto display_buffer = create_display_buffer(mt::fake_shared(connection));
+    EXPECT_TRUE(display_buffer->overlay(list));
+    EXPECT_TRUE(display_buffer->overlay(list));
+    EXPECT_THAT(connection.arrangements.size(), Eq(1u));
+
+    geom::Rectangle const moved{{30, 40}, {5, 5}};
+    moving->position = moved;
+    EXPECT_TRUE(display_buffer->overlay(list));
+    ASSERT_THAT(connection.arrangements.size(), Eq(2u));
+    EXPECT_THAT(connection.arrangements.back(), ElementsAre(rectangle, moved));
+    EXPECT_THAT(connection.chains_created, Eq(2));
+}
+
+TEST_F(NestedDisplayBuffer, keeps_the_chain_of_each_renderable_when_one_below_goes_away)
+{
+    StubNestedBuffer nested_buffer1;
+    StubNestedBuffer nested_buffer2;
+    StubNestedBuffer nested_buffer3;
+    geom::Rectangle const middle_rect{{10, 20}, {5, 5}};
+    geom::Rectangle const top_rect{{30, 40}, {5, 5}};
+    auto const bottom = std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer1), rectangle);
+    auto const middle = std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer2), middle_rect);
+    auto const top = std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer3), top_rect);
+
+    ArrangementHostConnection connection;
+    auto display_buffer = create_display_buffer(mt::fake_shared(connection));
+    EXPECT_TRUE(display_buffer->overlay({bottom, middle, top}));
+    ASSERT_THAT(connection.submissions.size(), Eq(3u));
+    auto const submissions = connection.submissions;
+
+    EXPECT_TRUE(display_buffer->overlay({bottom, top}));
+
+    // The host still owns the buffers on the remaining chains, so they are not resubmitted
+    EXPECT_THAT(connection.submissions, ContainerEq(submissions));
+    EXPECT_THAT(connection.chains_created, Eq(3));
+    ASSERT_THAT(connection.arrangements.size(), Eq(2u));
+    EXPECT_THAT(connection.arrangements.back(), ElementsAre(rectangle, top_rect));
+}
+
 TEST_F(NestedDisplayBuffer, accepts_list_containing_multiple_renderables_with_fullscreen_on_top)
 {
     StubNestedBuffer nested_buffer; 
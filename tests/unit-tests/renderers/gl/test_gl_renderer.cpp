@@ -29,6 +29,8 @@
 #include <mir/test/doubles/mock_gl.h>
 #include <mir/test/doubles/mock_egl.h>
 #include <src/renderers/gl/renderer.h>
+#include <mir/gl/default_program_factory.h>
+#include <mir/graphics/surface_layer.h>
 #include <mir/test/doubles/stub_gl_display_buffer.h>
 #include <mir/test/doubles/mock_gl_display_buffer.h>
 
@@ -40,6 +42,7 @@ using testing::Pointee;
 using testing::AnyNumber;
 using testing::AtLeast;
 using testing::DoAll;
+using testing::NiceMock;
 using testing::_;
 
 namespace mt=mir::test;
@@ -466,3 +469,119 @@ TEST_F(GLRenderer, sets_viewport_downscaled_wide)
 
     mrg::Renderer renderer(mock_display_buffer);
 }
+
+namespace
+{
+struct MockSurfaceLayer : NiceMock<mtd::MockRenderable>, mg::SurfaceLayer
+{
+    MockSurfaceLayer(
+        mg::Renderable::ID surface,
+        std::shared_ptr<mg::Buffer> const& buffer,
+        mir::geometry::Rectangle const& position) :
+        surface{surface}
+    {
+        ON_CALL(*this, id()).WillByDefault(Return(this));
+        ON_CALL(*this, buffer()).WillByDefault(Return(buffer));
+        ON_CALL(*this, shaped()).WillByDefault(Return(true));
+        ON_CALL(*this, transformation()).WillByDefault(Return(glm::mat4(1)));
+        ON_CALL(*this, screen_position()).WillByDefault(Return(position));
+    }
+
+    mg::Renderable::ID surface_id() const override { return surface; }
+
+    mg::Renderable::ID const surface;
+};
+
+struct GLRendererFlatteningLayers : GLRenderer
+{
+    GLRendererFlatteningLayers()
+    {
+        ON_CALL(mock_gl, glGetIntegerv(GL_MAX_TEXTURE_SIZE, _))
+            .WillByDefault(SetArgPointee<1>(4096));
+        ON_CALL(mock_gl, glGenFramebuffers(1, _))
+            .WillByDefault(SetArgPointee<1>(flattened_fbo));
+        ON_CALL(mock_gl, glCheckFramebufferStatus(GL_FRAMEBUFFER))
+            .WillByDefault(Return(GL_FRAMEBUFFER_COMPLETE));
+
+        ON_CALL(*other_buffer, id()).WillByDefault(Return(mg::BufferID(790)));
+        ON_CALL(*other_buffer, size()).WillByDefault(Return(mir::geometry::Size{123, 456}));
+    }
+
+    std::unique_ptr<mrg::Renderer> create_renderer(bool flatten_layers)
+    {
+        return std::make_unique<mrg::Renderer>(
+            display_buffer,
+            mgl::DefaultProgramFactory().create_texture_cache(),
+            std::make_shared<mrg::ProgramFamily>(),
+            flatten_layers);
+    }
+
+    void render_until_settled(mrg::Renderer& renderer)
+    {
+        for (int i = 0; i != 100; ++i)
+            renderer.render(layers);
+    }
+
+    GLuint const flattened_fbo{7};
+    int const surface{0};
+    std::shared_ptr<MockSurfaceLayer> const bottom = std::make_shared<MockSurfaceLayer>(
+        &surface, mock_buffer, mir::geometry::Rectangle{{0, 0}, {100, 100}});
+    std::shared_ptr<MockSurfaceLayer> const top = std::make_shared<MockSurfaceLayer>(
+        &surface, mock_buffer, mir::geometry::Rectangle{{10, 10}, {20, 20}});
+    mg::RenderableList const layers{bottom, top};
+    std::shared_ptr<NiceMock<mtd::MockGLBuffer>> const other_buffer =
+        std::make_shared<NiceMock<mtd::MockGLBuffer>>();
+};
+}
+
+TEST_F(GLRendererFlatteningLayers, draws_settled_layers_of_a_surface_at_once)
+{
+    auto const renderer = create_renderer(true);
+    render_until_settled(*renderer);
+
+    EXPECT_CALL(mock_gl, glDrawArrays(_, _, _)).Times(1);
+    renderer->render(layers);
+}
+
+TEST_F(GLRendererFlatteningLayers, only_flattens_layers_again_when_they_change)
+{
+    auto const renderer = create_renderer(true);
+    render_until_settled(*renderer);
+
+    EXPECT_CALL(mock_gl, glBindFramebuffer(GL_FRAMEBUFFER, flattened_fbo)).Times(0);
+    renderer->render(layers);
+    renderer->render(layers);
+}
+
+TEST_F(GLRendererFlatteningLayers, moving_the_surface_moves_its_flattened_layers)
+{
+    auto const renderer = create_renderer(true);
+    render_until_settled(*renderer);
+
+    ON_CALL(*bottom, screen_position()).WillByDefault(Return(mir::geometry::Rectangle{{50, 50}, {100, 100}}));
+    ON_CALL(*top, screen_position()).WillByDefault(Return(mir::geometry::Rectangle{{60, 60}, {20, 20}}));
+
+    EXPECT_CALL(mock_gl, glBindFramebuffer(GL_FRAMEBUFFER, flattened_fbo)).Times(0);
+    EXPECT_CALL(mock_gl, glDrawArrays(_, _, _)).Times(1);
+    renderer->render(layers);
+}
+
+TEST_F(GLRendererFlatteningLayers, draws_each_layer_when_one_changes)
+{
+    auto const renderer = create_renderer(true);
+    render_until_settled(*renderer);
+
+    ON_CALL(*top, buffer()).WillByDefault(Return(other_buffer));
+
+    EXPECT_CALL(mock_gl, glDrawArrays(_, _, _)).Times(2);
+    renderer->render(layers);
+}
+
+TEST_F(GLRendererFlatteningLayers, draws_each_layer_unless_enabled)
+{
+    auto const renderer = create_renderer(false);
+    render_until_settled(*renderer);
+
+    EXPECT_CALL(mock_gl, glDrawArrays(_, _, _)).Times(2);
+    renderer->render(layers);
+}
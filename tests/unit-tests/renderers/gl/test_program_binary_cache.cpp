@@ -0,0 +1,122 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/renderers/gl/program_binary_cache.h"
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <system_error>
+
+namespace mrg = mir::renderer::gl;
+
+using namespace testing;
+
+namespace
+{
+struct ProgramBinaryCache : Test
+{
+    ProgramBinaryCache()
+    {
+        // Can't use std::string, as mkdtemp mutates its argument.
+        std::unique_ptr<char, decltype(&free)> tmp_name{strdup("/tmp/mir_program_cache_XXXXXX"), &free};
+        if (mkdtemp(tmp_name.get()) == NULL)
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+
+        temporary_directory = tmp_name.get();
+    }
+
+    ~ProgramBinaryCache()
+    {
+        boost::filesystem::remove_all(temporary_directory);
+    }
+
+    std::string temporary_directory;
+    std::string const key{"vendor\nrenderer\nversion\nvertex shader\0fragment shader", 55};
+    std::vector<char> const binary{'b', 'i', 'n', '\0', 'a', 'r', 'y'};
+    GLenum const format{0x1234};
+};
+}
+
+TEST_F(ProgramBinaryCache, loads_what_was_stored)
+{
+    mrg::ProgramBinaryCache const cache{temporary_directory + "/mir/gl-programs"};
+
+    cache.store(key, format, binary);
+
+    GLenum loaded_format{0};
+    std::vector<char> loaded;
+    ASSERT_TRUE(cache.load(key, loaded_format, loaded));
+    EXPECT_THAT(loaded_format, Eq(format));
+    EXPECT_THAT(loaded, ContainerEq(binary));
+}
+
+TEST_F(ProgramBinaryCache, persists_between_instances)
+{
+    mrg::ProgramBinaryCache{temporary_directory}.store(key, format, binary);
+
+    GLenum loaded_format{0};
+    std::vector<char> loaded;
+    EXPECT_TRUE(mrg::ProgramBinaryCache{temporary_directory}.load(key, loaded_format, loaded));
+    EXPECT_THAT(loaded, ContainerEq(binary));
+}
+
+TEST_F(ProgramBinaryCache, misses_for_a_different_key)
+{
+    mrg::ProgramBinaryCache const cache{temporary_directory};
+
+    cache.store(key, format, binary);
+
+    GLenum loaded_format{0};
+    std::vector<char> loaded;
+    EXPECT_FALSE(cache.load("other vendor\nrenderer\nversion\nvertex shader", loaded_format, loaded));
+    EXPECT_THAT(loaded, IsEmpty());
+}
+
+TEST_F(ProgramBinaryCache, misses_when_nothing_was_stored)
+{
+    mrg::ProgramBinaryCache const cache{temporary_directory + "/does-not-exist"};
+
+    GLenum loaded_format{0};
+    std::vector<char> loaded;
+    EXPECT_FALSE(cache.load(key, loaded_format, loaded));
+}
+
+TEST_F(ProgramBinaryCache, ignores_a_directory_it_cannot_write_to)
+{
+    mrg::ProgramBinaryCache const cache{"/proc/mir-program-cache"};
+
+    EXPECT_NO_THROW(cache.store(key, format, binary));
+}
+
+TEST_F(ProgramBinaryCache, default_directory_is_under_xdg_cache_home)
+{
+    auto const saved = getenv("XDG_CACHE_HOME");
+    std::string const previous{saved ? saved : ""};
+
+    setenv("XDG_CACHE_HOME", temporary_directory.c_str(), true);
+    EXPECT_THAT(mrg::ProgramBinaryCache::default_directory(), Eq(temporary_directory + "/mir/gl-programs"));
+
+    if (saved)
+        setenv("XDG_CACHE_HOME", previous.c_str(), true);
+    else
+        unsetenv("XDG_CACHE_HOME");
+}
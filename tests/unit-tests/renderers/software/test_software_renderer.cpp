@@ -0,0 +1,329 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/renderers/software/renderer.h"
+#include "src/renderers/software/pixel_kernels.h"
+#include "mir/renderer/sw/render_target.h"
+#include "mir/graphics/display_buffer.h"
+#include "mir/graphics/transformation.h"
+#include "mir/test/doubles/stub_buffer.h"
+#include "mir/test/doubles/stub_renderable.h"
+#include "mir/test/doubles/mock_display_buffer.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdlib>
+
+namespace mg = mir::graphics;
+namespace mrs = mir::renderer::software;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+
+using namespace testing;
+
+namespace
+{
+uint32_t const black{0};
+uint32_t const red{0xffff0000};
+uint32_t const blue{0xff0000ff};
+uint32_t const poison{0x12345678};
+
+struct SoftwareDisplayBuffer : mg::DisplayBuffer, mg::NativeDisplayBuffer, mrs::RenderTarget
+{
+    SoftwareDisplayBuffer(geom::Rectangle const& area, geom::Size const& physical_size)
+        : area{area},
+          physical_size{physical_size},
+          pixels(physical_size.width.as_int() * physical_size.height.as_int(), poison)
+    {
+    }
+
+    explicit SoftwareDisplayBuffer(geom::Rectangle const& area)
+        : SoftwareDisplayBuffer{area, area.size}
+    {
+    }
+
+    geom::Rectangle view_area() const override { return area; }
+    bool overlay(mg::RenderableList const&) override { return false; }
+    glm::mat2 transformation() const override { return glm::mat2{1}; }
+    NativeDisplayBuffer* native_display_buffer() override { return this; }
+
+    geom::Size size() const override { return physical_size; }
+    MirPixelFormat pixel_format() const override { return mir_pixel_format_argb_8888; }
+
+    Mapping map_back_buffer() override
+    {
+        return {
+            reinterpret_cast<unsigned char*>(pixels.data()),
+            geom::Stride{physical_size.width.as_int() * 4},
+            age};
+    }
+
+    void swap_buffers() override
+    {
+        ++frames;
+    }
+
+    uint32_t& at(int x, int y)
+    {
+        return pixels[y * physical_size.width.as_int() + x];
+    }
+
+    geom::Rectangle const area;
+    geom::Size const physical_size;
+    std::vector<uint32_t> pixels;
+    unsigned int age{1};
+    int frames{0};
+};
+
+struct ShapedRenderable : mtd::StubRenderable
+{
+    ShapedRenderable(std::shared_ptr<mg::Buffer> const& buffer, geom::Rectangle const& rect, float alpha)
+        : StubRenderable(buffer, rect),
+          renderable_alpha{alpha}
+    {
+    }
+
+    float alpha() const override { return renderable_alpha; }
+    bool shaped() const override { return true; }
+
+    float const renderable_alpha;
+};
+
+std::shared_ptr<mtd::StubBuffer> make_buffer(geom::Size const& size, MirPixelFormat format, uint32_t colour)
+{
+    auto const buffer = std::make_shared<mtd::StubBuffer>(
+        mg::BufferProperties{size, format, mg::BufferUsage::software});
+
+    std::vector<uint32_t> pixels(size.width.as_int() * size.height.as_int(), colour);
+    buffer->write(reinterpret_cast<unsigned char const*>(pixels.data()), pixels.size() * sizeof(uint32_t));
+    return buffer;
+}
+
+struct SoftwareRenderer : Test
+{
+    geom::Rectangle const screen{{0, 0}, {8, 4}};
+    SoftwareDisplayBuffer display_buffer{screen};
+};
+}
+
+TEST_F(SoftwareRenderer, draws_renderables_at_their_position_and_clears_the_rest)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    auto const window = std::make_shared<mtd::StubRenderable>(
+        make_buffer({2, 2}, mir_pixel_format_xrgb_8888, red), geom::Rectangle{{3, 1}, {2, 2}});
+
+    renderer.render({window});
+
+    EXPECT_THAT(display_buffer.at(3, 1), Eq(red));
+    EXPECT_THAT(display_buffer.at(4, 2), Eq(red));
+    EXPECT_THAT(display_buffer.at(0, 0), Eq(black));
+    EXPECT_THAT(display_buffer.at(5, 2), Eq(black));
+    EXPECT_THAT(display_buffer.frames, Eq(1));
+}
+
+TEST_F(SoftwareRenderer, blends_shaped_renderables_over_those_below)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    uint32_t const half_red{0x80800000};   // Premultiplied
+    auto const background = std::make_shared<mtd::StubRenderable>(
+        make_buffer(screen.size, mir_pixel_format_xrgb_8888, blue), screen);
+    auto const overlay = std::make_shared<ShapedRenderable>(
+        make_buffer({1, 1}, mir_pixel_format_argb_8888, half_red), geom::Rectangle{{0, 0}, {1, 1}}, 1.0f);
+
+    renderer.render({background, overlay});
+
+    EXPECT_THAT(display_buffer.at(0, 0), Eq(0xff80007fu));
+    EXPECT_THAT(display_buffer.at(1, 0), Eq(blue));
+}
+
+TEST_F(SoftwareRenderer, fades_renderables_with_alpha)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    auto const window = std::make_shared<ShapedRenderable>(
+        make_buffer(screen.size, mir_pixel_format_argb_8888, red), screen, 0.5f);
+
+    renderer.render({window});
+
+    EXPECT_THAT(display_buffer.at(0, 0), Eq(0x80800000u));
+}
+
+TEST_F(SoftwareRenderer, swaps_red_and_blue_for_buffers_in_the_other_order)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    uint32_t const abgr_red{0xff0000ff};
+    auto const window = std::make_shared<mtd::StubRenderable>(
+        make_buffer(screen.size, mir_pixel_format_abgr_8888, abgr_red), screen);
+
+    renderer.render({window});
+
+    EXPECT_THAT(display_buffer.at(0, 0), Eq(red));
+}
+
+TEST_F(SoftwareRenderer, scales_renderables_to_their_screen_position)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    auto const window = std::make_shared<mtd::StubRenderable>(
+        make_buffer({1, 1}, mir_pixel_format_xrgb_8888, red), geom::Rectangle{{0, 0}, {2, 2}});
+
+    renderer.render({window});
+
+    EXPECT_THAT(display_buffer.at(1, 1), Eq(red));
+    EXPECT_THAT(display_buffer.at(2, 2), Eq(black));
+}
+
+TEST_F(SoftwareRenderer, repaints_only_what_changed_since_the_buffer_was_last_drawn)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    auto const window = std::make_shared<mtd::StubRenderable>(
+        make_buffer({2, 2}, mir_pixel_format_xrgb_8888, red), geom::Rectangle{{0, 0}, {2, 2}});
+    auto const other = std::make_shared<mtd::StubRenderable>(
+        make_buffer({2, 2}, mir_pixel_format_xrgb_8888, blue), geom::Rectangle{{4, 0}, {2, 2}});
+
+    renderer.render({window, other});
+
+    display_buffer.at(0, 0) = poison;
+    display_buffer.at(4, 0) = poison;
+    display_buffer.at(7, 3) = poison;
+
+    other->set_buffer(make_buffer({2, 2}, mir_pixel_format_xrgb_8888, red));
+    renderer.render({window, other});
+
+    EXPECT_THAT(display_buffer.at(0, 0), Eq(poison));
+    EXPECT_THAT(display_buffer.at(7, 3), Eq(poison));
+    EXPECT_THAT(display_buffer.at(4, 0), Eq(red));
+}
+
+TEST_F(SoftwareRenderer, repaints_where_renderables_used_to_be)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    auto const window = std::make_shared<mtd::StubRenderable>(
+        make_buffer({2, 2}, mir_pixel_format_xrgb_8888, red), geom::Rectangle{{0, 0}, {2, 2}});
+
+    renderer.render({window});
+    renderer.render({});
+
+    EXPECT_THAT(display_buffer.at(0, 0), Eq(black));
+}
+
+TEST_F(SoftwareRenderer, repaints_everything_into_buffers_of_unknown_age)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    auto const window = std::make_shared<mtd::StubRenderable>(
+        make_buffer({2, 2}, mir_pixel_format_xrgb_8888, red), geom::Rectangle{{0, 0}, {2, 2}});
+
+    renderer.render({window});
+
+    display_buffer.age = 0;
+    display_buffer.at(0, 0) = poison;
+    display_buffer.at(7, 3) = poison;
+
+    renderer.render({window});
+
+    EXPECT_THAT(display_buffer.at(0, 0), Eq(red));
+    EXPECT_THAT(display_buffer.at(7, 3), Eq(black));
+}
+
+TEST_F(SoftwareRenderer, includes_damage_from_frames_the_buffer_missed)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    auto const window = std::make_shared<mtd::StubRenderable>(
+        make_buffer({2, 2}, mir_pixel_format_xrgb_8888, red), geom::Rectangle{{0, 0}, {2, 2}});
+    auto const other = std::make_shared<mtd::StubRenderable>(
+        make_buffer({2, 2}, mir_pixel_format_xrgb_8888, blue), geom::Rectangle{{4, 0}, {2, 2}});
+
+    renderer.render({window, other});
+    other->set_buffer(make_buffer({2, 2}, mir_pixel_format_xrgb_8888, red));
+    renderer.render({window, other});
+
+    // A buffer that last held the frame before last needs the previous frame's damage too
+    display_buffer.age = 2;
+    display_buffer.at(4, 0) = poison;
+    display_buffer.at(0, 0) = poison;
+    renderer.render({window, other});
+
+    EXPECT_THAT(display_buffer.at(4, 0), Eq(red));
+    EXPECT_THAT(display_buffer.at(0, 0), Eq(poison));
+}
+
+TEST_F(SoftwareRenderer, rotates_output)
+{
+    // Logically 3x2, physically 2x3
+    SoftwareDisplayBuffer rotated{{{0, 0}, {3, 2}}, {2, 3}};
+    mrs::Renderer renderer{rotated};
+    renderer.set_output_transform(mg::transformation(mir_orientation_left));
+
+    auto const top_left = std::make_shared<mtd::StubRenderable>(
+        make_buffer({1, 1}, mir_pixel_format_xrgb_8888, red), geom::Rectangle{{0, 0}, {1, 1}});
+    auto const top_right = std::make_shared<mtd::StubRenderable>(
+        make_buffer({1, 1}, mir_pixel_format_xrgb_8888, blue), geom::Rectangle{{2, 0}, {1, 1}});
+
+    renderer.render({top_left, top_right});
+
+    // Rotated a quarter turn anticlockwise
+    EXPECT_THAT(rotated.at(0, 2), Eq(red));
+    EXPECT_THAT(rotated.at(0, 0), Eq(blue));
+    EXPECT_THAT(rotated.at(1, 1), Eq(black));
+}
+
+TEST_F(SoftwareRenderer, rejects_display_buffers_it_cannot_draw_into)
+{
+    NiceMock<mtd::MockDisplayBuffer> gl_only;
+
+    EXPECT_THROW(mrs::Renderer{gl_only}, std::logic_error);
+}
+
+TEST(SoftwarePixelKernels, vectorised_blending_matches_scalar_blending)
+{
+    std::vector<uint32_t> src(67);
+    std::vector<uint32_t> dst(src.size());
+
+    srand(42);
+    for (size_t i = 0; i != src.size(); ++i)
+    {
+        // Premultiplied: no colour channel exceeds alpha
+        uint32_t const alpha = (i % 5 == 0) ? 0xff : (i % 7 == 0) ? 0 : rand() % 256;
+        uint32_t pixel = alpha << 24;
+        for (auto shift = 0; shift != 24; shift += 8)
+            pixel |= (alpha ? rand() % (alpha + 1) : 0) << shift;
+        src[i] = pixel;
+        dst[i] = static_cast<uint32_t>(rand()) | 0xff000000;
+    }
+
+    for (uint8_t alpha : {uint8_t{0xff}, uint8_t{0x80}})
+    {
+        for (bool swap_rb : {false, true})
+        {
+            auto whole_row = dst;
+            auto pixel_by_pixel = dst;
+
+            mrs::blend_row(whole_row.data(), src.data(), src.size(), swap_rb, false, alpha);
+            for (size_t i = 0; i != src.size(); ++i)
+                mrs::blend_row(&pixel_by_pixel[i], &src[i], 1, swap_rb, false, alpha);
+
+            EXPECT_THAT(whole_row, ContainerEq(pixel_by_pixel));
+        }
+    }
+}
@@ -24,6 +24,7 @@
 #include "mir/frontend/event_sink.h"
 #include "mir/geometry/rectangle.h"
 #include "mir/geometry/displacement.h"
+#include "mir/graphics/surface_layer.h"
 #include "mir/scene/null_surface_observer.h"
 #include "mir/events/event_builders.h"
 
@@ -879,6 +880,37 @@ TEST_F(BasicSurfaceTest, showing_brings_all_streams_up_to_date)
     surface.configure(mir_window_attrib_visibility, mir_window_visibility_exposed);
 }
 
+TEST_F(BasicSurfaceTest, streams_are_layers_of_the_same_surface)
+{
+    using namespace testing;
+    auto buffer_stream = std::make_shared<NiceMock<mtd::MockBufferStream>>();
+    std::list<ms::StreamInfo> streams = {
+        { mock_buffer_stream, {0,0}, {} },
+        { buffer_stream, {10,10}, {} }
+    };
+    surface.set_streams(streams);
+
+    ms::BasicSurface other_surface{
+        name, rect, mir_pointer_unconfined,
+        {{ std::make_shared<NiceMock<mtd::MockBufferStream>>(), {0,0}, {} }},
+        std::shared_ptr<mg::CursorImage>(), report};
+
+    auto const renderables = surface.generate_renderables(this);
+    auto const other_renderables = other_surface.generate_renderables(this);
+    ASSERT_THAT(renderables.size(), Eq(2u));
+    ASSERT_THAT(other_renderables.size(), Eq(1u));
+
+    auto const surface_of = [](std::shared_ptr<mg::Renderable> const& renderable)
+        {
+            auto const layer = std::dynamic_pointer_cast<mg::SurfaceLayer>(renderable);
+            return layer ? layer->surface_id() : nullptr;
+        };
+
+    EXPECT_THAT(surface_of(renderables[0]), NotNull());
+    EXPECT_THAT(surface_of(renderables[1]), Eq(surface_of(renderables[0])));
+    EXPECT_THAT(surface_of(other_renderables[0]), Ne(surface_of(renderables[0])));
+}
+
 //TODO: per-stream alpha and swapinterval seems useful
 TEST_F(BasicSurfaceTest, changing_alpha_effects_all_streams)
 {
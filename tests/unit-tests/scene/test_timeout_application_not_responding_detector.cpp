@@ -45,7 +45,7 @@ TEST(TimeoutApplicationNotRespondingDetector, pings_registered_sessions_on_sched
     
     mtd::FakeAlarmFactory fake_alarms;
     
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), 1s};
     
     bool first_session_pinged{false}, second_session_pinged{false};
     
@@ -72,7 +72,7 @@ TEST(TimeoutApplicationNotRespondingDetector, pings_repeatedly)
 
     mtd::FakeAlarmFactory fake_alarms;
 
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), 1s};
 
     int first_session_pinged{0}, second_session_pinged{0};
 
@@ -101,7 +101,7 @@ TEST(TimeoutApplicationNotRespondingDetector, triggers_anr_signal_when_session_f
 
     mtd::FakeAlarmFactory fake_alarms;
 
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), 1s};
 
     bool session_not_responding{false};
     auto observer = std::make_shared<NiceMock<MockObserver>>();
@@ -132,7 +132,7 @@ TEST(TimeoutApplicationNotRespondingDetector, does_not_trigger_anr_when_session_
 
     mtd::FakeAlarmFactory fake_alarms;
 
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), 1s};
 
     bool session_not_responding{false};
     auto observer = std::make_shared<NiceMock<MockObserver>>();
@@ -165,7 +165,7 @@ TEST(TimeoutApplicationNotRespondingDetector, triggers_now_responsive_signal_whe
 
     mtd::FakeAlarmFactory fake_alarms;
 
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), 1s};
 
     bool session_not_responding{false};
     auto observer = std::make_shared<NiceMock<MockObserver>>();
@@ -205,7 +205,7 @@ TEST(TimeoutApplicationNotRespondingDetector, fiddling_with_sessions_from_callba
 
     mtd::FakeAlarmFactory fake_alarms;
 
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), 1s};
 
     NiceMock<mtd::MockSceneSession> session_one, session_two, session_three;
 
@@ -242,7 +242,7 @@ TEST(TimeoutApplicationNotRespondingDetector, does_not_generate_signals_after_un
 
     mtd::FakeAlarmFactory fake_alarms;
 
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), 1s};
 
     bool session_not_responding{false};
     auto observer = std::make_shared<NiceMock<MockObserver>>();
@@ -285,7 +285,7 @@ TEST(TimeoutApplicationNotRespondingDetector, does_not_schedule_alarm_when_no_se
 
     mtd::FakeAlarmFactory fake_alarms;
 
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), 1s};
 
     // Go through several ping cycles.
     fake_alarms.advance_smoothly_by(5000ms);
@@ -316,7 +316,7 @@ TEST(TimeoutApplicationNotRespondingDetector, does_not_schedule_alarm_when_all_s
 
     mtd::FakeAlarmFactory fake_alarms;
 
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), 1s};
 
     NiceMock<mtd::MockSceneSession> session;
     bool session_unresponsive{false};
@@ -350,7 +350,7 @@ TEST(TimeoutApplicationNotRespondingDetector, session_switches_between_responsiv
 
     mtd::FakeAlarmFactory fake_alarms;
 
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), 1s};
 
     NiceMock<mtd::MockSceneSession> session;
     bool session_unresponsive{false};
@@ -391,7 +391,7 @@ TEST(TimeoutApplicationNotRespondingDetector, sends_unresponsive_notification_on
 
     mtd::FakeAlarmFactory fake_alarms;
 
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), 1s};
 
     NiceMock<mtd::MockSceneSession> session_one;
     NiceMock<mtd::MockSceneSession> session_two;
@@ -434,7 +434,7 @@ TEST(TimeoutApplicationNotRespondingDetector, sends_pings_on_schedule_as_session
     mtd::FakeAlarmFactory fake_alarms;
 
     auto const cycle_time = 1s;
-    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, cycle_time};
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, fake_alarms.the_clock(), cycle_time};
 
     NiceMock<mtd::MockSceneSession> session;
     std::atomic<int> ping_count{0};
@@ -469,3 +469,40 @@ TEST(TimeoutApplicationNotRespondingDetector, sends_pings_on_schedule_as_session
 
     EXPECT_THAT(ping_count, Ge(duration / cycle_time));
 }
+
+TEST(TimeoutApplicationNotRespondingDetector, pings_each_session_a_period_after_it_registered)
+{
+    using namespace testing;
+    using namespace std::literals::chrono_literals;
+
+    mtd::FakeAlarmFactory fake_alarms;
+    auto const clock = fake_alarms.the_clock();
+
+    auto const cycle_time = 1000ms;
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, clock, cycle_time};
+
+    int const session_count{10};
+    NiceMock<mtd::MockSceneSession> sessions[session_count];
+    mt::Timestamp registered_at[session_count];
+    mt::Timestamp first_pinged_at[session_count];
+
+    for (auto i = 0; i != session_count; ++i)
+    {
+        registered_at[i] = clock->now();
+        detector.register_session(&sessions[i],
+            [&first_pinged_at, &clock, i]()
+            {
+                if (first_pinged_at[i] == mt::Timestamp{})
+                    first_pinged_at[i] = clock->now();
+            });
+        fake_alarms.advance_smoothly_by(cycle_time / 10);
+    }
+
+    fake_alarms.advance_smoothly_by(2 * cycle_time);
+
+    for (auto i = 0; i != session_count; ++i)
+    {
+        EXPECT_THAT(first_pinged_at[i] - registered_at[i], Ge(mt::Duration{cycle_time}));
+        EXPECT_THAT(first_pinged_at[i] - registered_at[i], Le(mt::Duration{cycle_time + cycle_time / 8}));
+    }
+}
@@ -18,6 +18,7 @@
 
 #include "mir/cookie/authority.h"
 #include "mir/cookie/cookie.h"
+#include "mir/cookie/blob.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -165,3 +166,70 @@ TEST(MirCookieAuthority, makes_cookies_quickly)
     int seconds = std::chrono::duration_cast<std::chrono::seconds>(duration).count();
     EXPECT_THAT(seconds, Lt(5));
 }
+
+TEST(MirCookieAuthority, attests_siphash_timestamp)
+{
+    std::vector<uint8_t> secret{ 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0xde, 0x01 };
+    auto authority = mir::cookie::Authority::create_from(secret, mir::cookie::Format::siphash_2_4);
+
+    uint64_t mock_timestamp{0x322322322332};
+
+    auto cookie = authority->make_cookie(mock_timestamp);
+    EXPECT_NO_THROW({
+        authority->make_cookie(cookie->serialize());
+    });
+}
+
+TEST(MirCookieAuthority, siphash_cookies_are_smaller)
+{
+    using namespace testing;
+    std::vector<uint8_t> secret{ 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0xde, 0x01 };
+    auto authority = mir::cookie::Authority::create_from(secret, mir::cookie::Format::siphash_2_4);
+
+    auto const serialized = authority->make_cookie(23)->serialize();
+
+    EXPECT_THAT(serialized.size(), Eq(mir::cookie::siphash_2_4_blob_size));
+    EXPECT_THAT(serialized[0], Eq(static_cast<uint8_t>(mir::cookie::Format::siphash_2_4)));
+}
+
+TEST(MirCookieAuthority, doesnt_attest_tampered_siphash_cookie)
+{
+    std::vector<uint8_t> secret{ 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0xde, 0x01 };
+    auto authority = mir::cookie::Authority::create_from(secret, mir::cookie::Format::siphash_2_4);
+
+    auto serialized = authority->make_cookie(0x01020304)->serialize();
+    serialized[1] ^= 0x01;
+
+    EXPECT_THROW({
+        authority->make_cookie(serialized);
+    }, mir::cookie::SecurityCheckError);
+}
+
+TEST(MirCookieAuthority, siphash_timestamp_trusted_with_different_secret_doesnt_attest)
+{
+    std::vector<uint8_t> alice{ 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0xde, 0x01 };
+    std::vector<uint8_t> bob{ 0x01, 0x02, 0x44, 0xd8, 0xee, 0x0f, 0xde, 0x01 };
+
+    auto alices_authority = mir::cookie::Authority::create_from(alice, mir::cookie::Format::siphash_2_4);
+    auto bobs_authority   = mir::cookie::Authority::create_from(bob, mir::cookie::Format::siphash_2_4);
+
+    auto bobs_cookie = bobs_authority->make_cookie(0x01020304);
+
+    EXPECT_THROW({
+        alices_authority->make_cookie(bobs_cookie->serialize());
+    }, mir::cookie::SecurityCheckError);
+}
+
+TEST(MirCookieAuthority, doesnt_attest_cookies_of_another_format_from_the_same_secret)
+{
+    std::vector<uint8_t> secret{ 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0xde, 0x01 };
+    auto hmac_authority = mir::cookie::Authority::create_from(secret, mir::cookie::Format::hmac_sha_256);
+    auto siphash_authority = mir::cookie::Authority::create_from(secret, mir::cookie::Format::siphash_2_4);
+
+    EXPECT_THROW({
+        hmac_authority->make_cookie(siphash_authority->make_cookie(23)->serialize());
+    }, mir::cookie::SecurityCheckError);
+    EXPECT_THROW({
+        siphash_authority->make_cookie(hmac_authority->make_cookie(23)->serialize());
+    }, mir::cookie::SecurityCheckError);
+}
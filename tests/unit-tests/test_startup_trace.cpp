@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/startup_trace.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+
+TEST(StartupTrace, records_nothing_unless_running)
+{
+    {
+        mir::StartupTraceSpan const span{"before"};
+    }
+
+    mir::start_startup_trace();
+    EXPECT_TRUE(mir::startup_trace_running());
+    auto const trace = mir::stop_startup_trace();
+
+    EXPECT_FALSE(mir::startup_trace_running());
+    EXPECT_THAT(trace, Not(HasSubstr("before")));
+}
+
+TEST(StartupTrace, records_nested_spans_as_complete_events)
+{
+    mir::start_startup_trace();
+    {
+        mir::StartupTraceSpan const outer{"outer"};
+        mir::StartupTraceSpan const inner{"inner"};
+    }
+    auto const trace = mir::stop_startup_trace();
+
+    EXPECT_THAT(trace, StartsWith("{\"traceEvents\":["));
+    EXPECT_THAT(trace, HasSubstr("{\"name\":\"inner\",\"ph\":\"X\""));
+    EXPECT_THAT(trace, HasSubstr("{\"name\":\"outer\",\"ph\":\"X\""));
+    EXPECT_THAT(trace, HasSubstr("\"cpu_us\":"));
+}
+
+TEST(StartupTrace, discards_spans_started_before_the_trace)
+{
+    mir::start_startup_trace();
+    {
+        mir::StartupTraceSpan const span{"early"};
+        mir::start_startup_trace();
+    }
+    auto const trace = mir::stop_startup_trace();
+
+    EXPECT_THAT(trace, Not(HasSubstr("early")));
+}
+
+TEST(StartupTrace, escapes_span_names)
+{
+    mir::start_startup_trace();
+    {
+        mir::StartupTraceSpan const span{"a \"quoted\" \\name\n"};
+    }
+    auto const trace = mir::stop_startup_trace();
+
+    EXPECT_THAT(trace, HasSubstr("\"a \\\"quoted\\\" \\\\name\\u000a\""));
+}
@@ -22,7 +22,8 @@ packages="\
     mir-client-platform-mesa:MIR_CLIENT_PLATFORM_ABI \
     mir-platform-graphics-mesa-x:MIR_SERVER_GRAPHICS_PLATFORM_ABI \
     mir-platform-graphics-mesa-kms:MIR_SERVER_GRAPHICS_PLATFORM_ABI \
-    mir-platform-input-evdev:MIR_SERVER_INPUT_PLATFORM_ABI"
+    mir-platform-input-evdev:MIR_SERVER_INPUT_PLATFORM_ABI \
+    mir-platform-input-replay:MIR_SERVER_INPUT_PLATFORM_ABI"
 
 package_name()
 {